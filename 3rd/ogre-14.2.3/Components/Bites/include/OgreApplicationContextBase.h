@@ -238,6 +238,21 @@ namespace OgreBites
          */
         void enableShaderCache() const;
 
+        /**
+         * enables the caching of parsed scripts to file
+         *
+         * also loads any existing cache. Must be called before loadResources
+         */
+        void enableScriptCache() const;
+
+        /**
+         * enables the caching of decoded textures to files
+         *
+         * entries are mapped into memory when loading. Must be called before loadResources
+         * @param compress store block compressed textures, see TextureManager::setTextureCacheCompression
+         */
+        void enableTextureCache(bool compress = false) const;
+
         /** attach input listener
          *
          * @param lis the listener
@@ -9,6 +9,7 @@
 #include "OgreImGuiInputListener.h"
 #include "OgreRoot.h"
 #include "OgreGpuProgramManager.h"
+#include "OgreScriptCompiler.h"
 #include "OgreConfigFile.h"
 #include "OgreRenderWindow.h"
 #include "OgreViewport.h"
@@ -20,12 +21,16 @@
 #include "OgreCamera.h"
 
 #include "OgreArchiveManager.h"
+#include "OgreFileSystem.h"
+#include "OgreTextureManager.h"
 
 #include "OgreConfigPaths.h"
 
 namespace OgreBites {
 
 static const char* SHADER_CACHE_FILENAME = "cache.bin";
+static const char* SCRIPT_CACHE_FILENAME = "scripts.bin";
+static const char* TEXTURE_CACHE_DIRNAME = "textures";
 
 ApplicationContextBase::ApplicationContextBase(const Ogre::String& appName)
 {
@@ -335,6 +340,39 @@ void ApplicationContextBase::enableShaderCache() const
     Ogre::GpuProgramManager::getSingleton().loadMicrocodeCache(istream);
 }
 
+void ApplicationContextBase::enableScriptCache() const
+{
+    Ogre::ScriptCompilerManager::getSingleton().setSaveParsedScriptsToCache(true);
+
+    Ogre::String path = mFSLayer->getWritablePath(SCRIPT_CACHE_FILENAME);
+    std::ifstream inFile(path.c_str(), std::ios::binary);
+    if (!inFile.is_open())
+    {
+        Ogre::LogManager::getSingleton().logWarning("Could not open '"+path+"'");
+        return;
+    }
+    Ogre::LogManager::getSingleton().logMessage("Loading script cache from '"+path+"'");
+    Ogre::DataStreamPtr istream(new Ogre::FileStreamDataStream(path, &inFile, false));
+    Ogre::ScriptCompilerManager::getSingleton().loadParsedScriptCache(istream);
+}
+
+void ApplicationContextBase::enableTextureCache(bool compress) const
+{
+    Ogre::String path = mFSLayer->getWritablePath(TEXTURE_CACHE_DIRNAME);
+    if (!Ogre::FileSystemLayer::createDirectory(path))
+    {
+        Ogre::LogManager::getSingleton().logWarning("Could not create '"+path+"'");
+        return;
+    }
+    Ogre::LogManager::getSingleton().logMessage("Using texture cache in '"+path+"'");
+
+    // upload the entries straight from the mapped files
+    Ogre::FileSystemArchiveFactory::setMapFiles(true);
+    auto& texMgr = Ogre::TextureManager::getSingleton();
+    texMgr.setTextureCache(Ogre::ArchiveManager::getSingleton().load(path, "FileSystem", false));
+    texMgr.setTextureCacheCompression(compress);
+}
+
 void ApplicationContextBase::addInputListener(NativeWindowType* win, InputListener* lis)
 {
     mInputListeners.insert(std::make_pair(0, lis));
@@ -615,6 +653,22 @@ void ApplicationContextBase::shutdown()
             Ogre::LogManager::getSingleton().logWarning("Cannot open shader cache for writing "+path);
     }
 
+    const auto& scriptMgr = Ogre::ScriptCompilerManager::getSingleton();
+    if (scriptMgr.getSaveParsedScriptsToCache() && scriptMgr.isParsedScriptCacheDirty())
+    {
+        Ogre::String path = mFSLayer->getWritablePath(SCRIPT_CACHE_FILENAME);
+        std::fstream outFile(path.c_str(), std::ios::out | std::ios::binary);
+
+        if (outFile.is_open())
+        {
+            Ogre::LogManager::getSingleton().logMessage("Writing script cache to "+path);
+            Ogre::DataStreamPtr ostream(new Ogre::FileStreamDataStream(path, &outFile, false));
+            scriptMgr.saveParsedScriptCache(ostream);
+        }
+        else
+            Ogre::LogManager::getSingleton().logWarning("Cannot open script cache for writing "+path);
+    }
+
 #ifdef OGRE_BUILD_COMPONENT_RTSHADERSYSTEM
     // Destroy the RT Shader System.
     destroyRTShaderSystem();
@@ -375,6 +375,19 @@ public:
         validateMaterial(schemeName, mat.getName(), mat.getGroup());
     }
 
+    /**
+    Create the shader based techniques of the materials of a group and generate their shader programs.
+
+    Shader based techniques are usually created when a material is first rendered, see
+    OgreBites::SGTechniqueResolverListener, so the programs are generated and compiled during that frame.
+    Call this after loading the resources to do it upfront. With GpuProgramManager::setSaveMicrocodesToCache,
+    the program binaries are cached too, so the next run only generates the source.
+    @param schemeName The destination scheme, created from the default scheme techniques.
+    @param groupName The resource group of the materials, RGN_AUTODETECT for all groups.
+    @return The number of materials validated.
+    */
+    size_t precompileMaterials(const String& schemeName, const String& groupName = RGN_AUTODETECT);
+
 	/**
 	Invalidate specific material scheme. This action will lead to shader regeneration of the technique belongs to the
 	given scheme name.
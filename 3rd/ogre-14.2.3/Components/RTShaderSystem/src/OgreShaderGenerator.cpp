@@ -1085,6 +1085,43 @@ bool ShaderGenerator::validateMaterial(const String& schemeName, const String& m
     return itScheme->second->validate(materialName, groupName);
 }
 
+//-----------------------------------------------------------------------------
+size_t ShaderGenerator::precompileMaterials(const String& schemeName, const String& groupName)
+{
+    // validation may create materials, so work on a copy
+    std::vector<MaterialPtr> materials;
+    for (const auto& res : MaterialManager::getSingleton().getResourceIterator())
+    {
+        if (groupName == RGN_AUTODETECT || res.second->getGroup() == groupName)
+            materials.push_back(static_pointer_cast<Material>(res.second));
+    }
+
+    size_t count = 0;
+    for (const auto& mat : materials)
+    {
+        // as loading would, to know which techniques are supported
+        if (!mat->isLoaded())
+            mat->compile();
+
+        if (!createShaderBasedTechnique(*mat, MSN_DEFAULT, schemeName))
+            continue;
+
+        try
+        {
+            count += validateMaterial(schemeName, mat->getName(), mat->getGroup());
+        }
+        catch (const Exception& e)
+        {
+            LogManager::getSingleton().logWarning("RTSS: could not precompile material '" + mat->getName() +
+                                                  "': " + e.getDescription());
+        }
+    }
+
+    LogManager::getSingleton().stream() << "RTSS: precompiled " << count << " materials for scheme '"
+                                        << schemeName << "'";
+    return count;
+}
+
 //-----------------------------------------------------------------------------
 void ShaderGenerator::invalidateMaterialIlluminationPasses(const String& schemeName, const String& materialName, const String& groupName)
 {
@@ -54,6 +54,7 @@ THE SOFTWARE.
 #include "OgreDataStream.h"
 #include "OgreEntity.h"
 #include "OgreException.h"
+#include "OgreFrameAllocator.h"
 #include "OgreFrameListener.h"
 #include "OgreFrustum.h"
 #include "OgreGpuProgram.h"
@@ -80,6 +81,7 @@ THE SOFTWARE.
 #include "OgreMath.h"
 #include "OgreMatrix3.h"
 #include "OgreMatrix4.h"
+#include "OgreMemoryReport.h"
 #include "OgreMesh.h"
 #include "OgreMeshManager.h"
 #include "OgreMovablePlane.h"
@@ -125,8 +127,10 @@ THE SOFTWARE.
 #include "OgreTextureManager.h"
 #include "OgreTextureUnitState.h"
 #include "OgreTimer.h"
+#include "OgreTransformHierarchy.h"
 #include "OgreVector.h"
 #include "OgreViewport.h"
+#include "OgreVisibilityCuller.h"
 #include "OgreComponents.h"
 // .... more to come
 
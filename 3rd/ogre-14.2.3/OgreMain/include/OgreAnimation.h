@@ -77,6 +77,27 @@ namespace Ogre {
         virtual void removeAnimation(const String& name) = 0;
         
     };
+    /** Transforms of the bones of a skeleton, one array per component
+
+        Skeleton::setAnimationState blends the node tracks of all enabled animations into it with
+        Animation::_applyToPose, then writes each bone once.
+    */
+    struct SkeletonPose
+    {
+        std::vector<Real> tx, ty, tz;
+        std::vector<Real> qw, qx, qy, qz;
+        std::vector<Real> sx, sy, sz;
+        /// whether the bone is written back, set for the bones a track was applied to
+        std::vector<uchar> animated;
+
+        void resize(size_t numBones)
+        {
+            for (auto v : {&tx, &ty, &tz, &qw, &qx, &qy, &qz, &sx, &sy, &sz})
+                v->resize(numBones);
+            animated.resize(numBones);
+        }
+    };
+
     /** An animation sequence. 
 
         This class defines the interface for a sequence of animation, whether that
@@ -443,7 +464,10 @@ namespace Ogre {
         
         /** Internal method used to tell the animation that keyframe list has been
             changed, which may cause it to rebuild some internal data */
-        void _keyFrameListChanged(void) { mKeyFrameTimesDirty = true; }
+        void _keyFrameListChanged(void) { mKeyFrameTimesDirty = true; mFlatNodeTracksDirty = true; }
+
+        /// Internal method used to tell the animation that the values of node keyframes changed
+        void _keyFrameDataChanged(void) { mFlatNodeTracksDirty = true; }
 
         /** Internal method used to convert time position to time index object.
         @note
@@ -456,6 +480,39 @@ namespace Ogre {
             global keyframe time list.
         */
         TimeIndex _getTimeIndex(Real timePos) const;
+
+        /** As _getTimeIndex, but the search starts at keyIndexCursor, which receives the found index
+
+            Sequential playback finds the keyframe at the cursor or right after it, without a
+            binary search.
+        */
+        TimeIndex _getTimeIndex(Real timePos, uint& keyIndexCursor) const;
+
+        /** Prepare for _applyToPose, returns whether _applyToPose can evaluate this animation
+
+            Applies the base keyframe and copies the node tracks to flat arrays if needed. Spline
+            interpolation and node tracks with a listener need the per node path of apply.
+        */
+        bool _prepareApplyToPose();
+
+        /** Whether _applyToPose can evaluate this animation, with nothing left to prepare
+
+            In which case _applyToPose only reads this animation, and can run on several threads.
+        */
+        bool _canApplyToPose() const;
+
+        /** Blends the node tracks at timePos into pose, as apply does to the bones of a skeleton
+
+            Requires _prepareApplyToPose to return true.
+        @param pose The pose of the skeleton
+        @param timePos The time position in the animation to apply.
+        @param keyIndexCursor Where the keyframe search starts (@see AnimationState::_getKeyIndexCursor)
+        @param weight The influence to give to this animation
+        @param blendMask Additional per bone weights, or NULL
+        @param scale The scale to apply to translations and scalings
+        */
+        void _applyToPose(SkeletonPose& pose, Real timePos, uint& keyIndexCursor, Real weight,
+                          const AnimationState::BoneBlendMask* blendMask, Real scale) const;
         
         /** Sets a base keyframe which for the skeletal / pose keyframes 
             in this animation. 
@@ -516,6 +573,8 @@ namespace Ogre {
         /// Dirty flag indicate that keyframe time list need to rebuild
         mutable bool mKeyFrameTimesDirty;
         bool mUseBaseKeyFrame;
+        /// Dirty flag indicate that the flat node tracks need to be copied again
+        bool mFlatNodeTracksDirty;
 
         static InterpolationMode msDefaultInterpolationMode;
         static RotationInterpolationMode msDefaultRotationInterpolationMode;
@@ -527,11 +586,30 @@ namespace Ogre {
         String mBaseKeyFrameAnimationName;
         AnimationContainer* mContainer;
 
+        /// A node track with keyframes, as copied for _applyToPose
+        struct FlatNodeTrack
+        {
+            const NodeAnimationTrack* track;
+            ushort handle;
+            /// index of the first keyframe in the arrays below
+            uint firstKey;
+        };
+        std::vector<FlatNodeTrack> mFlatNodeTracks;
+        /// keyframes of all flat node tracks, track after track
+        std::vector<Real> mFlatKeyTimes;
+        std::vector<Quaternion> mFlatKeyRotations;
+        std::vector<Vector3> mFlatKeyTranslations;
+        std::vector<Vector3> mFlatKeyScales;
+        /// keyframe of each flat node track for each global keyframe index, one row per track
+        std::vector<ushort> mFlatKeyIndexMap;
+
         void optimiseNodeTracks(bool discardIdentityTracks);
         void optimiseVertexTracks(void);
 
         /// Internal method to build global keyframe time list
         void buildKeyFrameTimeList(void) const;
+        /// Internal method to copy the node tracks to flat arrays
+        void buildFlatNodeTracks(void);
     };
 
     /** @} */
@@ -165,6 +165,10 @@ namespace Ogre {
           assert(mBlendMask.size() > boneHandle);
           return mBlendMask[boneHandle];
       }
+
+        /** Global keyframe index found at the last evaluation, where Animation::_getTimeIndex starts
+            looking, so sequential playback does not need a binary search */
+        uint& _getKeyIndexCursor() const { return mKeyIndexCursor; }
     private:
         /** @brief Set the blend mask data (might be dangerous)
          *
@@ -184,6 +188,7 @@ namespace Ogre {
         Real mWeight;
         bool mEnabled;
         bool mLoop;
+        mutable uint mKeyIndexCursor;
 
     };
 
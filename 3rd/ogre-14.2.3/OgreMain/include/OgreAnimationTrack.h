@@ -235,6 +235,8 @@ namespace Ogre
 
         /** Set a listener for this track. */
         virtual void setListener(Listener* l) { mListener = l; }
+        /** Returns the listener of this track, if any. */
+        Listener* getListener() const { return mListener; }
 
         /** Returns the parent Animation object for this track. */
         Animation *getParent() const { return mParent; }
@@ -124,9 +124,16 @@ namespace Ogre {
         const SceneManager* mCurrentSceneManager;
         const VisibleObjectsBoundsInfo* mMainCamBoundsInfo;
         const Pass* mCurrentPass;
+        /// identity view and projection flags of the current renderable
+        uchar mIdentityFlags;
+
+        /// change counters, indexed by GpuParamVariability
+        uint32 mChangeCount[GPV_LIGHTS + 1];
 
         SceneNode mDummyNode;
         Light mBlankLight;
+
+        void markChanged(uint16 variability);
     public:
         AutoParamDataSource();
         /** Updates the current renderable */
@@ -154,6 +161,16 @@ namespace Ogre {
         /** Sets the current pass */
         void setCurrentPass(const Pass* pass);
 
+        /** Counter that is incremented whenever the data behind the auto constants of the given variability
+            may have changed
+
+            GpuProgramParameters compare it to the value seen by their last update, so constants are only
+            recomputed when their inputs changed. Setting the current pass or pass number is not counted, the
+            parameters check these themselves.
+        @param variability one of GPV_GLOBAL, GPV_PER_OBJECT or GPV_LIGHTS
+        */
+        uint32 getChangeCount(GpuParamVariability variability) const { return mChangeCount[variability]; }
+
 		/** Returns the current bounded camera */
 		const Camera* getCurrentCamera() const;
 
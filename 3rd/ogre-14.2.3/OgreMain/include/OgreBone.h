@@ -92,6 +92,12 @@ namespace Ogre
         */
         void reset(void);
 
+        /** Sets position, orientation and scale at once, as Skeleton::setAnimationState does
+
+            Internal use only.
+        */
+        void _setTransform(const Vector3& position, const Quaternion& orientation, const Vector3& scale);
+
         /** Sets whether or not this bone is manually controlled. 
 
             Manually controlled bones can be altered by the application at runtime, 
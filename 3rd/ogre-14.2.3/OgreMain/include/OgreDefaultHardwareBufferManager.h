@@ -117,6 +117,8 @@ namespace Ogre {
         {
             return mImpl->createUniformBuffer(sizeBytes, usage, useShadowBuffer);
         }
+
+        MemoryUsage getMemoryUsage() const override { return mImpl->getMemoryUsage(); }
     };
 
     /** @} */
@@ -336,6 +336,8 @@ namespace Ogre {
         mutable AxisAlignedBox mFullBoundingBox;  // note: this exists only so that getBoundingBox() can return an AAB by reference
 
         ShadowRenderableList mShadowRenderables;
+        /// Shadow volume indexes per light, reused while the entity is not animated
+        ShadowVolumeCache mShadowVolumes;
 
         /** Nested class to allow entity shadows. */
         class EntityShadowRenderable : public ShadowRenderable
@@ -434,6 +436,10 @@ namespace Ogre {
         AxisAlignedBox getChildObjectsBoundingBox(void) const;
 
         void _updateRenderQueue(RenderQueue* queue) override;
+        /// true unless animated, with attached or manual LOD objects or a listener
+        bool _canUpdateRenderQueueConcurrently() const override;
+        /// evaluates the skeleton, unless it is shared with or has objects attached to its bones
+        void _prepareRenderQueueUpdate() override;
         const String& getMovableType(void) const override;
 
         /** For entities based on animated meshes, gets the AnimationState object for a single animation.
@@ -605,6 +611,7 @@ namespace Ogre {
         const ShadowRenderableList& getShadowVolumeRenderableList(
             const Light* light, const HardwareIndexBufferPtr& indexBuffer,
             size_t& indexBufferUsedSize, float extrusionDistance, int flags = 0) override;
+        ShadowVolume* _getShadowVolumeToBuild(const Light* light, int flags) override;
 
         /** Internal method for retrieving bone matrix information. */
         const Affine3* _getBoneMatrices(void) const { return mBoneMatrices;}
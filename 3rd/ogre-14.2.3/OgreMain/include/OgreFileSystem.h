@@ -48,6 +48,9 @@ namespace Ogre {
     /// internal method to open a FileStreamDataStream
     DataStreamPtr _openFileStream(const String& path, std::ios::openmode mode, const String& name = "");
 
+    /// internal method to map a file into a MemoryDataStream, returns NULL if it cannot be mapped
+    DataStreamPtr _mapFileStream(const String& path, const String& name = "");
+
     /** Specialisation of the ArchiveFactory to allow reading of files from
         filesystem folders / directories.
     */
@@ -68,6 +71,18 @@ namespace Ogre {
 
         /// Get whether hidden files are ignored during filesystem enumeration.
         static bool getIgnoreHidden();
+
+        /** Set whether files opened read-only are mapped into memory.
+
+            The returned streams are MemoryDataStream instances over the mapping, which loaders such as
+            Mesh read in place instead of copying the whole file into memory first. A file that cannot
+            be mapped is opened as a regular stream. The file must not be truncated while a stream of it
+            is open. The default is false.
+        */
+        static void setMapFiles(bool map);
+
+        /// Get whether files opened read-only are mapped into memory.
+        static bool getMapFiles();
     };
 
     class APKFileSystemArchiveFactory : public ArchiveFactory
@@ -0,0 +1,140 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __FrameAllocator_H__
+#define __FrameAllocator_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** Linear arena for temporaries that do not outlive a frame
+
+        Allocating only moves an offset forward, and nothing is freed individually. Root resets its
+        arena when the frame ends, merging the blocks it had to add into a single one large enough for
+        the busiest frame so far, so a steady state does not touch the heap at all.
+
+        Code that needs scratch memory for the duration of a call can rewind to a Marker instead of
+        waiting for the end of the frame.
+    @note
+        Not thread safe, use the arena of Root from the rendering thread only.
+    */
+    class _OgreExport FrameAllocator : public GeneralAllocatedObject
+    {
+    public:
+        /// position to rewind to, see getMarker
+        struct Marker
+        {
+            size_t block;
+            size_t offset;
+            size_t used;
+        };
+
+        explicit FrameAllocator(size_t blockSize = 64 * 1024);
+        ~FrameAllocator();
+
+        /** Memory valid until the next reset or rewind
+            @param size bytes to allocate
+            @param alignment power of two in range [1, 128]
+        */
+        void* allocate(size_t size, size_t alignment = OGRE_SIMD_ALIGNMENT);
+
+        /// release all allocations at once
+        void reset();
+
+        Marker getMarker() const;
+        /// release the allocations made since marker was taken
+        void rewind(const Marker& marker);
+
+        /// bytes handed out since the last reset, including alignment padding
+        size_t getUsedBytes() const { return mUsed; }
+        /// the largest getUsedBytes seen before a reset
+        size_t getPeakBytes() const { return std::max(mPeak, mUsed); }
+        /// bytes reserved from the heap
+        size_t getCapacity() const;
+        /// allocations since the last reset
+        size_t getNumAllocations() const { return mNumAllocations; }
+
+    private:
+        struct Block
+        {
+            char* data;
+            size_t size;
+        };
+        std::vector<Block> mBlocks;
+        size_t mCurrent;
+        size_t mOffset;
+        size_t mUsed;
+        size_t mPeak;
+        size_t mNumAllocations;
+        size_t mBlockSize;
+    };
+
+    /** STL compatible wrapper for @ref FrameAllocator
+
+        Deallocation does nothing, so the container must not outlive the arena contents. Use it for
+        the temporary vectors and strings of a frame.
+    */
+    template<typename T>
+    struct ArenaAllocator
+    {
+        typedef T value_type;
+
+        FrameAllocator* arena;
+
+        explicit ArenaAllocator(FrameAllocator* a) : arena(a) {}
+
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+        T* allocate(size_t n)
+        {
+            return static_cast<T*>(arena->allocate(n * sizeof(T), std::max<size_t>(alignof(T), sizeof(void*))));
+        }
+
+        void deallocate(T* p, size_t n) {}
+
+        template <class U>
+        bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+        template <class U>
+        bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
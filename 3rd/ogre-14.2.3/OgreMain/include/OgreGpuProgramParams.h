@@ -1250,6 +1250,24 @@ namespace Ogre {
         /// physical index for active pass iteration parameter real constant entry;
         size_t mActivePassIterationIndex;
 
+        /// data source, pass and pass number the auto constants were last updated with
+        const AutoParamDataSource* mAutoSource;
+        const Pass* mAutoSourcePass;
+        int mAutoSourcePassNumber;
+        /// change counts of the source seen by the last update, indexed by GpuParamVariability
+        uint32 mAutoChangeCount[GPV_LIGHTS + 1];
+        /// variability whose change counts above are up to date
+        uint16 mAutoUpToDate;
+        /// variability of the auto constants that changed value in the last update
+        uint16 mChangedVariability;
+        /// bytes from each auto constant to the next one, to compare the values written
+        std::vector<uint32> mAutoConstantSizes;
+        /// size of the constants per variability mask, built on demand
+        mutable std::vector<uint32> mConstantsSizes;
+
+        /// the auto constants or the buffer layout changed, recompute everything on the next update
+        void resetAutoConstantTracking();
+
         /// Return the variability for an auto constant
         static uint16 deriveVariability(AutoConstantType act);
 
@@ -1635,6 +1653,20 @@ namespace Ogre {
         */
         void _updateAutoParams(const AutoParamDataSource* source, uint16 variabilityMask);
 
+        /** Variability of the auto constants whose value was changed by the last _updateAutoParams
+
+            Constants are only recomputed when AutoParamDataSource::getChangeCount reports that their inputs
+            changed, and only count as changed when the values written differ from the previous ones, so
+            binding the parameters again can be limited to this mask.
+        */
+        uint16 _getChangedVariability() const { return mChangedVariability; }
+
+        /** Size in bytes of the constants that have any of the given variability bits
+
+            That is what a render system uploads when binding the parameters with this mask.
+        */
+        size_t _getConstantsSize(uint16 variabilityMask) const;
+
         /** Tells the program whether to ignore missing parameters or not.
          */
         void setIgnoreMissingParams(bool state) { mIgnoreMissingParams = state; }
@@ -82,6 +82,7 @@ namespace Ogre {
         typedef std::set<HardwareVertexBuffer*> VertexBufferList;
         typedef std::set<HardwareIndexBuffer*> IndexBufferList;
         VertexBufferList mVertexBuffers;
+        IndexBufferList mIndexBuffers;
 
 
         typedef std::set<VertexDeclaration*> VertexDeclarationList;
@@ -91,6 +92,7 @@ namespace Ogre {
 
         // Mutexes
         OGRE_MUTEX(mVertexBuffersMutex);
+        OGRE_MUTEX(mIndexBuffersMutex);
         OGRE_MUTEX(mVertexDeclarationsMutex);
         OGRE_MUTEX(mVertexBufferBindingsMutex);
 
@@ -302,6 +304,27 @@ namespace Ogre {
 
         /// Notification that a hardware vertex buffer has been destroyed.
         void _notifyVertexBufferDestroyed(HardwareVertexBuffer* buf);
+
+        /// Notification that a hardware index buffer has been created.
+        void _notifyIndexBufferCreated(HardwareIndexBuffer* buf);
+        /// Notification that a hardware index buffer has been destroyed.
+        void _notifyIndexBufferDestroyed(HardwareIndexBuffer* buf);
+
+        /// Bytes held by the vertex and index buffers of this manager
+        struct MemoryUsage
+        {
+            size_t numVertexBuffers;
+            size_t vertexBytes;
+            size_t numIndexBuffers;
+            size_t indexBytes;
+            /// system memory copies of the buffers above, see HardwareBuffer::hasShadowBuffer
+            size_t shadowBytes;
+            /// temporary copies of vertex buffers, e.g. for software skinning, included in vertexBytes
+            size_t tempCopyBytes;
+        };
+
+        /// Sum up the sizes of the live buffers
+        virtual MemoryUsage getMemoryUsage() const;
     };
 
     /** Singleton wrapper for hardware buffer manager. */
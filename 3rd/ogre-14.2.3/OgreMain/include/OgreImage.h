@@ -426,7 +426,9 @@ namespace Ogre {
         {
             FILTER_NEAREST,
             FILTER_LINEAR,
-            FILTER_BILINEAR = FILTER_LINEAR
+            FILTER_BILINEAR = FILTER_LINEAR,
+            /// separable Catmull-Rom filter, widened when minifying. Sharper, but slower.
+            FILTER_BICUBIC
         };
         /** Scale a 1D, 2D or 3D image volume. 
             @param  src         PixelBox containing the source pointer, dimensions and format
@@ -439,6 +441,23 @@ namespace Ogre {
         
         /** Resize a 2D image, applying the appropriate filter. */
         void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR);
+
+        /** Generate the full mipmap chain of the image on the CPU
+
+            The levels below the top one are replaced, each being scaled from the one above. Halving the
+            width and height of 8 bit and float formats uses a box filter with SIMD kernels, and large
+            levels are split over the WorkQueue worker threads.
+        @param filter Which filter to use, FILTER_NEAREST is treated as FILTER_BILINEAR
+        */
+        void generateMipmaps(Filter filter = FILTER_BILINEAR);
+
+        /** Block compress the image including its mipmaps
+
+            Each 4x4 block is encoded on the CPU, fitting the endpoints to the principal axis of its colours.
+            This is meant for caching textures offline or on first use, not for per frame updates.
+        @param format PF_DXT1 for opaque images or PF_DXT5
+        */
+        void compress(PixelFormat format);
         
         /// Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static size_t calculateSize(uint32 mipmaps, uint32 faces, uint32 width, uint32 height, uint32 depth, PixelFormat format);
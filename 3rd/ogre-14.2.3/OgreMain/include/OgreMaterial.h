@@ -241,6 +241,9 @@ namespace Ogre {
 
         /// @deprecated use getSupportedTechniques()
         OGRE_DEPRECATED TechniqueIterator getSupportedTechniqueIterator(void);
+
+        /// The textures of the supported techniques, compiling the material if required
+        void _getDependencies(std::vector<ResourcePtr>& dependencies) override;
         
         /** Gets the indexed supported technique. */
         Technique* getSupportedTechnique(size_t index) const { return mSupportedTechniques.at(index); }
@@ -79,9 +79,75 @@ namespace Ogre
 
 namespace Ogre
 {
-    class AllocPolicy {};
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** Routes the allocations of AllocatedObject subclasses by MemoryCategory
+
+        By default the memory comes from the general heap. Categories can be switched to size class
+        pools with setPoolingEnabled, which serve blocks up to getMaxPooledSize bytes from slabs kept
+        for the lifetime of the process, so creating and destroying SceneNodes, Entities or particles
+        neither contends on the heap lock nor fragments it.
+
+        The number of allocations and bytes are counted per category, and per frame when Root calls
+        _frameEnded.
+    */
+    class _OgreExport CategoryAllocator
+    {
+    public:
+        /// allocation counters of one category
+        struct Stats
+        {
+            /// bytes held by live objects
+            size_t liveBytes;
+            /// number of live objects
+            size_t liveAllocations;
+            /// allocations since the process started
+            size_t totalAllocations;
+            /// allocations and bytes during the last complete frame
+            size_t frameAllocations;
+            size_t frameBytes;
+            /// bytes reserved by the pools, used or not
+            size_t pooledBytes;
+        };
+
+        static void* allocate(int category, size_t size);
+        static void deallocate(int category, void* ptr, size_t size);
+
+        /// count a raw allocation, see OGRE_MALLOC
+        static void* allocateBytes(int category, size_t size);
+
+        /** Serve the objects of category from pools
+
+            Only possible while there is no live object of the category, so call it before creating
+            Root. Returns whether pooling is now in the requested state.
+        */
+        static bool setPoolingEnabled(MemoryCategory category, bool enabled);
+        static bool isPoolingEnabled(MemoryCategory category);
+
+        /// objects larger than that always come from the heap
+        static size_t getMaxPooledSize();
+
+        static Stats getStats(MemoryCategory category);
+
+        /// roll the per frame counters over, called by Root
+        static void _frameEnded();
+    };
+
     // this is a template, mainly so swig does not pick it up
-    template<int Category = MEMCATEGORY_GENERAL> class AllocatedObject {};
+    template<int Category = MEMCATEGORY_GENERAL> class AllocatedObject
+    {
+    public:
+        static void* operator new(size_t size) { return CategoryAllocator::allocate(Category, size); }
+        static void operator delete(void* ptr, size_t size) { CategoryAllocator::deallocate(Category, ptr, size); }
+    };
+    /** @} */
+    /** @} */
+
+    class AllocPolicy {};
 
     // Useful shortcuts
     typedef AllocPolicy GeneralAllocPolicy;
@@ -94,14 +160,14 @@ namespace Ogre
     typedef AllocPolicy RenderSysAllocPolicy;
 
     // Now define all the base classes for each allocation
-    typedef AllocatedObject<> GeneralAllocatedObject;
-    typedef AllocatedObject<> GeometryAllocatedObject;
-    typedef AllocatedObject<> AnimationAllocatedObject;
-    typedef AllocatedObject<> SceneCtlAllocatedObject;
-    typedef AllocatedObject<> SceneObjAllocatedObject;
-    typedef AllocatedObject<> ResourceAllocatedObject;
-    typedef AllocatedObject<> ScriptingAllocatedObject;
-    typedef AllocatedObject<> RenderSysAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_GENERAL> GeneralAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_GEOMETRY> GeometryAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_ANIMATION> AnimationAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_SCENE_CONTROL> SceneCtlAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_SCENE_OBJECTS> SceneObjAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_RESOURCE> ResourceAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_SCRIPTING> ScriptingAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_RENDERSYS> RenderSysAllocatedObject;
 
 
     // Per-class allocators defined here
@@ -176,9 +242,9 @@ namespace Ogre
 */
 
 /// Allocate a block of raw memory, and indicate the category of usage
-#   define OGRE_MALLOC(bytes, category) (void*)new char[bytes]
+#   define OGRE_MALLOC(bytes, category) ::Ogre::CategoryAllocator::allocateBytes(category, bytes)
 /// Allocate a block of memory for a primitive type, and indicate the category of usage
-#   define OGRE_ALLOC_T(T, count, category) (T*)new char[(count) * sizeof(T)]
+#   define OGRE_ALLOC_T(T, count, category) (T*)::Ogre::CategoryAllocator::allocateBytes(category, (count) * sizeof(T))
 /// Free the memory allocated with OGRE_MALLOC or OGRE_ALLOC_T. Category is required to be restated to ensure the matching policy is used
 #   define OGRE_FREE(ptr, category) delete[] (char*)ptr
 
@@ -0,0 +1,105 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __MemoryReport_H__
+#define __MemoryReport_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** Memory held by the subsystems of Ogre at one point in time
+
+        Gathers the counters of CategoryAllocator, the usage and budget of every ResourceManager known
+        to the ResourceGroupManager along with its largest resources, the vertex and index buffers of the
+        HardwareBufferManager including their shadow copies, and the frame arena of Root.
+
+        Textures are accounted by their size on the GPU, so shadow textures show up with the
+        TextureManager, and the shaders generated by the RTSS with the GpuProgramManager.
+    @note
+        The bytes per category only cover AllocatedObject subclasses, while the allocations per frame
+        also count OGRE_MALLOC and OGRE_ALLOC_T.
+    */
+    struct _OgreExport MemoryReport
+    {
+        struct ResourceUsage
+        {
+            String name;
+            size_t bytes;
+        };
+
+        struct ManagerUsage
+        {
+            String resourceType;
+            size_t memoryUsage;
+            size_t memoryBudget;
+            size_t numResources;
+            size_t numLoaded;
+            /// largest resources first
+            std::vector<ResourceUsage> largest;
+        };
+
+        CategoryAllocator::Stats categories[MEMCATEGORY_COUNT];
+        std::vector<ManagerUsage> managers;
+        HardwareBufferManagerBase::MemoryUsage buffers;
+        /// the most the frame arena of Root had to hold
+        size_t frameArenaPeak;
+        size_t frameArenaCapacity;
+
+        /** Collect the counters of the running instance
+            @param numLargest number of resources to list per manager
+        */
+        static MemoryReport capture(size_t numLargest = 5);
+
+        /// bytes held by live objects of all categories
+        size_t getObjectBytes() const;
+        /// allocations of all categories during the last complete frame
+        size_t getFrameAllocations() const;
+        /// memory usage of all resource managers
+        size_t getResourceBytes() const;
+
+        /// one line per entry, for the log or a debug overlay
+        String toString() const;
+
+        static const char* getCategoryName(MemoryCategory category);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
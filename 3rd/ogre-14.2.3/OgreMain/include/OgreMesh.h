@@ -445,6 +445,9 @@ namespace Ogre {
 
         /** Gets the name of any linked Skeleton */
         const String& getSkeletonName(void) const;
+
+        /// The materials of the sub meshes and the skeleton, once loaded
+        void _getDependencies(std::vector<ResourcePtr>& dependencies) override;
         /** Initialise an animation set suitable for use with this mesh. 
 
             Only recommended for use inside the engine, not by applications.
@@ -364,6 +364,27 @@ namespace Ogre {
         /** Retrieves whether all Meshes should prepare themselves for shadow volumes. */
         bool getPrepareAllMeshesForShadowVolumes(void);
 
+        /** Tells the mesh manager to write meshes back to their file after building their edge lists on loading.
+
+            Meshes prepared for shadow volumes whose file has no edge lists build them after loading, which
+            is slow for large meshes. With this enabled the mesh, edge lists included, replaces the file it
+            was loaded from, so later loads read the edge lists instead. Files in read-only archives are
+            left untouched; those meshes are stored in the archive set with setEdgeListCache, if any.
+            Disabled by default.
+        */
+        void setSaveBuiltEdgeLists(bool enable) { mSaveBuiltEdgeLists = enable; }
+        /** Retrieves whether meshes are written back after building their edge lists on loading. */
+        bool getSaveBuiltEdgeLists(void) const { return mSaveBuiltEdgeLists; }
+
+        /** Sets the archive meshes from read-only archives are saved in, see setSaveBuiltEdgeLists
+
+            As long as the mesh file is not modified, later loads read the saved mesh instead.
+        @param archive a writable archive or NULL to leave these meshes unsaved, which is the default
+        */
+        void setEdgeListCache(Archive* archive) { mEdgeListCache = archive; }
+        /// Gets the archive meshes from read-only archives are saved in
+        Archive* getEdgeListCache() const { return mEdgeListCache; }
+
         /// @copydoc Singleton::getSingleton()
         static MeshManager& getSingleton(void);
         /// @copydoc Singleton::getSingleton()
@@ -424,6 +445,8 @@ namespace Ogre {
         VertexElementType mBlendWeightsBaseElementType;
 
         bool mPrepAllMeshesForShadowVolumes;
+        bool mSaveBuiltEdgeLists;
+        Archive* mEdgeListCache;
         static bool mBonesUseObjectSpace;
     
         //the factor by which the bounding box of an entity is padded   
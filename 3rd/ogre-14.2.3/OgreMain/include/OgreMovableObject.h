@@ -275,6 +275,22 @@ namespace Ogre {
         */
         virtual void _updateRenderQueue(RenderQueue* queue) = 0;
 
+        /** Whether _notifyCurrentCamera and _updateRenderQueue may run on a worker thread.
+
+            With SceneManager::setParallelQueueingEnabled, objects that return true are updated on several
+            threads at once, so they may only change their own state and must not call listeners. The
+            renderables they add are queued on the calling thread afterwards, in the usual order.
+        */
+        virtual bool _canUpdateRenderQueueConcurrently() const { return false; }
+
+        /** Prepare the work of _updateRenderQueue that may run on a worker thread.
+
+            With SceneManager::setParallelQueueingEnabled, this is called on several threads at once for
+            the objects that cannot update the render queue concurrently, before _notifyCurrentCamera and
+            _updateRenderQueue run on the calling thread. The same restrictions apply.
+        */
+        virtual void _prepareRenderQueueUpdate() {}
+
         /** Tells this object whether to be visible or not, if it has a renderable component. 
         @note An alternative approach of making an object invisible is to detach it
             from it's SceneNode, or to remove the SceneNode entirely. 
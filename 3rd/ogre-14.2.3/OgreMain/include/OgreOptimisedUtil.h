@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreEdgeListBuilder.h"
 #include <cstddef>
+#include <functional>
 
 namespace Ogre {
 
@@ -55,6 +56,8 @@ namespace Ogre {
     protected:
         /// Store a pointer to the implementation
         static OptimisedUtil* msImplementation;
+        /// Number of elements from which kernel calls are split
+        static size_t msParallelThreshold;
 
         /// Detect best implementation based on run-time environment
         static OptimisedUtil* _detectImplementation(void);
@@ -72,6 +75,67 @@ namespace Ogre {
         */
         static OptimisedUtil* getImplementation(void) { return msImplementation; }
 
+        /// Replace the implementation used by the engine, e.g. by one of getAvailableImplementations
+        static void setImplementation(OptimisedUtil* impl) { msImplementation = impl; }
+
+        typedef std::vector<std::pair<String, OptimisedUtil*> > ImplementationList;
+
+        /** Gets the implementations that can run on this CPU, by name
+
+            The first one is the portable C++ implementation.
+        */
+        static const ImplementationList& getAvailableImplementations(void);
+
+        /// The kernels measured by benchmark
+        enum BenchmarkKernel
+        {
+            BK_SOFTWARE_VERTEX_SKINNING,
+            BK_SOFTWARE_VERTEX_MORPH,
+            BK_CONCATENATE_AFFINE_MATRICES,
+            BK_CALCULATE_FACE_NORMALS,
+            BK_CALCULATE_LIGHT_FACING,
+            BK_EXTRUDE_VERTICES,
+            BK_COUNT
+        };
+
+        /** Measure the throughput of an implementation on a synthetic mesh
+
+            The mesh is a grid of numVertices vertices with normals, skinned by 4 weights out of 64 bones,
+            and about twice as many triangles. Matrices are concatenated for one in 16 vertices.
+        @param impl The implementation to measure.
+        @param numVertices Number of vertices of the mesh.
+        @param minSeconds Each kernel is repeated for at least this long.
+        @return Elements processed per second, that is vertices, matrices, triangles or faces,
+            indexed by BenchmarkKernel.
+        */
+        static std::vector<double> benchmark(OptimisedUtil* impl, size_t numVertices, double minSeconds);
+
+        /** Select the fastest of getAvailableImplementations on this CPU
+
+            Each one is measured with benchmark on a small mesh, which takes a few milliseconds, and the one
+            taking the least time over all kernels is set as the implementation. By default the
+            implementation is chosen by the CPU features instead. As timings are noisy on a busy machine,
+            only call this where the measured choice is preferred, before Root::initialise.
+        */
+        static OptimisedUtil* _selectFastestImplementation(void);
+
+        /** Sets the number of elements from which the engine splits a kernel call into chunks
+
+            The chunks of the skinning, morphing, face normals, light facing and extrusion of large meshes
+            run on the worker threads of the Root WorkQueue and the calling thread. 0 disables the split.
+            The default is 8192 vertices or triangles.
+        */
+        static void setParallelThreshold(size_t numElements) { msParallelThreshold = numElements; }
+        /// Gets the number of elements from which a kernel call is split
+        static size_t getParallelThreshold(void) { return msParallelThreshold; }
+
+        /** Calls kernel(begin, end) for ranges covering [0, numElements)
+
+            The ranges run on the worker threads if numElements reaches getParallelThreshold, otherwise
+            kernel(0, numElements) runs on the calling thread.
+        */
+        static void _runChunked(size_t numElements, const std::function<void(size_t, size_t)>& kernel);
+
         /** Performs software vertex skinning.
         @param srcPosPtr Pointer to source position buffer.
         @param destPosPtr Pointer to destination position buffer.
@@ -111,6 +111,7 @@ namespace Ogre {
     class ExternalTextureSourceManager;
     class Factory;
     struct FrameEvent;
+    class FrameAllocator;
     class FrameListener;
     class Frustum;
     struct GpuLogicalBufferStruct;
@@ -142,6 +143,7 @@ namespace Ogre {
     class Image;
     class KeyFrame;
     class Light;
+    class LightGrid;
     class Log;
     class LogManager;
     class LodStrategy;
@@ -244,6 +246,7 @@ namespace Ogre {
     class TextureManager;
     class TransformKeyFrame;
     class Timer;
+    class TransformHierarchy;
     class UserObjectBindings;
     template <int dims, typename T> class _OgreMaybeExport Vector;
     typedef Vector<2, Real> Vector2;
@@ -260,6 +263,7 @@ namespace Ogre {
     class VertexData;
     class VertexDeclaration;
     class VertexMorphKeyFrame;
+    class VisibilityCuller;
     class WireBoundingBox;
     class WorkQueue;
     class Compositor;
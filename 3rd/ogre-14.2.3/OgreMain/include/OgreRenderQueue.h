@@ -130,6 +130,52 @@ namespace Ogre {
             virtual bool renderableQueued(Renderable* rend, uint8 groupID, 
                 ushort priority, Technique** ppTech, RenderQueue* pQueue) = 0;
         };
+
+        /// Counters of the retained sorting, see setRetainedSortingEnabled
+        struct RetainedSortStats
+        {
+            /// items that kept their place from the previous sort
+            size_t reused;
+            /// items that were not in the previous sort
+            size_t inserted;
+            /// items whose depth or pass hash changed since the previous sort
+            size_t moved;
+            /// items of the previous sort that were not queued again
+            size_t removed;
+            /// sorts that merged the changes into the previous order
+            size_t deltaSorts;
+            /// sorts that sorted all items
+            size_t fullSorts;
+            /// items sorted by the full sorts
+            size_t fullSortItems;
+
+            RetainedSortStats()
+                : reused(0), inserted(0), moved(0), removed(0), deltaSorts(0), fullSorts(0), fullSortItems(0)
+            {
+            }
+
+            RetainedSortStats& operator+=(const RetainedSortStats& rhs)
+            {
+                reused += rhs.reused;
+                inserted += rhs.inserted;
+                moved += rhs.moved;
+                removed += rhs.removed;
+                deltaSorts += rhs.deltaSorts;
+                fullSorts += rhs.fullSorts;
+                fullSortItems += rhs.fullSortItems;
+                return *this;
+            }
+        };
+
+        /// A renderable added while recording, see _setRecording
+        struct RecordedRenderable
+        {
+            Renderable* renderable;
+            uint8 groupID;
+            ushort priority;
+        };
+        typedef std::vector<RecordedRenderable> RecordedRenderableList;
+
     private:
         RenderQueueGroupMap mGroups;
         /// The current default queue group
@@ -140,8 +186,10 @@ namespace Ogre {
         bool mSplitPassesByLightingType;
         bool mSplitNoShadowPasses;
         bool mShadowCastersCannotBeReceivers;
+        bool mRetainedSorting;
 
         RenderableListener* mRenderableListener;
+        RecordedRenderableList* mRecording;
     public:
         RenderQueue();
         virtual ~RenderQueue();
@@ -275,6 +323,20 @@ namespace Ogre {
         */
         bool getShadowCastersCannotBeReceivers(void) const;
 
+        /** Sets whether the queued renderables keep their depth sorted order from one frame to the next.
+
+            Only the renderables that were added, removed or moved since the previous frame are sorted
+            again, which saves most of the sorting for mostly static scenes seen by a still camera.
+        @see QueuedRenderableCollection::setRetainedSortingEnabled
+        */
+        void setRetainedSortingEnabled(bool enabled);
+
+        /** Gets whether the queued renderables keep their depth sorted order from one frame to the next. */
+        bool getRetainedSortingEnabled(void) const { return mRetainedSorting; }
+
+        /** Gets the retained sorting counters of all groups, summed since they were created. */
+        RetainedSortStats getRetainedSortStats(void) const;
+
         /** Set a renderable listener on the queue.
 
             There can only be a single renderable listener on the queue, since
@@ -286,6 +348,16 @@ namespace Ogre {
         RenderableListener* getRenderableListener(void) const
         { return mRenderableListener; }
 
+        /** Record the renderables added to this queue instead of queueing them.
+
+            This lets objects be updated on worker threads, each with its own queue, while the
+            renderables are added to the actual queue on the calling thread. The default group and
+            priority and the shadow settings of the groups are taken from source.
+        @param source The queue the recorded renderables are meant for
+        @param list Where to record to, NULL to stop recording
+        */
+        void _setRecording(const RenderQueue* source, RecordedRenderableList* list);
+
         /** Merge render queue.
         */
         void merge( const RenderQueue* rhs );
@@ -31,6 +31,7 @@ THE SOFTWARE.
 // Precompiler options
 #include "OgrePrerequisites.h"
 #include "OgrePass.h"
+#include "OgreRenderQueue.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -156,6 +157,40 @@ namespace Ogre {
         /// Sorted descending (can iterate backwards to get ascending)
         RenderablePassList mSortedDescending;
 
+        /// Item of the retained sorting, the key orders by descending depth, then by pass hash
+        struct RetainedItem
+        {
+            uint64 key;
+            RenderablePass rp;
+            /// position in queue order
+            uint32 index;
+
+            RetainedItem(uint64 k, const RenderablePass& p, uint32 i) : key(k), rp(p), index(i) {}
+        };
+        typedef std::vector<RetainedItem> RetainedItemList;
+
+        bool mRetainedSorting;
+        /// items were added since the last sort
+        bool mQueueChanged;
+        /// camera of the last sort, NULL when there is no order to keep. Only compared.
+        const Camera* mRetainedCamera;
+        /// items of the last sort, in queue order
+        RetainedItemList mRetainedItems;
+        /// items of the last sort, in sorted order
+        RetainedItemList mRetainedSorted;
+        /// scratch space of sortRetained
+        RetainedItemList mQueuedItems;
+        RetainedItemList mMergedItems;
+        std::vector<uint32> mNewIndex;
+        std::vector<uint32> mChangedItems;
+        RenderQueue::RetainedSortStats mRetainedStats;
+
+        /// sort mSortedDescending by merging the differences into the previous order
+        void sortRetained(const Camera* cam);
+        /** Match the queued items to the retained ones, filling mNewIndex and mChangedItems. Returns false
+            when more than maxChanges items differ. */
+        bool diffRetained(size_t maxChanges, RenderQueue::RetainedSortStats& stats);
+
         /// Internal visitor implementation
         void acceptVisitorGrouped(QueuedRenderableVisitor* visitor) const;
         /// Internal visitor implementation
@@ -204,6 +239,22 @@ namespace Ogre {
         */
         void sort(const Camera* cam);
 
+        /** Keep the depth sorted order from one sort to the next.
+
+            The items queued again are matched to those of the previous sort in queue order, which does
+            not change for a static scene. Only the new items and those whose depth or pass hash changed
+            are sorted and merged into the previous order, while the items that are not queued anymore
+            are dropped from it. When the camera changes or too many items differ, everything is sorted
+            again.
+        @note
+            Items of equal depth and pass hash may end up in any order, like with the radix sort used
+            for large queues.
+        */
+        void setRetainedSortingEnabled(bool enabled);
+
+        /// Counters of the retained sorting
+        const RenderQueue::RetainedSortStats& getRetainedSortStats() const { return mRetainedStats; }
+
         /** Accept a visitor over the collection contents.
         @param visitor Visitor class which should be called back
         @param om The organisation mode which you want to iterate over.
@@ -356,6 +407,14 @@ namespace Ogre {
             mShadowCastersNotReceivers = ind;
         }
 
+        /** Sets whether the collections keep their depth sorted order from one sort to the next.
+        @see QueuedRenderableCollection::setRetainedSortingEnabled
+        */
+        void setRetainedSortingEnabled(bool enabled);
+
+        /** Adds the retained sorting counters of all collections to stats. */
+        void _addRetainedSortStats(RenderQueue::RetainedSortStats& stats) const;
+
         /** Merge group of renderables. 
         */
         void merge( const RenderPriorityGroup* rhs );
@@ -387,6 +446,8 @@ namespace Ogre {
         bool mShadowsEnabled;
         /// Bitmask of the organisation modes requested (for new priority groups)
         uint8 mOrganisationMode;
+        /// Whether the priority groups keep their sorted order
+        bool mRetainedSorting;
 
 
     public:
@@ -398,6 +459,7 @@ namespace Ogre {
             , mShadowCastersNotReceivers(shadowCastersNotReceivers)
             , mShadowsEnabled(true)
             , mOrganisationMode(0)
+            , mRetainedSorting(false)
         {
         }
 
@@ -430,6 +492,8 @@ namespace Ogre {
                     pPriorityGrp->resetOrganisationModes();
                     pPriorityGrp->addOrganisationMode((QueuedRenderableCollection::OrganisationMode)mOrganisationMode);
                 }
+                if (mRetainedSorting)
+                    pPriorityGrp->setRetainedSortingEnabled(true);
 
                 mPriorityGroups.emplace(priority, pPriorityGrp);
             }
@@ -524,6 +588,15 @@ namespace Ogre {
                 i->second->setShadowCastersCannotBeReceivers(ind);
             }
         }
+        /** Sets whether the priority groups keep their depth sorted order from one sort to the next.
+        @see QueuedRenderableCollection::setRetainedSortingEnabled
+        */
+        void setRetainedSortingEnabled(bool enabled)
+        {
+            mRetainedSorting = enabled;
+            for (const auto& pg : mPriorityGroups)
+                pg.second->setRetainedSortingEnabled(enabled);
+        }
         /** Reset the organisation modes required for the solids in this group. 
 
             You can only do this when the group is empty, ie after clearing the 
@@ -602,6 +675,8 @@ namespace Ogre {
                         pDstPriorityGrp->resetOrganisationModes();
                         pDstPriorityGrp->addOrganisationMode((QueuedRenderableCollection::OrganisationMode)mOrganisationMode);
                     }
+                    if (mRetainedSorting)
+                        pDstPriorityGrp->setRetainedSortingEnabled(true);
 
                     mPriorityGroups.emplace(priority, pDstPriorityGrp);
                 }
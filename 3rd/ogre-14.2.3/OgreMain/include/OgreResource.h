@@ -401,6 +401,13 @@ namespace Ogre {
 
         /// Gets the manager which created this resource
         ResourceManager* getCreator(void) { return mCreator; }
+
+        /** Adds the resources this one refers to, as far as they are known in its current state.
+
+            Used to prepare them ahead of loading, e.g. the textures of a material, or the materials
+            and skeleton of a loaded mesh. Called on the thread that loads the resource.
+        */
+        virtual void _getDependencies(std::vector<ResourcePtr>& dependencies) {}
         /** Get the origin of this resource, e.g. a script file name.
 
             This property will only contain something if the creator of
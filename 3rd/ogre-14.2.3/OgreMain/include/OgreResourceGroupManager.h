@@ -403,6 +403,15 @@ namespace Ogre {
 
         /// Stored current group - optimisation for when bulk loading a group
         ResourceGroup* mCurrentGroup;
+
+        bool mParallelLoading;
+
+        /** Prepare resources and the dependencies they already know on the WorkQueue
+
+            Only resources whose manager allows concurrent preparing are prepared, failures are left for
+            the calling thread to report when it prepares or loads them again.
+        */
+        void prepareConcurrently(const std::vector<ResourcePtr>& resources);
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -465,6 +474,34 @@ namespace Ogre {
         */
         void loadResourceGroup(const String& name);
 
+        /** Loads the given resources and the resources they depend on.
+
+            Resources are loaded on the calling thread in waves. Before each wave, the resources and
+            their known dependencies are prepared on the WorkQueue if parallel loading is enabled. After
+            loading, the dependencies revealed by loading, such as the materials and skeleton of a mesh,
+            make up the next wave.
+        */
+        void loadResources(const std::vector<ResourcePtr>& resources);
+
+        /** Sets whether resources are prepared on the WorkQueue before they are loaded.
+
+            When enabled, prepareResourceGroup, loadResourceGroup and loadResources first prepare the
+            resources, along with their dependencies such as the textures of materials, on the worker
+            threads. Files are read and decoded there. Only the resources whose ResourceManager allows
+            concurrent preparing are handled this way, see ResourceManager::getPrepareConcurrently. The
+            resources are then loaded on the calling thread in the usual order, which mostly leaves
+            the GPU uploads to do. The default is false.
+        @note
+            Preparing may log and fire Resource::Listener::preparingComplete on the worker threads, so
+            this requires a build where the Log and resource mutexes are not compiled out, i.e.
+            OGRE_THREAD_SUPPORT 1 or 2, and listeners that can be called from any thread. In other builds
+            enabling it logs a warning and has no effect.
+        */
+        void setParallelLoadingEnabled(bool enabled);
+
+        /// Gets whether resources are prepared on the WorkQueue before they are loaded
+        bool getParallelLoadingEnabled() const { return mParallelLoading; }
+
         /** Unloads a resource group.
 
             This method unloads all the resources that have been declared as
@@ -736,6 +773,14 @@ namespace Ogre {
 
         /** Retrieve the modification time of a given file */
         time_t resourceModifiedTime(const String& group, const String& filename) const;
+        /** Retrieve the archive a resource is read from
+        @param resourceName The name of the file
+        @param groupName The name of the group to look in
+        @param searchGroupsIfNotFound Whether to look in the other groups if the group has no such file
+        @return the archive or NULL if the file is not found
+        */
+        Archive* _getArchiveToResource(const String& resourceName, const String& groupName,
+                                       bool searchGroupsIfNotFound = true) const;
         /** List all resource locations in a resource group.
         @param groupName The name of the group
         @return A list of resource locations matching the criteria
@@ -391,6 +391,13 @@ namespace Ogre {
         /** Gets whether this manager and its resources habitually produce log output */
         bool getVerbose(void) { return mVerbose; }
 
+        /** Gets whether resources of this type can be prepared on worker threads, next to other resources
+            being prepared, see ResourceGroupManager::setParallelLoadingEnabled.
+
+            This holds when preparing reads and decodes files without creating or looking up resources.
+        */
+        bool getPrepareConcurrently(void) const { return mPrepareConcurrently; }
+
         /** Definition of a pool of resources, which users can use to reuse similar
             resources many times without destroying and recreating them.
 
@@ -472,6 +479,7 @@ namespace Ogre {
         std::atomic<size_t> mMemoryUsage; /// In bytes
 
         bool mVerbose;
+        bool mPrepareConcurrently;
 
         // IMPORTANT - all subclasses must populate the fields below
 
@@ -95,6 +95,7 @@ namespace Ogre
         std::unique_ptr<DynLibManager> mDynLibManager;
         std::unique_ptr<Timer> mTimer;
         std::unique_ptr<WorkQueue> mWorkQueue;
+        std::unique_ptr<FrameAllocator> mFrameAllocator;
         std::unique_ptr<ResourceGroupManager> mResourceGroupManager;
         std::unique_ptr<ResourceBackgroundQueue> mResourceBackgroundQueue;
         std::unique_ptr<MaterialManager> mMaterialManager;
@@ -899,6 +900,17 @@ namespace Ogre
         */
         void setWorkQueue(WorkQueue* queue);
 
+        /** Get the arena for temporaries of the current frame.
+            It is reset when the frame ends, see FrameAllocator.
+        */
+        FrameAllocator* getFrameAllocator() const { return mFrameAllocator.get(); }
+
+        /** Replace the frame arena, e.g. by one with larger blocks.
+        @param arena The new FrameAllocator instance. Root will delete it at shutdown,
+            so do not destroy it yourself.
+        */
+        void setFrameAllocator(FrameAllocator* arena);
+
         /** Sets whether blend indices information needs to be passed to the GPU.
             When entities use software animation they remove blend information such as
             indices and weights from the vertex buffers sent to the graphic card. This function
@@ -116,6 +116,8 @@ namespace Ogre {
         void reset();
         void merge(const AxisAlignedBox& boxBounds, const Sphere& sphereBounds, 
             const Camera* cam, bool receiver=true);
+        /// Merge the bounds gathered by another instance for the same camera
+        void merge(const VisibleObjectsBoundsInfo& rhs);
         /** Merge an object that is not being rendered because it's not a shadow caster, 
             but is a shadow receiver so should be included in the range.
         */
@@ -302,6 +304,21 @@ namespace Ogre {
             Real skyBoxDistance;
         };
 
+        /// Statistics about binding GPU program parameters in the current frame
+        struct GpuParamsStats
+        {
+            /// parameters bound to the render system
+            size_t uploads;
+            /// parameters not bound again, as none of their values changed since the last time
+            size_t skippedUploads;
+            /// size of the constants bound to the render system
+            size_t bytesUploaded;
+            /// size of the constants not bound again, as their values did not change
+            size_t bytesSkipped;
+
+            GpuParamsStats() : uploads(0), skippedUploads(0), bytesUploaded(0), bytesSkipped(0) {}
+        };
+
         /** Class that allows listening in on the various stages of SceneManager
             processing, so that custom behaviour can be implemented from outside.
         */
@@ -454,6 +471,13 @@ namespace Ogre {
         /// Current Viewport
         Viewport* mCurrentViewport;
 
+        /// Structure of arrays transform update, declared before the root so it outlives the nodes
+        std::unique_ptr<TransformHierarchy> mTransformHierarchy;
+        /// Frustum culling on flat arrays, declared before the root so it outlives the nodes
+        std::unique_ptr<VisibilityCuller> mVisibilityCuller;
+        /// Whether the VisibilityCuller updates the visible objects on worker threads
+        bool mParallelQueueing;
+
         /// Root scene node
         std::unique_ptr<SceneNode> mSceneRoot;
 
@@ -575,11 +599,13 @@ namespace Ogre {
             Real range;         /// Sets to zero if directional light
             Vector3 position;   /// Sets to zero if directional light
             uint32 lightMask;   /// Light mask
+            bool castShadows;   /// Whether the light casts shadows
 
             bool operator== (const LightInfo& rhs) const
             {
                 return light == rhs.light && type == rhs.type &&
-                    range == rhs.range && position == rhs.position && lightMask == rhs.lightMask;
+                    range == rhs.range && position == rhs.position && lightMask == rhs.lightMask &&
+                    castShadows == rhs.castShadows;
             }
 
             bool operator!= (const LightInfo& rhs) const
@@ -594,6 +620,8 @@ namespace Ogre {
         LightInfoList mCachedLightInfos;
         LightInfoList mTestLightInfos; // potentially new list
         ulong mLightsDirtyCounter;
+        /// spatial index of mLightsAffectingFrustum for _populateLightList
+        std::unique_ptr<LightGrid> mLightGrid;
 
         /// Simple structure to hold MovableObject map and a mutex to go with it.
         struct MovableObjectCollection
@@ -996,6 +1024,9 @@ namespace Ogre {
         uint32 mLastLightHash;
         /// Gpu params that need rebinding (mask of GpuParamVariability)
         uint16 mGpuParamsDirty;
+        /// Gpu params that need rebinding even if their values did not change, as programs were bound
+        uint16 mGpuParamsForced;
+        GpuParamsStats mGpuParamsStats;
 
         /** Render a group in the ordinary way */
         void renderBasicQueueGroupObjects(RenderQueueGroup* pGroup,
@@ -3204,6 +3235,71 @@ namespace Ogre {
         */
         bool getFlipCullingOnNegativeScale() const { return mFlipCullingOnNegativeScale; }
 
+        /** Set whether the scene graph is updated through a TransformHierarchy
+
+            Instead of recursing through SceneNode::_update, the derived transforms are kept in structure
+            of arrays storage and only the moved nodes and their descendants are recomputed.
+            This pays off for large, mostly static scenes. Off by default.
+        @note
+            Custom SceneNode types must not override Node::updateFromParentImpl while this is enabled.
+            Has no effect with OGRE_NODE_INHERIT_TRANSFORM.
+        */
+        void setTransformHierarchyEnabled(bool enabled);
+
+        /// Get whether the scene graph is updated through a TransformHierarchy
+        bool isTransformHierarchyEnabled() const { return mTransformHierarchy != nullptr; }
+
+        /// the TransformHierarchy in use or NULL
+        TransformHierarchy* _getTransformHierarchy() const { return mTransformHierarchy.get(); }
+
+        /** Set whether visibility is determined by a VisibilityCuller
+
+            Instead of testing the nodes one by one while recursing through SceneNode::_findVisibleObjects,
+            their world bounds are gathered into flat arrays and tested against the frustum with SIMD,
+            split across the WorkQueue worker threads. The render queue is filled in the same order as
+            before. This pays off for large scenes and many cameras or shadow cameras per frame, in
+            particular with setTransformHierarchyEnabled, as the gathered bounds of static scenes are
+            then reused across cameras and frames. Off by default.
+        @note
+            Overrides of Camera::isVisible are not taken into account while this is enabled.
+        */
+        void setParallelCullingEnabled(bool enabled);
+
+        /// Get whether visibility is determined by a VisibilityCuller
+        bool isParallelCullingEnabled() const { return mVisibilityCuller != nullptr; }
+
+        /// the VisibilityCuller in use or NULL
+        VisibilityCuller* _getVisibilityCuller() const { return mVisibilityCuller.get(); }
+
+        /** Set whether the visible objects are updated on the WorkQueue worker threads
+
+            With setParallelCullingEnabled, the LOD and render queue updates of the visible objects are
+            split across threads, each recording the renderables its objects add. The recordings are then
+            added to the render queue on the calling thread in the order of the scene graph, so the queue,
+            the listener calls and the visible bounds are the same as without threads. Only objects that
+            allow it with MovableObject::_canUpdateRenderQueueConcurrently are updated on worker threads,
+            the others are updated on the calling thread in their place, after MovableObject::_prepareRenderQueueUpdate
+            ran on the worker threads, which evaluates the skeletons of animated entities. Nothing runs on
+            worker threads while LOD listeners are registered. Off by default.
+        */
+        void setParallelQueueingEnabled(bool enabled) { mParallelQueueing = enabled; }
+
+        /// Get whether the visible objects are updated on the WorkQueue worker threads
+        bool isParallelQueueingEnabled() const { return mParallelQueueing; }
+
+        /** Set whether the render queue keeps its depth sorted draw lists across frames
+
+            Instead of sorting all depth sorted renderables again for every frame, the order of the
+            previous frame is kept and only the renderables that were added, removed or moved are sorted
+            and merged into it. Everything is sorted again when the camera changes or too much differs.
+            This pays off for mostly static scenes seen by a still camera. Off by default.
+        @see RenderQueue::getRetainedSortStats for how much of the order was reused
+        */
+        void setRetainedRenderQueueEnabled(bool enabled) { getRenderQueue()->setRetainedSortingEnabled(enabled); }
+
+        /// Get whether the render queue keeps its depth sorted draw lists across frames
+        bool isRetainedRenderQueueEnabled() { return getRenderQueue()->getRetainedSortingEnabled(); }
+
         /** Render something as if it came from the current queue.
         @param rend The renderable to issue to the pipeline
         @param pass The pass which is being used
@@ -3238,6 +3334,14 @@ namespace Ogre {
         */
         void _markGpuParamsDirty(uint16 mask);
 
+        /** Get how much constant data was bound to the render system in the current frame
+
+            Only the variability groups of the parameters of a pass whose auto constants changed value are bound
+            again between renderables, see GpuProgramParameters::_getChangedVariability. Parameters are always
+            bound completely after a program was bound or _markGpuParamsDirty was called.
+        */
+        const GpuParamsStats& getGpuParamsStats() const { return mGpuParamsStats; }
+
         /** Render the objects in a given queue group
         */
         void _renderQueueGroupObjects(RenderQueueGroup* group,
@@ -3291,6 +3395,9 @@ namespace Ogre {
         */
         void removeLodListener(LodListener *listener);
 
+        /// Whether any level of detail listeners are registered
+        bool hasLodListeners() const { return !mLodListeners.empty(); }
+
         /** Notify that a movable object LOD change event has occurred. */
         void _notifyMovableObjectLodChanged(MovableObjectLodChangedEvent& evt);
 
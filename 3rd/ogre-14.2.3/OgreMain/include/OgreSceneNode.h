@@ -60,6 +60,7 @@ namespace Ogre {
     class _OgreExport SceneNode : public Node
     {
         friend class SceneManager;
+        friend class TransformHierarchy;
     public:
         typedef std::vector<MovableObject*> ObjectMap;
         typedef VectorIterator<ObjectMap> ObjectIterator;
@@ -84,6 +85,9 @@ namespace Ogre {
         /// World-Axis aligned bounding box, updated only through _update
         AxisAlignedBox mWorldAABB;
 
+        /// Position in the TransformHierarchy of the creator, if it uses one
+        uint32 mTransformSlot;
+
         void updateFromParentImpl(void) const override;
 
         /** See Node */
@@ -198,6 +202,13 @@ namespace Ogre {
         */
         virtual void _updateBounds(void);
 
+        /** See Node
+
+            If the creator uses a TransformHierarchy, this only flags the node in there instead of
+            notifying the parents.
+        */
+        void needUpdate(bool forceParentUpdate = false) override;
+
         /** Internal method which locates any visible objects attached to this node and adds them to the passed in queue.
 
                 Should only be called by a SceneManager implementation, and only after the _updat method has been called to
@@ -406,6 +406,17 @@ namespace Ogre
 
         // the specific compiler instance used
         ScriptCompiler mScriptCompiler;
+
+        struct ParsedScript
+        {
+            uint32 hash;
+            std::vector<uchar> data;
+        };
+        // the serialised parse trees by script name
+        std::map<String, ParsedScript> mParsedScriptCache;
+        bool mSaveParsedScriptsToCache;
+        bool mParsedScriptCacheDirty;
+        OGRE_MUTEX(mParsedScriptCacheMutex);
     public:
         ScriptCompilerManager();
         virtual ~ScriptCompilerManager();
@@ -446,6 +457,39 @@ namespace Ogre
         /// @copydoc ScriptLoader::getLoadingOrder
         Real getLoadingOrder(void) const override;
 
+        /** Parse the script content, going through the parsed script cache
+
+            Lexing and parsing are skipped when the cache holds the parse tree of source for the same content.
+            Otherwise the content is parsed and, if enabled, the result is added to the cache.
+        */
+        ConcreteNodeListPtr _parse(const String& content, const String& source);
+
+        /** Get if the parse trees of the scripts should be saved to a cache
+        */
+        bool getSaveParsedScriptsToCache() const { return mSaveParsedScriptsToCache; }
+        /** Set if the parse trees of the scripts should be saved to a cache
+
+            Combined with saveParsedScriptCache and loadParsedScriptCache, this skips lexing and parsing of
+            unchanged scripts on the next start. The scripts are still translated.
+        */
+        void setSaveParsedScriptsToCache(bool val) { mSaveParsedScriptsToCache = val; }
+
+        /** Returns true if the parsed script cache changed during the run.
+        */
+        bool isParsedScriptCacheDirty() const { return mParsedScriptCacheDirty; }
+
+        /** Saves the parsed script cache to disk.
+        @param stream The destination stream
+        */
+        void saveParsedScriptCache(const DataStreamPtr& stream) const;
+        /** Loads the parsed script cache from disk.
+
+            The stream is read at once. Entries are matched against the content of the scripts when they are
+            parsed, so a stale cache only costs a parse. A truncated or corrupt cache is logged and dropped.
+        @param stream The source stream
+        */
+        void loadParsedScriptCache(const DataStreamPtr& stream);
+
         /// @copydoc Singleton::getSingleton()
         static ScriptCompilerManager& getSingleton(void);
         /// @copydoc Singleton::getSingleton()
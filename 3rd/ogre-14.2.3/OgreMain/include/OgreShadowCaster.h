@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreRenderable.h"
 #include "OgreRenderOperation.h"
+#include "OgreVector.h"
 #include "OgreHeaderPrefix.h"
 
 
@@ -199,6 +200,54 @@ namespace Ogre {
             size_t originalVertexCount, const Vector4& lightPos, Real extrudeDist);
         /** Get the distance to extrude for a point/spot light. */
         virtual Real getPointExtrusionDistance(const Light* l) const = 0;
+
+        /// The indexes of a shadow volume, before they are copied to the index buffer
+        struct ShadowVolume
+        {
+            /// Where the indexes of an edge group start, where its light cap starts and where it ends
+            struct GroupRange
+            {
+                size_t start;
+                size_t lightCapStart;
+                size_t end;
+            };
+
+            /// What the volume is built for
+            const Light* light = NULL;
+            const EdgeData* edgeData = NULL;
+            Vector4 lightPos = Vector4(0, 0, 0, 0);
+            unsigned long flags = 0;
+            bool useMcGuire = false;
+            /// Whether indices and groups are up to date
+            bool built = false;
+
+            std::vector<unsigned short> indices;
+            std::vector<GroupRange> groups;
+            /// Silhouette state of the edges of the group being built
+            std::vector<uchar> silhouette;
+            /// Light facing of the triangles, kept here rather than in the shared edge data
+            std::vector<char> lightFacings;
+        };
+        /// The shadow volumes of a caster, one per light
+        typedef std::vector<ShadowVolume> ShadowVolumeCache;
+
+        /** Finds the shadow volume getShadowVolumeRenderableList needs next, if it can be built ahead.
+
+            Lets the shadow renderer build the volumes of all casters of a light at the same time, see
+            _buildShadowVolume. getShadowVolumeRenderableList then only copies the indexes to the index
+            buffer. Called on the rendering thread, with the light and flags getShadowVolumeRenderableList
+            is called with next.
+        @return the volume to build. NULL if it is built already, or if the caster builds it when its
+            renderables are requested, e.g. because its geometry is animated.
+        */
+        virtual ShadowVolume* _getShadowVolumeToBuild(const Light* light, int flags) { return NULL; }
+
+        /** Builds a volume returned by _getShadowVolumeToBuild.
+
+            Only reads the edge data and writes the volume, so the volumes of several casters can be
+            built on different threads, also when they share their edge data.
+        */
+        static void _buildShadowVolume(ShadowVolume& volume);
     protected:
         /** Tells the caster to perform the tasks necessary to update the 
             edge data's light listing. Can be overridden if the subclass needs 
@@ -236,6 +285,63 @@ namespace Ogre {
         virtual void generateShadowVolume(EdgeData* edgeData, 
             const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize,
             const Light* light, ShadowRenderableList& shadowRenderables, unsigned long flags);
+
+        /** Finds the volume of the light in cache, and marks it for building if it is out of date.
+
+            A light without a volume takes over the one used least recently.
+        @param reuse
+            Whether a volume built for the same edge data, light position, flags and dark cap may be
+            kept. False when the geometry of the caster is animated.
+        */
+        ShadowVolume* findShadowVolume(const EdgeData* edgeData, const Vector4& lightPos, const Light* light,
+            unsigned long flags, ShadowVolumeCache& cache, bool reuse) const;
+
+        /** Generates the shadow volume, keeping it in a cache.
+
+            Has the effect of updateEdgeListLightFacing followed by generateShadowVolume, though the light
+            facing is kept in the volume, not in the edge data. If reuse is true and cache already holds
+            the volume of this edge data for the same light, object space light position and flags, the
+            silhouette is not computed again and the cached indexes are copied to the index buffer as they
+            are. That is also the case when the volume was built by _buildShadowVolume since.
+            Pass false when the geometry of the caster is animated.
+        @param edgeData
+            The edge information to use.
+        @param lightPos
+            4D vector representing the light in object space, a directional light has w=0.0.
+        @param indexBuffer
+            The buffer into which to write data into.
+        @param indexBufferUsedSize
+            See generateShadowVolume.
+        @param light
+            The light.
+        @param shadowRenderables
+            The shadow renderables to populate, one per edge group.
+        @param flags
+            Additional controller flags, see ShadowRenderableFlags.
+        @param cache
+            The volumes of this caster from previous calls, updated in place.
+        @param reuse
+            Whether a volume of the cache may be used without checking the geometry.
+        */
+        void updateShadowVolume(EdgeData* edgeData, const Vector4& lightPos,
+            const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize,
+            const Light* light, ShadowRenderableList& shadowRenderables, unsigned long flags,
+            ShadowVolumeCache& cache, bool reuse);
+
+        /** Builds the indexes of the shadow volume for what it is set up for, from the given light facing.
+
+            Edges are classified in parallel on large edge lists, the indexes are then emitted in
+            the order generateShadowVolume has always used.
+        */
+        static void buildShadowVolume(const char* lightFacings, ShadowVolume& volume);
+
+        /// Copies the indexes of volume to the index buffer and updates the index ranges of the renderables
+        static void writeShadowVolume(const ShadowVolume& volume,
+            const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize,
+            ShadowRenderableList& shadowRenderables);
+
+        /// Whether the dark cap can be a triangle fan over the silhouette (McGuire et al)
+        bool useMcGuireDarkCap(const EdgeData* edgeData, const Light* light) const;
         /** Utility method for extruding a bounding box. 
         @param box
             Original bounding box, will be updated in-place.
@@ -257,6 +257,14 @@ namespace Ogre {
         */
         virtual void setAnimationState(const AnimationStateSet& animSet);
 
+        /** Whether setAnimationState only reads the shared animations for animSet
+
+            True when all enabled animations were evaluated into a flat pose before, so nothing
+            is built lazily and the skeleton can be animated on a worker thread, as long as
+            nothing else touches its bones.
+        */
+        bool _canSetAnimationStateConcurrently(const AnimationStateSet& animSet) const;
+
 
         /** Initialise an animation set suitable for use with this skeleton. 
 
@@ -445,6 +453,8 @@ namespace Ogre {
         bool mManualBonesDirty;
         /// Storage of bones, indexed by bone handle
         BoneList mBoneList;
+        /// Pose the enabled animations are blended into by setAnimationState
+        SkeletonPose mPose;
 
         /** Internal method which parses the bones to derive the root bone. 
 
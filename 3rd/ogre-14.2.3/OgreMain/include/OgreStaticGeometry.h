@@ -378,6 +378,8 @@ namespace Ogre {
             Camera *mCamera;
             /// Cached squared view depth value to avoid recalculation by GeometryBucket
             Real mSquaredViewDepth;
+            /// Shadow volume indexes per light, the geometry never moves relative to the region
+            ShadowVolumeCache mShadowVolumes;
 
         public:
             Region(StaticGeometry* parent, const String& name, SceneManager* mgr, 
@@ -413,6 +415,7 @@ namespace Ogre {
             getShadowVolumeRenderableList(const Light* light, const HardwareIndexBufferPtr& indexBuffer,
                                           size_t& indexBufferUsedSize, float extrusionDistance,
                                           int flags = 0) override;
+            ShadowVolume* _getShadowVolumeToBuild(const Light* light, int flags) override;
             EdgeData* getEdgeList(void) override;
 
             void _releaseManualHardwareResources() override;
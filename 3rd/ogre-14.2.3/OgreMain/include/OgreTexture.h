@@ -512,7 +512,16 @@ namespace Ogre {
         typedef std::vector<Image> LoadedImages;
         LoadedImages mLoadedImages;
 
+        /// the mapped TextureManager cache entry mLoadedImages point into
+        DataStreamPtr mCacheEntry;
+
         void readImage(LoadedImages& imgs, const String& name, const String& ext, bool haveNPOT);
+        /// the settings a cache entry of this texture is generated with
+        uint32 getCacheOptions(bool haveNPOT) const;
+        /// read the TextureManager cache entry, returns false if there is no valid one
+        bool readCachedImage(LoadedImages& imgs, uint32 options);
+        /// generate the mipmaps and compress img as the options say, then store it in the cache
+        void writeCachedImage(Image& img, uint32 options);
         void freeInternalResources(void);
     };
     /** @} */
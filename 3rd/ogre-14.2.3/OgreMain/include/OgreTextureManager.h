@@ -400,6 +400,31 @@ namespace Ogre {
             return mDefaultNumMipmaps;
         }
 
+        /** Sets the archive decoded textures are cached in
+
+            A 2D texture read from a file is stored in the cache after decoding, together with the mipmaps
+            generated on the CPU. As long as the file is not modified, later loads read the cache entry
+            instead and upload it as it is. With FileSystemArchiveFactory::setMapFiles the entries are
+            mapped into memory rather than read.
+        @param archive a writable archive or NULL to disable the cache, which is the default
+        */
+        void setTextureCache(Archive* archive) { mTextureCache = archive; }
+        /// Gets the archive decoded textures are cached in
+        Archive* getTextureCache() const { return mTextureCache; }
+
+        /** Sets whether the texture cache stores block compressed textures
+
+            When the RenderSystem supports RSC_TEXTURE_COMPRESSION_DXT, the cached textures are encoded
+            as PF_DXT1, or PF_DXT5 if they have an alpha channel, cutting their GPU memory by 4 to 8.
+            This is lossy, so only enable it for textures that tolerate it. Only 8 bit colour formats
+            are compressed, float, 16 bit and luminance textures as well as those with gamma correction
+            or a desired format are stored uncompressed. Entries written with a different setting are
+            regenerated. The default is false.
+        */
+        void setTextureCacheCompression(bool compress) { mTextureCacheCompression = compress; }
+        /// Gets whether the texture cache stores block compressed textures
+        bool getTextureCacheCompression() const { return mTextureCacheCompression; }
+
         /// Internal method to create a warning texture (bound when a texture unit is blank)
         const TexturePtr& _getWarningTexture();
 
@@ -421,6 +446,8 @@ namespace Ogre {
         TexturePtr mWarningTexture;
         SamplerPtr mDefaultSampler;
         std::map<String, SamplerPtr> mNamedSamplers;
+        Archive* mTextureCache;
+        bool mTextureCacheCompression;
     };
 
     /// Specialisation of TextureManager for offline processing. Cannot be used with an active RenderSystem.
@@ -1004,6 +1004,9 @@ namespace Ogre {
 
         /** Internal method for preparing this object for load, as part of Material::prepare. */
         void _prepare(void);
+        /** Internal method adding the textures _prepare would prepare, with the settings of this unit
+            applied to them, as part of Material::_getDependencies. */
+        void _getDependencies(std::vector<ResourcePtr>& dependencies) const;
         /** Internal method for undoing the preparation this object as part of Material::unprepare. */
         void _unprepare(void);
         /** Internal method for loading this object as part of Material::load. */
@@ -0,0 +1,136 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __TransformHierarchy_H__
+#define __TransformHierarchy_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Structure of arrays storage for the derived transforms of a SceneNode graph
+
+        Instead of recursing through Node::_update, the nodes in the scene graph are laid out breadth first,
+        so all nodes of one depth are contiguous and the children of a node are adjacent. Local and derived
+        position, orientation and scale are kept in one array per component. As parents precede their
+        children, everything is updated in a single linear pass, four nodes at a time where SIMD is available.
+
+        Changes are tracked with one bit per node: only nodes that were moved and their descendants are
+        recomputed, while static subtrees cost nothing but scanning empty bitmap words. The results are
+        written back to the nodes, which raise the same notifications as with Node::_updateFromParent and
+        the world bounds are merged bottom up for the changed nodes and their ancestors.
+
+        The layout is rebuilt when nodes are attached or detached, which makes this a good fit for large,
+        mostly static scenes.
+    @note
+        Enable it with SceneManager::setTransformHierarchyEnabled. The nodes must not override
+        Node::updateFromParentImpl, as the derived transforms are not computed by the nodes themselves.
+        With OGRE_NODE_INHERIT_TRANSFORM the regular update is used.
+    */
+    class _OgreExport TransformHierarchy : public SceneMgtAlloc
+    {
+    public:
+        TransformHierarchy();
+        ~TransformHierarchy();
+
+        /** Update the derived transforms and world bounds of all nodes below root
+
+            Equivalent to root->_update(true, false)
+        */
+        void update(SceneNode* root);
+
+        /// flag the local transform of a node as changed. Returns false if the node is not tracked.
+        bool _markDirty(SceneNode* node);
+
+        /// the graph structure changed, rebuild the layout on the next update
+        void _notifyStructureChanged() { mStructureChanged = true; }
+
+        /// number of tracked nodes
+        size_t getNumNodes() const { return mNumNodes; }
+
+        /// number of nodes that had their derived transform recomputed by the last update
+        size_t getNumUpdatedNodes() const { return mNumUpdated; }
+
+    private:
+        typedef std::vector<uint64> Bitmap;
+
+        /** breadth first layout, so parents come before their children. Each level starts at a multiple of 4
+            and is padded with NULL nodes, so a group of 4 never spans two levels. */
+        std::vector<SceneNode*> mNodes;
+        std::vector<uint32> mParent;
+        std::vector<uint32> mFirstChild;
+        std::vector<uint32> mNumChildren;
+
+        /// local transforms, copied from the nodes when they change
+        std::vector<Real> mPosition[3];
+        std::vector<Real> mOrientation[4]; // w, x, y, z
+        std::vector<Real> mScale[3];
+        std::vector<Real> mInheritOrientation;
+        std::vector<Real> mInheritScale;
+
+        /// derived transforms
+        std::vector<Real> mDerivedPosition[3];
+        std::vector<Real> mDerivedOrientation[4];
+        std::vector<Real> mDerivedScale[3];
+
+        /// nodes that changed since the last update
+        Bitmap mDirty;
+        /// nodes to recompute this update: dirty ones and their descendants
+        Bitmap mChanged;
+        /// nodes that need their world bounds merged
+        Bitmap mBoundsDirty;
+
+        size_t mNumNodes;
+        size_t mNumUpdated;
+        bool mStructureChanged;
+
+        void rebuild(SceneNode* root);
+        /// copy the local transform of the node into slot i
+        void gather(uint32 i);
+        /// compute the derived transforms of the 4 slots starting at i from their parents
+        void updateGroup(uint32 i);
+        /// store the derived transform of slot i in the node and notify it
+        void scatter(uint32 i);
+
+        static void setBit(Bitmap& bits, uint32 i) { bits[i >> 6] |= uint64(1) << (i & 63); }
+        static bool testBit(const Bitmap& bits, uint32 i) { return (bits[i >> 6] >> (i & 63)) & 1; }
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __VisibilityCuller_H__
+#define __VisibilityCuller_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Frustum culling of a SceneNode graph on flat arrays
+
+        Instead of testing node after node while recursing through SceneNode::_findVisibleObjects, the nodes
+        are laid out depth first, so every subtree is a contiguous range, and their world bounds are copied
+        into one array per component. They are tested against the frustum planes four at a time where SIMD
+        is available, split into chunks that run on the WorkQueue worker threads next to the calling thread.
+
+        The visible nodes then feed the render queue on the calling thread, in the same order as the
+        recursive traversal, so the queue contents do not depend on the number of threads.
+
+        With SceneManager::setParallelQueueingEnabled, the visible objects that allow it are updated on the
+        worker threads too, recording the renderables they add, which are then queued on the calling thread.
+        The others get a chance to prepare there, which evaluates the skeletons of animated entities.
+
+        The layout is rebuilt when nodes are attached or detached. The bounds are copied again after each
+        scene graph update, unless a TransformHierarchy reports that nothing moved, so the cameras and
+        shadow cameras of static scenes only test the planes.
+    @note
+        Enable it with SceneManager::setParallelCullingEnabled. The frustum planes of the camera, or of its
+        culling frustum, are used directly, so overrides of Camera::isVisible are not taken into account.
+    */
+    class _OgreExport VisibilityCuller : public SceneMgtAlloc
+    {
+    public:
+        VisibilityCuller();
+        ~VisibilityCuller();
+
+        /** Add the objects of all nodes below root visible by cam to the queue
+
+            Equivalent to root->_findVisibleObjects(cam, queue, visibleBounds, true, false, onlyShadowCasters)
+        */
+        void findVisibleObjects(SceneNode* root, Camera* cam, RenderQueue* queue,
+                                VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+
+        /// the graph structure changed, rebuild the layout on the next call
+        void _notifyStructureChanged() { mStructureChanged = true; }
+
+        /// the world bounds changed, copy them again on the next call
+        void _notifyBoundsChanged() { mBoundsChanged = true; }
+
+        /// number of nodes in the layout
+        size_t getNumNodes() const { return mNodes.size(); }
+
+        /// number of nodes found visible by the last call
+        size_t getNumVisibleNodes() const { return mNumVisible; }
+
+        /// number of objects updated on worker threads by the last call
+        size_t getNumConcurrentObjects() const { return mNumConcurrent; }
+
+    private:
+        struct QueueTask;
+        /// depth first, so a subtree is a contiguous range
+        std::vector<SceneNode*> mNodes;
+        /// one past the last descendant of each node
+        std::vector<uint32> mSubtreeEnd;
+
+        /// world bounds, padded to a multiple of 4
+        std::vector<Real> mCentre[3];
+        std::vector<Real> mHalfSize[3];
+        std::vector<uchar> mNullBounds;
+
+        std::vector<uchar> mVisible;
+        /// visible nodes waiting for their descendants to be processed before the debug drawer gets them
+        std::vector<uint32> mOpenNodes;
+        /// visible nodes in order, when their objects are updated on worker threads
+        std::vector<uint32> mVisibleNodes;
+        /// per task queues and their recordings
+        std::vector<std::unique_ptr<QueueTask>> mQueueTasks;
+
+        size_t mNumVisible;
+        size_t mNumConcurrent;
+        bool mStructureChanged;
+        bool mBoundsChanged;
+
+        void rebuild(SceneNode* root);
+        /// add node and its descendants to the layout
+        void append(SceneNode* node);
+        /// copy the world bounds of the nodes [begin, end)
+        void gather(size_t begin, size_t end);
+        /// test the nodes [begin, end) against the planes, begin and end are multiples of 4
+        void cull(const Plane* planes, int numPlanes, size_t begin, size_t end);
+        /// add the objects of mVisibleNodes to the queue, updating them on worker threads
+        void queueVisibleParallel(WorkQueue* wq, Camera* cam, RenderQueue* queue,
+                                  VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
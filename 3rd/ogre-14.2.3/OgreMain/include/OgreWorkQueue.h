@@ -159,6 +159,14 @@ namespace Ogre
 
         /** Add a new task to the queue */
         virtual void addTask(std::function<void()> task) = 0;
+
+        /** Run task(0) to task(numTasks - 1) on the worker threads and the calling thread
+
+            Returns when all tasks are done. The calling thread takes part, so this completes even if the
+            workers are busy, and runs all tasks itself if the queue is paused or does not accept requests.
+            If tasks throw, the other tasks still run and the first exception is rethrown once all are done.
+        */
+        void runTasks(size_t numTasks, const std::function<void(size_t)>& task);
         
         /** Set whether to pause further processing of any requests. 
         If true, any further requests will simply be queued and not processed until
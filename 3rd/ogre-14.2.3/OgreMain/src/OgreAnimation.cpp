@@ -44,6 +44,7 @@ namespace Ogre {
         , mRotationInterpolationMode(msDefaultRotationInterpolationMode)
         , mKeyFrameTimesDirty(false)
         , mUseBaseKeyFrame(false)
+        , mFlatNodeTracksDirty(true)
         , mBaseKeyFrameTime(0.0f)
         , mBaseKeyFrameAnimationName(BLANKSTRING)
         , mContainer(0)
@@ -595,9 +596,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     TimeIndex Animation::_getTimeIndex(Real timePos) const
     {
-        // Uncomment following statement for work as previous
-        //return timePos;
-
+        uint keyIndexCursor = 0;
+        return _getTimeIndex(timePos, keyIndexCursor);
+    }
+    //---------------------------------------------------------------------
+    TimeIndex Animation::_getTimeIndex(Real timePos, uint& keyIndexCursor) const
+    {
         // Build keyframe time list on demand
         if (mKeyFrameTimesDirty)
         {
@@ -610,9 +614,24 @@ namespace Ogre {
         if( timePos > totalAnimationLength && totalAnimationLength > 0.0f )
             timePos = std::fmod( timePos, totalAnimationLength );
 
+        if (mKeyFrameTimes.empty())
+            return TimeIndex(timePos);
+
+        // Lower bound in all but the last time, try the cursor and the index after it first
+        uint last = static_cast<uint>(mKeyFrameTimes.size() - 1);
+        for (uint i = keyIndexCursor; i <= std::min(keyIndexCursor + 1, last); ++i)
+        {
+            if ((i == 0 || mKeyFrameTimes[i - 1] < timePos) && (i == last || timePos <= mKeyFrameTimes[i]))
+            {
+                keyIndexCursor = i;
+                return TimeIndex(timePos, i);
+            }
+        }
+
         // Search for global index
         auto it = std::lower_bound(mKeyFrameTimes.begin(), mKeyFrameTimes.end() - 1, timePos);
-        return TimeIndex(timePos, static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it)));
+        keyIndexCursor = static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it));
+        return TimeIndex(timePos, keyIndexCursor);
     }
     //-----------------------------------------------------------------------
     void Animation::buildKeyFrameTimeList(void) const
@@ -652,6 +671,147 @@ namespace Ogre {
         mKeyFrameTimesDirty = false;
     }
     //-----------------------------------------------------------------------
+    void Animation::buildFlatNodeTracks(void)
+    {
+        mFlatNodeTracks.clear();
+        mFlatKeyTimes.clear();
+        mFlatKeyRotations.clear();
+        mFlatKeyTranslations.clear();
+        mFlatKeyScales.clear();
+        mFlatKeyIndexMap.clear();
+
+        for (auto& i : mNodeTrackList)
+        {
+            const NodeAnimationTrack* track = i.second;
+            size_t numKeyFrames = track->getNumKeyFrames();
+            // applyToNode does nothing for those
+            if (numKeyFrames == 0)
+                continue;
+
+            mFlatNodeTracks.push_back({track, i.first, static_cast<uint>(mFlatKeyTimes.size())});
+            for (size_t k = 0; k < numKeyFrames; ++k)
+            {
+                const TransformKeyFrame* kf = track->getNodeKeyFrame(static_cast<ushort>(k));
+                mFlatKeyTimes.push_back(kf->getTime());
+                mFlatKeyRotations.push_back(kf->getRotation());
+                mFlatKeyTranslations.push_back(kf->getTranslate());
+                mFlatKeyScales.push_back(kf->getScale());
+            }
+
+            // Same mapping as AnimationTrack::_buildKeyFrameIndexMap
+            size_t firstKey = mFlatNodeTracks.back().firstKey;
+            size_t k = 0;
+            for (Real time : mKeyFrameTimes)
+            {
+                mFlatKeyIndexMap.push_back(static_cast<ushort>(k));
+                while (k < numKeyFrames - 1 && mFlatKeyTimes[firstKey + k] <= time)
+                    ++k;
+            }
+        }
+
+        mFlatNodeTracksDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    bool Animation::_prepareApplyToPose()
+    {
+        _applyBaseKeyFrame();
+
+        if (mKeyFrameTimesDirty)
+            buildKeyFrameTimeList();
+        if (mFlatNodeTracksDirty)
+            buildFlatNodeTracks();
+
+        return _canApplyToPose();
+    }
+    //-----------------------------------------------------------------------
+    bool Animation::_canApplyToPose() const
+    {
+        if (mUseBaseKeyFrame || mKeyFrameTimesDirty || mFlatNodeTracksDirty || mInterpolationMode != IM_LINEAR)
+            return false;
+
+        for (const auto& t : mFlatNodeTracks)
+        {
+            if (t.track->getListener())
+                return false;
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void Animation::_applyToPose(SkeletonPose& pose, Real timePos, uint& keyIndexCursor, Real weight,
+                                 const AnimationState::BoneBlendMask* blendMask, Real scale) const
+    {
+        TimeIndex timeIndex = _getTimeIndex(timePos, keyIndexCursor);
+        if (!timeIndex.hasKeyIndex())
+            return;
+
+        timePos = timeIndex.getTimePos();
+        size_t numBones = pose.animated.size();
+        size_t numKeyFrameTimes = mKeyFrameTimes.size();
+        bool spherical = mRotationInterpolationMode == RIM_SPHERICAL;
+
+        for (size_t t = 0; t < mFlatNodeTracks.size(); ++t)
+        {
+            const FlatNodeTrack& track = mFlatNodeTracks[t];
+            size_t b = track.handle;
+            if (b >= numBones)
+                continue;
+
+            Real w = blendMask ? (*blendMask)[b] * weight : weight;
+            if (!w)
+                continue;
+
+            // The keyframes around timePos, as AnimationTrack::getKeyFramesAtTime finds them
+            uint k2 = track.firstKey + mFlatKeyIndexMap[t * numKeyFrameTimes + timeIndex.getKeyIndex()];
+            uint k1 = k2;
+            if (k1 != track.firstKey && timePos < mFlatKeyTimes[k1])
+                --k1;
+
+            Real t1 = mFlatKeyTimes[k1], t2 = mFlatKeyTimes[k2];
+            Real u = t1 == t2 ? 0.0f : (timePos - t1) / (t2 - t1);
+            bool shortestPath = track.track->getUseShortestRotationPath();
+
+            // As NodeAnimationTrack::getInterpolatedKeyFrame with IM_LINEAR
+            Quaternion rotation = mFlatKeyRotations[k1];
+            Vector3 translate = mFlatKeyTranslations[k1];
+            Vector3 scl = mFlatKeyScales[k1];
+            if (u != 0.0f)
+            {
+                rotation = spherical
+                    ? Quaternion::Slerp(u, rotation, mFlatKeyRotations[k2], shortestPath)
+                    : Quaternion::nlerp(u, rotation, mFlatKeyRotations[k2], shortestPath);
+                translate += (mFlatKeyTranslations[k2] - translate) * u;
+                scl += (mFlatKeyScales[k2] - scl) * u;
+            }
+
+            // As NodeAnimationTrack::applyToNode
+            translate *= w * scale;
+            pose.tx[b] += translate.x;
+            pose.ty[b] += translate.y;
+            pose.tz[b] += translate.z;
+
+            rotation = spherical ? Quaternion::Slerp(w, Quaternion::IDENTITY, rotation, shortestPath)
+                                 : Quaternion::nlerp(w, Quaternion::IDENTITY, rotation, shortestPath);
+            rotation = Quaternion(pose.qw[b], pose.qx[b], pose.qy[b], pose.qz[b]) * rotation;
+            pose.qw[b] = rotation.w;
+            pose.qx[b] = rotation.x;
+            pose.qy[b] = rotation.y;
+            pose.qz[b] = rotation.z;
+
+            if (scl != Vector3::UNIT_SCALE)
+            {
+                if (scale != 1.0f)
+                    scl = Vector3::UNIT_SCALE + (scl - Vector3::UNIT_SCALE) * scale;
+                else if (w != 1.0f)
+                    scl = Vector3::UNIT_SCALE + (scl - Vector3::UNIT_SCALE) * w;
+                pose.sx[b] *= scl.x;
+                pose.sy[b] *= scl.y;
+                pose.sz[b] *= scl.z;
+            }
+
+            pose.animated[b] = 1;
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::setUseBaseKeyFrame(bool useBaseKeyFrame, Real keyframeTime, const String& baseAnimName)
     {
         if (useBaseKeyFrame != mUseBaseKeyFrame ||
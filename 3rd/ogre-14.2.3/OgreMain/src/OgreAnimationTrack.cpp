@@ -563,6 +563,8 @@ namespace Ogre {
     void NodeAnimationTrack::_keyFrameDataChanged(void) const
     {
         mSplineBuildNeeded = true;
+        if (mParent)
+            mParent->_keyFrameDataChanged();
     }
     //---------------------------------------------------------------------
     bool NodeAnimationTrack::hasNonZeroKeyFrames(void) const
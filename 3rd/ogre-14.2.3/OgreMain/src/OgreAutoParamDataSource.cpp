@@ -65,8 +65,10 @@ namespace Ogre {
          mCurrentSceneManager(0),
          mMainCamBoundsInfo(0),
          mCurrentPass(0),
+         mIdentityFlags(0),
          mDummyNode(NULL)
     {
+        memset(mChangeCount, 0, sizeof(mChangeCount));
         mBlankLight.setDiffuseColour(ColourValue::Black);
         mBlankLight.setSpecularColour(ColourValue::Black);
         mBlankLight.setAttenuation(0,1,0,0);
@@ -101,8 +103,22 @@ namespace Ogre {
         }        
     }
     //-----------------------------------------------------------------------------
+    void AutoParamDataSource::markChanged(uint16 variability)
+    {
+        for (uint16 v : {GPV_GLOBAL, GPV_PER_OBJECT, GPV_LIGHTS})
+        {
+            if (variability & v)
+                mChangeCount[v]++;
+        }
+    }
+    //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentRenderable(const Renderable* rend)
     {
+        // the view and projection matrices only depend on the renderable through these flags
+        uchar identityFlags = rend ? uchar(rend->getUseIdentityView()) | uchar(rend->getUseIdentityProjection()) << 1 : 0;
+        markChanged(identityFlags == mIdentityFlags ? GPV_PER_OBJECT : GPV_ALL);
+        mIdentityFlags = identityFlags;
+
         mCurrentRenderable = rend;
         mWorldMatrixDirty = true;
         mViewMatrixDirty = true;
@@ -127,6 +143,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentCamera(const Camera* cam, bool useCameraRelative)
     {
+        markChanged(GPV_ALL);
         mCurrentCamera = cam;
         mCameraRelativeRendering = useCameraRelative;
         mCameraRelativePosition = cam->getDerivedPosition();
@@ -146,6 +163,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentLightList(const LightList* ll)
     {
+        markChanged(GPV_LIGHTS);
         mCurrentLightList = ll;
         for(size_t i = 0; i < ll->size() && i < OGRE_MAX_SIMULTANEOUS_LIGHTS; ++i)
         {
@@ -257,17 +275,20 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setMainCamBoundsInfo(VisibleObjectsBoundsInfo* info)
     {
+        markChanged(GPV_GLOBAL);
         mMainCamBoundsInfo = info;
         mSceneDepthRangeDirty = true;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentSceneManager(const SceneManager* sm)
     {
+        markChanged(GPV_ALL);
         mCurrentSceneManager = sm;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setWorldMatrices(const Affine3* m, size_t count)
     {
+        markChanged(GPV_PER_OBJECT);
         mWorldMatrixArray = m;
         mWorldMatrixCount = count;
         mWorldMatrixDirty = false;
@@ -520,6 +541,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setAmbientLightColour(const ColourValue& ambient)
     {
+        markChanged(GPV_GLOBAL);
         mAmbientLight = ambient;
     }
     //---------------------------------------------------------------------
@@ -629,6 +651,7 @@ namespace Ogre {
         Real expDensity, Real linearStart, Real linearEnd)
     {
         (void)mode; // ignored
+        markChanged(GPV_GLOBAL);
         mFogColour = colour;
         mFogParams[0] = expDensity;
         mFogParams[1] = linearStart;
@@ -648,6 +671,7 @@ namespace Ogre {
 
     void AutoParamDataSource::setPointParameters(bool attenuation, const Vector4f& params)
     {
+        markChanged(GPV_GLOBAL);
         mPointParams = params;
         if(attenuation)
             mPointParams[0] *= getViewportHeight();
@@ -662,6 +686,7 @@ namespace Ogre {
     {
         if (index < OGRE_MAX_SIMULTANEOUS_LIGHTS)
         {
+            markChanged(GPV_ALL);
             mCurrentTextureProjector[index] = frust;
             mTextureViewProjMatrixDirty[index] = true;
             mTextureWorldViewProjMatrixDirty[index] = true;
@@ -807,6 +832,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentRenderTarget(const RenderTarget* target)
     {
+        markChanged(GPV_GLOBAL);
         mCurrentRenderTarget = target;
     }
     //-----------------------------------------------------------------------------
@@ -817,16 +843,19 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentViewport(const Viewport* viewport)
     {
+        markChanged(GPV_GLOBAL);
         mCurrentViewport = viewport;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setShadowDirLightExtrusionDistance(Real dist)
     {
+        markChanged(GPV_ALL);
         mDirLightExtrusionDistance = dist;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setShadowPointLightExtrusionDistance(Real dist)
     {
+        markChanged(GPV_ALL);
         mPointLightExtrusionDistance = dist;
     }
     //-----------------------------------------------------------------------------
@@ -79,6 +79,14 @@ namespace Ogre {
         resetToInitialState();
     }
     //---------------------------------------------------------------------
+    void Bone::_setTransform(const Vector3& position, const Quaternion& orientation, const Vector3& scale)
+    {
+        mPosition = position;
+        mOrientation = orientation;
+        mScale = scale;
+        needUpdate();
+    }
+    //---------------------------------------------------------------------
     void Bone::setManuallyControlled(bool manuallyControlled) 
     {
         mManuallyControlled = manuallyControlled;
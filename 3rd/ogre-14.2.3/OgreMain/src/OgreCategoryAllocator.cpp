@@ -0,0 +1,224 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace Ogre {
+
+    namespace {
+        const size_t POOL_GRANULARITY = 16;
+        const size_t MAX_POOLED_SIZE = 1024;
+        const size_t NUM_SIZE_CLASSES = MAX_POOLED_SIZE / POOL_GRANULARITY;
+        const size_t SLAB_SIZE = 64 * 1024;
+
+        /// blocks of one size carved out of slabs, the free ones are linked through their first bytes
+        class ObjectPool
+        {
+            std::mutex mMutex;
+            void* mFree;
+            std::vector<void*> mSlabs;
+            size_t mBlockSize;
+        public:
+            explicit ObjectPool(size_t blockSize) : mFree(NULL), mBlockSize(blockSize) {}
+
+            /// returns the number of bytes reserved, if a slab was added
+            size_t allocate(void*& ptr)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                size_t reserved = 0;
+                if (!mFree)
+                    reserved = grow();
+                ptr = mFree;
+                mFree = *static_cast<void**>(mFree);
+                return reserved;
+            }
+
+            void deallocate(void* ptr)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                *static_cast<void**>(ptr) = mFree;
+                mFree = ptr;
+            }
+
+        private:
+            size_t grow()
+            {
+                size_t count = std::max<size_t>(SLAB_SIZE / mBlockSize, 1);
+                char* slab = static_cast<char*>(AlignedMemory::allocate(count * mBlockSize, POOL_GRANULARITY));
+                mSlabs.push_back(slab);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    void* block = slab + (count - 1 - i) * mBlockSize;
+                    *static_cast<void**>(block) = mFree;
+                    mFree = block;
+                }
+                return count * mBlockSize;
+            }
+        };
+
+        struct CategoryState
+        {
+            std::atomic<size_t> liveBytes;
+            std::atomic<size_t> liveAllocations;
+            std::atomic<size_t> totalAllocations;
+            std::atomic<size_t> frameAllocations;
+            std::atomic<size_t> frameBytes;
+            std::atomic<size_t> pooledBytes;
+            size_t lastFrameAllocations;
+            size_t lastFrameBytes;
+
+            std::atomic<bool> pooled;
+            /// one pool per size class, created when pooling is first enabled
+            ObjectPool* pools;
+        };
+
+        CategoryState* getStates()
+        {
+            // never destroyed, as objects may still be released during static destruction
+            static CategoryState* states = []() {
+                CategoryState* ret = new CategoryState[MEMCATEGORY_COUNT];
+                for (int i = 0; i < MEMCATEGORY_COUNT; ++i)
+                {
+                    ret[i].liveBytes = 0;
+                    ret[i].liveAllocations = 0;
+                    ret[i].totalAllocations = 0;
+                    ret[i].frameAllocations = 0;
+                    ret[i].frameBytes = 0;
+                    ret[i].pooledBytes = 0;
+                    ret[i].lastFrameAllocations = 0;
+                    ret[i].lastFrameBytes = 0;
+                    ret[i].pooled = false;
+                    ret[i].pools = NULL;
+                }
+                return ret;
+            }();
+            return states;
+        }
+
+        size_t getSizeClass(size_t size) { return (std::max<size_t>(size, 1) - 1) / POOL_GRANULARITY; }
+
+        void countAllocation(CategoryState& state, size_t size)
+        {
+            state.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+            state.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+            state.frameBytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void* CategoryAllocator::allocate(int category, size_t size)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        CategoryState& state = getStates()[category];
+        countAllocation(state, size);
+        state.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+        state.liveBytes.fetch_add(size, std::memory_order_relaxed);
+
+        if (size > MAX_POOLED_SIZE || !state.pooled.load(std::memory_order_relaxed))
+            return ::operator new(size);
+
+        void* ptr;
+        if (size_t reserved = state.pools[getSizeClass(size)].allocate(ptr))
+            state.pooledBytes.fetch_add(reserved, std::memory_order_relaxed);
+        return ptr;
+    }
+    //-----------------------------------------------------------------------
+    void CategoryAllocator::deallocate(int category, void* ptr, size_t size)
+    {
+        if (!ptr)
+            return;
+
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        CategoryState& state = getStates()[category];
+        state.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+        state.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+
+        if (size > MAX_POOLED_SIZE || !state.pooled.load(std::memory_order_relaxed))
+            ::operator delete(ptr);
+        else
+            state.pools[getSizeClass(size)].deallocate(ptr);
+    }
+    //-----------------------------------------------------------------------
+    void* CategoryAllocator::allocateBytes(int category, size_t size)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        countAllocation(getStates()[category], size);
+        return new char[size];
+    }
+    //-----------------------------------------------------------------------
+    bool CategoryAllocator::setPoolingEnabled(MemoryCategory category, bool enabled)
+    {
+        CategoryState& state = getStates()[category];
+        if (state.pooled == enabled)
+            return true;
+
+        // the blocks of live objects must go back where they came from
+        if (state.liveAllocations.load() != 0)
+            return false;
+
+        if (enabled && !state.pools)
+        {
+            state.pools = static_cast<ObjectPool*>(::operator new(NUM_SIZE_CLASSES * sizeof(ObjectPool)));
+            for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+                new (state.pools + i) ObjectPool((i + 1) * POOL_GRANULARITY);
+        }
+        state.pooled = enabled;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    bool CategoryAllocator::isPoolingEnabled(MemoryCategory category)
+    {
+        return getStates()[category].pooled;
+    }
+    //-----------------------------------------------------------------------
+    size_t CategoryAllocator::getMaxPooledSize() { return MAX_POOLED_SIZE; }
+    //-----------------------------------------------------------------------
+    CategoryAllocator::Stats CategoryAllocator::getStats(MemoryCategory category)
+    {
+        const CategoryState& state = getStates()[category];
+        Stats ret;
+        ret.liveBytes = state.liveBytes.load(std::memory_order_relaxed);
+        ret.liveAllocations = state.liveAllocations.load(std::memory_order_relaxed);
+        ret.totalAllocations = state.totalAllocations.load(std::memory_order_relaxed);
+        ret.frameAllocations = state.lastFrameAllocations;
+        ret.frameBytes = state.lastFrameBytes;
+        ret.pooledBytes = state.pooledBytes.load(std::memory_order_relaxed);
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    void CategoryAllocator::_frameEnded()
+    {
+        CategoryState* states = getStates();
+        for (int i = 0; i < MEMCATEGORY_COUNT; ++i)
+        {
+            states[i].lastFrameAllocations = states[i].frameAllocations.exchange(0, std::memory_order_relaxed);
+            states[i].lastFrameBytes = states[i].frameBytes.exchange(0, std::memory_order_relaxed);
+        }
+    }
+}
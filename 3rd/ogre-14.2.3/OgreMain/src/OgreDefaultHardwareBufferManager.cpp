@@ -82,8 +82,13 @@ namespace Ogre {
         DefaultHardwareBufferManagerBase::createVertexBuffer(size_t vertexSize, 
         size_t numVerts, HardwareBuffer::Usage usage, bool useShadowBuffer)
     {
-        return std::make_shared<HardwareVertexBuffer>(this, vertexSize, numVerts,
-                                                      new DefaultHardwareBuffer(vertexSize * numVerts));
+        auto buf = std::make_shared<HardwareVertexBuffer>(this, vertexSize, numVerts,
+                                                          new DefaultHardwareBuffer(vertexSize * numVerts));
+        {
+            OGRE_LOCK_MUTEX(mVertexBuffersMutex);
+            mVertexBuffers.insert(buf.get());
+        }
+        return buf;
     }
     //-----------------------------------------------------------------------
     HardwareIndexBufferSharedPtr 
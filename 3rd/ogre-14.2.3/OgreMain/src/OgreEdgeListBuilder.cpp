@@ -398,11 +398,14 @@ namespace Ogre {
         // Use optimised util to determine if triangle's face normal are light facing
         if(!triangleFaceNormals.empty())
         {
-            OptimisedUtil::getImplementation()->calculateLightFacing(
-                lightPos,
-                &triangleFaceNormals.front(),
-                &triangleLightFacings.front(),
-                triangleLightFacings.size());
+            OptimisedUtil* util = OptimisedUtil::getImplementation();
+            OptimisedUtil::_runChunked(triangleLightFacings.size(), [&](size_t begin, size_t end) {
+                util->calculateLightFacing(
+                    lightPos,
+                    &triangleFaceNormals[begin],
+                    &triangleLightFacings[begin],
+                    end - begin);
+            });
         }
     }
     //---------------------------------------------------------------------
@@ -420,11 +423,14 @@ namespace Ogre {
         if (eg.triCount != 0) 
         {
             HardwareBufferLockGuard positionsLock(positionBuffer, HardwareBuffer::HBL_READ_ONLY);
-            OptimisedUtil::getImplementation()->calculateFaceNormals(
-                static_cast<float*>(positionsLock.pData),
-                &triangles[eg.triStart],
-                &triangleFaceNormals[eg.triStart],
-                eg.triCount);
+            OptimisedUtil* util = OptimisedUtil::getImplementation();
+            OptimisedUtil::_runChunked(eg.triCount, [&](size_t begin, size_t end) {
+                util->calculateFaceNormals(
+                    static_cast<float*>(positionsLock.pData),
+                    &triangles[eg.triStart + begin],
+                    &triangleFaceNormals[eg.triStart + begin],
+                    end - begin);
+            });
         }
     }
     //---------------------------------------------------------------------
@@ -213,6 +213,7 @@ namespace Ogre {
 #endif
         // Delete shadow renderables
         clearShadowRenderableList(mShadowRenderables);
+        mShadowVolumes.clear();
 
         // Detach all child objects, do this manually to avoid needUpdate() call
         // which can fail because of deleted items
@@ -562,6 +563,24 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    bool Entity::_canUpdateRenderQueueConcurrently() const
+    {
+        // anything that touches shared skeletons, buffers or other objects stays on the calling thread
+        return mInitialised && !mListener && mMesh->getStateCount() == mMeshStateCount && !hasSkeleton() &&
+               !hasVertexAnimation() && mChildObjectList.empty() && mLodEntityList.empty();
+    }
+    //-----------------------------------------------------------------------
+    void Entity::_prepareRenderQueueUpdate()
+    {
+        // the calling thread then finds the bone matrices of this frame and only skins
+        if (mInitialised && hasSkeleton() && isVisible() && !mSkipAnimStateUpdates && !sharesSkeletonInstance() &&
+            mMesh->getStateCount() == mMeshStateCount && mChildObjectList.empty() && mLodEntityList.empty() &&
+            mSkeletonInstance->_canSetAnimationStateConcurrently(*mAnimationState))
+        {
+            cacheBoneMatrices();
+        }
+    }
+    //-----------------------------------------------------------------------
     void Entity::_updateRenderQueue(RenderQueue* queue)
     {
         // Do nothing if not initialised yet
@@ -1885,15 +1904,38 @@ namespace Ogre {
             esrPositionBuffer->suppressHardwareUpdate(false);
 
         }
-        // Calc triangle light facing
-        updateEdgeListLightFacing(edgeList, lightPos);
-
-        // Generate indexes and update renderables
-        generateShadowVolume(edgeList, indexBuffer, indexBufferUsedSize, light, mShadowRenderables, flags);
+        // Calc triangle light facing and generate indexes, unless neither the light nor the
+        // geometry moved since the last volume for this light
+        updateShadowVolume(edgeList, lightPos, indexBuffer, indexBufferUsedSize, light,
+                           mShadowRenderables, flags, mShadowVolumes, !hasAnimation);
 
         return mShadowRenderables;
     }
     //-----------------------------------------------------------------------
+    ShadowCaster::ShadowVolume* Entity::_getShadowVolumeToBuild(const Light* light, int flags)
+    {
+        // animated volumes follow the blended positions, leave them to getShadowVolumeRenderableList
+        if (mMesh->getStateCount() != mMeshStateCount || hasSkeleton() || hasVertexAnimation())
+            return NULL;
+
+#if !OGRE_NO_MESHLOD
+        if (mMesh->hasManualLodLevel() && mMeshLodIndex > 0 && mLodEntityList[mMeshLodIndex - 1] != this)
+            return mLodEntityList[mMeshLodIndex - 1]->_getShadowVolumeToBuild(light, flags);
+#endif
+
+        EdgeData* edgeList = getEdgeList();
+        if (!edgeList)
+            return NULL;
+
+        // the object space light as getShadowVolumeRenderableList computes it
+        Vector4 lightPos = light->getAs4DVector();
+        Affine3 world2Obj = mParentNode->_getFullTransform().inverse();
+        lightPos = world2Obj * lightPos;
+
+        ShadowVolume* volume = findShadowVolume(edgeList, lightPos, light, flags, mShadowVolumes, true);
+        return volume->built ? NULL : volume;
+    }
+    //-----------------------------------------------------------------------
     const VertexData* Entity::findBlendedVertexData(const VertexData* orig)
     {
         bool skel = hasSkeleton();
@@ -37,6 +37,14 @@ THE SOFTWARE.
 #   include <sys/param.h>
 #endif
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE || \
+    OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS || OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
+#   include <sys/mman.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   define OGRE_FILESYSTEM_MMAP
+#endif
+
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
 #  define WIN32_LEAN_AND_MEAN
 #  if !defined(NOMINMAX) && defined(_MSC_VER)
@@ -116,6 +124,45 @@ namespace {
     };
 
     bool gIgnoreHidden = true;
+    bool gMapFiles = false;
+
+    /** A read-only file mapped into memory, so reading it costs no copy into an intermediate buffer.
+    */
+    class MappedFileDataStream : public MemoryDataStream
+    {
+        void* mMapped;
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        HANDLE mMapping;
+#endif
+    public:
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        MappedFileDataStream(const String& name, void* pMem, size_t size, HANDLE mapping)
+            : MemoryDataStream(name, pMem, size, false, true), mMapped(pMem), mMapping(mapping)
+        {
+        }
+#else
+        MappedFileDataStream(const String& name, void* pMem, size_t size)
+            : MemoryDataStream(name, pMem, size, false, true), mMapped(pMem)
+        {
+        }
+#endif
+        ~MappedFileDataStream() { close(); }
+
+        void close(void) override
+        {
+            if (mMapped)
+            {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+                UnmapViewOfFile(mMapped);
+                CloseHandle(mMapping);
+#elif defined(OGRE_FILESYSTEM_MMAP)
+                munmap(mMapped, mSize);
+#endif
+                mMapped = 0;
+            }
+            MemoryDataStream::close();
+        }
+    };
 }
 
     //-----------------------------------------------------------------------
@@ -326,6 +373,48 @@ namespace {
         // nothing to see here, move along
     }
     //-----------------------------------------------------------------------
+    /// Map the file into memory, returns null if it cannot be mapped
+    static DataStreamPtr mapFile(const String& full_path, const String& name, size_t size)
+    {
+        if (size == 0)
+            return DataStreamPtr();
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#ifdef _OGRE_FILESYSTEM_ARCHIVE_UNICODE
+        HANDLE file = CreateFileW(to_wpath(full_path).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+#else
+        HANDLE file = CreateFileA(full_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+#endif
+        if (file == INVALID_HANDLE_VALUE)
+            return DataStreamPtr();
+        // the mapping keeps the file open
+        HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        CloseHandle(file);
+        if (!mapping)
+            return DataStreamPtr();
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+        if (!data)
+        {
+            CloseHandle(mapping);
+            return DataStreamPtr();
+        }
+        return std::make_shared<MappedFileDataStream>(name, data, size, mapping);
+#elif defined(OGRE_FILESYSTEM_MMAP)
+        int fd = ::open(full_path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return DataStreamPtr();
+        // the mapping keeps the file open
+        void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+            return DataStreamPtr();
+        return std::make_shared<MappedFileDataStream>(name, data, size);
+#else
+        return DataStreamPtr();
+#endif
+    }
+    //---------------------------------------------------------------------
     DataStreamPtr FileSystemArchive::open(const String& filename, bool readOnly) const
     {
         if (!readOnly && isReadOnly())
@@ -339,8 +428,29 @@ namespace {
 
         if(!readOnly) mode |= std::ios::out;
 
-        return _openFileStream(concatenate_path(mName, filename), mode, filename);
+        String full_path = concatenate_path(mName, filename);
+        if (readOnly && gMapFiles)
+        {
+            if (DataStreamPtr stream = _mapFileStream(full_path, filename))
+                return stream;
+        }
+
+        return _openFileStream(full_path, mode, filename);
     }
+    DataStreamPtr _mapFileStream(const String& full_path, const String& name)
+    {
+#ifdef _OGRE_FILESYSTEM_ARCHIVE_UNICODE
+        struct _stat64i32 tagStat;
+        int ret = _wstat(to_wpath(full_path).c_str(), &tagStat);
+#else
+        struct stat tagStat;
+        int ret = stat(full_path.c_str(), &tagStat);
+#endif
+        if (ret != 0)
+            return DataStreamPtr();
+        return mapFile(full_path, name, tagStat.st_size);
+    }
+    //---------------------------------------------------------------------
     DataStreamPtr _openFileStream(const String& full_path, std::ios::openmode mode, const String& name)
     {
         // Use filesystem to determine size 
@@ -569,4 +679,14 @@ namespace {
     {
         return gIgnoreHidden;
     }
+
+    void FileSystemArchiveFactory::setMapFiles(bool map)
+    {
+        gMapFiles = map;
+    }
+
+    bool FileSystemArchiveFactory::getMapFiles()
+    {
+        return gMapFiles;
+    }
 }
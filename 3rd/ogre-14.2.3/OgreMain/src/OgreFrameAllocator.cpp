@@ -0,0 +1,119 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreFrameAllocator.h"
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    FrameAllocator::FrameAllocator(size_t blockSize)
+        : mCurrent(0), mOffset(0), mUsed(0), mPeak(0), mNumAllocations(0), mBlockSize(blockSize)
+    {
+    }
+    //-----------------------------------------------------------------------
+    FrameAllocator::~FrameAllocator()
+    {
+        for (auto& b : mBlocks)
+            AlignedMemory::deallocate(b.data);
+    }
+    //-----------------------------------------------------------------------
+    void* FrameAllocator::allocate(size_t size, size_t alignment)
+    {
+        assert(0 < alignment && alignment <= 128 && Bitwise::isPO2(alignment));
+        mNumAllocations++;
+
+        while (mCurrent < mBlocks.size())
+        {
+            const Block& b = mBlocks[mCurrent];
+            size_t start = (reinterpret_cast<size_t>(b.data + mOffset) + alignment - 1) & ~(alignment - 1);
+            size_t offset = start - reinterpret_cast<size_t>(b.data);
+            if (offset + size <= b.size)
+            {
+                mUsed += offset + size - mOffset;
+                mOffset = offset + size;
+                return b.data + offset;
+            }
+            // the rest of this block is lost until the next reset
+            mUsed += b.size - mOffset;
+            mCurrent++;
+            mOffset = 0;
+        }
+
+        Block b;
+        b.size = std::max(mBlockSize, size + alignment);
+        b.data = static_cast<char*>(AlignedMemory::allocate(b.size, alignment));
+        mBlocks.push_back(b);
+        mCurrent = mBlocks.size() - 1;
+        mOffset = size;
+        mUsed += size;
+        return b.data;
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocator::reset()
+    {
+        mPeak = std::max(mPeak, mUsed);
+
+        if (mBlocks.size() > 1)
+        {
+            // one block for the busiest frame, with some headroom
+            size_t size = std::max(mBlockSize, mPeak + mPeak / 4);
+            for (auto& b : mBlocks)
+                AlignedMemory::deallocate(b.data);
+            mBlocks.resize(1);
+            mBlocks[0].size = size;
+            mBlocks[0].data = static_cast<char*>(AlignedMemory::allocate(size));
+        }
+
+        mCurrent = 0;
+        mOffset = 0;
+        mUsed = 0;
+        mNumAllocations = 0;
+    }
+    //-----------------------------------------------------------------------
+    FrameAllocator::Marker FrameAllocator::getMarker() const
+    {
+        Marker ret = {mCurrent, mOffset, mUsed};
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocator::rewind(const Marker& marker)
+    {
+        mPeak = std::max(mPeak, mUsed);
+        mCurrent = marker.block;
+        mOffset = marker.offset;
+        mUsed = marker.used;
+    }
+    //-----------------------------------------------------------------------
+    size_t FrameAllocator::getCapacity() const
+    {
+        size_t ret = 0;
+        for (auto& b : mBlocks)
+            ret += b.size;
+        return ret;
+    }
+}
@@ -752,6 +752,7 @@ namespace Ogre
         , mIgnoreMissingParams(false)
         , mActivePassIterationIndex(std::numeric_limits<size_t>::max())
     {
+        resetAutoConstantTracking();
         static_assert((sizeof(AutoConstantDictionary) / sizeof(AutoConstantDefinition) - 5) == ACT_MATERIAL_LOD_INDEX,
                       "AutoConstantDictionary out of sync");
     }
@@ -780,10 +781,23 @@ namespace Ogre
         mTransposeMatrices = oth.mTransposeMatrices;
         mIgnoreMissingParams  = oth.mIgnoreMissingParams;
         mActivePassIterationIndex = oth.mActivePassIterationIndex;
+        resetAutoConstantTracking();
 
         return *this;
     }
     //---------------------------------------------------------------------
+    void GpuProgramParameters::resetAutoConstantTracking()
+    {
+        mAutoSource = 0;
+        mAutoSourcePass = 0;
+        mAutoSourcePassNumber = 0;
+        memset(mAutoChangeCount, 0, sizeof(mAutoChangeCount));
+        mAutoUpToDate = 0;
+        mChangedVariability = 0;
+        mAutoConstantSizes.clear();
+        mConstantsSizes.clear();
+    }
+    //---------------------------------------------------------------------
     void GpuProgramParameters::copySharedParamSetUsage(const GpuSharedParamUsageList& srcList)
     {
         mSharedParamSets.clear();
@@ -813,6 +827,7 @@ namespace Ogre
         const GpuNamedConstantsPtr& namedConstants)
     {
         mNamedConstants = namedConstants;
+        resetAutoConstantTracking();
 
         // Determine any extension to local buffers
 
@@ -829,6 +844,7 @@ namespace Ogre
     void GpuProgramParameters::_setLogicalIndexes(const GpuLogicalBufferStructPtr& indexMap)
     {
         mLogicalToPhysical = indexMap;
+        resetAutoConstantTracking();
 
         // resize the internal buffers
         // Note that these will only contain something after the first parameter
@@ -1219,6 +1235,7 @@ namespace Ogre
 
                 // Expand at buffer end
                 mConstants.insert(mConstants.end(), requestedSize*4, 0);
+                resetAutoConstantTracking();
 
                 // Record extended size for future GPU params re-using this information
                 mLogicalToPhysical->bufferSize = mConstants.size()/4;
@@ -1264,6 +1281,7 @@ namespace Ogre
                 auto insertPos = mConstants.begin();
                 std::advance(insertPos, physicalIndex);
                 mConstants.insert(insertPos, insertCount*4, 0);
+                resetAutoConstantTracking();
 
                 // shift all physical positions after this one
                 for (auto& p : mLogicalToPhysical->map)
@@ -1435,6 +1453,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, extraInfo, variability, elementSize));
 
         mCombinedVariability |= variability;
+        resetAutoConstantTracking();
 
 
     }
@@ -1460,6 +1479,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, rData, variability, elementSize));
 
         mCombinedVariability |= variability;
+        resetAutoConstantTracking();
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::clearAutoConstant(size_t index)
@@ -1478,6 +1498,7 @@ namespace Ogre
                 if (i->physicalIndex == physicalIndex)
                 {
                     mAutoConstants.erase(i);
+                    resetAutoConstantTracking();
                     break;
                 }
             }
@@ -1499,6 +1520,7 @@ namespace Ogre
                     if (i->physicalIndex == def->physicalIndex)
                     {
                         mAutoConstants.erase(i);
+                        resetAutoConstantTracking();
                         break;
                     }
                 }
@@ -1510,6 +1532,7 @@ namespace Ogre
     {
         mAutoConstants.clear();
         mCombinedVariability = GPV_GLOBAL;
+        resetAutoConstantTracking();
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::setAutoConstantReal(size_t index, AutoConstantType acType, float rData)
@@ -1538,12 +1561,58 @@ namespace Ogre
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::_updateAutoParams(const AutoParamDataSource* source, uint16 mask)
     {
+        mChangedVariability = 0;
         // abort early if no autos
         if (!hasAutoConstants()) return;
         // abort early if variability doesn't match any param
         if (!(mask & mCombinedVariability))
             return;
 
+        // the values written for another source, pass or pass number tell nothing
+        if (source != mAutoSource || source->getCurrentPass() != mAutoSourcePass ||
+            source->getPassNumber() != mAutoSourcePassNumber)
+        {
+            mAutoSource = source;
+            mAutoSourcePass = source->getCurrentPass();
+            mAutoSourcePassNumber = source->getPassNumber();
+            mAutoUpToDate = 0;
+        }
+
+        // only recompute the constants whose inputs changed since they were last written
+        uint16 stale = ~(GPV_GLOBAL | GPV_PER_OBJECT | GPV_LIGHTS);
+        for (uint16 v : {GPV_GLOBAL, GPV_PER_OBJECT, GPV_LIGHTS})
+        {
+            uint32 count = source->getChangeCount(GpuParamVariability(v));
+            if (!(mAutoUpToDate & v) || count != mAutoChangeCount[v])
+                stale |= v;
+            if (mask & v)
+                mAutoChangeCount[v] = count;
+        }
+        mAutoUpToDate |= mask;
+
+        if (mAutoConstantSizes.size() != mAutoConstants.size())
+        {
+            // an auto constant ends at the latest where the next one starts. Other constants are not written
+            // while updating, so including them in the comparison does not matter.
+            std::vector<size_t> starts;
+            for (const auto& ac : mAutoConstants)
+                starts.push_back(ac.physicalIndex);
+            std::sort(starts.begin(), starts.end());
+            starts.push_back(mConstants.size());
+
+            mAutoConstantSizes.clear();
+            for (const auto& ac : mAutoConstants)
+            {
+                size_t end = *std::upper_bound(starts.begin(), starts.end() - 1, ac.physicalIndex);
+                mAutoConstantSizes.push_back(uint32(std::max(end, ac.physicalIndex) - ac.physicalIndex));
+            }
+        }
+
+        // previous values of the constant being written
+        uchar previous[1024];
+        size_t size = 0;
+        size_t acIndex = 0;
+
         size_t index;
         size_t numMatrices;
         const Affine3* pMatrix;
@@ -1560,8 +1629,11 @@ namespace Ogre
         for (const auto& ac : mAutoConstants)
         {
             // Only update needed slots
-            if (ac.variability & mask)
+            if ((ac.variability & mask) && (ac.variability & stale))
             {
+                size = std::min<size_t>(mAutoConstantSizes[acIndex], mConstants.size() - ac.physicalIndex);
+                if (size <= sizeof(previous))
+                    memcpy(previous, &mConstants[ac.physicalIndex], size);
 
                 switch(ac.paramType)
                 {
@@ -2194,9 +2266,55 @@ namespace Ogre
                 default:
                     break;
                 };
+
+                if (size > sizeof(previous) || memcmp(previous, &mConstants[ac.physicalIndex], size) != 0)
+                    mChangedVariability |= ac.variability;
+            }
+            ++acIndex;
+        }
+    }
+    //---------------------------------------------------------------------------
+    size_t GpuProgramParameters::_getConstantsSize(uint16 mask) const
+    {
+        if (mConstantsSizes.empty())
+        {
+            // start, size and variability of every constant. Array elements may be listed on their own too,
+            // so the bytes covered by an earlier entry are not counted again.
+            std::vector<std::pair<size_t, std::pair<size_t, uint16>>> constants;
+            if (mNamedConstants)
+            {
+                for (const auto& p : mNamedConstants->map)
+                {
+                    const GpuConstantDefinition& def = p.second;
+                    if (!def.isSampler())
+                        constants.push_back({def.physicalIndex, {def.elementSize * def.arraySize *
+                                                                 (def.isDouble() ? 8 : 4), def.variability}});
+                }
+            }
+            else if (mLogicalToPhysical)
+            {
+                for (const auto& p : mLogicalToPhysical->map)
+                    constants.push_back({p.second.physicalIndex, {p.second.currentSize * 4, p.second.variability}});
+            }
+            std::sort(constants.begin(), constants.end());
+
+            mConstantsSizes.resize(16);
+            for (size_t m = 0; m < mConstantsSizes.size(); m++)
+            {
+                size_t covered = 0;
+                for (const auto& c : constants)
+                {
+                    size_t end = c.first + c.second.first;
+                    if ((c.second.second & m) && end > covered)
+                    {
+                        mConstantsSizes[m] += uint32(end - std::max(c.first, covered));
+                        covered = end;
+                    }
+                }
             }
         }
 
+        return mConstantsSizes[mask & 15];
     }
     //---------------------------------------------------------------------------
     static size_t withArrayOffset(const GpuConstantDefinition* def, const String& name)
@@ -2451,12 +2569,14 @@ namespace Ogre
         mAutoConstants = source.getAutoConstantList();
         mCombinedVariability = source.mCombinedVariability;
         copySharedParamSetUsage(source.mSharedParamSets);
+        resetAutoConstantTracking();
     }
     //---------------------------------------------------------------------
     void GpuProgramParameters::copyMatchingNamedConstantsFrom(const GpuProgramParameters& source)
     {
         if (mNamedConstants && source.mNamedConstants)
         {
+            resetAutoConstantTracking();
             std::map<size_t, String> srcToDestNamedMap;
             for (auto& m : source.mNamedConstants->map)
             {
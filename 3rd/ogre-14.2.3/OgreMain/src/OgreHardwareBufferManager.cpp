@@ -368,6 +368,52 @@ namespace Ogre {
             _forceReleaseBufferCopies(buf);
         }
     }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::_notifyIndexBufferCreated(HardwareIndexBuffer* buf)
+    {
+        OGRE_LOCK_MUTEX(mIndexBuffersMutex);
+        mIndexBuffers.insert(buf);
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::_notifyIndexBufferDestroyed(HardwareIndexBuffer* buf)
+    {
+        OGRE_LOCK_MUTEX(mIndexBuffersMutex);
+        mIndexBuffers.erase(buf);
+    }
+    //-----------------------------------------------------------------------
+    HardwareBufferManagerBase::MemoryUsage HardwareBufferManagerBase::getMemoryUsage() const
+    {
+        MemoryUsage ret = {};
+        {
+            OGRE_LOCK_MUTEX(mVertexBuffersMutex);
+            ret.numVertexBuffers = mVertexBuffers.size();
+            for (auto *b : mVertexBuffers)
+            {
+                ret.vertexBytes += b->getSizeInBytes();
+                if (b->hasShadowBuffer())
+                    ret.shadowBytes += b->getSizeInBytes();
+            }
+        }
+        {
+            OGRE_LOCK_MUTEX(mIndexBuffersMutex);
+            ret.numIndexBuffers = mIndexBuffers.size();
+            for (auto *b : mIndexBuffers)
+            {
+                ret.indexBytes += b->getSizeInBytes();
+                if (b->hasShadowBuffer())
+                    ret.shadowBytes += b->getSizeInBytes();
+            }
+        }
+        {
+            OGRE_LOCK_MUTEX(mTempBuffersMutex);
+            for (auto& f : mFreeTempVertexBufferMap)
+                ret.tempCopyBytes += f.second->getSizeInBytes();
+            for (auto& l : mTempVertexBufferLicenses)
+                ret.tempCopyBytes += l.second.buffer->getSizeInBytes();
+        }
+        return ret;
+    }
+    //-----------------------------------------------------------------------
     RenderToVertexBufferSharedPtr HardwareBufferManagerBase::createRenderToVertexBuffer()
     {
         OGRE_EXCEPT(Exception::ERR_RENDERINGAPI_ERROR, "not supported by RenderSystem");
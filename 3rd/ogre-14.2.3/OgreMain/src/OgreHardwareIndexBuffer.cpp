@@ -59,6 +59,11 @@ namespace Ogre {
         {
             mShadowBuffer = std::make_unique<DefaultHardwareBuffer>(mSizeInBytes);
         }
+
+        if (mMgr)
+        {
+            mMgr->_notifyIndexBufferCreated(this);
+        }
     }
 
     HardwareIndexBuffer::HardwareIndexBuffer(HardwareBufferManagerBase* mgr, IndexType idxType,
@@ -71,6 +76,10 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     HardwareIndexBuffer::~HardwareIndexBuffer()
     {
+        if (mMgr)
+        {
+            mMgr->_notifyIndexBufferDestroyed(this);
+        }
     }
 
 }
@@ -28,7 +28,10 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreImage.h"
 #include "OgreImageCodec.h"
+#include "OgrePlatformInformation.h"
+#include "OgreOptimisedUtil.h"
 #include "OgreImageResampler.h"
+#include "OgreImageBlockEncoder.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------------
@@ -377,6 +380,87 @@ namespace Ogre {
         // scale the image from temp into our resized buffer
         Image::scale(temp.getPixelBox(), getPixelBox(), filter);
     }
+    //-----------------------------------------------------------------------------
+    // the box filter for halvings, as linear filtering is equivalent then
+    template<typename T, unsigned int channels> static void scaleBilinear(const PixelBox& src, const PixelBox& dst)
+    {
+        if (BoxResampler<T, channels>::canScale(src, dst))
+            BoxResampler<T, channels>::scale(src, dst);
+        else
+            LinearResampler_Byte<channels>::scale(src, dst);
+    }
+    //-----------------------------------------------------------------------------
+    void Image::generateMipmaps(Filter filter)
+    {
+        OgreAssert(mBuffer, "No image data loaded");
+        OgreAssert(!PixelUtil::isCompressed(mFormat), "compressed formats not supported");
+
+        // see ARB_texture_non_power_of_two
+        uint32 numMipmaps = Bitwise::mostSignificantBitSet(std::max(mWidth, std::max(mHeight, mDepth)));
+        uint32 numFaces = getNumFaces();
+
+        if (mNumMipmaps != numMipmaps)
+        {
+            // reassign buffer to temp image, it keeps the top levels
+            Image temp;
+            temp.loadDynamicImage(mBuffer, mWidth, mHeight, mDepth, mFormat, mAutoDelete, numFaces, mNumMipmaps);
+
+            // do not delete[] mBuffer!  temp owns it
+            mBuffer = 0;
+            create(mFormat, mWidth, mHeight, mDepth, numFaces, numMipmaps);
+
+            for (uint32 face = 0; face < numFaces; face++)
+                PixelUtil::bulkPixelConversion(temp.getPixelBox(face, 0), getPixelBox(face, 0));
+        }
+
+        if (filter == FILTER_NEAREST)
+            filter = FILTER_BILINEAR;
+
+        // each level depends on the one above, the rows of a level are split over the worker threads
+        for (uint32 mip = 1; mip <= numMipmaps; mip++)
+        {
+            for (uint32 face = 0; face < numFaces; face++)
+                scale(getPixelBox(face, mip - 1), getPixelBox(face, mip), filter);
+        }
+    }
+    //-----------------------------------------------------------------------------
+    void Image::compress(PixelFormat format)
+    {
+        OgreAssert(mBuffer, "No image data loaded");
+        OgreAssert(format == PF_DXT1 || format == PF_DXT5, "only PF_DXT1 and PF_DXT5 are supported");
+        OgreAssert(!PixelUtil::isCompressed(mFormat), "image is compressed already");
+
+        uint32 numFaces = getNumFaces();
+        Image dst;
+        dst.create(format, mWidth, mHeight, mDepth, numFaces, mNumMipmaps);
+
+        for (uint32 face = 0; face < numFaces; face++)
+        {
+            for (uint32 mip = 0; mip <= mNumMipmaps; mip++)
+            {
+                PixelBox src = getPixelBox(face, mip);
+                Image rgba;
+                if (mFormat != PF_BYTE_RGBA)
+                {
+                    rgba.create(PF_BYTE_RGBA, src.getWidth(), src.getHeight(), src.getDepth());
+                    PixelUtil::bulkPixelConversion(src, rgba.getPixelBox());
+                    src = rgba.getPixelBox();
+                }
+
+                uchar* blocks = dst.getPixelBox(face, mip).data;
+                size_t sliceSize = PixelUtil::getMemorySize(src.getWidth(), src.getHeight(), 1, format);
+                for (uint32 z = 0; z < src.getDepth(); z++)
+                {
+                    encodeBlocks(src.getSubVolume(Box(0, 0, z, src.getWidth(), src.getHeight(), z + 1)),
+                                 blocks + z * sliceSize, format);
+                }
+            }
+        }
+
+        // take over the buffer of dst
+        loadDynamicImage(dst.mBuffer, mWidth, mHeight, mDepth, format, true, numFaces, mNumMipmaps);
+        dst.mAutoDelete = false;
+    }
     //-----------------------------------------------------------------------
     void Image::scale(const PixelBox &src, const PixelBox &scaled, Filter filter) 
     {
@@ -434,10 +518,10 @@ namespace Ogre {
                 // super-optimized: byte-oriented math, no conversion
                 switch (PixelUtil::getNumElemBytes(src.format)) 
                 {
-                case 1: LinearResampler_Byte<1>::scale(src, temp); break;
-                case 2: LinearResampler_Byte<2>::scale(src, temp); break;
-                case 3: LinearResampler_Byte<3>::scale(src, temp); break;
-                case 4: LinearResampler_Byte<4>::scale(src, temp); break;
+                case 1: scaleBilinear<uchar, 1>(src, temp); break;
+                case 2: scaleBilinear<uchar, 2>(src, temp); break;
+                case 3: scaleBilinear<uchar, 3>(src, temp); break;
+                case 4: scaleBilinear<uchar, 4>(src, temp); break;
                 default:
                     // never reached
                     assert(false);
@@ -448,8 +532,24 @@ namespace Ogre {
                     PixelUtil::bulkPixelConversion(temp, scaled);
                 }
                 break;
+            case PF_FLOAT32_R:
+            case PF_FLOAT32_GR:
+                if (src.format == scaled.format && BoxResampler<float, 1>::canScale(src, scaled))
+                {
+                    PixelUtil::getComponentCount(src.format) == 1 ? BoxResampler<float, 1>::scale(src, scaled)
+                                                                  : BoxResampler<float, 2>::scale(src, scaled);
+                    break;
+                }
+                LinearResampler::scale(src, scaled);
+                break;
             case PF_FLOAT32_RGB:
             case PF_FLOAT32_RGBA:
+                if (src.format == scaled.format && BoxResampler<float, 1>::canScale(src, scaled))
+                {
+                    src.format == PF_FLOAT32_RGB ? BoxResampler<float, 3>::scale(src, scaled)
+                                                 : BoxResampler<float, 4>::scale(src, scaled);
+                    break;
+                }
                 if (scaled.format == PF_FLOAT32_RGB || scaled.format == PF_FLOAT32_RGBA)
                 {
                     // float32 to float32, avoid unpack/repack overhead
@@ -462,6 +562,66 @@ namespace Ogre {
                 LinearResampler::scale(src, scaled);
             }
             break;
+
+        case FILTER_BICUBIC:
+            if (src.getDepth() != scaled.getDepth())
+            {
+                // the cubic filter is 2D only
+                LinearResampler::scale(src, scaled);
+                break;
+            }
+            switch (src.format)
+            {
+            case PF_L8: case PF_R8: case PF_A8: case PF_BYTE_LA:
+            case PF_R8G8B8: case PF_B8G8R8:
+            case PF_R8G8B8A8: case PF_B8G8R8A8:
+            case PF_A8B8G8R8: case PF_A8R8G8B8:
+            case PF_X8B8G8R8: case PF_X8R8G8B8:
+            case PF_FLOAT32_R: case PF_FLOAT32_GR:
+            case PF_FLOAT32_RGB: case PF_FLOAT32_RGBA:
+                if(src.format != scaled.format)
+                {
+                    // Allocate temp buffer of destination size in source format
+                    buf.create(src.format, scaled.getWidth(), scaled.getHeight(), scaled.getDepth());
+                    temp = buf.getPixelBox();
+                }
+                if (PixelUtil::isFloatingPoint(src.format))
+                {
+                    switch (PixelUtil::getComponentCount(src.format))
+                    {
+                    case 1: CubicResampler<float, 1>::scale(src, temp); break;
+                    case 2: CubicResampler<float, 2>::scale(src, temp); break;
+                    case 3: CubicResampler<float, 3>::scale(src, temp); break;
+                    case 4: CubicResampler<float, 4>::scale(src, temp); break;
+                    }
+                }
+                else
+                {
+                    switch (PixelUtil::getNumElemBytes(src.format))
+                    {
+                    case 1: CubicResampler<uchar, 1>::scale(src, temp); break;
+                    case 2: CubicResampler<uchar, 2>::scale(src, temp); break;
+                    case 3: CubicResampler<uchar, 3>::scale(src, temp); break;
+                    case 4: CubicResampler<uchar, 4>::scale(src, temp); break;
+                    }
+                }
+                if(temp.data != scaled.data)
+                {
+                    // Blit temp buffer
+                    PixelUtil::bulkPixelConversion(temp, scaled);
+                }
+                break;
+            default:
+                {
+                    // filter in float, with conversions on both sides
+                    Image srcf(PF_FLOAT32_RGBA, src.getWidth(), src.getHeight(), src.getDepth());
+                    Image dstf(PF_FLOAT32_RGBA, scaled.getWidth(), scaled.getHeight(), scaled.getDepth());
+                    PixelUtil::bulkPixelConversion(src, srcf.getPixelBox());
+                    CubicResampler<float, 4>::scale(srcf.getPixelBox(), dstf.getPixelBox());
+                    PixelUtil::bulkPixelConversion(dstf.getPixelBox(), scaled);
+                }
+            }
+            break;
         }
     }
 
@@ -0,0 +1,238 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef OGREIMAGEBLOCKENCODER_H
+#define OGREIMAGEBLOCKENCODER_H
+
+#include <climits>
+
+// this file is inlined into OgreImage.cpp!
+// do not include anywhere else.
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+
+// BC1 (DXT1) and BC3 (DXT5) encoding of PF_BYTE_RGBA pixels, fitting the colour endpoints to the
+// range of the block along its principal axis
+
+inline uint16 packRGB565(const float* c)
+{
+    int r = Math::Clamp(int(c[0] * (31 / 255.0f) + 0.5f), 0, 31);
+    int g = Math::Clamp(int(c[1] * (63 / 255.0f) + 0.5f), 0, 63);
+    int b = Math::Clamp(int(c[2] * (31 / 255.0f) + 0.5f), 0, 31);
+    return uint16((r << 11) | (g << 5) | b);
+}
+
+inline void unpackRGB565(uint16 v, int* c)
+{
+    int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    c[0] = (r << 3) | (r >> 2);
+    c[1] = (g << 2) | (g >> 4);
+    c[2] = (b << 3) | (b >> 2);
+}
+
+inline void storeLE(uchar* dst, uint64 v, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        dst[i] = uchar(v >> (8 * i));
+}
+
+/// encode the colours of 16 texels as 4 colour block of 8 bytes
+inline void encodeBC1Block(const uchar* texels, uchar* block)
+{
+    float mean[3] = {0, 0, 0};
+    for (int i = 0; i < 16; i++)
+        for (int c = 0; c < 3; c++)
+            mean[c] += texels[4 * i + c] / 16.0f;
+
+    // covariance xx, xy, xz, yy, yz, zz
+    float cov[6] = {0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < 16; i++)
+    {
+        float d[3] = {texels[4 * i] - mean[0], texels[4 * i + 1] - mean[1], texels[4 * i + 2] - mean[2]};
+        cov[0] += d[0] * d[0];
+        cov[1] += d[0] * d[1];
+        cov[2] += d[0] * d[2];
+        cov[3] += d[1] * d[1];
+        cov[4] += d[1] * d[2];
+        cov[5] += d[2] * d[2];
+    }
+
+    // principal axis by power iteration, starting from the row of the largest variance, as a fixed
+    // start like the grey axis can be orthogonal to it
+    static const int rows[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+    int start = cov[0] >= cov[3] && cov[0] >= cov[5] ? 0 : (cov[3] >= cov[5] ? 1 : 2);
+    float axis[3] = {cov[rows[start][0]], cov[rows[start][1]], cov[rows[start][2]]};
+    for (int iter = 0; iter < 8; iter++)
+    {
+        float next[3];
+        for (int c = 0; c < 3; c++)
+            next[c] = cov[rows[c][0]] * axis[0] + cov[rows[c][1]] * axis[1] + cov[rows[c][2]] * axis[2];
+        float len = std::max(std::abs(next[0]), std::max(std::abs(next[1]), std::abs(next[2])));
+        if (len == 0)
+            break;
+        for (int c = 0; c < 3; c++)
+            axis[c] = next[c] / len;
+    }
+    float len2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+
+    // the extent of the texels along it
+    float tmin = 0, tmax = 0;
+    for (int i = 0; i < 16 && len2 > 0; i++)
+    {
+        float t = ((texels[4 * i] - mean[0]) * axis[0] + (texels[4 * i + 1] - mean[1]) * axis[1] +
+                   (texels[4 * i + 2] - mean[2]) * axis[2]) / len2;
+        tmin = std::min(tmin, t);
+        tmax = std::max(tmax, t);
+    }
+
+    float e0[3], e1[3];
+    for (int c = 0; c < 3; c++)
+    {
+        e0[c] = mean[c] + axis[c] * tmax;
+        e1[c] = mean[c] + axis[c] * tmin;
+    }
+    uint16 c0 = packRGB565(e0);
+    uint16 c1 = packRGB565(e1);
+    // c0 > c1 selects the 4 colour mode
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    uint32 indices = 0;
+    if (c0 != c1)
+    {
+        int pal[4][3];
+        unpackRGB565(c0, pal[0]);
+        unpackRGB565(c1, pal[1]);
+        for (int c = 0; c < 3; c++)
+        {
+            pal[2][c] = (2 * pal[0][c] + pal[1][c]) / 3;
+            pal[3][c] = (pal[0][c] + 2 * pal[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0, bestDist = INT_MAX;
+            for (int p = 0; p < 4; p++)
+            {
+                int dr = texels[4 * i] - pal[p][0], dg = texels[4 * i + 1] - pal[p][1],
+                    db = texels[4 * i + 2] - pal[p][2];
+                int dist = dr * dr + dg * dg + db * db;
+                if (dist < bestDist)
+                {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= uint32(best) << (2 * i);
+        }
+    }
+
+    storeLE(block, c0, 2);
+    storeLE(block + 2, c1, 2);
+    storeLE(block + 4, indices, 4);
+}
+
+/// encode the alpha of 16 texels as 8 alpha block of 8 bytes
+inline void encodeBC3AlphaBlock(const uchar* texels, uchar* block)
+{
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; i++)
+    {
+        a0 = std::max<int>(a0, texels[4 * i + 3]);
+        a1 = std::min<int>(a1, texels[4 * i + 3]);
+    }
+
+    uint64 indices = 0;
+    if (a0 != a1)
+    {
+        // a0 > a1 selects the 8 alpha mode
+        int pal[8] = {a0, a1};
+        for (int p = 2; p < 8; p++)
+            pal[p] = ((8 - p) * a0 + (p - 1) * a1) / 7;
+
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0, bestDist = INT_MAX;
+            for (int p = 0; p < 8; p++)
+            {
+                int dist = std::abs(texels[4 * i + 3] - pal[p]);
+                if (dist < bestDist)
+                {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= uint64(best) << (3 * i);
+        }
+    }
+
+    block[0] = uchar(a0);
+    block[1] = uchar(a1);
+    storeLE(block + 2, indices, 6);
+}
+
+/// encode a PF_BYTE_RGBA slice to the blocks of format, which is PF_DXT1 or PF_DXT5
+inline void encodeBlocks(const PixelBox& src, uchar* dst, PixelFormat format)
+{
+    uint32 width = src.getWidth(), height = src.getHeight();
+    uint32 blocksX = (width + 3) / 4;
+    size_t blockSize = format == PF_DXT1 ? 8 : 16;
+
+    OptimisedUtil::_runChunked(size_t(blocksX) * ((height + 3) / 4), [&](size_t begin, size_t end) {
+        uchar texels[64];
+        for (size_t b = begin; b < end; b++)
+        {
+            uint32 bx = uint32(b % blocksX) * 4, by = uint32(b / blocksX) * 4;
+            // the partial blocks at the right and bottom edge repeat the last texel
+            for (uint32 y = 0; y < 4; y++)
+            {
+                const uchar* row = src.data + 4 * std::min(by + y, height - 1) * src.rowPitch;
+                for (uint32 x = 0; x < 4; x++)
+                    memcpy(texels + 4 * (4 * y + x), row + 4 * std::min(bx + x, width - 1), 4);
+            }
+
+            uchar* block = dst + b * blockSize;
+            if (format == PF_DXT5)
+            {
+                encodeBC3AlphaBlock(texels, block);
+                block += 8;
+            }
+            encodeBC1Block(texels, block);
+        }
+    });
+}
+    /** @} */
+    /** @} */
+
+}
+
+#endif
@@ -29,6 +29,15 @@ THE SOFTWARE.
 #define OGREIMAGERESAMPLER_H
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
+
+#if __OGRE_HAVE_SSE && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define __OGRE_RESAMPLER_SSE2 1
+#   include <emmintrin.h>
+#elif __OGRE_HAVE_NEON
+#   include <arm_neon.h>
+#endif
 
 // this file is inlined into OgreImage.cpp!
 // do not include anywhere else.
@@ -40,6 +49,20 @@ namespace Ogre {
     *  @{
     */
 
+// calls kernel(begin, end) for ranges of rows covering [0, height), split over the
+// worker threads when height * width reaches OptimisedUtil::getParallelThreshold
+inline void forEachRowRange(size_t height, size_t width, const std::function<void(size_t, size_t)>& kernel)
+{
+    width = std::max<size_t>(width, 1);
+    OptimisedUtil::_runChunked(height * width, [&kernel, width](size_t begin, size_t end) {
+        // the rows that start in [begin, end)
+        size_t rowBegin = (begin + width - 1) / width;
+        size_t rowEnd = (end + width - 1) / width;
+        if (rowBegin < rowEnd)
+            kernel(rowBegin, rowEnd);
+    });
+}
+
 // variable name hints:
 // sx_48 = 16/48-bit fixed-point x-position in source
 // stepx = difference between adjacent sx_48 values
@@ -292,15 +315,18 @@ template<unsigned int channels> struct LinearResampler_Byte {
 
         // srcdata stays at beginning of slice, pdst is a moving pointer
         uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        uchar* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
 
         // sx_48,sy_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
         uint64 stepx = ((uint64)src.getWidth() << 48) / dst.getWidth();
         uint64 stepy = ((uint64)src.getHeight() << 48) / dst.getHeight();
-        
-        uint64 sy_48 = (stepy >> 1) - 1;
-        for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+
+        // rows are independent, large images are split over the worker threads
+        forEachRowRange(dst.getHeight(), dst.getWidth(), [&](size_t begin, size_t end) {
+        uchar* pdst = dstdata + begin * dst.rowPitch * channels;
+        uint64 sy_48 = (stepy >> 1) - 1 + begin * stepy;
+        for (size_t y = begin; y < end; y++, sy_48+=stepy) {
             // bottom 28 bits of temp are 16/12 bit fixed precision, used to
             // adjust a source coordinate backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -335,6 +361,170 @@ template<unsigned int channels> struct LinearResampler_Byte {
             }
             pdst += channels*dst.getRowSkip();
         }
+        });
+    }
+};
+
+
+inline uchar boxAverage(uchar a, uchar b, uchar c, uchar d) { return uchar((a + b + c + d + 2) >> 2); }
+inline float boxAverage(float a, float b, float c, float d) { return (a + b + c + d) * 0.25f; }
+
+// box filter halving width and height, as for mipmaps, where it is equivalent
+// to the linear resamplers. does not convert formats.
+// templated on channel type and count, so the row loops vectorise
+template<typename T, unsigned int channels> struct BoxResampler {
+    static bool canScale(const PixelBox& src, const PixelBox& dst) {
+        return src.getDepth() == 1 && dst.getDepth() == 1 && src.getWidth() == 2 * dst.getWidth() &&
+               src.getHeight() == 2 * dst.getHeight();
+    }
+
+    // SIMD kernel for the row start, returns the number of pixels done
+    static size_t halveRow(const T*, const T*, T*, size_t) { return 0; }
+
+    static void scale(const PixelBox& src, const PixelBox& dst) {
+        const T* srcdata = (const T*)src.getTopLeftFrontPixelPtr();
+        T* dstdata = (T*)dst.getTopLeftFrontPixelPtr();
+        size_t width = dst.getWidth();
+
+        forEachRowRange(dst.getHeight(), width, [&](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; y++) {
+                const T* s0 = srcdata + 2 * y * src.rowPitch * channels;
+                const T* s1 = s0 + src.rowPitch * channels;
+                T* d = dstdata + y * dst.rowPitch * channels;
+
+                for (size_t x = halveRow(s0, s1, d, width); x < width; x++) {
+                    for (unsigned int k = 0; k < channels; k++) {
+                        d[x * channels + k] = boxAverage(s0[2 * x * channels + k], s0[(2 * x + 1) * channels + k],
+                                                         s1[2 * x * channels + k], s1[(2 * x + 1) * channels + k]);
+                    }
+                }
+            }
+        });
+    }
+};
+
+#ifdef __OGRE_RESAMPLER_SSE2
+// 4 destination pixels of 4 bytes per iteration
+template<> inline size_t BoxResampler<uchar, 4>::halveRow(const uchar* s0, const uchar* s1, uchar* d, size_t width) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    size_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i q[2];
+        for (int i = 0; i < 2; i++) {
+            __m128i r0 = _mm_loadu_si128((const __m128i*)(s0 + 8 * x + 16 * i));
+            __m128i r1 = _mm_loadu_si128((const __m128i*)(s1 + 8 * x + 16 * i));
+            // vertical sums of 2 pixel pairs as 16 bit
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+            // horizontal sums of each pair in the low 64 bits
+            lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+            hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+            q[i] = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+        }
+        _mm_storeu_si128((__m128i*)(d + 4 * x), _mm_packus_epi16(q[0], q[1]));
+    }
+    return x;
+}
+#elif __OGRE_HAVE_NEON
+// 4 destination pixels of 4 bytes per iteration
+template<> inline size_t BoxResampler<uchar, 4>::halveRow(const uchar* s0, const uchar* s1, uchar* d, size_t width) {
+    size_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        // even and odd pixels
+        uint32x4x2_t r0 = vld2q_u32((const uint32_t*)(s0 + 8 * x));
+        uint32x4x2_t r1 = vld2q_u32((const uint32_t*)(s1 + 8 * x));
+        uint8x16_t e0 = vreinterpretq_u8_u32(r0.val[0]), o0 = vreinterpretq_u8_u32(r0.val[1]);
+        uint8x16_t e1 = vreinterpretq_u8_u32(r1.val[0]), o1 = vreinterpretq_u8_u32(r1.val[1]);
+        uint16x8_t lo = vaddq_u16(vaddl_u8(vget_low_u8(e0), vget_low_u8(o0)),
+                                  vaddl_u8(vget_low_u8(e1), vget_low_u8(o1)));
+        uint16x8_t hi = vaddq_u16(vaddl_u8(vget_high_u8(e0), vget_high_u8(o0)),
+                                  vaddl_u8(vget_high_u8(e1), vget_high_u8(o1)));
+        vst1q_u8(d + 4 * x, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+    }
+    return x;
+}
+#endif
+
+
+// separable cubic resampler (Catmull-Rom). when minifying, the filter is widened by
+// the scale factor, so every source pixel contributes. does not convert formats.
+// 2D only, the slices of 3D pixelboxes are scaled one by one, so depth must match.
+struct CubicWeights {
+    uint32 taps;
+    std::vector<uint32> index; // taps source indices per destination index
+    std::vector<float> weight; // taps weights per destination index
+
+    CubicWeights(uint32 srcSize, uint32 dstSize) {
+        float scale = float(srcSize) / dstSize;
+        float width = std::max(scale, 1.0f);
+        float support = 2 * width;
+        taps = uint32(std::ceil(2 * support)) + 1;
+        index.resize(size_t(dstSize) * taps);
+        weight.resize(size_t(dstSize) * taps);
+
+        for (uint32 i = 0; i < dstSize; i++) {
+            float centre = (i + 0.5f) * scale - 0.5f;
+            int first = int(std::floor(centre - support)) + 1;
+            float sum = 0;
+            for (uint32 k = 0; k < taps; k++) {
+                float t = std::abs((first + int(k) - centre) / width);
+                float w = t < 1 ? (1.5f * t - 2.5f) * t * t + 1
+                        : t < 2 ? ((-0.5f * t + 2.5f) * t - 4) * t + 2 : 0;
+                index[i * taps + k] = uint32(Math::Clamp(first + int(k), 0, int(srcSize) - 1));
+                weight[i * taps + k] = w;
+                sum += w;
+            }
+            for (uint32 k = 0; k < taps; k++)
+                weight[i * taps + k] /= sum;
+        }
+    }
+};
+
+inline void cubicStore(float v, uchar* d) { *d = uchar(Math::Clamp(v + 0.5f, 0.0f, 255.0f)); }
+inline void cubicStore(float v, float* d) { *d = v; }
+
+template<typename T, unsigned int channels> struct CubicResampler {
+    static void scale(const PixelBox& src, const PixelBox& dst) {
+        // assert(src.getDepth() == dst.getDepth());
+        uint32 srcwidth = src.getWidth();
+        uint32 dstwidth = dst.getWidth();
+        CubicWeights xw(srcwidth, dstwidth);
+        CubicWeights yw(src.getHeight(), dst.getHeight());
+
+        for (uint32 z = 0; z < dst.getDepth(); z++) {
+            const T* srcdata = (const T*)src.getTopLeftFrontPixelPtr() + z * src.slicePitch * channels;
+            T* dstdata = (T*)dst.getTopLeftFrontPixelPtr() + z * dst.slicePitch * channels;
+
+            forEachRowRange(dst.getHeight(), dstwidth, [&](size_t begin, size_t end) {
+                // vertically filtered source row
+                std::vector<float> row(size_t(srcwidth) * channels);
+                for (size_t y = begin; y < end; y++) {
+                    std::fill(row.begin(), row.end(), 0.0f);
+                    for (uint32 k = 0; k < yw.taps; k++) {
+                        float w = yw.weight[y * yw.taps + k];
+                        if (w == 0)
+                            continue;
+                        const T* s = srcdata + yw.index[y * yw.taps + k] * src.rowPitch * channels;
+                        for (size_t i = 0; i < row.size(); i++)
+                            row[i] += w * s[i];
+                    }
+
+                    T* d = dstdata + y * dst.rowPitch * channels;
+                    for (uint32 x = 0; x < dstwidth; x++) {
+                        float accum[channels] = {};
+                        for (uint32 k = 0; k < xw.taps; k++) {
+                            float w = xw.weight[x * xw.taps + k];
+                            const float* s = &row[xw.index[x * xw.taps + k] * channels];
+                            for (unsigned int c = 0; c < channels; c++)
+                                accum[c] += w * s[c];
+                        }
+                        for (unsigned int c = 0; c < channels; c++)
+                            cubicStore(accum[c], d++);
+                    }
+                }
+            });
+        }
     }
 };
 /** @} */
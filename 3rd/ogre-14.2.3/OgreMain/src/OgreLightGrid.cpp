@@ -0,0 +1,208 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreLightGrid.h"
+
+namespace Ogre {
+
+    /// below this many lights the linear scan is cheaper
+    static const size_t MIN_LIGHTS = 16;
+    /// lights overlapping more cells are candidates for every query
+    static const size_t MAX_CELLS_PER_LIGHT = 64;
+    /// queries overlapping more cells fall back to the linear scan
+    static const size_t MAX_CELLS_PER_QUERY = 64;
+
+    //-----------------------------------------------------------------------
+    LightGrid::LightGrid() : mCellSize(1), mBucketMask(0), mQueryMark(0), mVersion(0), mBuilt(false) {}
+    //-----------------------------------------------------------------------
+    LightGrid::~LightGrid() {}
+    //-----------------------------------------------------------------------
+    uint32 LightGrid::hashCell(int32 x, int32 y, int32 z)
+    {
+        return (uint32(x) * 73856093u) ^ (uint32(y) * 19349663u) ^ (uint32(z) * 83492791u);
+    }
+    //-----------------------------------------------------------------------
+    bool LightGrid::getCells(const Vector3& centre, Real radius, size_t maxCells, int32* lo, int32* hi) const
+    {
+        size_t numCells = 1;
+        for (int c = 0; c < 3; c++)
+        {
+            Real l = std::floor((centre[c] - radius) / mCellSize);
+            Real h = std::floor((centre[c] + radius) / mCellSize);
+            // also catches NaN and infinite ranges
+            if (!(l >= -1e9 && h <= 1e9) || h - l >= maxCells)
+                return false;
+
+            lo[c] = int32(l);
+            hi[c] = int32(h);
+            numCells *= size_t(hi[c] - lo[c] + 1);
+        }
+        return numCells <= maxCells;
+    }
+    //-----------------------------------------------------------------------
+    void LightGrid::rebuild(const LightList& lights)
+    {
+        size_t numLights = lights.size();
+        mGlobal.clear();
+        mLightMasks.resize(numLights);
+        mCastShadows.resize(numLights);
+        mShadowCasterCounts.clear();
+        mQueryMarks.assign(numLights, 0);
+        mQueryMark = 0;
+
+        // cells twice the median range, so most lights overlap at most 8 of them
+        std::vector<Real> ranges;
+        for (auto l : lights)
+        {
+            if (l->getType() != Light::LT_DIRECTIONAL)
+                ranges.push_back(l->getAttenuationRange());
+        }
+        if (!ranges.empty())
+        {
+            std::nth_element(ranges.begin(), ranges.begin() + ranges.size() / 2, ranges.end());
+            mCellSize = std::max(2 * ranges[ranges.size() / 2], Real(1e-3));
+        }
+
+        std::vector<int32> cells(numLights * 6);
+        size_t numEntries = 0;
+        for (uint32 i = 0; i < numLights; i++)
+        {
+            Light* l = lights[i];
+            mLightMasks[i] = l->getLightMask();
+            mCastShadows[i] = l->getCastShadows();
+
+            int32* lo = &cells[i * 6];
+            int32* hi = lo + 3;
+            if (l->getType() == Light::LT_DIRECTIONAL ||
+                !getCells(l->getDerivedPosition(), l->getAttenuationRange(), MAX_CELLS_PER_LIGHT, lo, hi))
+            {
+                mGlobal.push_back(i);
+                lo[0] = 1; // no cells
+                hi[0] = 0;
+                continue;
+            }
+            numEntries += size_t(hi[0] - lo[0] + 1) * (hi[1] - lo[1] + 1) * (hi[2] - lo[2] + 1);
+        }
+
+        // count the entries per bucket, then place them
+        uint32 numBuckets = Bitwise::firstPO2From(uint32(std::max<size_t>(numEntries * 2, 16)));
+        mBucketMask = numBuckets - 1;
+        mBucketStart.assign(numBuckets + 1, 0);
+        mEntries.resize(numEntries);
+
+        for (int pass = 0; pass < 2; pass++)
+        {
+            for (uint32 i = 0; i < numLights; i++)
+            {
+                const int32* lo = &cells[i * 6];
+                const int32* hi = lo + 3;
+                for (int32 x = lo[0]; x <= hi[0]; x++)
+                    for (int32 y = lo[1]; y <= hi[1]; y++)
+                        for (int32 z = lo[2]; z <= hi[2]; z++)
+                        {
+                            uint32 b = hashCell(x, y, z) & mBucketMask;
+                            if (pass == 0)
+                                mBucketStart[b + 1]++;
+                            else
+                                mEntries[mBucketStart[b]++] = i;
+                        }
+            }
+
+            if (pass == 0)
+            {
+                for (uint32 b = 0; b < numBuckets; b++)
+                    mBucketStart[b + 1] += mBucketStart[b];
+            }
+        }
+        // placing advanced every start to the next one
+        for (uint32 b = numBuckets; b > 0; b--)
+            mBucketStart[b] = mBucketStart[b - 1];
+        mBucketStart[0] = 0;
+
+        mBuilt = true;
+    }
+    //-----------------------------------------------------------------------
+    const std::vector<uint32>* LightGrid::query(const LightList& lights, ulong lightsVersion, const Sphere& bound)
+    {
+        if (lights.size() < MIN_LIGHTS)
+            return NULL;
+
+        if (!mBuilt || mVersion != lightsVersion || mLightMasks.size() != lights.size())
+        {
+            rebuild(lights);
+            mVersion = lightsVersion;
+        }
+
+        // a little larger, so rounding cannot drop a light touching the sphere
+        int32 lo[3], hi[3];
+        if (!getCells(bound.getCenter(), bound.getRadius() + mCellSize * Real(1e-3), MAX_CELLS_PER_QUERY, lo, hi))
+            return NULL;
+
+        if (++mQueryMark == 0)
+        {
+            std::fill(mQueryMarks.begin(), mQueryMarks.end(), 0);
+            mQueryMark = 1;
+        }
+
+        mCandidates = mGlobal;
+        for (int32 x = lo[0]; x <= hi[0]; x++)
+            for (int32 y = lo[1]; y <= hi[1]; y++)
+                for (int32 z = lo[2]; z <= hi[2]; z++)
+                {
+                    uint32 b = hashCell(x, y, z) & mBucketMask;
+                    for (uint32 e = mBucketStart[b]; e < mBucketStart[b + 1]; e++)
+                    {
+                        uint32 i = mEntries[e];
+                        if (mQueryMarks[i] != mQueryMark)
+                        {
+                            mQueryMarks[i] = mQueryMark;
+                            mCandidates.push_back(i);
+                        }
+                    }
+                }
+
+        std::sort(mCandidates.begin(), mCandidates.end());
+        return &mCandidates;
+    }
+    //-----------------------------------------------------------------------
+    size_t LightGrid::getNumShadowCasters(uint32 lightMask)
+    {
+        for (const auto& c : mShadowCasterCounts)
+        {
+            if (c.first == lightMask)
+                return c.second;
+        }
+
+        size_t count = 0;
+        for (size_t i = 0; i < mLightMasks.size(); i++)
+            count += mCastShadows[i] && (mLightMasks[i] & lightMask);
+
+        mShadowCasterCounts.push_back(std::make_pair(lightMask, count));
+        return count;
+    }
+}
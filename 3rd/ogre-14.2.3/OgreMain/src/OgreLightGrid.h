@@ -0,0 +1,108 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __LightGrid_H__
+#define __LightGrid_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreCommon.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Uniform grid over the lights affecting the frustum
+
+        Used by SceneManager::_populateLightList, so that finding the lights of an object does not test
+        every light in the frustum. The point and spot lights are entered into the hashed cells their range
+        overlaps, while directional lights and lights spanning many cells are candidates for every query.
+        A query visits the cells overlapped by the bounds of the object and returns the lights found there,
+        which are then tested like before.
+
+        The grid is rebuilt on the first query after the lights affecting the frustum changed, i.e. at most
+        once per camera. Below a few lights a linear scan is cheaper and no grid is built.
+    */
+    class LightGrid : public SceneMgtAlloc
+    {
+    public:
+        LightGrid();
+        ~LightGrid();
+
+        /** Find the lights that may affect a sphere
+
+        @param lights the lights to index
+        @param lightsVersion the grid is rebuilt when this changes, see SceneManager::_getLightsDirtyCounter
+        @param bound the sphere to find lights for
+        @return indices into lights in increasing order, of the lights whose range may intersect the sphere
+            and all directional lights. NULL if the lights should be scanned linearly instead.
+        */
+        const std::vector<uint32>* query(const LightList& lights, ulong lightsVersion, const Sphere& bound);
+
+        /// number of lights matching lightMask that cast shadows, as of the last rebuild. A light starting or
+        /// stopping to cast shadows changes the lights version, so it triggers a rebuild
+        size_t getNumShadowCasters(uint32 lightMask);
+
+    private:
+        Real mCellSize;
+        uint32 mBucketMask;
+        /// hashed cells, the lights of bucket b are mEntries[mBucketStart[b], mBucketStart[b + 1])
+        std::vector<uint32> mBucketStart;
+        std::vector<uint32> mEntries;
+        /// candidates of every query
+        std::vector<uint32> mGlobal;
+
+        /// light masks and shadow casting at the last rebuild
+        std::vector<uint32> mLightMasks;
+        std::vector<uchar> mCastShadows;
+        std::vector<std::pair<uint32, size_t> > mShadowCasterCounts;
+
+        /// lights already found by the current query
+        std::vector<uint32> mQueryMarks;
+        uint32 mQueryMark;
+        std::vector<uint32> mCandidates;
+
+        ulong mVersion;
+        bool mBuilt;
+
+        void rebuild(const LightList& lights);
+        /// the range of cells overlapped by a sphere, false if it spans too many
+        bool getCells(const Vector3& centre, Real radius, size_t maxCells, int32* lo, int32* hi) const;
+        static uint32 hashCell(int32 x, int32 y, int32 z);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -129,6 +129,23 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Material::_getDependencies(std::vector<ResourcePtr>& dependencies)
+    {
+        // as loading would, to know which techniques are used
+        if (mCompilationRequired)
+            compile();
+
+        for (auto *t : mSupportedTechniques)
+        {
+            for (auto *p : t->getPasses())
+            {
+                // not through _getTexturePtr, which would load them right away
+                for (auto *tus : p->getTextureUnitStates())
+                    tus->_getDependencies(dependencies);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void Material::loadImpl(void)
     {
         // Load all supported techniques
@@ -0,0 +1,176 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreMemoryReport.h"
+#include "OgreFrameAllocator.h"
+
+namespace Ogre {
+
+    namespace {
+        const char* CATEGORY_NAMES[MEMCATEGORY_COUNT] = {
+            "general", "geometry", "animation", "scene control",
+            "scene objects", "resource", "scripting", "render system"};
+
+        String formatBytes(size_t bytes)
+        {
+            StringStream str;
+            str.precision(1);
+            str << std::fixed;
+            if (bytes >= 1024 * 1024)
+                str << bytes / (1024.0 * 1024.0) << " MiB";
+            else if (bytes >= 1024)
+                str << bytes / 1024.0 << " KiB";
+            else
+                str << bytes << " B";
+            return str.str();
+        }
+    }
+    //-----------------------------------------------------------------------
+    MemoryReport MemoryReport::capture(size_t numLargest)
+    {
+        MemoryReport ret;
+        for (int i = 0; i < MEMCATEGORY_COUNT; ++i)
+            ret.categories[i] = CategoryAllocator::getStats(MemoryCategory(i));
+
+        if (auto rgm = ResourceGroupManager::getSingletonPtr())
+        {
+            for (const auto& it : rgm->getResourceManagers())
+            {
+                ResourceManager* rm = it.second;
+                ManagerUsage usage;
+                usage.resourceType = it.first;
+                usage.memoryUsage = rm->getMemoryUsage();
+                usage.memoryBudget = rm->getMemoryBudget();
+                usage.numResources = 0;
+                usage.numLoaded = 0;
+
+                auto resources = rm->getResourceIterator();
+                while (resources.hasMoreElements())
+                {
+                    const ResourcePtr& r = resources.getNext();
+                    usage.numResources++;
+                    if (!r->isLoaded())
+                        continue;
+                    usage.numLoaded++;
+
+                    ResourceUsage ru = {r->getName(), r->getSize()};
+                    auto pos = std::upper_bound(usage.largest.begin(), usage.largest.end(), ru,
+                                                [](const ResourceUsage& a, const ResourceUsage& b)
+                                                { return a.bytes > b.bytes; });
+                    if (size_t(pos - usage.largest.begin()) < numLargest)
+                    {
+                        usage.largest.insert(pos, ru);
+                        if (usage.largest.size() > numLargest)
+                            usage.largest.pop_back();
+                    }
+                }
+                ret.managers.push_back(usage);
+            }
+        }
+
+        ret.buffers = HardwareBufferManagerBase::MemoryUsage();
+        if (auto hbm = HardwareBufferManager::getSingletonPtr())
+            ret.buffers = hbm->getMemoryUsage();
+
+        ret.frameArenaPeak = 0;
+        ret.frameArenaCapacity = 0;
+        if (auto root = Root::getSingletonPtr())
+        {
+            ret.frameArenaPeak = root->getFrameAllocator()->getPeakBytes();
+            ret.frameArenaCapacity = root->getFrameAllocator()->getCapacity();
+        }
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    size_t MemoryReport::getObjectBytes() const
+    {
+        size_t ret = 0;
+        for (const auto& c : categories)
+            ret += c.liveBytes;
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    size_t MemoryReport::getFrameAllocations() const
+    {
+        size_t ret = 0;
+        for (const auto& c : categories)
+            ret += c.frameAllocations;
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    size_t MemoryReport::getResourceBytes() const
+    {
+        size_t ret = 0;
+        for (const auto& m : managers)
+            ret += m.memoryUsage;
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    String MemoryReport::toString() const
+    {
+        StringStream str;
+        str << "objects: " << formatBytes(getObjectBytes()) << ", " << getFrameAllocations()
+            << " allocations per frame\n";
+        for (int i = 0; i < MEMCATEGORY_COUNT; ++i)
+        {
+            const CategoryAllocator::Stats& c = categories[i];
+            str << "  " << CATEGORY_NAMES[i] << ": " << c.liveAllocations << " objects, "
+                << formatBytes(c.liveBytes) << ", " << c.frameAllocations << " per frame";
+            if (c.pooledBytes)
+                str << ", pools " << formatBytes(c.pooledBytes);
+            str << "\n";
+        }
+
+        str << "resources: " << formatBytes(getResourceBytes()) << "\n";
+        for (const auto& m : managers)
+        {
+            if (!m.numResources)
+                continue;
+            str << "  " << m.resourceType << ": " << m.numLoaded << " of " << m.numResources << " loaded, "
+                << formatBytes(m.memoryUsage);
+            if (m.memoryBudget != std::numeric_limits<size_t>::max())
+                str << " of " << formatBytes(m.memoryBudget);
+            str << "\n";
+            for (const auto& r : m.largest)
+                str << "    " << r.name << ": " << formatBytes(r.bytes) << "\n";
+        }
+
+        str << "buffers: " << buffers.numVertexBuffers << " vertex, " << formatBytes(buffers.vertexBytes)
+            << ", " << buffers.numIndexBuffers << " index, " << formatBytes(buffers.indexBytes) << "\n";
+        str << "  shadow copies: " << formatBytes(buffers.shadowBytes)
+            << ", temporary copies: " << formatBytes(buffers.tempCopyBytes) << "\n";
+        str << "frame arena: peak " << formatBytes(frameArenaPeak) << " of " << formatBytes(frameArenaCapacity)
+            << "\n";
+        return str.str();
+    }
+    //-----------------------------------------------------------------------
+    const char* MemoryReport::getCategoryName(MemoryCategory category)
+    {
+        return CATEGORY_NAMES[category];
+    }
+}
@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "OgreSkeletonManager.h"
 #include "OgreEdgeListBuilder.h"
+#include "OgreMeshSerializer.h"
 #include "OgreAnimation.h"
 #include "OgreAnimationState.h"
 #include "OgreAnimationTrack.h"
@@ -172,6 +173,15 @@ namespace Ogre {
         return getSubMesh(index);
     }
     //-----------------------------------------------------------------------
+    /// the entry of a mesh in the edge list cache, readable and unique per group and name
+    static String getEdgeListCacheEntry(const String& group, const String& name)
+    {
+        String base, path;
+        StringUtil::splitFilename(name, base, path);
+        uint32 hash = FastHash(name.data(), name.size(), FastHash(group.data(), group.size()));
+        return StringUtil::format("%08x_%s", hash, base.c_str());
+    }
+    //-----------------------------------------------------------------------
     void Mesh::postLoadImpl(void)
     {
         // Prepare for shadow volumes?
@@ -185,6 +195,33 @@ namespace Ogre {
             if (!mEdgeListsBuilt && mAutoBuildEdgeLists)
             {
                 buildEdgeList();
+
+                // Store the edge lists with the mesh, so they are read on the next load
+                if (MeshManager::getSingleton().getSaveBuiltEdgeLists() && !isManuallyLoaded())
+                {
+                    try
+                    {
+                        // replace the source file, or keep a copy in the cache if it is read-only
+                        Archive* arch = ResourceGroupManager::getSingleton()._getArchiveToResource(mName, mGroup);
+                        Archive* cache = MeshManager::getSingleton().getEdgeListCache();
+                        DataStreamPtr stream;
+                        if (arch && !arch->isReadOnly())
+                            stream = arch->create(mName);
+                        else if (arch && cache)
+                            stream = cache->create(getEdgeListCacheEntry(mGroup, mName));
+
+                        if (stream)
+                        {
+                            MeshSerializer().exportMesh(this, stream);
+                            LogManager::getSingleton().logMessage("Mesh: Saved edge lists of " + mName);
+                        }
+                    }
+                    catch (Exception& e)
+                    {
+                        LogManager::getSingleton().logWarning("Mesh: Unable to save edge lists of " + mName +
+                                                              ": " + e.getDescription());
+                    }
+                }
             }
         }
 #if !OGRE_NO_MESHLOD
@@ -205,12 +242,24 @@ namespace Ogre {
         if (getCreator()->getVerbose())
             LogManager::getSingleton().logMessage("Mesh: Loading "+mName+".");
 
-        mFreshFromDisk =
-            ResourceGroupManager::getSingleton().openResource(
-                mName, mGroup, this);
+        // a copy saved with its edge lists, unless the file was modified since
+        Archive* cache = MeshManager::getSingleton().getEdgeListCache();
+        String entry = getEdgeListCacheEntry(mGroup, mName);
+        if (cache && cache->exists(entry))
+        {
+            Archive* arch = ResourceGroupManager::getSingleton()._getArchiveToResource(mName, mGroup);
+            if (arch && cache->getModifiedTime(entry) >= arch->getModifiedTime(mName))
+                mFreshFromDisk = cache->open(entry);
+        }
+
+        if (!mFreshFromDisk)
+            mFreshFromDisk =
+                ResourceGroupManager::getSingleton().openResource(
+                    mName, mGroup, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless the archive already did, e.g. by mapping the file
+        if (!dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get()))
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
@@ -1080,6 +1129,17 @@ namespace Ogre {
         return mSkeleton ? mSkeleton->getName() : BLANKSTRING;
     }
     //---------------------------------------------------------------------
+    void Mesh::_getDependencies(std::vector<ResourcePtr>& dependencies)
+    {
+        for (auto *sm : mSubMeshList)
+        {
+            if (sm->getMaterial())
+                dependencies.push_back(sm->getMaterial());
+        }
+        if (mSkeleton)
+            dependencies.push_back(mSkeleton);
+    }
+    //---------------------------------------------------------------------
     const MeshLodUsage& Mesh::getLodLevel(ushort index) const
     {
 #if !OGRE_NO_MESHLOD
@@ -1888,16 +1948,22 @@ namespace Ogre {
         auto blendIdxStride = srcIdxBuf->getVertexSize();
         auto blendWeightStride = srcWeightBuf->getVertexSize();
 
-        OptimisedUtil::getImplementation()->softwareVertexSkinning(
-            pSrcPos, pDestPos,
-            pSrcNorm, pDestNorm,
-            pBlendWeight, pBlendIdx,
-            blendMatrices,
-            srcPosStride, destPosStride,
-            srcNormStride, destNormStride,
-            blendWeightStride, blendIdxStride,
-            numWeightsPerVertex,
-            targetVertexData->vertexCount);
+        // Large meshes are split into ranges of vertices skinned on the worker threads
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        OptimisedUtil::_runChunked(targetVertexData->vertexCount, [&](size_t begin, size_t end) {
+            util->softwareVertexSkinning(
+                rawOffsetPointer(pSrcPos, begin * srcPosStride), rawOffsetPointer(pDestPos, begin * destPosStride),
+                pSrcNorm ? rawOffsetPointer(pSrcNorm, begin * srcNormStride) : NULL,
+                pDestNorm ? rawOffsetPointer(pDestNorm, begin * destNormStride) : NULL,
+                rawOffsetPointer(pBlendWeight, begin * blendWeightStride),
+                rawOffsetPointer(pBlendIdx, begin * blendIdxStride),
+                blendMatrices,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIdxStride,
+                numWeightsPerVertex,
+                end - begin);
+        });
     }
     //---------------------------------------------------------------------
     void Mesh::softwareVertexMorph(float t,
@@ -1942,11 +2008,16 @@ namespace Ogre {
         HardwareBufferLockGuard destLock(destBuf, HardwareBuffer::HBL_DISCARD);
         float* pdst = static_cast<float*>(destLock.pData);
 
-        OptimisedUtil::getImplementation()->softwareVertexMorph(
-            t, pb1, pb2, pdst,
-            b1->getVertexSize(), b2->getVertexSize(), destBuf->getVertexSize(),
-            targetVertexData->vertexCount,
-            morphNormals);
+        size_t b1Size = b1->getVertexSize(), b2Size = b2->getVertexSize(), dstSize = destBuf->getVertexSize();
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        OptimisedUtil::_runChunked(targetVertexData->vertexCount, [&](size_t begin, size_t end) {
+            util->softwareVertexMorph(
+                t, rawOffsetPointer(pb1, begin * b1Size), rawOffsetPointer(pb2, begin * b2Size),
+                rawOffsetPointer(pdst, begin * dstSize),
+                b1Size, b2Size, dstSize,
+                end - begin,
+                morphNormals);
+        });
     }
     //---------------------------------------------------------------------
     void Mesh::softwareVertexPoseBlend(float weight,
@@ -65,9 +65,13 @@ namespace Ogre
     {
         mBlendWeightsBaseElementType = VET_FLOAT1;
         mPrepAllMeshesForShadowVolumes = false;
+        mSaveBuiltEdgeLists = false;
+        mEdgeListCache = NULL;
 
         mLoadOrder = 350.0f;
         mResourceType = "Mesh";
+        // preparing only reads the file into memory
+        mPrepareConcurrently = true;
 
         mMeshCodec = std::make_unique<MeshCodec>();
         Codec::registerCodec(mMeshCodec.get());
@@ -724,15 +724,18 @@ namespace Ogre {
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
             pMesh->mVertexBufferShadowBuffer);
-        HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_DISCARD);
-        stream->read(vbufLock.pData, dest->vertexCount * vertexSize);
+        if (!readBufferData(stream, vbuf.get(), vbuf->getSizeInBytes()))
+        {
+            HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_DISCARD);
+            stream->read(vbufLock.pData, dest->vertexCount * vertexSize);
 
-        // endian conversion for OSX
-        flipFromLittleEndian(
-            vbufLock.pData,
-            dest->vertexCount,
-            vertexSize,
-            dest->vertexDeclaration->findElementsBySource(bindIndex));
+            // endian conversion for OSX
+            flipFromLittleEndian(
+                vbufLock.pData,
+                dest->vertexCount,
+                vertexSize,
+                dest->vertexDeclaration->findElementsBySource(bindIndex));
+        }
 
         // Set binding
         dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
@@ -918,8 +921,11 @@ namespace Ogre {
                         sm->indexData->indexCount,
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
-                HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
-                readInts(stream, static_cast<unsigned int*>(ibufLock.pData), sm->indexData->indexCount);
+                if (!readBufferData(stream, ibuf.get(), ibuf->getSizeInBytes()))
+                {
+                    HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
+                    readInts(stream, static_cast<unsigned int*>(ibufLock.pData), sm->indexData->indexCount);
+                }
 
             }
             else // 16-bit
@@ -929,8 +935,11 @@ namespace Ogre {
                         sm->indexData->indexCount,
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
-                HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
-                readShorts(stream, static_cast<unsigned short*>(ibufLock.pData), sm->indexData->indexCount);
+                if (!readBufferData(stream, ibuf.get(), ibuf->getSizeInBytes()))
+                {
+                    HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
+                    readShorts(stream, static_cast<unsigned short*>(ibufLock.pData), sm->indexData->indexCount);
+                }
             }
         }
         sm->indexData->indexBuffer = ibuf;
@@ -1476,6 +1485,18 @@ namespace Ogre {
         }
     }
 #endif
+    //---------------------------------------------------------------------
+    bool MeshSerializerImpl::readBufferData(const DataStreamPtr& stream, HardwareBuffer* buf, size_t size)
+    {
+        // Data already in memory, like a mapped file, is written to the buffer in place
+        MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        if (mFlipEndian || !memStream || stream->size() - stream->tell() < size)
+            return false;
+
+        buf->writeData(0, size, memStream->getCurrentPtr(), true);
+        stream->skip(long(size));
+        return true;
+    }
     //---------------------------------------------------------------------
     void MeshSerializerImpl::flipFromLittleEndian(void* pData, size_t vertexCount,
         size_t vertexSize, const VertexDeclaration::VertexElementList& elems)
@@ -2495,8 +2516,11 @@ namespace Ogre {
                 vertexSize, vertexCount,
                 HardwareBuffer::HBU_STATIC, true);
         // float x,y,z          // repeat by number of vertices in original geometry
-        HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_DISCARD);
-        readFloats(stream, static_cast<float*>(vbufLock.pData), vertexCount * (includesNormals ? 6 : 3));
+        if (!readBufferData(stream, vbuf.get(), vbuf->getSizeInBytes()))
+        {
+            HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_DISCARD);
+            readFloats(stream, static_cast<float*>(vbufLock.pData), vertexCount * (includesNormals ? 6 : 3));
+        }
         kf->setVertexBuffer(vbuf);
 
     }
@@ -2830,16 +2854,22 @@ namespace Ogre {
                     indexData->indexBuffer = pMesh->getHardwareBufferManager()->createIndexBuffer(
                         HardwareIndexBuffer::IT_32BIT, indexData->indexCount,
                         pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                    HardwareBufferLockGuard ibufLock(indexData->indexBuffer, HardwareBuffer::HBL_DISCARD);
-                    readInts(stream, static_cast<unsigned int*>(ibufLock.pData), indexData->indexCount);
+                    if (!readBufferData(stream, indexData->indexBuffer.get(), indexData->indexBuffer->getSizeInBytes()))
+                    {
+                        HardwareBufferLockGuard ibufLock(indexData->indexBuffer, HardwareBuffer::HBL_DISCARD);
+                        readInts(stream, static_cast<unsigned int*>(ibufLock.pData), indexData->indexCount);
+                    }
                 }
                 else
                 {
                     indexData->indexBuffer = pMesh->getHardwareBufferManager()->createIndexBuffer(
                         HardwareIndexBuffer::IT_16BIT, indexData->indexCount,
                         pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                    HardwareBufferLockGuard ibufLock(indexData->indexBuffer, HardwareBuffer::HBL_DISCARD);
-                    readShorts(stream, static_cast<unsigned short*>(ibufLock.pData), indexData->indexCount);
+                    if (!readBufferData(stream, indexData->indexBuffer.get(), indexData->indexBuffer->getSizeInBytes()))
+                    {
+                        HardwareBufferLockGuard ibufLock(indexData->indexBuffer, HardwareBuffer::HBL_DISCARD);
+                        readShorts(stream, static_cast<unsigned short*>(ibufLock.pData), indexData->indexCount);
+                    }
                 }
             }
         }
@@ -172,6 +172,13 @@ namespace Ogre {
         virtual void readExtremes(const DataStreamPtr& stream, Mesh *pMesh);
 
 
+        /** Reads size bytes of the stream straight into buf when they are in memory and need no endian flip
+
+            Returns false without reading anything otherwise, the caller then locks the buffer and reads
+            the data into it.
+        */
+        bool readBufferData(const DataStreamPtr& stream, HardwareBuffer* buf, size_t size);
+
         /// Flip an entire vertex buffer from little endian
         virtual void flipFromLittleEndian(void* pData, size_t vertexCount, size_t vertexSize, const VertexDeclaration::VertexElementList& elems);
         /// Flip an entire vertex buffer to little endian
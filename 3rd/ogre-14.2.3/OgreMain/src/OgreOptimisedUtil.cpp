@@ -27,8 +27,9 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreOptimisedUtil.h"
-
-//#define __DO_PROFILE__
+#include "OgreTimer.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre {
 
@@ -38,288 +39,16 @@ namespace Ogre {
 #if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
 #endif
-
-#ifdef __DO_PROFILE__
-    //---------------------------------------------------------------------
-    class OptimisedUtilProfiler : public OptimisedUtil
-    {
-    protected:
-
-        enum
-        {
-            IMPL_DEFAULT,
-#if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
-            IMPL_SSE,
+#if __OGRE_HAVE_AVX2
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
 #endif
-            IMPL_COUNT
-        };
-
-        struct ProfileItem
-        {
-            uint mAvgTicks;
-            uint mCount;
-            uint64 mTotalTicks;
-            uint64 mStartTick;
-
-            ProfileItem(void)
-                : mAvgTicks()
-                , mCount()
-                , mTotalTicks()
-                , mStartTick()
-            {
-            }
-
-            void begin(void)
-            {
-                mStartTick = clock();
-            }
-
-            void end(void)
-            {
-                uint64 ticks = clock() - mStartTick;
-                mTotalTicks += ticks;
-                ++mCount;
-                mAvgTicks = mTotalTicks / mCount;
-            }
-        };
-
-        typedef ProfileItem ProfileItems[IMPL_COUNT];
-
-        typedef std::vector<OptimisedUtil*> OptimisedUtilList;
-        OptimisedUtilList mOptimisedUtils;
-
-    public:
-        OptimisedUtilProfiler(void)
-        {
-            mOptimisedUtils.push_back(_getOptimisedUtilGeneral());
-#if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
-            //if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
-            {
-                mOptimisedUtils.push_back(_getOptimisedUtilSSE());
-            }
+#if __OGRE_HAVE_NEON
+    extern OptimisedUtil* _getOptimisedUtilNEON(void);
 #endif
-        }
-
-        virtual void softwareVertexSkinning(
-            const float *srcPosPtr, float *destPosPtr,
-            const float *srcNormPtr, float *destNormPtr,
-            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
-            const Affine3* const* blendMatrices,
-            size_t srcPosStride, size_t destPosStride,
-            size_t srcNormStride, size_t destNormStride,
-            size_t blendWeightStride, size_t blendIndexStride,
-            size_t numWeightsPerVertex,
-            size_t numVertices)
-        {
-            static ProfileItems results;
-            static size_t index;
-            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
-            OptimisedUtil* impl = mOptimisedUtils[index];
-            ProfileItem& profile = results[index];
-
-            profile.begin();
-            impl->softwareVertexSkinning(
-                srcPosPtr, destPosPtr,
-                srcNormPtr, destNormPtr,
-                blendWeightPtr, blendIndexPtr,
-                blendMatrices,
-                srcPosStride, destPosStride,
-                srcNormStride, destNormStride,
-                blendWeightStride, blendIndexStride,
-                numWeightsPerVertex,
-                numVertices);
-            profile.end();
-
-            LogManager::getSingleton().logMessage(StringUtil::format(
-                "OptimisedUtilProfiler: %s - impl %zu = %u avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
-            // You can put break point here while running test application, to
-            // watch profile results.
-            ++index;    // So we can put break point here even if in release build
-        }
-
-        virtual void softwareVertexMorph(
-            float t,
-            const float *srcPos1, const float *srcPos2,
-            float *dstPos,
-            size_t pos1VSize, size_t pos2VSize, size_t dstVSize, 
-            size_t numVertices,
-            bool morphNormals)
-        {
-            static ProfileItems results;
-            static size_t index;
-            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
-            OptimisedUtil* impl = mOptimisedUtils[index];
-            ProfileItem& profile = results[index];
-
-            profile.begin();
-            impl->softwareVertexMorph(
-                t,
-                srcPos1, srcPos2,
-                dstPos,
-                pos1VSize, pos2VSize, dstVSize,
-                numVertices,
-                morphNormals);
-            profile.end();
-
-            LogManager::getSingleton().logMessage(StringUtil::format(
-                "OptimisedUtilProfiler: %s - impl %zu = %u avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
-
-            // You can put break point here while running test application, to
-            // watch profile results.
-            ++index;    // So we can put break point here even if in release build
-        }
-
-        virtual void concatenateAffineMatrices(
-            const Affine3& baseMatrix,
-            const Affine3* srcMatrices,
-            Affine3* dstMatrices,
-            size_t numMatrices)
-        {
-            static ProfileItems results;
-            static size_t index;
-            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
-            OptimisedUtil* impl = mOptimisedUtils[index];
-            ProfileItem& profile = results[index];
-
-            profile.begin();
-            impl->concatenateAffineMatrices(
-                baseMatrix,
-                srcMatrices,
-                dstMatrices,
-                numMatrices);
-            profile.end();
-
-            LogManager::getSingleton().logMessage(StringUtil::format(
-                "OptimisedUtilProfiler: %s - impl %zu = %u avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
-
-            // You can put break point here while running test application, to
-            // watch profile results.
-            ++index;    // So we can put break point here even if in release build
-        }
-
-        /// @copydoc OptimisedUtil::calculateFaceNormals
-        virtual void calculateFaceNormals(
-            const float *positions,
-            const EdgeData::Triangle *triangles,
-            Vector4 *faceNormals,
-            size_t numTriangles)
-        {
-            static ProfileItems results;
-            static size_t index;
-            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
-            OptimisedUtil* impl = mOptimisedUtils[index];
-            ProfileItem& profile = results[index];
-
-            profile.begin();
-            impl->calculateFaceNormals(
-                positions,
-                triangles,
-                faceNormals,
-                numTriangles);
-            profile.end();
-
-            //
-            //   Dagon SkeletonAnimation sample test results (CPU timestamp per-function call):
-            //
-            //                  Pentium 4 3.0G HT       Athlon XP 2500+
-            //
-            //      General     657080                  486494
-            //      SSE         223559                  399495
-            //
-
-            LogManager::getSingleton().logMessage(StringUtil::format(
-                "OptimisedUtilProfiler: %s - impl %zu = %u avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
-
-            // You can put break point here while running test application, to
-            // watch profile results.
-            ++index;    // So we can put break point here even if in release build
-        }
-
-        /// @copydoc OptimisedUtil::calculateLightFacing
-        virtual void calculateLightFacing(
-            const Vector4& lightPos,
-            const Vector4* faceNormals,
-            char* lightFacings,
-            size_t numFaces)
-        {
-            static ProfileItems results;
-            static size_t index;
-            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
-            OptimisedUtil* impl = mOptimisedUtils[index];
-            ProfileItem& profile = results[index];
-
-            profile.begin();
-            impl->calculateLightFacing(
-                lightPos,
-                faceNormals,
-                lightFacings,
-                numFaces);
-            profile.end();
-
-            //
-            //   Dagon SkeletonAnimation sample test results (CPU timestamp per-function call):
-            //
-            //                  Pentium 4 3.0G HT       Athlon XP 2500+
-            //
-            //      General     171875                  86998
-            //      SSE          47934                  63995
-            //
-
-            LogManager::getSingleton().logMessage(StringUtil::format(
-                "OptimisedUtilProfiler: %s - impl %zu = %u avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
-
-            // You can put break point here while running test application, to
-            // watch profile results.
-            ++index;    // So we can put break point here even if in release build
-        }
-
-        virtual void extrudeVertices(
-            const Vector4& lightPos,
-            Real extrudeDist,
-            const float* srcPositions,
-            float* destPositions,
-            size_t numVertices)
-        {
-            static ProfileItems results;
-            static size_t index;
-            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
-            OptimisedUtil* impl = mOptimisedUtils[index];
-            ProfileItem& profile = results[index];
-
-            profile.begin();
-            impl->extrudeVertices(
-                lightPos,
-                extrudeDist,
-                srcPositions,
-                destPositions,
-                numVertices);
-            profile.end();
-
-            //
-            //   Dagon SkeletonAnimation sample test results (CPU timestamp per-function call):
-            //
-            //                                  Pentium 4 3.0G HT   Athlon XP 2500+
-            //
-            //      Directional Light, General   38106               92306
-            //      Directional Light, SSE       27292               67055
-            //
-            //      Point Light, General        224209              155483
-            //      Point Light, SSE             56817              106663
-            //
-
-            LogManager::getSingleton().logMessage(StringUtil::format(
-                "OptimisedUtilProfiler: %s - impl %zu = %u avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
-
-            // You can put break point here while running test application, to
-            // watch profile results.
-            ++index;    // So we can put break point here even if in release build
-        }
-
-    };
-#endif // __DO_PROFILE__
 
     //---------------------------------------------------------------------
     OptimisedUtil* OptimisedUtil::msImplementation = OptimisedUtil::_detectImplementation();
+    size_t OptimisedUtil::msParallelThreshold = 8192;
 
     //---------------------------------------------------------------------
     OptimisedUtil* OptimisedUtil::_detectImplementation(void)
@@ -359,15 +88,16 @@ namespace Ogre {
         //
         //
         // We are pick up the implementation based on test results above.
+        // _selectFastestImplementation can refine this by measuring the running CPU.
         //
-#ifdef __DO_PROFILE__
+#if __OGRE_HAVE_AVX2
+        if (PlatformInformation::hasCpuFeature(PlatformInformation::CPU_FEATURE_AVX2) &&
+            PlatformInformation::hasCpuFeature(PlatformInformation::CPU_FEATURE_FMA))
         {
-            static OptimisedUtilProfiler msOptimisedUtilProfiler;
-            return &msOptimisedUtilProfiler;
+            return _getOptimisedUtilAVX2();
         }
-
-#else   // !__DO_PROFILE__
-
+        else
+#endif  // __OGRE_HAVE_AVX2
 #if __OGRE_HAVE_SSE
         if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
         {
@@ -377,15 +107,246 @@ namespace Ogre {
 #elif __OGRE_HAVE_NEON
         if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
         {
-            return _getOptimisedUtilSSE();
+            return _getOptimisedUtilNEON();
         }
         else
 #endif  // __OGRE_HAVE_SSE
         {
             return _getOptimisedUtilGeneral();
         }
+    }
+
+    //---------------------------------------------------------------------
+    const OptimisedUtil::ImplementationList& OptimisedUtil::getAvailableImplementations(void)
+    {
+        static ImplementationList impls;
+        if (impls.empty())
+        {
+            impls.emplace_back("General", _getOptimisedUtilGeneral());
+#if __OGRE_HAVE_SSE
+            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
+                impls.emplace_back("SSE", _getOptimisedUtilSSE());
+#elif __OGRE_HAVE_NEON
+            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
+            {
+                impls.emplace_back("SSE", _getOptimisedUtilSSE());
+                impls.emplace_back("NEON", _getOptimisedUtilNEON());
+            }
+#endif
+#if __OGRE_HAVE_AVX2
+            if (PlatformInformation::hasCpuFeature(PlatformInformation::CPU_FEATURE_AVX2) &&
+                PlatformInformation::hasCpuFeature(PlatformInformation::CPU_FEATURE_FMA))
+                impls.emplace_back("AVX2", _getOptimisedUtilAVX2());
+#endif
+        }
+        return impls;
+    }
+    //---------------------------------------------------------------------
+    namespace
+    {
+        /// grid mesh shaped like the data the engine passes to the kernels
+        struct BenchmarkMesh
+        {
+            static const size_t NUM_BONES = 64;
+            static const size_t NUM_WEIGHTS = 4;
+
+            size_t numVertices;
+            std::vector<float> posNorm, posNormDst;         // interleaved position and normal
+            std::vector<float> pos1, pos2, posDst;          // packed xyz
+            std::vector<float> weights;
+            std::vector<uchar> indices;
+            aligned_vector<Affine3> bones;
+            std::vector<const Affine3*> blendMatrices;
+            aligned_vector<Affine3> matrices, matricesDst;
+            std::vector<EdgeData::Triangle> triangles;
+            aligned_vector<Vector4> faceNormals;
+            std::vector<char> lightFacings;
+
+            BenchmarkMesh(size_t n) : numVertices(n)
+            {
+                size_t side = std::max<size_t>(2, size_t(std::sqrt(double(n))));
+                posNorm.resize(n * 6);
+                posNormDst.resize(n * 6);
+                pos1.resize(n * 3);
+                pos2.resize(n * 3);
+                posDst.resize(n * 3);
+                weights.resize(n * NUM_WEIGHTS);
+                indices.resize(n * NUM_WEIGHTS);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    float x = float(i % side), z = float(i / side), y = std::sin(x * 0.1f) * std::cos(z * 0.1f);
+                    float* v = &posNorm[i * 6];
+                    v[0] = x; v[1] = y; v[2] = z;
+                    v[3] = 0; v[4] = 1; v[5] = 0;
+                    float* p = &pos1[i * 3];
+                    p[0] = x; p[1] = y; p[2] = z;
+                    p = &pos2[i * 3];
+                    p[0] = x; p[1] = y + 1; p[2] = z;
+                    for (size_t w = 0; w < NUM_WEIGHTS; ++w)
+                    {
+                        weights[i * NUM_WEIGHTS + w] = 1.0f / NUM_WEIGHTS;
+                        indices[i * NUM_WEIGHTS + w] = uchar((i + w * 7) % NUM_BONES);
+                    }
+                }
+
+                bones.resize(NUM_BONES);
+                blendMatrices.resize(NUM_BONES);
+                for (size_t b = 0; b < NUM_BONES; ++b)
+                {
+                    Quaternion q(Radian(b * 0.1f), Vector3::UNIT_Y);
+                    bones[b].makeTransform(Vector3(Real(b), 0, 0), Vector3::UNIT_SCALE, q);
+                    blendMatrices[b] = &bones[b];
+                }
+
+                matrices.assign(std::max<size_t>(1, n / 16), bones[1]);
+                matricesDst.resize(matrices.size());
+
+                for (size_t z = 0; z + 1 < side; ++z)
+                {
+                    for (size_t x = 0; x + 1 < side; ++x)
+                    {
+                        size_t v = z * side + x;
+                        if (v + side + 1 >= n)
+                            break;
+                        EdgeData::Triangle t;
+                        t.indexSet = t.vertexSet = 0;
+                        size_t quad[2][3] = {{v, v + side, v + 1}, {v + 1, v + side, v + side + 1}};
+                        for (auto& tri : quad)
+                        {
+                            for (int k = 0; k < 3; ++k)
+                                t.vertIndex[k] = t.sharedVertIndex[k] = tri[k];
+                            triangles.push_back(t);
+                        }
+                    }
+                }
+                faceNormals.resize(triangles.size());
+                lightFacings.resize(triangles.size());
+            }
+
+            void run(OptimisedUtil* impl, int kernel)
+            {
+                const Vector4 lightPos(10, 50, 10, 1);
+                switch (kernel)
+                {
+                case OptimisedUtil::BK_SOFTWARE_VERTEX_SKINNING:
+                    impl->softwareVertexSkinning(&posNorm[0], &posNormDst[0], &posNorm[3], &posNormDst[3],
+                                                 &weights[0], &indices[0], &blendMatrices[0],
+                                                 sizeof(float) * 6, sizeof(float) * 6,
+                                                 sizeof(float) * 6, sizeof(float) * 6,
+                                                 sizeof(float) * NUM_WEIGHTS, NUM_WEIGHTS,
+                                                 NUM_WEIGHTS, numVertices);
+                    break;
+                case OptimisedUtil::BK_SOFTWARE_VERTEX_MORPH:
+                    impl->softwareVertexMorph(0.5f, &pos1[0], &pos2[0], &posDst[0], sizeof(float) * 3,
+                                              sizeof(float) * 3, sizeof(float) * 3, numVertices, false);
+                    break;
+                case OptimisedUtil::BK_CONCATENATE_AFFINE_MATRICES:
+                    impl->concatenateAffineMatrices(bones[2], &matrices[0], &matricesDst[0], matrices.size());
+                    break;
+                case OptimisedUtil::BK_CALCULATE_FACE_NORMALS:
+                    impl->calculateFaceNormals(&pos1[0], triangles.data(), &faceNormals[0], triangles.size());
+                    break;
+                case OptimisedUtil::BK_CALCULATE_LIGHT_FACING:
+                    impl->calculateLightFacing(lightPos, &faceNormals[0], &lightFacings[0], faceNormals.size());
+                    break;
+                case OptimisedUtil::BK_EXTRUDE_VERTICES:
+                    impl->extrudeVertices(lightPos, 100, &pos1[0], &posDst[0], numVertices);
+                    break;
+                }
+            }
+
+            size_t numElements(int kernel) const
+            {
+                switch (kernel)
+                {
+                case OptimisedUtil::BK_CONCATENATE_AFFINE_MATRICES:
+                    return matrices.size();
+                case OptimisedUtil::BK_CALCULATE_FACE_NORMALS:
+                case OptimisedUtil::BK_CALCULATE_LIGHT_FACING:
+                    return triangles.size();
+                default:
+                    return numVertices;
+                }
+            }
+        };
+    }
+    //---------------------------------------------------------------------
+    std::vector<double> OptimisedUtil::benchmark(OptimisedUtil* impl, size_t numVertices, double minSeconds)
+    {
+        BenchmarkMesh mesh(std::max<size_t>(numVertices, 16));
+        std::vector<double> throughput(BK_COUNT);
+        Timer timer;
+        uint64 minMicroseconds = uint64(minSeconds * 1e6);
+
+        for (int k = 0; k < BK_COUNT; ++k)
+        {
+            // warm up the caches, then double the repetitions until the run is long enough
+            mesh.run(impl, k);
+            size_t reps = 1;
+            uint64 elapsed;
+            for (;;)
+            {
+                timer.reset();
+                for (size_t r = 0; r < reps; ++r)
+                    mesh.run(impl, k);
+                elapsed = timer.getMicroseconds();
+                if (elapsed >= minMicroseconds)
+                    break;
+                reps *= 2;
+            }
+            throughput[k] = double(mesh.numElements(k)) * reps * 1e6 / std::max<uint64>(elapsed, 1);
+        }
+        return throughput;
+    }
+    //---------------------------------------------------------------------
+    OptimisedUtil* OptimisedUtil::_selectFastestImplementation(void)
+    {
+        // the CPU does not change, measure only once per process
+        static OptimisedUtil* fastest = []()
+        {
+            const ImplementationList& impls = getAvailableImplementations();
+            if (impls.size() == 1)
+                return msImplementation;
+
+            // weigh the kernels equally, by the time they take on the same mesh
+            OptimisedUtil* best = msImplementation;
+            double bestTime = std::numeric_limits<double>::max();
+            for (const auto& impl : impls)
+            {
+                std::vector<double> throughput = benchmark(impl.second, 4096, 0.001);
+                double time = 0;
+                for (double t : throughput)
+                    time += 1 / t;
+                if (time < bestTime)
+                {
+                    bestTime = time;
+                    best = impl.second;
+                }
+            }
+            return best;
+        }();
+        msImplementation = fastest;
+        return fastest;
+    }
+
+    //---------------------------------------------------------------------
+    void OptimisedUtil::_runChunked(size_t numElements, const std::function<void(size_t, size_t)>& kernel)
+    {
+        WorkQueue* wq = msParallelThreshold && Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+        size_t numChunks = wq ? std::min(numElements / msParallelThreshold, wq->getWorkerThreadCount() + 1) : 1;
+        if (numChunks < 2)
+        {
+            kernel(0, numElements);
+            return;
+        }
 
-#endif  // __DO_PROFILE__
+        // multiples of 16 elements, so the SIMD loops of the chunks are not cut short
+        size_t chunkSize = ((numElements + numChunks - 1) / numChunks + 15) & ~size_t(15);
+        wq->runTasks(numChunks, [&kernel, numElements, chunkSize](size_t c) {
+            size_t begin = c * chunkSize, end = std::min(numElements, begin + chunkSize);
+            if (begin < end)
+                kernel(begin, end);
+        });
     }
 
 }
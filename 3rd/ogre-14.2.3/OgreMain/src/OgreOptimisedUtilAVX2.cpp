@@ -0,0 +1,496 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreOptimisedUtil.h"
+
+#if __OGRE_HAVE_AVX2
+
+#include <immintrin.h>
+
+// The build only enables SSE, the AVX2 and FMA instructions are enabled per function, so this file
+// stays loadable on CPUs without them, where _detectImplementation does not select it.
+#if OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG
+#define __OGRE_AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+#define __OGRE_AVX2_TARGET
+#endif
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+    extern OptimisedUtil* _getOptimisedUtilSSE(void);
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** AVX2 and FMA implementation of OptimisedUtil.
+
+        Processes 8 vertices, triangles or faces at a time, component-major. Morphing and matrix
+        concatenation use the SSE implementation.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilAVX2 : public OptimisedUtil
+    {
+        OptimisedUtil* mGeneral;
+        OptimisedUtil* mSSE;
+    public:
+        OptimisedUtilAVX2(void) : mGeneral(_getOptimisedUtilGeneral()), mSSE(_getOptimisedUtilSSE()) {}
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        void __OGRE_AVX2_TARGET softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Affine3* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        void softwareVertexMorph(
+            float t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals) override
+        {
+            mSSE->softwareVertexMorph(t, srcPos1, srcPos2, dstPos, pos1VSize, pos2VSize, dstVSize,
+                                      numVertices, morphNormals);
+        }
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        void concatenateAffineMatrices(
+            const Affine3& baseMatrix,
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override
+        {
+            mSSE->concatenateAffineMatrices(baseMatrix, srcMatrices, dstMatrices, numMatrices);
+        }
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        void __OGRE_AVX2_TARGET calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles) override;
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        void __OGRE_AVX2_TARGET calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces) override;
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        void __OGRE_AVX2_TARGET extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices) override;
+    };
+
+//-------------------------------------------------------------------------
+// Helpers
+//-------------------------------------------------------------------------
+
+    /// 4 floats from a in the low half, 4 floats from b in the high half
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m256 load2(const float* a, const float* b)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(a)), _mm_loadu_ps(b), 1);
+    }
+    //---------------------------------------------------------------------
+    /// x, y, z, 0 of a in the low half and of b in the high half, without reading past z
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m256 load2Vector3(const float* a, const float* b)
+    {
+        __m128 va = _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double*)a)), _mm_load_ss(a + 2));
+        __m128 vb = _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double*)b)), _mm_load_ss(b + 2));
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(va), vb, 1);
+    }
+    //---------------------------------------------------------------------
+    /// transpose the 4x4 matrices in the low halves and in the high halves of a, b, c and d
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void transpose4(__m256& a, __m256& b, __m256& c, __m256& d)
+    {
+        __m256 t0 = _mm256_unpacklo_ps(a, b), t1 = _mm256_unpacklo_ps(c, d);
+        __m256 t2 = _mm256_unpackhi_ps(a, b), t3 = _mm256_unpackhi_ps(c, d);
+        a = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+        b = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+        c = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        d = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    //---------------------------------------------------------------------
+    /// 1 / sqrt(v), refined by a Newton-Raphson step
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m256 rsqrt(__m256 v)
+    {
+        __m256 r = _mm256_rsqrt_ps(v);
+        // r * (1.5 - 0.5 * v * r * r)
+        __m256 halfVR = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), v), r);
+        return _mm256_mul_ps(r, _mm256_fnmadd_ps(halfVR, r, _mm256_set1_ps(1.5f)));
+    }
+    //---------------------------------------------------------------------
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void storeVector3(float* dst, __m128 v)
+    {
+        _mm_storel_pi((__m64*)dst, v);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(v, v));
+    }
+    //---------------------------------------------------------------------
+    /// store x, y, z of the low half to a, and of the high half to b
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void storeVector3x2(float* a, float* b, __m256 v)
+    {
+        storeVector3(a, _mm256_castps256_ps128(v));
+        storeVector3(b, _mm256_extractf128_ps(v, 1));
+    }
+    //---------------------------------------------------------------------
+    /// load 8 packed xyz vectors as x, y and z of 8 vectors
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void loadVector3x8(const float* src, __m256& x, __m256& y,
+                                                                  __m256& z)
+    {
+        __m256 m03 = load2(src, src + 12);
+        __m256 m14 = load2(src + 4, src + 16);
+        __m256 m25 = load2(src + 8, src + 20);
+
+        __m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+        __m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+        x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+        y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+        z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+    }
+    //---------------------------------------------------------------------
+    /// inverse of loadVector3x8
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void storeVector3x8(float* dst, __m256 x, __m256 y, __m256 z)
+    {
+        __m256 rxy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 ryz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+        __m256 rzx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+
+        __m256 r03 = _mm256_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 r14 = _mm256_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0));
+        __m256 r25 = _mm256_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1));
+
+        _mm_storeu_ps(dst, _mm256_castps256_ps128(r03));
+        _mm_storeu_ps(dst + 4, _mm256_castps256_ps128(r14));
+        _mm_storeu_ps(dst + 8, _mm256_castps256_ps128(r25));
+        _mm_storeu_ps(dst + 12, _mm256_extractf128_ps(r03, 1));
+        _mm_storeu_ps(dst + 16, _mm256_extractf128_ps(r14, 1));
+        _mm_storeu_ps(dst + 20, _mm256_extractf128_ps(r25, 1));
+    }
+
+//-------------------------------------------------------------------------
+// Implementation
+//-------------------------------------------------------------------------
+
+    void OptimisedUtilAVX2::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+
+        // Eight vertices per iteration, register k holds vertex k in the low half and k + 4 in the high half
+        size_t numIterations = numVertices / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m256 m0[4], m1[4], m2[4], pos[4], norm[4];
+            for (int k = 0; k < 4; ++k)
+            {
+                const float* pWeightA = rawOffsetPointer(pBlendWeight, k * blendWeightStride);
+                const float* pWeightB = rawOffsetPointer(pBlendWeight, (k + 4) * blendWeightStride);
+                const unsigned char* pIndexA = rawOffsetPointer(pBlendIndex, k * blendIndexStride);
+                const unsigned char* pIndexB = rawOffsetPointer(pBlendIndex, (k + 4) * blendIndexStride);
+
+                // Blend the matrix rows, like the SSE version the matrices of zero weights are read too
+                __m256 r0 = zero, r1 = zero, r2 = zero;
+                for (size_t w = 0; w < numWeightsPerVertex; ++w)
+                {
+                    const float* matA = (*blendMatrices[pIndexA[w]])[0];
+                    const float* matB = (*blendMatrices[pIndexB[w]])[0];
+                    __m256 weight = _mm256_blend_ps(_mm256_set1_ps(pWeightA[w]), _mm256_set1_ps(pWeightB[w]), 0xF0);
+                    r0 = _mm256_fmadd_ps(weight, load2(matA, matB), r0);
+                    r1 = _mm256_fmadd_ps(weight, load2(matA + 4, matB + 4), r1);
+                    r2 = _mm256_fmadd_ps(weight, load2(matA + 8, matB + 8), r2);
+                }
+                m0[k] = r0;
+                m1[k] = r1;
+                m2[k] = r2;
+
+                // Load everything before storing, positions and normals might share the buffer
+                pos[k] = load2Vector3(rawOffsetPointer(pSrcPos, k * srcPosStride),
+                                      rawOffsetPointer(pSrcPos, (k + 4) * srcPosStride));
+                if (pSrcNorm)
+                    norm[k] = load2Vector3(rawOffsetPointer(pSrcNorm, k * srcNormStride),
+                                           rawOffsetPointer(pSrcNorm, (k + 4) * srcNormStride));
+            }
+
+            // Component-major, m0[c] holds column c of row 0 of the eight matrices
+            transpose4(m0[0], m0[1], m0[2], m0[3]);
+            transpose4(m1[0], m1[1], m1[2], m1[3]);
+            transpose4(m2[0], m2[1], m2[2], m2[3]);
+            transpose4(pos[0], pos[1], pos[2], pos[3]);
+
+            __m256 x = _mm256_fmadd_ps(m0[0], pos[0], _mm256_fmadd_ps(m0[1], pos[1], _mm256_fmadd_ps(m0[2], pos[2], m0[3])));
+            __m256 y = _mm256_fmadd_ps(m1[0], pos[0], _mm256_fmadd_ps(m1[1], pos[1], _mm256_fmadd_ps(m1[2], pos[2], m1[3])));
+            __m256 z = _mm256_fmadd_ps(m2[0], pos[0], _mm256_fmadd_ps(m2[1], pos[1], _mm256_fmadd_ps(m2[2], pos[2], m2[3])));
+            __m256 w = zero;
+            transpose4(x, y, z, w);
+            storeVector3x2(pDestPos, rawOffsetPointer(pDestPos, 4 * destPosStride), x);
+            storeVector3x2(rawOffsetPointer(pDestPos, destPosStride), rawOffsetPointer(pDestPos, 5 * destPosStride), y);
+            storeVector3x2(rawOffsetPointer(pDestPos, 2 * destPosStride), rawOffsetPointer(pDestPos, 6 * destPosStride), z);
+            storeVector3x2(rawOffsetPointer(pDestPos, 3 * destPosStride), rawOffsetPointer(pDestPos, 7 * destPosStride), w);
+
+            if (pSrcNorm)
+            {
+                transpose4(norm[0], norm[1], norm[2], norm[3]);
+                x = _mm256_fmadd_ps(m0[0], norm[0], _mm256_fmadd_ps(m0[1], norm[1], _mm256_mul_ps(m0[2], norm[2])));
+                y = _mm256_fmadd_ps(m1[0], norm[0], _mm256_fmadd_ps(m1[1], norm[1], _mm256_mul_ps(m1[2], norm[2])));
+                z = _mm256_fmadd_ps(m2[0], norm[0], _mm256_fmadd_ps(m2[1], norm[1], _mm256_mul_ps(m2[2], norm[2])));
+
+                // Normalise, leaving zero vectors alone
+                __m256 length2 = _mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_mul_ps(z, z)));
+                __m256 scale = _mm256_and_ps(rsqrt(length2), _mm256_cmp_ps(length2, zero, _CMP_GT_OQ));
+                x = _mm256_mul_ps(x, scale);
+                y = _mm256_mul_ps(y, scale);
+                z = _mm256_mul_ps(z, scale);
+
+                w = zero;
+                transpose4(x, y, z, w);
+                storeVector3x2(pDestNorm, rawOffsetPointer(pDestNorm, 4 * destNormStride), x);
+                storeVector3x2(rawOffsetPointer(pDestNorm, destNormStride), rawOffsetPointer(pDestNorm, 5 * destNormStride), y);
+                storeVector3x2(rawOffsetPointer(pDestNorm, 2 * destNormStride), rawOffsetPointer(pDestNorm, 6 * destNormStride), z);
+                storeVector3x2(rawOffsetPointer(pDestNorm, 3 * destNormStride), rawOffsetPointer(pDestNorm, 7 * destNormStride), w);
+
+                advanceRawPointer(pSrcNorm, 8 * srcNormStride);
+                advanceRawPointer(pDestNorm, 8 * destNormStride);
+            }
+
+            advanceRawPointer(pSrcPos, 8 * srcPosStride);
+            advanceRawPointer(pDestPos, 8 * destPosStride);
+            advanceRawPointer(pBlendWeight, 8 * blendWeightStride);
+            advanceRawPointer(pBlendIndex, 8 * blendIndexStride);
+        }
+
+        // Less than eight vertices left
+        mGeneral->softwareVertexSkinning(pSrcPos, pDestPos, pSrcNorm, pDestNorm, pBlendWeight, pBlendIndex,
+                                         blendMatrices, srcPosStride, destPosStride, srcNormStride,
+                                         destNormStride, blendWeightStride, blendIndexStride,
+                                         numWeightsPerVertex, numVertices % 8);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        size_t i = 0;
+        for (; i + 8 <= numTriangles; i += 8)
+        {
+            // Gather the vertices of 8 triangles
+            __m256 x[3], y[3], z[3];
+            for (int v = 0; v < 3; ++v)
+            {
+                int offsets[8];
+                for (int k = 0; k < 8; ++k)
+                    offsets[k] = int(triangles[i + k].vertIndex[v] * 3);
+                __m256i idx = _mm256_loadu_si256((const __m256i*)offsets);
+                x[v] = _mm256_i32gather_ps(positions, idx, 4);
+                y[v] = _mm256_i32gather_ps(positions + 1, idx, 4);
+                z[v] = _mm256_i32gather_ps(positions + 2, idx, 4);
+            }
+
+            // normal = (v1 - v0) x (v2 - v0), w = -normal . v0
+            __m256 ax = _mm256_sub_ps(x[1], x[0]), ay = _mm256_sub_ps(y[1], y[0]), az = _mm256_sub_ps(z[1], z[0]);
+            __m256 bx = _mm256_sub_ps(x[2], x[0]), by = _mm256_sub_ps(y[2], y[0]), bz = _mm256_sub_ps(z[2], z[0]);
+            __m256 nx = _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by));
+            __m256 ny = _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz));
+            __m256 nz = _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx));
+            __m256 nw = _mm256_fmadd_ps(nx, x[0], _mm256_fmadd_ps(ny, y[0], _mm256_mul_ps(nz, z[0])));
+            nw = _mm256_sub_ps(_mm256_setzero_ps(), nw);
+
+            // Transpose to 8 Vector4, triangles 0-3 are in the low halves, 4-7 in the high halves
+            __m256 t0 = _mm256_unpacklo_ps(nx, ny);
+            __m256 t1 = _mm256_unpackhi_ps(nx, ny);
+            __m256 t2 = _mm256_unpacklo_ps(nz, nw);
+            __m256 t3 = _mm256_unpackhi_ps(nz, nw);
+            __m256 r04 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 r15 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 r26 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 r37 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+            float* dst = faceNormals[i].ptr();
+            _mm256_storeu_ps(dst, _mm256_permute2f128_ps(r04, r15, 0x20));
+            _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(r26, r37, 0x20));
+            _mm256_storeu_ps(dst + 16, _mm256_permute2f128_ps(r04, r15, 0x31));
+            _mm256_storeu_ps(dst + 24, _mm256_permute2f128_ps(r26, r37, 0x31));
+        }
+
+        for (; i < numTriangles; ++i)
+        {
+            const EdgeData::Triangle& t = triangles[i];
+            const float* v0 = positions + t.vertIndex[0] * 3;
+            const float* v1 = positions + t.vertIndex[1] * 3;
+            const float* v2 = positions + t.vertIndex[2] * 3;
+            faceNormals[i] = Math::calculateFaceNormalWithoutNormalize(
+                Vector3(v0[0], v0[1], v0[2]), Vector3(v1[0], v1[1], v1[2]), Vector3(v2[0], v2[1], v2[2]));
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        const __m256 light = _mm256_broadcast_ps((const __m128*)lightPos.ptr());
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256i one = _mm256_set1_epi32(1);
+
+        size_t i = 0;
+        for (; i + 8 <= numFaces; i += 8)
+        {
+            // faces 0 and 1 in n01, and so on
+            const float* n = faceNormals[i].ptr();
+            __m256 n01 = _mm256_mul_ps(_mm256_loadu_ps(n), light);
+            __m256 n23 = _mm256_mul_ps(_mm256_loadu_ps(n + 8), light);
+            __m256 n45 = _mm256_mul_ps(_mm256_loadu_ps(n + 16), light);
+            __m256 n67 = _mm256_mul_ps(_mm256_loadu_ps(n + 24), light);
+
+            // Horizontal add, faces 0, 2, 4, 6 in the low half, 1, 3, 5, 7 in the high half
+            __m256 t0 = _mm256_add_ps(_mm256_unpacklo_ps(n01, n23), _mm256_unpackhi_ps(n01, n23));
+            __m256 t1 = _mm256_add_ps(_mm256_unpacklo_ps(n45, n67), _mm256_unpackhi_ps(n45, n67));
+            __m256 dp = _mm256_add_ps(_mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0)),
+                                      _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2)));
+
+            // 0 or 1 per face, packed to bytes in order
+            __m256i facing = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(dp, zero, _CMP_GT_OQ)), one);
+            __m128i even = _mm256_castsi256_si128(facing), odd = _mm256_extracti128_si256(facing, 1);
+            __m128i words = _mm_packs_epi32(_mm_unpacklo_epi32(even, odd), _mm_unpackhi_epi32(even, odd));
+            _mm_storel_epi64((__m128i*)(lightFacings + i), _mm_packs_epi16(words, words));
+        }
+
+        for (; i < numFaces; ++i)
+        {
+            lightFacings[i] = (lightPos.dotProduct(faceNormals[i]) > 0);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        size_t i = 0;
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+            Vector3 extrusionDir(-lightPos.x, -lightPos.y, -lightPos.z);
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+
+            // 8 vertices are 3 registers, each starting at a different component
+            const float dx = extrusionDir.x, dy = extrusionDir.y, dz = extrusionDir.z;
+            const __m256 dir0 = _mm256_setr_ps(dx, dy, dz, dx, dy, dz, dx, dy);
+            const __m256 dir1 = _mm256_setr_ps(dz, dx, dy, dz, dx, dy, dz, dx);
+            const __m256 dir2 = _mm256_setr_ps(dy, dz, dx, dy, dz, dx, dy, dz);
+            for (; i + 8 <= numVertices; i += 8)
+            {
+                const float* src = pSrcPos + i * 3;
+                float* dst = pDestPos + i * 3;
+                _mm256_storeu_ps(dst, _mm256_add_ps(_mm256_loadu_ps(src), dir0));
+                _mm256_storeu_ps(dst + 8, _mm256_add_ps(_mm256_loadu_ps(src + 8), dir1));
+                _mm256_storeu_ps(dst + 16, _mm256_add_ps(_mm256_loadu_ps(src + 16), dir2));
+            }
+
+            for (i *= 3; i < numVertices * 3; ++i)
+                pDestPos[i] = pSrcPos[i] + extrusionDir[i % 3];
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            const __m256 lx = _mm256_set1_ps(lightPos.x);
+            const __m256 ly = _mm256_set1_ps(lightPos.y);
+            const __m256 lz = _mm256_set1_ps(lightPos.z);
+            const __m256 dist = _mm256_set1_ps(extrudeDist);
+            const __m256 zero = _mm256_setzero_ps();
+            for (; i + 8 <= numVertices; i += 8)
+            {
+                __m256 x, y, z;
+                loadVector3x8(pSrcPos + i * 3, x, y, z);
+
+                __m256 dx = _mm256_sub_ps(x, lx), dy = _mm256_sub_ps(y, ly), dz = _mm256_sub_ps(z, lz);
+                __m256 length2 = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+                // Normalise, leaving zero vectors alone
+                __m256 scale = _mm256_and_ps(_mm256_div_ps(dist, _mm256_sqrt_ps(length2)),
+                                             _mm256_cmp_ps(length2, zero, _CMP_GT_OQ));
+
+                storeVector3x8(pDestPos + i * 3, _mm256_fmadd_ps(dx, scale, x), _mm256_fmadd_ps(dy, scale, y),
+                               _mm256_fmadd_ps(dz, scale, z));
+            }
+
+            for (; i < numVertices; ++i)
+            {
+                const float* src = pSrcPos + i * 3;
+                float* dst = pDestPos + i * 3;
+                Vector3 extrusionDir(src[0] - lightPos.x, src[1] - lightPos.y, src[2] - lightPos.z);
+                extrusionDir.normalise();
+                extrusionDir *= extrudeDist;
+
+                dst[0] = src[0] + extrusionDir.x;
+                dst[1] = src[1] + extrusionDir.y;
+                dst[2] = src[2] + extrusionDir.z;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void)
+    {
+        static OptimisedUtilAVX2 msOptimisedUtilAVX2;
+        return &msOptimisedUtilAVX2;
+    }
+
+}
+
+#endif // __OGRE_HAVE_AVX2
@@ -0,0 +1,362 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreOptimisedUtil.h"
+
+#if __OGRE_HAVE_NEON
+
+#include <arm_neon.h>
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilSSE(void);
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** Native NEON implementation of OptimisedUtil.
+
+        Uses the structure loads and stores of NEON to process 4 triangles, 8 faces or 4 vertices at
+        a time, instead of the SSE shuffles translated by SSE2NEON. Morphing and matrix concatenation
+        use the SSE implementation.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilNEON : public OptimisedUtil
+    {
+        OptimisedUtil* mSSE;
+    public:
+        OptimisedUtilNEON(void) : mSSE(_getOptimisedUtilSSE()) {}
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        void softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Affine3* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        void softwareVertexMorph(
+            float t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals) override
+        {
+            mSSE->softwareVertexMorph(t, srcPos1, srcPos2, dstPos, pos1VSize, pos2VSize, dstVSize,
+                                      numVertices, morphNormals);
+        }
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        void concatenateAffineMatrices(
+            const Affine3& baseMatrix,
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override
+        {
+            mSSE->concatenateAffineMatrices(baseMatrix, srcMatrices, dstMatrices, numMatrices);
+        }
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        void calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles) override;
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces) override;
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices) override;
+    };
+
+//-------------------------------------------------------------------------
+// Helpers
+//-------------------------------------------------------------------------
+
+    /// sum of the components of a * b
+    static OGRE_FORCE_INLINE float dot4(float32x4_t a, float32x4_t b)
+    {
+        float32x4_t p = vmulq_f32(a, b);
+        float32x2_t s = vpadd_f32(vget_low_f32(p), vget_high_f32(p));
+        return vget_lane_f32(vpadd_f32(s, s), 0);
+    }
+    //---------------------------------------------------------------------
+    /// dist / sqrt(length2), or 0 where length2 is 0, with two Newton-Raphson steps
+    static OGRE_FORCE_INLINE float32x4_t scaleToLength(float32x4_t length2, float32x4_t dist)
+    {
+        float32x4_t r = vrsqrteq_f32(length2);
+        r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(length2, r), r));
+        r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(length2, r), r));
+        uint32x4_t nonZero = vcgtq_f32(length2, vdupq_n_f32(0));
+        return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(r, dist)), nonZero));
+    }
+
+//-------------------------------------------------------------------------
+// Implementation
+//-------------------------------------------------------------------------
+
+    void OptimisedUtilNEON::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        for (size_t vertIdx = 0; vertIdx < numVertices; ++vertIdx)
+        {
+            // Blend the matrix rows
+            float32x4_t m0 = vdupq_n_f32(0), m1 = m0, m2 = m0;
+            for (size_t blendIdx = 0; blendIdx < numWeightsPerVertex; ++blendIdx)
+            {
+                float weight = pBlendWeight[blendIdx];
+                if (weight)
+                {
+                    const float* mat = (*blendMatrices[pBlendIndex[blendIdx]])[0];
+                    m0 = vmlaq_n_f32(m0, vld1q_f32(mat), weight);
+                    m1 = vmlaq_n_f32(m1, vld1q_f32(mat + 4), weight);
+                    m2 = vmlaq_n_f32(m2, vld1q_f32(mat + 8), weight);
+                }
+            }
+
+            // Load both before storing, positions and normals might share the buffer
+            float32x4_t pos = {pSrcPos[0], pSrcPos[1], pSrcPos[2], 1.0f};
+            if (pSrcNorm)
+            {
+                float32x4_t norm = {pSrcNorm[0], pSrcNorm[1], pSrcNorm[2], 0.0f};
+
+                pDestPos[0] = dot4(m0, pos);
+                pDestPos[1] = dot4(m1, pos);
+                pDestPos[2] = dot4(m2, pos);
+
+                Vector3 n(dot4(m0, norm), dot4(m1, norm), dot4(m2, norm));
+                n.normalise();
+                pDestNorm[0] = n.x;
+                pDestNorm[1] = n.y;
+                pDestNorm[2] = n.z;
+
+                advanceRawPointer(pSrcNorm, srcNormStride);
+                advanceRawPointer(pDestNorm, destNormStride);
+            }
+            else
+            {
+                pDestPos[0] = dot4(m0, pos);
+                pDestPos[1] = dot4(m1, pos);
+                pDestPos[2] = dot4(m2, pos);
+            }
+
+            advanceRawPointer(pSrcPos, srcPosStride);
+            advanceRawPointer(pDestPos, destPosStride);
+            advanceRawPointer(pBlendWeight, blendWeightStride);
+            advanceRawPointer(pBlendIndex, blendIndexStride);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        size_t i = 0;
+        for (; i + 4 <= numTriangles; i += 4)
+        {
+            // Gather the vertices of 4 triangles, one lane each
+            float32x4x3_t v[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                v[k].val[0] = v[k].val[1] = v[k].val[2] = vdupq_n_f32(0);
+                v[k] = vld3q_lane_f32(positions + triangles[i + 0].vertIndex[k] * 3, v[k], 0);
+                v[k] = vld3q_lane_f32(positions + triangles[i + 1].vertIndex[k] * 3, v[k], 1);
+                v[k] = vld3q_lane_f32(positions + triangles[i + 2].vertIndex[k] * 3, v[k], 2);
+                v[k] = vld3q_lane_f32(positions + triangles[i + 3].vertIndex[k] * 3, v[k], 3);
+            }
+
+            // normal = (v1 - v0) x (v2 - v0), w = -normal . v0
+            float32x4_t ax = vsubq_f32(v[1].val[0], v[0].val[0]);
+            float32x4_t ay = vsubq_f32(v[1].val[1], v[0].val[1]);
+            float32x4_t az = vsubq_f32(v[1].val[2], v[0].val[2]);
+            float32x4_t bx = vsubq_f32(v[2].val[0], v[0].val[0]);
+            float32x4_t by = vsubq_f32(v[2].val[1], v[0].val[1]);
+            float32x4_t bz = vsubq_f32(v[2].val[2], v[0].val[2]);
+
+            float32x4x4_t n;
+            n.val[0] = vmlsq_f32(vmulq_f32(ay, bz), az, by);
+            n.val[1] = vmlsq_f32(vmulq_f32(az, bx), ax, bz);
+            n.val[2] = vmlsq_f32(vmulq_f32(ax, by), ay, bx);
+            float32x4_t d = vmulq_f32(n.val[0], v[0].val[0]);
+            d = vmlaq_f32(d, n.val[1], v[0].val[1]);
+            d = vmlaq_f32(d, n.val[2], v[0].val[2]);
+            n.val[3] = vnegq_f32(d);
+
+            // Interleaved store gives 4 Vector4
+            vst4q_f32(faceNormals[i].ptr(), n);
+        }
+
+        for (; i < numTriangles; ++i)
+        {
+            const EdgeData::Triangle& t = triangles[i];
+            const float* v0 = positions + t.vertIndex[0] * 3;
+            const float* v1 = positions + t.vertIndex[1] * 3;
+            const float* v2 = positions + t.vertIndex[2] * 3;
+            faceNormals[i] = Math::calculateFaceNormalWithoutNormalize(
+                Vector3(v0[0], v0[1], v0[2]), Vector3(v1[0], v1[1], v1[2]), Vector3(v2[0], v2[1], v2[2]));
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        const float32x4_t zero = vdupq_n_f32(0);
+
+        size_t i = 0;
+        for (; i + 8 <= numFaces; i += 8)
+        {
+            // Deinterleaving loads give x, y, z and w of 4 faces
+            float32x4x4_t n0 = vld4q_f32(faceNormals[i].ptr());
+            float32x4x4_t n1 = vld4q_f32(faceNormals[i + 4].ptr());
+
+            float32x4_t d0 = vmulq_n_f32(n0.val[0], lightPos.x);
+            d0 = vmlaq_n_f32(d0, n0.val[1], lightPos.y);
+            d0 = vmlaq_n_f32(d0, n0.val[2], lightPos.z);
+            d0 = vmlaq_n_f32(d0, n0.val[3], lightPos.w);
+            float32x4_t d1 = vmulq_n_f32(n1.val[0], lightPos.x);
+            d1 = vmlaq_n_f32(d1, n1.val[1], lightPos.y);
+            d1 = vmlaq_n_f32(d1, n1.val[2], lightPos.z);
+            d1 = vmlaq_n_f32(d1, n1.val[3], lightPos.w);
+
+            // Narrow the masks to bytes of 0 or 1
+            uint16x8_t mask = vcombine_u16(vmovn_u32(vcgtq_f32(d0, zero)), vmovn_u32(vcgtq_f32(d1, zero)));
+            vst1_u8((uint8_t*)lightFacings + i, vand_u8(vmovn_u16(mask), vdup_n_u8(1)));
+        }
+
+        for (; i < numFaces; ++i)
+        {
+            lightFacings[i] = (lightPos.dotProduct(faceNormals[i]) > 0);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        size_t i = 0;
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+            Vector3 extrusionDir(-lightPos.x, -lightPos.y, -lightPos.z);
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+
+            for (; i + 4 <= numVertices; i += 4)
+            {
+                float32x4x3_t v = vld3q_f32(pSrcPos + i * 3);
+                v.val[0] = vaddq_f32(v.val[0], vdupq_n_f32(extrusionDir.x));
+                v.val[1] = vaddq_f32(v.val[1], vdupq_n_f32(extrusionDir.y));
+                v.val[2] = vaddq_f32(v.val[2], vdupq_n_f32(extrusionDir.z));
+                vst3q_f32(pDestPos + i * 3, v);
+            }
+
+            for (i *= 3; i < numVertices * 3; ++i)
+                pDestPos[i] = pSrcPos[i] + extrusionDir[i % 3];
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            const float32x4_t dist = vdupq_n_f32(extrudeDist);
+            for (; i + 4 <= numVertices; i += 4)
+            {
+                float32x4x3_t v = vld3q_f32(pSrcPos + i * 3);
+                float32x4_t dx = vsubq_f32(v.val[0], vdupq_n_f32(lightPos.x));
+                float32x4_t dy = vsubq_f32(v.val[1], vdupq_n_f32(lightPos.y));
+                float32x4_t dz = vsubq_f32(v.val[2], vdupq_n_f32(lightPos.z));
+                float32x4_t length2 = vmlaq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz);
+                float32x4_t scale = scaleToLength(length2, dist);
+
+                v.val[0] = vmlaq_f32(v.val[0], dx, scale);
+                v.val[1] = vmlaq_f32(v.val[1], dy, scale);
+                v.val[2] = vmlaq_f32(v.val[2], dz, scale);
+                vst3q_f32(pDestPos + i * 3, v);
+            }
+
+            for (; i < numVertices; ++i)
+            {
+                const float* src = pSrcPos + i * 3;
+                float* dst = pDestPos + i * 3;
+                Vector3 extrusionDir(src[0] - lightPos.x, src[1] - lightPos.y, src[2] - lightPos.z);
+                extrusionDir.normalise();
+                extrusionDir *= extrudeDist;
+
+                dst[0] = src[0] + extrusionDir.x;
+                dst[1] = src[1] + extrusionDir.y;
+                dst[2] = src[2] + extrusionDir.z;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilNEON(void);
+    extern OptimisedUtil* _getOptimisedUtilNEON(void)
+    {
+        static OptimisedUtilNEON msOptimisedUtilNEON;
+        return &msOptimisedUtilNEON;
+    }
+
+}
+
+#endif // __OGRE_HAVE_NEON
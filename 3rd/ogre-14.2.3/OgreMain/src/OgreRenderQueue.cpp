@@ -41,7 +41,9 @@ namespace Ogre {
         : mSplitPassesByLightingType(false)
         , mSplitNoShadowPasses(false)
         , mShadowCastersCannotBeReceivers(false)
+        , mRetainedSorting(false)
         , mRenderableListener(0)
+        , mRecording(0)
     {
         // Create the 'main' queue up-front since we'll always need that
         mGroups[RENDER_QUEUE_MAIN] = std::make_unique<RenderQueueGroup>(
@@ -78,6 +80,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RenderQueue::addRenderable(Renderable* pRend, uint8 groupID, ushort priority)
     {
+        if (mRecording)
+        {
+            mRecording->push_back({pRend, groupID, priority});
+            return;
+        }
+
         Technique* pTech;
 
         // tell material it's been used
@@ -183,6 +191,8 @@ namespace Ogre {
             // Insert new
             mGroups[groupID] = std::make_unique<RenderQueueGroup>(mSplitPassesByLightingType, mSplitNoShadowPasses,
                                                         mShadowCastersCannotBeReceivers);
+            if (mRetainedSorting)
+                mGroups[groupID]->setRetainedSortingEnabled(true);
         }
 
         return mGroups[groupID].get();
@@ -237,6 +247,47 @@ namespace Ogre {
         return mShadowCastersCannotBeReceivers;
     }
     //-----------------------------------------------------------------------
+    void RenderQueue::setRetainedSortingEnabled(bool enabled)
+    {
+        mRetainedSorting = enabled;
+
+        for (auto & g : mGroups)
+        {
+            if(g)
+                g->setRetainedSortingEnabled(enabled);
+        }
+    }
+    //-----------------------------------------------------------------------
+    RenderQueue::RetainedSortStats RenderQueue::getRetainedSortStats(void) const
+    {
+        RetainedSortStats stats;
+        for (auto & g : mGroups)
+        {
+            if(!g)
+                continue;
+
+            for (const auto& pg : g->getPriorityGroups())
+                pg.second->_addRetainedSortStats(stats);
+        }
+        return stats;
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::_setRecording(const RenderQueue* source, RecordedRenderableList* list)
+    {
+        mRecording = list;
+        if (!source)
+            return;
+
+        mDefaultQueueGroup = source->mDefaultQueueGroup;
+        mDefaultRenderablePriority = source->mDefaultRenderablePriority;
+        for (size_t i = 0; i < RENDER_QUEUE_COUNT; ++i)
+        {
+            // missing groups have shadows enabled once created
+            if (source->mGroups[i] || mGroups[i])
+                getQueueGroup(i)->setShadowsEnabled(!source->mGroups[i] || source->mGroups[i]->getShadowsEnabled());
+        }
+    }
+    //-----------------------------------------------------------------------
     void RenderQueue::merge( const RenderQueue* rhs )
     {
         for (size_t i = 0; i < RENDER_QUEUE_COUNT; ++i)
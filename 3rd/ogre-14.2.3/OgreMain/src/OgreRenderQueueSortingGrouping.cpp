@@ -93,6 +93,21 @@ namespace {
             return static_cast<float>(- p.renderable->getSquaredViewDepth(camera));
         }
     };
+
+    /// How far ahead in queue order an item of the previous sort is looked for
+    const size_t RETAINED_SEARCH_WINDOW = 64;
+    const uint32 RETAINED_NONE = ~uint32(0);
+
+    /// Radix sort key of the descending depth first and the pass hash second
+    uint64 getRetainedSortKey(const RenderablePass& rp, const Camera* cam)
+    {
+        // same value as RadixSortFunctorDistance, with its bits flipped so it orders as an unsigned integer
+        float depth = static_cast<float>(-rp.renderable->getSquaredViewDepth(cam));
+        uint32 bits;
+        memcpy(&bits, &depth, sizeof(bits));
+        bits ^= (bits >> 31) ? 0xFFFFFFFF : 0x80000000;
+        return (uint64(bits) << 32) | rp.pass->getHash();
+    }
 }
     //-----------------------------------------------------------------------
     RenderPriorityGroup::RenderPriorityGroup(RenderQueueGroup* parent, 
@@ -290,8 +305,28 @@ namespace {
         mTransparents.merge( rhs->mTransparents );
     }
     //-----------------------------------------------------------------------
+    void RenderPriorityGroup::setRetainedSortingEnabled(bool enabled)
+    {
+        mSolidsBasic.setRetainedSortingEnabled(enabled);
+        mSolidsDecal.setRetainedSortingEnabled(enabled);
+        mSolidsDiffuseSpecular.setRetainedSortingEnabled(enabled);
+        mSolidsNoShadowReceive.setRetainedSortingEnabled(enabled);
+        mTransparentsUnsorted.setRetainedSortingEnabled(enabled);
+        mTransparents.setRetainedSortingEnabled(enabled);
+    }
+    //-----------------------------------------------------------------------
+    void RenderPriorityGroup::_addRetainedSortStats(RenderQueue::RetainedSortStats& stats) const
+    {
+        stats += mSolidsBasic.getRetainedSortStats();
+        stats += mSolidsDecal.getRetainedSortStats();
+        stats += mSolidsDiffuseSpecular.getRetainedSortStats();
+        stats += mSolidsNoShadowReceive.getRetainedSortStats();
+        stats += mTransparentsUnsorted.getRetainedSortStats();
+        stats += mTransparents.getRetainedSortStats();
+    }
+    //-----------------------------------------------------------------------
     QueuedRenderableCollection::QueuedRenderableCollection(void)
-        :mOrganisationMode(0)
+        :mOrganisationMode(0), mRetainedSorting(false), mQueueChanged(true), mRetainedCamera(NULL)
     {
     }
 
@@ -306,6 +341,7 @@ namespace {
 
         // Clear sorted list
         mSortedDescending.clear();
+        mQueueChanged = true;
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::removePassGroup(Pass* p)
@@ -330,7 +366,11 @@ namespace {
         // ascending and descending sort both set bit 1
         // We always sort descending, because the only difference is in the
         // acceptVisitor method, where we iterate in reverse in ascending mode
-        if (mOrganisationMode & OM_SORT_DESCENDING)
+        if ((mOrganisationMode & OM_SORT_DESCENDING) && mRetainedSorting)
+        {
+            sortRetained(cam);
+        }
+        else if (mOrganisationMode & OM_SORT_DESCENDING)
         {
             
             // We can either use a stable_sort and the 'less' implementation,
@@ -363,12 +403,199 @@ namespace {
 
     }
     //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::setRetainedSortingEnabled(bool enabled)
+    {
+        mRetainedSorting = enabled;
+        mRetainedCamera = NULL;
+        mQueueChanged = true;
+        mRetainedItems.clear();
+        mRetainedSorted.clear();
+    }
+    //-----------------------------------------------------------------------
+    bool QueuedRenderableCollection::diffRetained(size_t maxChanges, RenderQueue::RetainedSortStats& stats)
+    {
+        const RetainedItemList& prev = mRetainedItems;
+        const RetainedItemList& cur = mQueuedItems;
+        size_t numPrev = prev.size(), numCur = cur.size();
+
+        mNewIndex.assign(numPrev, RETAINED_NONE);
+        mChangedItems.clear();
+
+        auto same = [](const RetainedItem& a, const RetainedItem& b) {
+            return a.rp.renderable == b.rp.renderable && a.rp.pass == b.rp.pass;
+        };
+
+        // the queue order of a static scene does not change, so walk both in step and only search
+        // a little ahead where items were added or removed
+        size_t i = 0, j = 0;
+        while (i < numPrev || j < numCur)
+        {
+            if (i < numPrev && j < numCur && same(prev[i], cur[j]))
+            {
+                if (prev[i].key == cur[j].key)
+                {
+                    mNewIndex[i] = uint32(j);
+                    stats.reused++;
+                }
+                else
+                {
+                    mChangedItems.push_back(uint32(j));
+                    stats.moved++;
+                }
+                i++;
+                j++;
+            }
+            else
+            {
+                size_t numRemoved = 0, numAdded = 0;
+                for (size_t k = 1; j < numCur && k <= RETAINED_SEARCH_WINDOW && i + k < numPrev; k++)
+                {
+                    if (same(prev[i + k], cur[j]))
+                    {
+                        numRemoved = k;
+                        break;
+                    }
+                }
+                for (size_t k = 1; i < numPrev && k <= RETAINED_SEARCH_WINDOW && j + k < numCur; k++)
+                {
+                    if (same(prev[i], cur[j + k]))
+                    {
+                        numAdded = k;
+                        break;
+                    }
+                }
+
+                if (numRemoved && (!numAdded || numRemoved <= numAdded))
+                {
+                    stats.removed += numRemoved;
+                    i += numRemoved;
+                }
+                else if (numAdded)
+                {
+                    for (size_t k = 0; k < numAdded; k++)
+                        mChangedItems.push_back(uint32(j + k));
+                    stats.inserted += numAdded;
+                    j += numAdded;
+                }
+                else
+                {
+                    // replaced, or out of reach
+                    if (i < numPrev)
+                    {
+                        stats.removed++;
+                        i++;
+                    }
+                    if (j < numCur)
+                    {
+                        mChangedItems.push_back(uint32(j));
+                        stats.inserted++;
+                        j++;
+                    }
+                }
+            }
+
+            if (stats.inserted + stats.moved + stats.removed > maxChanges)
+                return false;
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::sortRetained(const Camera* cam)
+    {
+        /// Radix sorter for the order of the retained items
+        static RadixSort<std::vector<uint32>, uint32, uint32> msRadixSorter;
+
+        // the list is still sorted for this camera
+        if (!mQueueChanged && cam == mRetainedCamera)
+            return;
+        mQueueChanged = false;
+
+        mQueuedItems.clear();
+        mQueuedItems.reserve(mSortedDescending.size());
+        for (const auto& rp : mSortedDescending)
+        {
+            mQueuedItems.push_back(RetainedItem(getRetainedSortKey(rp, cam), rp, uint32(mQueuedItems.size())));
+        }
+
+        const RetainedItemList& items = mQueuedItems;
+        auto keyLess = [&items](uint32 a, uint32 b) {
+            return items[a].key < items[b].key || (items[a].key == items[b].key && a < b);
+        };
+
+        mMergedItems.clear();
+        mMergedItems.reserve(items.size());
+
+        RenderQueue::RetainedSortStats stats;
+        size_t maxChanges = std::max(items.size(), mRetainedItems.size()) / 4;
+        if (cam == mRetainedCamera && diffRetained(maxChanges, stats))
+        {
+            // merge the changed items into the previous order of the others, which kept their keys
+            std::sort(mChangedItems.begin(), mChangedItems.end(), keyLess);
+
+            auto changed = mChangedItems.begin();
+            for (const auto& prev : mRetainedSorted)
+            {
+                uint32 i = mNewIndex[prev.index];
+                if (i == RETAINED_NONE)
+                    continue;
+
+                while (changed != mChangedItems.end() && items[*changed].key < prev.key)
+                {
+                    mMergedItems.push_back(items[*changed]);
+                    ++changed;
+                }
+                mMergedItems.push_back(RetainedItem(prev.key, prev.rp, i));
+            }
+            for (; changed != mChangedItems.end(); ++changed)
+                mMergedItems.push_back(items[*changed]);
+
+            stats.deltaSorts = 1;
+        }
+        else
+        {
+            stats = RenderQueue::RetainedSortStats();
+            stats.fullSorts = 1;
+            stats.fullSortItems = items.size();
+
+            mChangedItems.resize(items.size());
+            for (size_t i = 0; i < items.size(); i++)
+                mChangedItems[i] = uint32(i);
+
+            // same tipping point as sort
+            if (items.size() > 2000)
+            {
+                // by pass hash, then by depth
+                msRadixSorter.sort(mChangedItems, [&items](uint32 i) { return uint32(items[i].key); });
+                msRadixSorter.sort(mChangedItems, [&items](uint32 i) { return uint32(items[i].key >> 32); });
+            }
+            else
+            {
+                std::sort(mChangedItems.begin(), mChangedItems.end(), keyLess);
+            }
+
+            for (uint32 i : mChangedItems)
+                mMergedItems.push_back(items[i]);
+        }
+
+        mRetainedItems.swap(mQueuedItems);
+        mRetainedSorted.swap(mMergedItems);
+        mRetainedCamera = cam;
+        mRetainedStats += stats;
+
+        for (size_t k = 0; k < mRetainedSorted.size(); k++)
+        {
+            mSortedDescending[k] = mRetainedSorted[k].rp;
+        }
+    }
+    //-----------------------------------------------------------------------
     void QueuedRenderableCollection::addRenderable(Pass* pass, Renderable* rend)
     {
         // ascending and descending sort both set bit 1
         if (mOrganisationMode & OM_SORT_DESCENDING)
         {
             mSortedDescending.push_back(RenderablePass(rend, pass));
+            mQueueChanged = true;
         }
 
         if (mOrganisationMode & OM_PASS_GROUP)
@@ -460,6 +687,7 @@ namespace {
     void QueuedRenderableCollection::merge( const QueuedRenderableCollection& rhs )
     {
         mSortedDescending.insert( mSortedDescending.end(), rhs.mSortedDescending.begin(), rhs.mSortedDescending.end() );
+        mQueueChanged = true;
 
         for (const auto& srcGroup : rhs.mGrouped)
         {
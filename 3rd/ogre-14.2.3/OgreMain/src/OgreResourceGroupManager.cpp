@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreScriptLoader.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre {
 
@@ -55,7 +56,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mCurrentGroup(0), mParallelLoading(false)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME, true); // the "General" group is synonymous to global pool
@@ -151,6 +152,17 @@ namespace Ogre {
         LogManager::getSingleton().stream() << "Preparing resource group '" << name << "'";
         // load all created resources
         ResourceGroup* grp = getResourceGroup(name, true);
+        if (mParallelLoading)
+        {
+            // the loop below then only fires the events of resources prepared already
+            std::vector<ResourcePtr> resources;
+            {
+                OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+                for (auto& oi : grp->loadResourceOrderMap)
+                    resources.insert(resources.end(), oi.second.begin(), oi.second.end());
+            }
+            prepareConcurrently(resources);
+        }
         OGRE_LOCK_AUTO_MUTEX;
         OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex 
         // Set current group
@@ -215,6 +227,17 @@ namespace Ogre {
         LogManager::getSingleton().stream() << "Loading resource group '" << name << "'";
         // load all created resources
         ResourceGroup* grp = getResourceGroup(name, true);
+        if (mParallelLoading)
+        {
+            // the loop below then mostly uploads what was read and decoded on the workers
+            std::vector<ResourcePtr> resources;
+            {
+                OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+                for (auto& oi : grp->loadResourceOrderMap)
+                    resources.insert(resources.end(), oi.second.begin(), oi.second.end());
+            }
+            prepareConcurrently(resources);
+        }
         OGRE_LOCK_AUTO_MUTEX;
         OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex 
         // Set current group
@@ -277,6 +300,104 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("Finished loading resource group " + name);
     }
     //-----------------------------------------------------------------------
+    void ResourceGroupManager::loadResources(const std::vector<ResourcePtr>& resources)
+    {
+        std::set<Resource*> visited;
+        std::vector<ResourcePtr> wave;
+        for (auto& r : resources)
+        {
+            if (r && visited.insert(r.get()).second)
+                wave.push_back(r);
+        }
+
+        std::vector<ResourcePtr> dependencies;
+        while (!wave.empty())
+        {
+            if (mParallelLoading)
+                prepareConcurrently(wave);
+
+            dependencies.clear();
+            for (auto& r : wave)
+            {
+                r->load();
+                r->_getDependencies(dependencies);
+            }
+
+            wave.clear();
+            for (auto& r : dependencies)
+            {
+                if (r && !r->isLoaded() && visited.insert(r.get()).second)
+                    wave.push_back(r);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::setParallelLoadingEnabled(bool enabled)
+    {
+#if OGRE_THREAD_SUPPORT != 1 && OGRE_THREAD_SUPPORT != 2
+        // the resource mutexes are compiled out
+        if (enabled)
+            LogManager::getSingleton().logWarning("parallel loading requires OGRE_THREAD_SUPPORT 1 or 2");
+        enabled = false;
+#endif
+        mParallelLoading = enabled;
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::prepareConcurrently(const std::vector<ResourcePtr>& resources)
+    {
+        WorkQueue* wq = Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+        if (!wq)
+            return;
+
+        // walk the known dependencies, e.g. material -> texture, the leaves get prepared
+        std::set<Resource*> visited;
+        std::vector<ResourcePtr> pending(resources.rbegin(), resources.rend());
+        std::vector<ResourcePtr> tasks;
+        while (!pending.empty())
+        {
+            ResourcePtr r = pending.back();
+            pending.pop_back();
+            if (!r || !visited.insert(r.get()).second)
+                continue;
+
+            Resource::LoadingState state = r->getLoadingState();
+            if (state == Resource::LOADSTATE_PREPARED || state == Resource::LOADSTATE_LOADED)
+                continue;
+
+            // resources still looking for their group move between groups while they are opened
+            if (r->getCreator() && r->getCreator()->getPrepareConcurrently() &&
+                r->getGroup() != AUTODETECT_RESOURCE_GROUP_NAME)
+                tasks.push_back(r);
+            else
+                r->_getDependencies(pending);
+        }
+
+        // the Log is not safe to use from the workers, the errors are reported below
+        std::vector<String> errors(tasks.size());
+        wq->runTasks(tasks.size(), [&tasks, &errors](size_t i) {
+            try
+            {
+                tasks[i]->prepare();
+            }
+            catch (const std::exception& e)
+            {
+                errors[i] = e.what();
+            }
+            catch (...)
+            {
+                errors[i] = "unknown error";
+            }
+        });
+
+        for (size_t i = 0; i < tasks.size(); i++)
+        {
+            // it is prepared again when loaded, which throws on the calling thread
+            if (!errors[i].empty())
+                LogManager::getSingleton().logWarning("preparing '" + tasks[i]->getName() +
+                                                      "' concurrently failed: " + errors[i]);
+        }
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::unloadResourceGroup(const String& name, bool reloadableOnly)
     {
         LogManager::getSingleton().logMessage("Unloading resource group " + name);
@@ -1375,6 +1496,21 @@ namespace Ogre {
         return 0;
     }
     //-----------------------------------------------------------------------
+    Archive* ResourceGroupManager::_getArchiveToResource(const String& resourceName, const String& groupName,
+                                                         bool searchGroupsIfNotFound) const
+    {
+        if (ResourceGroup* grp = getResourceGroup(groupName))
+        {
+            if (Archive* arch = resourceExists(grp, resourceName))
+                return arch;
+        }
+
+        if (searchGroupsIfNotFound)
+            return resourceExistsInAnyGroupImpl(resourceName).first;
+
+        return NULL;
+    }
+    //-----------------------------------------------------------------------
     std::pair<Archive*, ResourceGroupManager::ResourceGroup*>
     ResourceGroupManager::resourceExistsInAnyGroupImpl(const String& filename) const
     {
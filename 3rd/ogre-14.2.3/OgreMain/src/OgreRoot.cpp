@@ -46,8 +46,10 @@ THE SOFTWARE.
 #include "OgreBillboardChain.h"
 #include "OgreRibbonTrail.h"
 #include "OgreConvexBody.h"
+#include "OgreOptimisedUtil.h"
 #include "OgreTimer.h"
 #include "OgreFrameListener.h"
+#include "OgreFrameAllocator.h"
 #include "OgreLodStrategyManager.h"
 #include "OgreFileSystemLayer.h"
 #include "OgreStaticGeometry.h"
@@ -155,6 +157,8 @@ namespace Ogre {
         defaultQ->setWorkersCanAccessRenderSystem(OGRE_THREAD_SUPPORT == 1);
         mWorkQueue.reset(defaultQ);
 
+        mFrameAllocator = std::make_unique<FrameAllocator>();
+
         // ResourceBackgroundQueue
         mResourceBackgroundQueue = std::make_unique<ResourceBackgroundQueue>();
 
@@ -527,6 +531,15 @@ namespace Ogre {
             mControllerManager = std::make_unique<ControllerManager>();
 
         PlatformInformation::log(LogManager::getSingleton().getDefaultLog());
+
+        // chosen by the CPU features, _selectFastestImplementation would measure them instead
+        OptimisedUtil* optimisedUtil = OptimisedUtil::getImplementation();
+        for (const auto& impl : OptimisedUtil::getAvailableImplementations())
+        {
+            if (impl.second == optimisedUtil)
+                LogManager::getSingleton().logMessage("OptimisedUtil: using the " + impl.first +
+                                                      " implementation");
+        }
         mActiveRenderer->_initialise();
 
         // Initialise timer
@@ -682,6 +695,10 @@ namespace Ogre {
         // Tell the queue to process responses
         mWorkQueue->processMainThreadTasks();
 
+        // Release the temporaries of this frame
+        mFrameAllocator->reset();
+        CategoryAllocator::_frameEnded();
+
         OgreProfileEndGroup("Frame", OGREPROF_GENERAL);
 
         return ret;
@@ -1286,4 +1303,10 @@ namespace Ogre {
 
         }
     }
+    //---------------------------------------------------------------------
+    void Root::setFrameAllocator(FrameAllocator* arena)
+    {
+        OgreAssert(arena, "arena must not be NULL");
+        mFrameAllocator.reset(arena);
+    }
 }
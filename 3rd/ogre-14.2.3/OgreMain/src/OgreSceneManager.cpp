@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 
 #include "OgreEntity.h"
+#include "OgreFrameAllocator.h"
 #include "OgreControllerManager.h"
 #include "OgreAnimation.h"
 #include "OgreRenderObjectListener.h"
@@ -44,6 +45,9 @@ THE SOFTWARE.
 #include "OgreRenderTexture.h"
 #include "OgreLodListener.h"
 #include "OgreDefaultDebugDrawer.h"
+#include "OgreTransformHierarchy.h"
+#include "OgreVisibilityCuller.h"
+#include "OgreLightGrid.h"
 
 // This class implements the most basic scene manager
 
@@ -56,6 +60,7 @@ SceneManager::SceneManager(const String& name) :
 mName(name),
 mCameraInProgress(0),
 mCurrentViewport(0),
+mParallelQueueing(false),
 mSkyPlane(this),
 mSkyBox(this),
 mSkyDome(this),
@@ -71,6 +76,7 @@ mResetIdentityView(false),
 mResetIdentityProj(false),
 mFlipCullingOnNegativeScale(true),
 mLightsDirtyCounter(0),
+mLightGrid(new LightGrid()),
 mMovableNameGenerator("Ogre/MO"),
 mDisplayNodes(false),
 mShowBoundingBoxes(false),
@@ -83,7 +89,8 @@ mVisibilityMask(0xFFFFFFFF),
 mFindVisibleObjects(true),
 mCameraRelativeRendering(false),
 mLastLightHash(0),
-mGpuParamsDirty((uint16)GPV_ALL)
+mGpuParamsDirty((uint16)GPV_ALL),
+mGpuParamsForced((uint16)GPV_ALL)
 {
     if (Root* root = Root::getSingletonPtr())
         _setDestinationRenderSystem(root->getRenderSystem());
@@ -295,7 +302,7 @@ const LightList& SceneManager::_getLightsAffectingFrustum(void) const
 //-----------------------------------------------------------------------
 void SceneManager::_populateLightList(const Vector3& position, Real radius, LightList& destList, uint32 lightMask)
 {
-    // Really basic trawl of the lights, then sort
+    // Trawl of the lights, narrowed down by a grid when there are many, then sort
     // Subclasses could do something smarter
 
     // Pre-allocate memory
@@ -306,27 +313,50 @@ void SceneManager::_populateLightList(const Vector3& position, Real radius, Ligh
     size_t numShadowTextures = isShadowTechniqueTextureBased() ? getShadowTextureConfigList().size() : 0;
     size_t numShadowCastingLights = 0;
 
-    // Pick up the lights that affecting frustum only, which should has been
-    // cached, so better than take all lights in the scene into account.
-    // this is partitioned as: | shadow casting lights | other lights |
-    // NOTE: no shadow casting lights might be in frustum, so we cannot rely on numShadowTextures
-    for (Light* lt : mLightsAffectingFrustum)
+    Sphere bound(position, radius);
+    auto addLight = [&](Light* lt)
     {
         // check whether or not this light is suppose to be taken into consideration for the current light mask set for this operation
         if(!(lt->getLightMask() & lightMask))
-            continue; //skip this light
+            return; //skip this light
 
         // Calc squared distance
         lt->_calcTempSquareDist(position);
 
         // only add in-range lights, but ensure texture shadow casters are there
-        if ((lt->getCastShadows() && lightIndex < numShadowTextures) || lt->isInLightRange(Sphere(position, radius)))
+        if ((lt->getCastShadows() && lightIndex < numShadowTextures) || lt->isInLightRange(bound))
         {
             destList.push_back(lt);
         }
 
         numShadowCastingLights += int(lt->getCastShadows());
         lightIndex++;
+    };
+
+    // Pick up the lights that affecting frustum only, which should has been
+    // cached, so better than take all lights in the scene into account.
+    // this is partitioned as: | shadow casting lights | other lights |
+    // NOTE: no shadow casting lights might be in frustum, so we cannot rely on numShadowTextures
+    const auto* candidates = mLightGrid->query(mLightsAffectingFrustum, mLightsDirtyCounter, bound);
+    if (!candidates)
+    {
+        for (Light* lt : mLightsAffectingFrustum)
+            addLight(lt);
+    }
+    else
+    {
+        // lights that might get a shadow texture are added regardless of their range
+        uint32 first = 0;
+        while (first < mLightsAffectingFrustum.size() && lightIndex < numShadowTextures)
+            addLight(mLightsAffectingFrustum[first++]);
+
+        // the grid only leaves out lights that are out of range
+        for (uint32 i : *candidates)
+        {
+            if (i >= first)
+                addLight(mLightsAffectingFrustum[i]);
+        }
+        numShadowCastingLights = mLightGrid->getNumShadowCasters(lightMask);
     }
 
     auto start = destList.begin();
@@ -953,6 +983,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
         _applySceneAnimations();
         updateDirtyInstanceManagers();
         mLastFrameNumber = thisFrameNumber;
+        mGpuParamsStats = GpuParamsStats();
     }
 
     {
@@ -1232,14 +1263,56 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+    if (mTransformHierarchy)
+        mTransformHierarchy->update(getRootSceneNode());
+    else
+        getRootSceneNode()->_update(true, false);
+
+    // only the hierarchy tells whether any bounds changed
+    if (mVisibilityCuller && (!mTransformHierarchy || mTransformHierarchy->getNumUpdatedNodes()))
+        mVisibilityCuller->_notifyBoundsChanged();
 
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
+void SceneManager::setTransformHierarchyEnabled(bool enabled)
+{
+#if OGRE_NODE_INHERIT_TRANSFORM
+    // needs the full parent transform, which is not tracked
+    enabled = false;
+#endif
+    if (enabled == isTransformHierarchyEnabled())
+        return;
+
+    if (enabled)
+    {
+        mTransformHierarchy.reset(new TransformHierarchy());
+        return;
+    }
+
+    mTransformHierarchy.reset();
+    // moved nodes did not notify their parents meanwhile
+    getRootSceneNode()->needUpdate();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setParallelCullingEnabled(bool enabled)
+{
+    if (enabled == isParallelCullingEnabled())
+        return;
+
+    mVisibilityCuller.reset(enabled ? new VisibilityCuller() : NULL);
+}
+//-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    if (mVisibilityCuller)
+    {
+        mVisibilityCuller->findVisibleObjects(getRootSceneNode(), cam, getRenderQueue(), visibleBounds,
+                                              onlyShadowCasters);
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
         mDisplayNodes, onlyShadowCasters);
@@ -1628,23 +1701,30 @@ void SceneManager::renderInstancedObject(const RenderableList& rends, const Pass
     // TODO: manually driving lights
 
     // collect lights of all renderables, thus cannot handle start-light without re-sorting
-    std::set<Light*> batchLights;
-    for (auto r : rends)
-    {
-        const LightList& rendLightList = r->getLights();
-        batchLights.insert(rendLightList.begin(), rendLightList.end());
-    }
     LightList lightListToUse;
-
-    if(pass->getLightMask() == 0xFFFFFFFF)
     {
-        lightListToUse = LightList(batchLights.begin(), batchLights.end());
-    }
-    else
-    {
-        for (auto l : batchLights)
-            if (pass->getLightMask() & l->getLightMask())
-                lightListToUse.push_back(l);
+        FrameAllocator* arena = Root::getSingleton().getFrameAllocator();
+        FrameAllocator::Marker marker = arena->getMarker();
+        std::vector<Light*, ArenaAllocator<Light*>> batchLights{ArenaAllocator<Light*>(arena)};
+        for (auto r : rends)
+        {
+            const LightList& rendLightList = r->getLights();
+            batchLights.insert(batchLights.end(), rendLightList.begin(), rendLightList.end());
+        }
+        std::sort(batchLights.begin(), batchLights.end());
+        batchLights.erase(std::unique(batchLights.begin(), batchLights.end()), batchLights.end());
+
+        if(pass->getLightMask() == 0xFFFFFFFF)
+        {
+            lightListToUse.assign(batchLights.begin(), batchLights.end());
+        }
+        else
+        {
+            for (auto l : batchLights)
+                if (pass->getLightMask() & l->getLightMask())
+                    lightListToUse.push_back(l);
+        }
+        arena->rewind(marker);
     }
 
     // TODO IterationDepthBias
@@ -2503,6 +2583,7 @@ void SceneManager::findLightsAffectingFrustum(const Camera* camera)
                 lightInfo.light = l;
                 lightInfo.type = l->getType();
                 lightInfo.lightMask = l->getLightMask();
+                lightInfo.castShadows = l->getCastShadows();
                 if (lightInfo.type == Light::LT_DIRECTIONAL)
                 {
                     // Always visible
@@ -3555,12 +3636,14 @@ void SceneManager::bindGpuProgram(GpuProgram* prog)
     // Hash == 1 is almost impossible to achieve otherwise
     mLastLightHash = 1;
     mGpuParamsDirty = (uint16)GPV_ALL;
+    mGpuParamsForced = (uint16)GPV_ALL;
     mDestRenderSystem->bindGpuProgram(prog);
 }
 //---------------------------------------------------------------------
 void SceneManager::_markGpuParamsDirty(uint16 mask)
 {
     mGpuParamsDirty |= mask;
+    mGpuParamsForced |= mask;
 }
 //---------------------------------------------------------------------
 void SceneManager::updateGpuProgramParameters(const Pass* pass)
@@ -3577,8 +3660,19 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
             GpuProgramType t = (GpuProgramType)i;
             if (pass->hasGpuProgram(t))
             {
-                mDestRenderSystem->bindGpuProgramParameters(t, pass->getGpuProgramParameters(t),
-                                                            mGpuParamsDirty);
+                const GpuProgramParametersPtr& params = pass->getGpuProgramParameters(t);
+                // the render system still has the values that did not change since the program was bound
+                uint16 mask = mGpuParamsDirty & (mGpuParamsForced | params->_getChangedVariability());
+                size_t bytes = params->_getConstantsSize(mask);
+                mGpuParamsStats.bytesSkipped += params->_getConstantsSize(mGpuParamsDirty) - bytes;
+                if (!mask)
+                {
+                    mGpuParamsStats.skippedUploads++;
+                    continue;
+                }
+                mGpuParamsStats.uploads++;
+                mGpuParamsStats.bytesUploaded += bytes;
+                mDestRenderSystem->bindGpuProgramParameters(t, params, mask);
             }
         }
     }
@@ -3591,6 +3685,7 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
     }
 
     mGpuParamsDirty = 0;
+    mGpuParamsForced = 0;
 }
 //---------------------------------------------------------------------
 void SceneManager::_issueRenderOp(Renderable* rend, const Pass* pass)
@@ -3641,6 +3736,16 @@ void VisibleObjectsBoundsInfo::merge(const AxisAlignedBox& boxBounds, const Sphe
     maxDistanceInFrustum = std::max(maxDistanceInFrustum, camDistToCenter + sphereBounds.getRadius());
 }
 //---------------------------------------------------------------------
+void VisibleObjectsBoundsInfo::merge(const VisibleObjectsBoundsInfo& rhs)
+{
+    aabb.merge(rhs.aabb);
+    receiverAabb.merge(rhs.receiverAabb);
+    minDistance = std::min(minDistance, rhs.minDistance);
+    maxDistance = std::max(maxDistance, rhs.maxDistance);
+    minDistanceInFrustum = std::min(minDistanceInFrustum, rhs.minDistanceInFrustum);
+    maxDistanceInFrustum = std::max(maxDistanceInFrustum, rhs.maxDistanceInFrustum);
+}
+//---------------------------------------------------------------------
 void VisibleObjectsBoundsInfo::mergeNonRenderedButInFrustum(const AxisAlignedBox& boxBounds, const Sphere& sphereBounds, const Camera* cam)
 {
     (void)boxBounds;
@@ -26,6 +26,8 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreStableHeaders.h"
+#include "OgreTransformHierarchy.h"
+#include "OgreVisibilityCuller.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -38,6 +40,7 @@ namespace Ogre {
         , mCreator(creator)
         , mAutoTrackTarget(0)
         , mGlobalIndex(-1)
+        , mTransformSlot(-1)
         , mYawFixed(false)
         , mIsInSceneGraph(false)
         , mShowBoundingBox(false)
@@ -47,6 +50,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     SceneNode::~SceneNode()
     {
+        // the base class detaches us without going through setParent below
+        if (auto hierarchy = mCreator ? mCreator->_getTransformHierarchy() : NULL)
+            hierarchy->_notifyStructureChanged();
+        if (auto culler = mCreator ? mCreator->_getVisibilityCuller() : NULL)
+            culler->_notifyStructureChanged();
+
         // Detach all objects, do this manually to avoid needUpdate() call 
         // which can fail because of deleted items
         for (auto & itr : mObjectsByName)
@@ -64,6 +73,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void SceneNode::setParent(Node* parent)
     {
+        if (auto hierarchy = mCreator ? mCreator->_getTransformHierarchy() : NULL)
+            hierarchy->_notifyStructureChanged();
+        if (auto culler = mCreator ? mCreator->_getVisibilityCuller() : NULL)
+            culler->_notifyStructureChanged();
+
         Node::setParent(parent);
 
         if (parent)
@@ -224,6 +238,21 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void SceneNode::needUpdate(bool forceParentUpdate)
+    {
+        auto hierarchy = mCreator ? mCreator->_getTransformHierarchy() : NULL;
+        if (hierarchy && hierarchy->_markDirty(this))
+        {
+            // the hierarchy finds us by the dirty bit, the parents need not know
+            mNeedParentUpdate = true;
+            mNeedChildUpdate = true;
+            mCachedTransformOutOfDate = true;
+            return;
+        }
+
+        Node::needUpdate(forceParentUpdate);
+    }
+    //-----------------------------------------------------------------------
     void SceneNode::_findVisibleObjects(Camera* cam, RenderQueue* queue, 
         VisibleObjectsBoundsInfo* visibleBounds, bool includeChildren, 
         bool displayNodes, bool onlyShadowCasters)
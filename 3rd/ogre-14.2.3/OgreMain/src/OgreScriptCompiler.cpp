@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreScriptParser.h"
 #include "OgreBuiltinScriptTranslators.h"
 #include "OgreComponents.h"
+#include "OgreStreamSerialiser.h"
 
 #define DEBUG_AST 0
 
@@ -516,7 +517,10 @@ namespace Ogre
             if (!stream)
                 return retval;
 
-            nodes = ScriptParser::parse(ScriptLexer::tokenize(stream->getAsString(), name), name);
+            if (auto mgr = ScriptCompilerManager::getSingletonPtr())
+                nodes = mgr->_parse(stream->getAsString(), name);
+            else
+                nodes = ScriptParser::parse(ScriptLexer::tokenize(stream->getAsString(), name), name);
         }
 
         if(nodes)
@@ -1509,6 +1513,7 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------
     ScriptCompilerManager::ScriptCompilerManager()
+        : mSaveParsedScriptsToCache(false), mParsedScriptCacheDirty(false)
     {
             OGRE_LOCK_AUTO_MUTEX;
         mScriptPatterns.push_back("*.program");
@@ -1603,14 +1608,200 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void ScriptCompilerManager::parseScript(DataStreamPtr& stream, const String& groupName)
     {
-        ConcreteNodeListPtr nodes =
-            ScriptParser::parse(ScriptLexer::tokenize(stream->getAsString(), stream->getName()), stream->getName());
+        ConcreteNodeListPtr nodes = _parse(stream->getAsString(), stream->getName());
         {
             // compile is not reentrant
             OGRE_LOCK_AUTO_MUTEX;
             mScriptCompiler.compile(nodes, groupName);
         }
     }
+    //-----------------------------------------------------------------------
+    namespace
+    {
+        uint32 PARSED_SCRIPT_CACHE_CHUNK_ID = StreamSerialiser::makeIdentifier("OPSC"); // Ogre Parsed Script Cache
+
+        template <typename T> void writeValue(std::vector<uchar>& out, T val)
+        {
+            const uchar* bytes = reinterpret_cast<const uchar*>(&val);
+            out.insert(out.end(), bytes, bytes + sizeof(T));
+        }
+
+        template <typename T> bool readValue(const uchar*& pos, const uchar* end, T& val)
+        {
+            if (size_t(end - pos) < sizeof(T))
+                return false;
+            memcpy(&val, pos, sizeof(T));
+            pos += sizeof(T);
+            return true;
+        }
+
+        /// depth first: count, then type, line, token and children of each node. file is the same for all nodes
+        void writeNodes(const ConcreteNodeList& nodes, std::vector<uchar>& out)
+        {
+            writeValue(out, uint32(nodes.size()));
+            for (const auto& node : nodes)
+            {
+                writeValue(out, uint8(node->type));
+                writeValue(out, uint32(node->line));
+                writeValue(out, uint32(node->token.size()));
+                out.insert(out.end(), node->token.begin(), node->token.end());
+                writeNodes(node->children, out);
+            }
+        }
+
+        bool readNodes(const uchar*& pos, const uchar* end, const String& file, ConcreteNode* parent,
+                       ConcreteNodeList& nodes)
+        {
+            uint32 count;
+            if (!readValue(pos, end, count))
+                return false;
+            for (uint32 i = 0; i < count; ++i)
+            {
+                uint8 type;
+                uint32 line, length;
+                if (!readValue(pos, end, type) || !readValue(pos, end, line) || !readValue(pos, end, length) ||
+                    type > CNT_COLON || size_t(end - pos) < length)
+                    return false;
+
+                auto node = std::make_shared<ConcreteNode>();
+                node->token.assign(reinterpret_cast<const char*>(pos), length);
+                pos += length;
+                node->file = file;
+                node->line = line;
+                node->type = ConcreteNodeType(type);
+                node->parent = parent;
+                nodes.push_back(node);
+
+                if (!readNodes(pos, end, file, node.get(), node->children))
+                    return false;
+            }
+            return true;
+        }
+    }
+    //-----------------------------------------------------------------------
+    ConcreteNodeListPtr ScriptCompilerManager::_parse(const String& content, const String& source)
+    {
+        uint32 hash = FastHash(content.data(), content.size());
+        {
+            OGRE_LOCK_MUTEX(mParsedScriptCacheMutex);
+            auto it = mParsedScriptCache.find(source);
+            if (it != mParsedScriptCache.end() && it->second.hash == hash)
+            {
+                auto nodes = std::make_shared<ConcreteNodeList>();
+                const uchar* pos = it->second.data.data();
+                const uchar* end = pos + it->second.data.size();
+                if (readNodes(pos, end, source, NULL, *nodes) && pos == end)
+                    return nodes;
+
+                LogManager::getSingleton().logWarning("Invalid parsed script cache entry for " + source);
+                mParsedScriptCache.erase(it);
+                mParsedScriptCacheDirty = true;
+            }
+        }
+
+        ConcreteNodeListPtr nodes = ScriptParser::parse(ScriptLexer::tokenize(content, source), source);
+
+        if (mSaveParsedScriptsToCache)
+        {
+            ParsedScript entry;
+            entry.hash = hash;
+            writeNodes(*nodes, entry.data);
+
+            OGRE_LOCK_MUTEX(mParsedScriptCacheMutex);
+            mParsedScriptCache[source] = std::move(entry);
+            mParsedScriptCacheDirty = true;
+        }
+        return nodes;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::saveParsedScriptCache(const DataStreamPtr& stream) const
+    {
+        if (!mParsedScriptCacheDirty)
+            return;
+
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE, "Unable to write to stream " + stream->getName(),
+                        "ScriptCompilerManager::saveParsedScriptCache");
+        }
+
+        OGRE_LOCK_MUTEX(mParsedScriptCacheMutex);
+        StreamSerialiser serialiser(stream);
+        serialiser.writeChunkBegin(PARSED_SCRIPT_CACHE_CHUNK_ID, 1);
+
+        uint32 count = static_cast<uint32>(mParsedScriptCache.size());
+        serialiser.write(&count);
+        for (const auto& entry : mParsedScriptCache)
+        {
+            serialiser.write(&entry.first);
+            serialiser.write(&entry.second.hash);
+            uint32 length = static_cast<uint32>(entry.second.data.size());
+            serialiser.write(&length);
+            serialiser.writeData(entry.second.data.data(), 1, length);
+        }
+
+        serialiser.writeChunkEnd(PARSED_SCRIPT_CACHE_CHUNK_ID);
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::loadParsedScriptCache(const DataStreamPtr& stream)
+    {
+        OGRE_LOCK_MUTEX(mParsedScriptCacheMutex);
+        mParsedScriptCache.clear();
+
+        // read it all at once, the entries are then copied from memory
+        auto data = std::make_shared<MemoryDataStream>(stream);
+        StreamSerialiser serialiser(data);
+
+        // the file may be truncated or corrupt, check each read against what is left of it
+        auto readU32 = [&data, &serialiser]() {
+            uint32 val = 0;
+            if (data->size() - data->tell() < sizeof(val))
+                OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "unexpected end of " + data->getName());
+            serialiser.read(&val);
+            return val;
+        };
+        auto readLength = [&data, &readU32]() {
+            uint32 length = readU32();
+            if (length > data->size() - data->tell())
+                OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "length beyond the end of " + data->getName());
+            return length;
+        };
+
+        try
+        {
+            const StreamSerialiser::Chunk* chunk = serialiser.readChunkBegin();
+            if (chunk->id != PARSED_SCRIPT_CACHE_CHUNK_ID || chunk->version != 1)
+            {
+                LogManager::getSingleton().logWarning("Invalid Parsed Script Cache");
+                serialiser.readChunkEnd(chunk->id);
+                return;
+            }
+
+            uint32 count = readU32();
+            for (uint32 i = 0; i < count; ++i)
+            {
+                String name(readLength(), '\0');
+                serialiser.readData(&name[0], 1, name.size());
+
+                ParsedScript& entry = mParsedScriptCache[name];
+                entry.hash = readU32();
+                entry.data.resize(readLength());
+                serialiser.readData(entry.data.data(), 1, entry.data.size());
+            }
+            serialiser.readChunkEnd(PARSED_SCRIPT_CACHE_CHUNK_ID);
+        }
+        catch (const Exception& e)
+        {
+            // a broken cache only costs the parsing, it is replaced on the next save
+            LogManager::getSingleton().logWarning("Could not load Parsed Script Cache: " + e.getDescription());
+            mParsedScriptCache.clear();
+            mParsedScriptCacheDirty = true;
+            return;
+        }
+
+        // if cache is not modified, mark it as clean.
+        mParsedScriptCacheDirty = false;
+    }
 
     //-------------------------------------------------------------------------
     String ProcessResourceNameScriptCompilerEvent::eventType = "processResourceName";
@@ -30,6 +30,9 @@ THE SOFTWARE.
 #include "OgreOptimisedUtil.h"
 
 namespace Ogre {
+    /// lights whose shadow volumes a caster keeps, beyond that the oldest one is rebuilt
+    static const size_t MAX_CACHED_SHADOW_VOLUMES = 4;
+
     ShadowRenderable::ShadowRenderable(MovableObject* parent, const HardwareIndexBufferSharedPtr& indexBuffer,
                                    const VertexData* vertexData, bool createSeparateLightCap,
                                    bool isLightCap)
@@ -176,113 +179,268 @@ namespace Ogre {
         const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize, 
         const Light* light, ShadowRenderableList& shadowRenderables, unsigned long flags)
     {
-        // Edge groups should be 1:1 with shadow renderables
-        assert(edgeData->edgeGroups.size() == shadowRenderables.size());
+        ShadowVolume volume;
+        volume.light = light;
+        volume.edgeData = edgeData;
+        volume.flags = flags;
+        volume.useMcGuire = useMcGuireDarkCap(edgeData, light);
+        buildShadowVolume(edgeData->triangleLightFacings.data(), volume);
+        writeShadowVolume(volume, indexBuffer, indexBufferUsedSize, shadowRenderables);
+    }
+    // ------------------------------------------------------------------------
+    ShadowCaster::ShadowVolume* ShadowCaster::findShadowVolume(const EdgeData* edgeData,
+        const Vector4& lightPos, const Light* light, unsigned long flags, ShadowVolumeCache& cache,
+        bool reuse) const
+    {
+        bool useMcGuire = useMcGuireDarkCap(edgeData, light);
+
+        // one volume per light, a light seen for the first time takes over the oldest one
+        ShadowVolume* volume = NULL;
+        for (auto& v : cache)
+        {
+            if (v.light == light)
+            {
+                volume = &v;
+                break;
+            }
+        }
+        if (!volume)
+        {
+            if (cache.size() < MAX_CACHED_SHADOW_VOLUMES)
+            {
+                cache.push_back(ShadowVolume());
+                volume = &cache.back();
+            }
+            else
+            {
+                std::rotate(cache.begin(), cache.begin() + 1, cache.end());
+                volume = &cache.back();
+            }
+            volume->light = light;
+            volume->built = false;
+        }
+
+        if (!reuse || volume->edgeData != edgeData || volume->lightPos != lightPos ||
+            volume->flags != flags || volume->useMcGuire != useMcGuire)
+        {
+            volume->edgeData = edgeData;
+            volume->lightPos = lightPos;
+            volume->flags = flags;
+            volume->useMcGuire = useMcGuire;
+            volume->built = false;
+        }
+        return volume;
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::updateShadowVolume(EdgeData* edgeData, const Vector4& lightPos,
+        const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize,
+        const Light* light, ShadowRenderableList& shadowRenderables, unsigned long flags,
+        ShadowVolumeCache& cache, bool reuse)
+    {
+        ShadowVolume* volume = findShadowVolume(edgeData, lightPos, light, flags, cache, reuse);
+        _buildShadowVolume(*volume);
+        writeShadowVolume(*volume, indexBuffer, indexBufferUsedSize, shadowRenderables);
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::_buildShadowVolume(ShadowVolume& volume)
+    {
+        if (volume.built)
+            return;
 
-        Light::LightTypes lightType = light->getType();
+        // as EdgeData::updateTriangleLightFacing, but into the volume
+        const EdgeData* edgeData = volume.edgeData;
+        volume.lightFacings.resize(edgeData->triangleFaceNormals.size());
+        if (!volume.lightFacings.empty())
+        {
+            OptimisedUtil* util = OptimisedUtil::getImplementation();
+            char* lightFacings = volume.lightFacings.data();
+            const Vector4& lightPos = volume.lightPos;
+            OptimisedUtil::_runChunked(volume.lightFacings.size(), [&](size_t begin, size_t end) {
+                util->calculateLightFacing(lightPos, &edgeData->triangleFaceNormals[begin],
+                                           lightFacings + begin, end - begin);
+            });
+        }
 
+        buildShadowVolume(volume.lightFacings.data(), volume);
+        volume.built = true;
+    }
+    // ------------------------------------------------------------------------
+    bool ShadowCaster::useMcGuireDarkCap(const EdgeData* edgeData, const Light* light) const
+    {
         // Whether to use the McGuire method, a triangle fan covering all silhouette
         // This won't work properly with multiple separate edge groups (should be one fan per group, not implemented)
         // or when light position is too close to light cap bound.
-        bool useMcGuire = edgeData->edgeGroups.size() <= 1 && 
-            (lightType == Light::LT_DIRECTIONAL || isBoundOkForMcGuire(getLightCapBounds(), light->getDerivedPosition()));
-        ShadowRenderableList::const_iterator si;
+        return edgeData->edgeGroups.size() <= 1 &&
+            (light->getType() == Light::LT_DIRECTIONAL ||
+             isBoundOkForMcGuire(getLightCapBounds(), light->getDerivedPosition()));
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::buildShadowVolume(const char* lightFacings, ShadowVolume& volume)
+    {
+        const EdgeData* edgeData = volume.edgeData;
+        unsigned long flags = volume.flags;
+        bool useMcGuire = volume.useMcGuire;
+        volume.indices.clear();
+        volume.groups.clear();
 
-        // pre-count the size of index data we need since it makes a big perf difference
-        // to GL in particular if we lock a smaller area of the index buffer
-        size_t preCountIndexes = 0;
+        bool extrudeToInfinity = volume.light->getType() == Light::LT_DIRECTIONAL &&
+            (flags & SRF_EXTRUDE_TO_INFINITY);
 
-        si = shadowRenderables.begin();
         for (auto& eg : edgeData->edgeGroups)
         {
+            // Classify the edges first, they do not depend on each other
+            // 0 off the silhouette, 1 if the first tri faces the light, 2 if it faces away
+            size_t numEdges = eg.edges.size();
+            volume.silhouette.resize(numEdges);
+            uchar* silhouette = volume.silhouette.data();
+            const EdgeData::Edge* edges = eg.edges.data();
+            OptimisedUtil::_runChunked(numEdges, [=](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    // Silhouette edge, when two tris has opposite light facing, or
+                    // degenerate edge where only tri 1 is valid and the tri light facing
+                    const EdgeData::Edge& edge = edges[i];
+                    char lightFacing = lightFacings[edge.triIndex[0]];
+                    if (edge.degenerate)
+                        silhouette[i] = lightFacing ? 1 : 0;
+                    else if (lightFacing != lightFacings[edge.triIndex[1]])
+                        silhouette[i] = lightFacing ? 1 : 2;
+                    else
+                        silhouette[i] = 0;
+                }
+            });
+
+            ShadowVolume::GroupRange range;
+            range.start = volume.indices.size();
+            // original number of verts (without extruded copy)
+            size_t originalVertexCount = eg.vertexData->vertexCount;
             bool  firstDarkCapTri = true;
-            for (auto& edge :  eg.edges)
+            unsigned short darkCapStart = 0;
+
+            for (size_t i = 0; i < numEdges; ++i)
             {
-                // Silhouette edge, when two tris has opposite light facing, or
-                // degenerate edge where only tri 1 is valid and the tri light facing
-                char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
-                if ((edge.degenerate && lightFacing) ||
-                    (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
+                if (!silhouette[i])
+                    continue;
+
+                size_t v0 = edges[i].vertIndex[0];
+                size_t v1 = edges[i].vertIndex[1];
+                if (silhouette[i] == 2)
                 {
+                    // Inverse edge indexes when t1 is light away
+                    std::swap(v0, v1);
+                }
 
-                    preCountIndexes += 3;
+                /* Note edge(v0, v1) run anticlockwise along the edge from
+                the light facing tri so to point shadow volume tris outward,
+                light cap indexes have to be backwards
+
+                We emit 2 tris if light is a point light, 1 if light 
+                is directional, because directional lights cause all
+                points to converge to a single point at infinity.
+
+                First side tri = near1, near0, far0
+                Second tri = far0, far1, near1
+
+                'far' indexes are 'near' index + originalVertexCount
+                because 'far' verts are in the second half of the 
+                buffer
+                */
+                assert(v1 < 65536 && v0 < 65536 && (v0 + originalVertexCount) < 65536 &&
+                    "Vertex count exceeds 16-bit index limit!");
+                volume.indices.push_back(static_cast<unsigned short>(v1));
+                volume.indices.push_back(static_cast<unsigned short>(v0));
+                volume.indices.push_back(static_cast<unsigned short>(v0 + originalVertexCount));
+
+                // Are we extruding to infinity?
+                if (!extrudeToInfinity)
+                {
+                    // additional tri to make quad
+                    volume.indices.push_back(static_cast<unsigned short>(v0 + originalVertexCount));
+                    volume.indices.push_back(static_cast<unsigned short>(v1 + originalVertexCount));
+                    volume.indices.push_back(static_cast<unsigned short>(v1));
+                }
 
-                    // Are we extruding to infinity?
-                    if (!(lightType == Light::LT_DIRECTIONAL &&
-                        flags & SRF_EXTRUDE_TO_INFINITY))
+                // Do dark cap tri
+                // Use McGuire et al method, a triangle fan covering all silhouette
+                // edges and one point (taken from the initial tri)
+                if (useMcGuire && (flags & SRF_INCLUDE_DARK_CAP))
+                {
+                    if (firstDarkCapTri)
                     {
-                        preCountIndexes += 3;
+                        darkCapStart = static_cast<unsigned short>(v0 + originalVertexCount);
+                        firstDarkCapTri = false;
                     }
-
-                    if(useMcGuire)
+                    else
                     {
-                        // Do dark cap tri
-                        // Use McGuire et al method, a triangle fan covering all silhouette
-                        // edges and one point (taken from the initial tri)
-                        if (flags & SRF_INCLUDE_DARK_CAP)
-                        {
-                            if (firstDarkCapTri)
-                            {
-                                firstDarkCapTri = false;
-                            }
-                            else
-                            {
-                                preCountIndexes += 3;
-                            }
-                        }
+                        volume.indices.push_back(darkCapStart);
+                        volume.indices.push_back(static_cast<unsigned short>(v1 + originalVertexCount));
+                        volume.indices.push_back(static_cast<unsigned short>(v0 + originalVertexCount));
                     }
                 }
-
             }
 
-            if(useMcGuire)
+            EdgeData::TriangleList::const_iterator tibegin = edgeData->triangles.begin() + eg.triStart;
+            EdgeData::TriangleList::const_iterator tiend = tibegin + eg.triCount;
+            const char* lfi;
+
+            // Do dark cap
+            if (!useMcGuire && (flags & SRF_INCLUDE_DARK_CAP))
             {
-                // Do light cap
-                if (flags & SRF_INCLUDE_LIGHT_CAP) 
+                // Iterate over the triangles which are using this vertex set
+                lfi = lightFacings + eg.triStart;
+                for (EdgeData::TriangleList::const_iterator ti = tibegin; ti != tiend; ++ti, ++lfi)
                 {
-                    // Iterate over the triangles which are using this vertex set
-                    EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
-                    ti = edgeData->triangles.begin() + eg.triStart;
-                    tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    for ( ; ti != tiend; ++ti, ++lfi)
+                    const EdgeData::Triangle& t = *ti;
+                    assert(t.vertexSet == eg.vertexSet);
+                    // Check it's light facing
+                    if (*lfi)
                     {
-                        assert(ti->vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                        {
-                            preCountIndexes += 3;
-                        }
+                        assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
+                            t.vertIndex[2] < 65536 && 
+                            "16-bit index limit exceeded!");
+                        volume.indices.push_back(static_cast<unsigned short>(t.vertIndex[1] + originalVertexCount));
+                        volume.indices.push_back(static_cast<unsigned short>(t.vertIndex[0] + originalVertexCount));
+                        volume.indices.push_back(static_cast<unsigned short>(t.vertIndex[2] + originalVertexCount));
                     }
-
                 }
             }
-            else
+
+            // Do light cap
+            range.lightCapStart = volume.indices.size();
+            if (flags & SRF_INCLUDE_LIGHT_CAP) 
             {
-                // Do both caps
-                int increment = ((flags & SRF_INCLUDE_DARK_CAP) ? 3 : 0) + ((flags & SRF_INCLUDE_LIGHT_CAP) ? 3 : 0);
-                if(increment != 0)
+                // Iterate over the triangles which are using this vertex set
+                lfi = lightFacings + eg.triStart;
+                for (EdgeData::TriangleList::const_iterator ti = tibegin; ti != tiend; ++ti, ++lfi)
                 {
-                    // Iterate over the triangles which are using this vertex set
-                    EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
-                    ti = edgeData->triangles.begin() + eg.triStart;
-                    tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    for ( ; ti != tiend; ++ti, ++lfi)
+                    const EdgeData::Triangle& t = *ti;
+                    assert(t.vertexSet == eg.vertexSet);
+                    // Check it's light facing
+                    if (*lfi)
                     {
-                        assert(ti->vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                            preCountIndexes += increment;
+                        assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
+                            t.vertIndex[2] < 65536 && 
+                            "16-bit index limit exceeded!");
+                        volume.indices.push_back(static_cast<unsigned short>(t.vertIndex[0]));
+                        volume.indices.push_back(static_cast<unsigned short>(t.vertIndex[1]));
+                        volume.indices.push_back(static_cast<unsigned short>(t.vertIndex[2]));
                     }
                 }
             }
-            ++si;
+            range.end = volume.indices.size();
+            volume.groups.push_back(range);
         }
-        // End pre-count
-        
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::writeShadowVolume(const ShadowVolume& volume,
+        const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize,
+        ShadowRenderableList& shadowRenderables)
+    {
+        // Edge groups should be 1:1 with shadow renderables
+        assert(volume.groups.size() == shadowRenderables.size());
+
+        size_t preCountIndexes = volume.indices.size();
+
         //Check if index buffer is to small 
         if (preCountIndexes > indexBuffer->getNumIndexes())
         {
@@ -311,18 +469,19 @@ namespace Ogre {
         }
 
         // Lock index buffer for writing, just enough length as we need
-        HardwareBufferLockGuard indexLock(indexBuffer,
-            sizeof(unsigned short) * indexBufferUsedSize, sizeof(unsigned short) * preCountIndexes,
-            indexBufferUsedSize == 0 ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NO_OVERWRITE);
-        unsigned short* pIdx = static_cast<unsigned short*>(indexLock.pData);
-        size_t numIndices = indexBufferUsedSize;
-        
-        // Iterate over the groups and form renderables for each based on their
-        // lightFacing
-        si = shadowRenderables.begin();
-        for (auto& eg : edgeData->edgeGroups)
+        if (preCountIndexes)
+        {
+            HardwareBufferLockGuard indexLock(indexBuffer,
+                sizeof(unsigned short) * indexBufferUsedSize, sizeof(unsigned short) * preCountIndexes,
+                indexBufferUsedSize == 0 ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NO_OVERWRITE);
+            memcpy(indexLock.pData, volume.indices.data(), sizeof(unsigned short) * preCountIndexes);
+        }
+
+        // Point the renderables of each group at their range
+        size_t base = indexBufferUsedSize;
+        ShadowRenderableList::const_iterator si = shadowRenderables.begin();
+        for (auto& range : volume.groups)
         {
-            // Initialise the index start for this shadow renderable
             IndexData* indexData = (*si)->getRenderOperationForUpdate()->indexData;
 
             if (indexData->indexBuffer != indexBuffer)
@@ -331,171 +490,25 @@ namespace Ogre {
                 indexData = (*si)->getRenderOperationForUpdate()->indexData;
             }
 
-            indexData->indexStart = numIndices;
-            // original number of verts (without extruded copy)
-            size_t originalVertexCount = eg.vertexData->vertexCount;
-            bool  firstDarkCapTri = true;
-            unsigned short darkCapStart = 0;
-
-            for (auto& edge : eg.edges)
+            indexData->indexStart = base + range.start;
+            // separate light cap?
+            if ((volume.flags & SRF_INCLUDE_LIGHT_CAP) && (*si)->isLightCapSeparate())
             {
-                // Silhouette edge, when two tris has opposite light facing, or
-                // degenerate edge where only tri 1 is valid and the tri light facing
-                char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
-                if ((edge.degenerate && lightFacing) ||
-                    (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
-                {
-                    size_t v0 = edge.vertIndex[0];
-                    size_t v1 = edge.vertIndex[1];
-                    if (!lightFacing)
-                    {
-                        // Inverse edge indexes when t1 is light away
-                        std::swap(v0, v1);
-                    }
-
-                    /* Note edge(v0, v1) run anticlockwise along the edge from
-                    the light facing tri so to point shadow volume tris outward,
-                    light cap indexes have to be backwards
-
-                    We emit 2 tris if light is a point light, 1 if light 
-                    is directional, because directional lights cause all
-                    points to converge to a single point at infinity.
-
-                    First side tri = near1, near0, far0
-                    Second tri = far0, far1, near1
-
-                    'far' indexes are 'near' index + originalVertexCount
-                    because 'far' verts are in the second half of the 
-                    buffer
-                    */
-                    assert(v1 < 65536 && v0 < 65536 && (v0 + originalVertexCount) < 65536 &&
-                        "Vertex count exceeds 16-bit index limit!");
-                    *pIdx++ = static_cast<unsigned short>(v1);
-                    *pIdx++ = static_cast<unsigned short>(v0);
-                    *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                    numIndices += 3;
-
-                    // Are we extruding to infinity?
-                    if (!(lightType == Light::LT_DIRECTIONAL &&
-                        flags & SRF_EXTRUDE_TO_INFINITY))
-                    {
-                        // additional tri to make quad
-                        *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                        *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
-                        *pIdx++ = static_cast<unsigned short>(v1);
-                        numIndices += 3;
-                    }
-
-                    if(useMcGuire)
-                    {
-                        // Do dark cap tri
-                        // Use McGuire et al method, a triangle fan covering all silhouette
-                        // edges and one point (taken from the initial tri)
-                        if (flags & SRF_INCLUDE_DARK_CAP)
-                        {
-                            if (firstDarkCapTri)
-                            {
-                                darkCapStart = static_cast<unsigned short>(v0 + originalVertexCount);
-                                firstDarkCapTri = false;
-                            }
-                            else
-                            {
-                                *pIdx++ = darkCapStart;
-                                *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
-                                *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                                numIndices += 3;
-                            }
-
-                        }
-                    }
-                }
+                indexData->indexCount = range.lightCapStart - range.start;
 
+                indexData = (*si)->getLightCapRenderable()->getRenderOperationForUpdate()->indexData;
+                indexData->indexStart = base + range.lightCapStart;
             }
-
-            if(!useMcGuire)
-            {
-                // Do dark cap
-                if (flags & SRF_INCLUDE_DARK_CAP) 
-                {
-                    // Iterate over the triangles which are using this vertex set
-                    EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
-                    ti = edgeData->triangles.begin() + eg.triStart;
-                    tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    for ( ; ti != tiend; ++ti, ++lfi)
-                    {
-                        const EdgeData::Triangle& t = *ti;
-                        assert(t.vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                        {
-                            assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
-                                t.vertIndex[2] < 65536 && 
-                                "16-bit index limit exceeded!");
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[1] + originalVertexCount);
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[0] + originalVertexCount);
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[2] + originalVertexCount);
-                            numIndices += 3;
-                        }
-                    }
-
-                }
-            }
-
-            // Do light cap
-            if (flags & SRF_INCLUDE_LIGHT_CAP) 
-            {
-                // separate light cap?
-                if ((*si)->isLightCapSeparate())
-                {
-                    // update index count for this shadow renderable
-                    indexData->indexCount = numIndices - indexData->indexStart;
-
-                    // get light cap index data for update
-                    indexData = (*si)->getLightCapRenderable()->getRenderOperationForUpdate()->indexData;
-                    // start indexes after the current total
-                    indexData->indexStart = numIndices;
-                }
-
-                // Iterate over the triangles which are using this vertex set
-                EdgeData::TriangleList::const_iterator ti, tiend;
-                EdgeData::TriangleLightFacingList::const_iterator lfi;
-                ti = edgeData->triangles.begin() + eg.triStart;
-                tiend = ti + eg.triCount;
-                lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                for ( ; ti != tiend; ++ti, ++lfi)
-                {
-                    const EdgeData::Triangle& t = *ti;
-                    assert(t.vertexSet == eg.vertexSet);
-                    // Check it's light facing
-                    if (*lfi)
-                    {
-                        assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
-                            t.vertIndex[2] < 65536 && 
-                            "16-bit index limit exceeded!");
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[0]);
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[1]);
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[2]);
-                        numIndices += 3;
-                    }
-                }
-
-            }
-
-            // update index count for current index data (either this shadow renderable or its light cap)
-            indexData->indexCount = numIndices - indexData->indexStart;
+            indexData->indexCount = base + range.end - indexData->indexStart;
 
             ++si;
         }
 
-        // In debug mode, check we didn't overrun the index buffer
-        assert(numIndices == indexBufferUsedSize + preCountIndexes);
-        assert(numIndices <= indexBuffer->getNumIndexes() &&
+        assert(base + preCountIndexes <= indexBuffer->getNumIndexes() &&
             "Index buffer overrun while generating shadow volume!! "
             "You must increase the size of the shadow index buffer.");
 
-        indexBufferUsedSize = numIndices;
+        indexBufferUsedSize = base + preCountIndexes;
     }
     // ------------------------------------------------------------------------
     void ShadowCaster::extrudeVertices(
@@ -516,9 +529,12 @@ namespace Ogre {
         // destination buffer have same alignment for slight performance gain.
         float* pDest = pSrc + originalVertexCount * 3;
 
-        OptimisedUtil::getImplementation()->extrudeVertices(
-            light, extrudeDist,
-            pSrc, pDest, originalVertexCount);
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        OptimisedUtil::_runChunked(originalVertexCount, [&](size_t begin, size_t end) {
+            util->extrudeVertices(
+                light, extrudeDist,
+                pSrc + begin * 3, pDest + begin * 3, end - begin);
+        });
     }
     // ------------------------------------------------------------------------
     void ShadowCaster::extrudeBounds(AxisAlignedBox& box, const Vector4& light, Real extrudeDist) const
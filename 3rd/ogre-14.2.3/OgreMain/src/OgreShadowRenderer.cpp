@@ -955,7 +955,17 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
     const PlaneBoundedVolume& nearClipVol =
         light->_getNearClipVolume(camera);
 
-    // Now iterate over the casters and render
+    // How each caster is rendered, decided up front so the volumes can be built together
+    struct CasterVolume
+    {
+        ShadowCaster* caster;
+        unsigned long flags;
+        bool zfailAlgo;
+        Real extrudeDist;
+    };
+    std::vector<CasterVolume> casterVolumes;
+    casterVolumes.reserve(casters.size());
+
     for (auto *caster : casters)
     {
         bool zfailAlgo = camera->isCustomNearClipPlaneEnabled();
@@ -967,8 +977,6 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
         {
             // we have to limit shadow extrusion to avoid cliping by far clip plane 
             extrudeDist = std::min(caster->getPointExtrusionDistance(light), mShadowDirLightExtrudeDist); 
-            // Set autoparams for finite point light extrusion
-            mSceneManager->mAutoParamDataSource->setShadowPointLightExtrusionDistance(extrudeDist);
         }
 
         Real darkCapExtrudeDist = extrudeDist;
@@ -1027,9 +1035,34 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
         if(extrudeInSoftware) // convert to flag
             flags |= SRF_EXTRUDE_IN_SOFTWARE;
 
+        casterVolumes.push_back({caster, flags, zfailAlgo, extrudeDist});
+    }
+
+    // Build the volumes that are out of date on the worker threads, each into its own index list.
+    // Only copying them to the shared index buffer is left for getShadowVolumeRenderableList
+    std::vector<ShadowCaster::ShadowVolume*> builds;
+    for (auto& cv : casterVolumes)
+    {
+        if (ShadowCaster::ShadowVolume* volume = cv.caster->_getShadowVolumeToBuild(light, int(cv.flags)))
+            builds.push_back(volume);
+    }
+    Root::getSingleton().getWorkQueue()->runTasks(builds.size(),
+                                                  [&builds](size_t i) { ShadowCaster::_buildShadowVolume(*builds[i]); });
+
+    // Now iterate over the casters and render
+    for (auto& cv : casterVolumes)
+    {
+        unsigned long flags = cv.flags;
+        bool zfailAlgo = cv.zfailAlgo;
+        if (light->getType() != Light::LT_DIRECTIONAL)
+        {
+            // Set autoparams for finite point light extrusion
+            mSceneManager->mAutoParamDataSource->setShadowPointLightExtrusionDistance(cv.extrudeDist);
+        }
+
         // Get shadow renderables
-        const ShadowRenderableList& shadowRenderables = caster->getShadowVolumeRenderableList(
-            light, mShadowIndexBuffer, mShadowIndexBufferUsedSize, extrudeDist, flags);
+        const ShadowRenderableList& shadowRenderables = cv.caster->getShadowVolumeRenderableList(
+            light, mShadowIndexBuffer, mShadowIndexBufferUsedSize, cv.extrudeDist, flags);
 
         // Render a shadow volume here
         //  - if we have 2-sided stencil, one render with no culling
@@ -186,11 +186,10 @@ namespace Ogre {
         Algorithm:
           1. Reset all bone positions
           2. Iterate per AnimationState, if enabled get Animation and call Animation::apply
+          When all animations allow it, both steps work on a flat pose instead, which is
+          written to each bone once
         */
 
-        // Reset bones
-        reset();
-
         Real weightFactor = 1.0f;
         if (mBlendState == ANIMBLEND_AVERAGE)
         {
@@ -215,6 +214,71 @@ namespace Ogre {
             }
         }
 
+        bool flat = true;
+        for (auto *animState : animSet.getEnabledAnimationStates())
+        {
+            Animation* anim = _getAnimationImpl(animState->getAnimationName());
+            if (anim && !anim->_prepareApplyToPose())
+            {
+                flat = false;
+                break;
+            }
+        }
+
+        if (flat)
+        {
+            // Reset bones, manual bones start from where they are
+            size_t numBones = mBoneList.size();
+            mPose.resize(numBones);
+            for (size_t i = 0; i < numBones; ++i)
+            {
+                const Bone* b = mBoneList[i];
+                bool manual = b->isManuallyControlled();
+                const Vector3& position = manual ? b->getPosition() : b->getInitialPosition();
+                const Quaternion& orientation = manual ? b->getOrientation() : b->getInitialOrientation();
+                const Vector3& scale = manual ? b->getScale() : b->getInitialScale();
+                mPose.tx[i] = position.x;
+                mPose.ty[i] = position.y;
+                mPose.tz[i] = position.z;
+                mPose.qw[i] = orientation.w;
+                mPose.qx[i] = orientation.x;
+                mPose.qy[i] = orientation.y;
+                mPose.qz[i] = orientation.z;
+                mPose.sx[i] = scale.x;
+                mPose.sy[i] = scale.y;
+                mPose.sz[i] = scale.z;
+                mPose.animated[i] = !manual;
+            }
+
+            for (auto *animState : animSet.getEnabledAnimationStates())
+            {
+                const LinkedSkeletonAnimationSource* linked = 0;
+                Animation* anim = _getAnimationImpl(animState->getAnimationName(), &linked);
+                if (anim)
+                {
+                    anim->_applyToPose(mPose, animState->getTimePosition(), animState->_getKeyIndexCursor(),
+                                       animState->getWeight() * weightFactor,
+                                       animState->hasBlendMask() ? animState->getBlendMask() : NULL,
+                                       linked ? linked->scale : 1.0f);
+                }
+            }
+
+            for (size_t i = 0; i < numBones; ++i)
+            {
+                if (!mPose.animated[i])
+                    continue;
+
+                Quaternion orientation(mPose.qw[i], mPose.qx[i], mPose.qy[i], mPose.qz[i]);
+                orientation.normalise();
+                mBoneList[i]->_setTransform(Vector3(mPose.tx[i], mPose.ty[i], mPose.tz[i]), orientation,
+                                            Vector3(mPose.sx[i], mPose.sy[i], mPose.sz[i]));
+            }
+            return;
+        }
+
+        // Reset bones
+        reset();
+
         // Per enabled animation state
         for(auto *animState : animSet.getEnabledAnimationStates())
         {
@@ -237,6 +301,17 @@ namespace Ogre {
         }
 
 
+    }
+    //---------------------------------------------------------------------
+    bool Skeleton::_canSetAnimationStateConcurrently(const AnimationStateSet& animSet) const
+    {
+        for (auto *animState : animSet.getEnabledAnimationStates())
+        {
+            Animation* anim = _getAnimationImpl(animState->getAnimationName());
+            if (anim && !anim->_canApplyToPose())
+                return false;
+        }
+        return true;
     }
     //---------------------------------------------------------------------
     void Skeleton::setBindingPose(void)
@@ -896,15 +896,29 @@ namespace Ogre {
         EdgeData* edgeList = mLodBucketList[mCurrentLod]->getEdgeList();
         ShadowRenderableList& shadowRendList = mLodBucketList[mCurrentLod]->getShadowRenderableList();
 
-        // Calc triangle light facing
-        updateEdgeListLightFacing(edgeList, lightPos);
-
-        // Generate indexes and update renderables
-        generateShadowVolume(edgeList, indexBuffer, indexBufferUsedSize, light, shadowRendList, flags);
+        // Calc triangle light facing and generate indexes, unless the light did not move
+        // since the last volume for this light
+        updateShadowVolume(edgeList, lightPos, indexBuffer, indexBufferUsedSize, light,
+                           shadowRendList, flags, mShadowVolumes, true);
 
         return shadowRendList;
 
     }
+    //---------------------------------------------------------------------
+    ShadowCaster::ShadowVolume* StaticGeometry::Region::_getShadowVolumeToBuild(const Light* light, int flags)
+    {
+        EdgeData* edgeList = mLodBucketList[mCurrentLod]->getEdgeList();
+        if (!edgeList)
+            return NULL;
+
+        // the object space light as getShadowVolumeRenderableList computes it
+        Vector4 lightPos = light->getAs4DVector();
+        Affine3 world2Obj = mParentNode->_getFullTransform().inverse();
+        lightPos = world2Obj * lightPos;
+
+        ShadowVolume* volume = findShadowVolume(edgeList, lightPos, light, flags, mShadowVolumes, true);
+        return volume->built ? NULL : volume;
+    }
     //--------------------------------------------------------------------------
     EdgeData* StaticGeometry::Region::getEdgeList(void)
     {
@@ -29,10 +29,61 @@ THE SOFTWARE.
 #include "OgreHardwarePixelBuffer.h"
 #include "OgreImage.h"
 #include "OgreTexture.h"
+#include "OgreArchive.h"
+
+#include <mutex>
 
 namespace Ogre {
     static const char* CUBEMAP_SUFFIXES[] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
     static const char* CUBEMAP_SUFFIXES_ALT[] = {"_px", "_nx", "_py", "_ny", "_pz", "_nz"};
+
+    namespace
+    {
+        /// header of the TextureManager cache entries, followed by the Image data
+        struct TextureCacheHeader
+        {
+            uint32 magic;
+            uint32 version;
+            uint64 sourceTime;
+            uint32 options; // TextureCacheOptions applied to the stored image
+            uint32 format;
+            uint32 width;
+            uint32 height;
+            uint32 numMipmaps;
+            uint32 reserved[3];
+        };
+        const uint32 TEXTURE_CACHE_MAGIC = 0x4543544F; // "OTCE"
+        const uint32 TEXTURE_CACHE_VERSION = 2;
+
+        enum TextureCacheOptions
+        {
+            TCO_NPOT = 1,
+            TCO_MIPMAPS = 2,
+            TCO_COMPRESSED = 4
+        };
+
+        /// entries are written from prepareImpl, which may run on several threads
+        std::mutex textureCacheMutex;
+
+        /// only 8 bit unorm colours survive block compression, others would lose range or precision
+        bool isCacheCompressible(PixelFormat format)
+        {
+            switch (format)
+            {
+            case PF_R8G8B8:
+            case PF_B8G8R8:
+            case PF_A8R8G8B8:
+            case PF_A8B8G8R8:
+            case PF_B8G8R8A8:
+            case PF_R8G8B8A8:
+            case PF_X8R8G8B8:
+            case PF_X8B8G8R8:
+                return true;
+            default:
+                return false;
+            }
+        }
+    }
     //--------------------------------------------------------------------------
     Texture::Texture(ResourceManager* creator, const String& name, 
         ResourceHandle handle, const String& group, bool isManual, 
@@ -424,6 +475,124 @@ namespace Ogre {
             img.resize(w, h);
     }
 
+    uint32 Texture::getCacheOptions(bool haveNPOT) const
+    {
+        uint32 options = haveNPOT ? TCO_NPOT : 0;
+        if (mNumMipmaps > 0)
+            options |= TCO_MIPMAPS;
+
+        // these are applied at upload, which needs uncompressed data
+        bool keepFormat = mDesiredFormat != PF_UNKNOWN || mTreatLuminanceAsAlpha || mGamma != 1.0f;
+        if (TextureManager::getSingleton().getTextureCacheCompression() && !keepFormat &&
+            Root::getSingleton().getRenderSystem()->getCapabilities()->hasCapability(RSC_TEXTURE_COMPRESSION_DXT))
+            options |= TCO_COMPRESSED;
+        return options;
+    }
+
+    /// the cache entry of a texture, readable and unique per group and name
+    static String getCacheEntryName(const String& group, const String& name)
+    {
+        String base, path;
+        StringUtil::splitFilename(name, base, path);
+        uint32 hash = FastHash(name.data(), name.size(), FastHash(group.data(), group.size()));
+        return StringUtil::format("%08x_%s.texcache", hash, base.c_str());
+    }
+
+    /// modification time of the texture file, 0 if it is not found
+    static time_t getSourceTime(const String& group, const String& name)
+    {
+        auto& rgm = ResourceGroupManager::getSingleton();
+        if (group != RGN_AUTODETECT)
+            return rgm.resourceModifiedTime(group, name);
+        if (!rgm.resourceExistsInAnyGroup(name))
+            return 0;
+        return rgm.resourceModifiedTime(rgm.findGroupContainingResource(name), name);
+    }
+
+    bool Texture::readCachedImage(LoadedImages& imgs, uint32 options)
+    {
+        Archive* cache = TextureManager::getSingleton().getTextureCache();
+        if (!cache)
+            return false;
+
+        time_t sourceTime = getSourceTime(mGroup, mName);
+        String entry = getCacheEntryName(mGroup, mName);
+        DataStreamPtr stream;
+        {
+            std::lock_guard<std::mutex> lock(textureCacheMutex);
+            if (!sourceTime || !cache->exists(entry))
+                return false;
+            stream = cache->open(entry);
+        }
+
+        TextureCacheHeader header;
+        if (stream->read(&header, sizeof(header)) != sizeof(header) || header.magic != TEXTURE_CACHE_MAGIC ||
+            header.version != TEXTURE_CACHE_VERSION || header.sourceTime != uint64(sourceTime))
+            return false;
+
+        // the header has the options applied, formats that do not compress are stored as they are
+        PixelFormat format = PixelFormat(header.format);
+        if (header.options != options &&
+            (header.options != (options & ~TCO_COMPRESSED) || isCacheCompressible(format)))
+            return false;
+
+        size_t size = Image::calculateSize(header.numMipmaps, 1, header.width, header.height, 1, format);
+        if (stream->size() != sizeof(header) + size)
+            return false;
+
+        imgs.push_back(Image());
+        Image& img = imgs.back();
+        if (auto mem = dynamic_cast<MemoryDataStream*>(stream.get()))
+        {
+            // upload straight from the stream memory, e.g. the mapped file
+            img.loadDynamicImage(mem->getCurrentPtr(), header.width, header.height, 1, format, false, 1,
+                                 header.numMipmaps);
+            mCacheEntry = stream;
+        }
+        else
+        {
+            img.create(format, header.width, header.height, 1, 1, header.numMipmaps);
+            stream->read(img.getData(), size);
+        }
+
+        if (TextureManager::getSingleton().getVerbose())
+            LogManager::getSingleton().logMessage("Texture '" + mName + "': read from cache entry " + entry);
+        return true;
+    }
+
+    void Texture::writeCachedImage(Image& img, uint32 options)
+    {
+        Archive* cache = TextureManager::getSingleton().getTextureCache();
+        time_t sourceTime = getSourceTime(mGroup, mName);
+        if (!cache || !sourceTime || img.hasFlag(IF_COMPRESSED) || img.getDepth() > 1 || img.getNumFaces() > 1)
+            return;
+
+        if ((options & TCO_MIPMAPS) && img.getNumMipmaps() == 0)
+            img.generateMipmaps();
+        if (!isCacheCompressible(img.getFormat()))
+            options &= ~TCO_COMPRESSED;
+        if (options & TCO_COMPRESSED)
+            img.compress(PixelUtil::hasAlpha(img.getFormat()) ? PF_DXT5 : PF_DXT1);
+
+        TextureCacheHeader header = {TEXTURE_CACHE_MAGIC, TEXTURE_CACHE_VERSION, uint64(sourceTime), options,
+                                     uint32(img.getFormat()), img.getWidth(), img.getHeight(),
+                                     img.getNumMipmaps(), {0, 0, 0}};
+        String entry = getCacheEntryName(mGroup, mName);
+        try
+        {
+            std::lock_guard<std::mutex> lock(textureCacheMutex);
+            DataStreamPtr stream = cache->create(entry);
+            stream->write(&header, sizeof(header));
+            stream->write(img.getData(), img.getSize());
+        }
+        catch (const Exception& e)
+        {
+            // the cache is an optimisation, loading goes on
+            LogManager::getSingleton().logWarning("Texture '" + mName + "': could not write cache entry " +
+                                                  entry + ": " + e.getDescription());
+        }
+    }
+
     void Texture::prepareImpl(void)
     {
         if (mUsage & TU_RENDERTARGET)
@@ -440,6 +609,13 @@ namespace Ogre {
 
         LoadedImages loadedImages;
 
+        uint32 cacheOptions = getCacheOptions(haveNPOT);
+        if (mLayerNames.empty() && mTextureType == TEX_TYPE_2D && readCachedImage(loadedImages, cacheOptions))
+        {
+            std::swap(mLoadedImages, loadedImages);
+            return;
+        }
+
         try
         {
             if(mLayerNames.empty())
@@ -485,6 +661,9 @@ namespace Ogre {
             readImage(loadedImages, name, ext, haveNPOT);
         }
 
+        if (mLayerNames.empty() && mTextureType == TEX_TYPE_2D)
+            writeCachedImage(loadedImages[0], cacheOptions);
+
         // If compressed and 0 custom mipmap, disable auto mip generation and
         // disable software mipmap creation.
         // Not supported by GLES.
@@ -503,6 +682,7 @@ namespace Ogre {
     void Texture::unprepareImpl()
     {
         mLoadedImages.clear();
+        mCacheEntry.reset();
     }
 
     void Texture::loadImpl()
@@ -514,9 +694,11 @@ namespace Ogre {
         }
 
         LoadedImages loadedImages;
+        DataStreamPtr cacheEntry;
         // Now the only copy is on the stack and will be cleaned in case of
         // exceptions being thrown from _loadImages
         std::swap(loadedImages, mLoadedImages);
+        std::swap(cacheEntry, mCacheEntry);
 
         // Call internal _loadImages, not loadImage since that's external and
         // will determine load status etc again
@@ -44,9 +44,13 @@ namespace Ogre {
          : mPreferredIntegerBitDepth(0)
          , mPreferredFloatBitDepth(0)
          , mDefaultNumMipmaps(MIP_UNLIMITED)
+         , mTextureCache(NULL)
+         , mTextureCacheCompression(false)
     {
         mResourceType = "Texture";
         mLoadOrder = 75.0f;
+        // preparing reads and decodes the images
+        mPrepareConcurrently = true;
 
         // Subclasses should register (when this is fully constructed)
     }
@@ -921,6 +921,22 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void TextureUnitState::_getDependencies(std::vector<ResourcePtr>& dependencies) const
+    {
+        if (mContentType != CONTENT_NAMED)
+            return;
+
+        for (const auto& tex : mFramePtrs)
+        {
+            if (!tex || mTextureLoadFailed || !checkTexCalcSettings(tex))
+                continue;
+
+            // as ensurePrepared, so the texture is prepared the way this unit needs it
+            tex->setGamma(mGamma);
+            dependencies.push_back(tex);
+        }
+    }
+    //-----------------------------------------------------------------------
     void TextureUnitState::_load(void)
     {
 
@@ -0,0 +1,360 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreTransformHierarchy.h"
+#include "OgreSIMDHelper.h"
+
+namespace Ogre {
+
+#if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
+    namespace {
+        /// load the values of 4 parents
+        inline __m128 gather4(const std::vector<Real>& a, const uint32* idx)
+        {
+            return _mm_setr_ps(a[idx[0]], a[idx[1]], a[idx[2]], a[idx[3]]);
+        }
+
+        inline __m128 select(__m128 mask, __m128 a, __m128 b)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+    }
+#endif
+    //-----------------------------------------------------------------------
+    TransformHierarchy::TransformHierarchy() : mNumNodes(0), mNumUpdated(0), mStructureChanged(true) {}
+    //-----------------------------------------------------------------------
+    TransformHierarchy::~TransformHierarchy() {}
+    //-----------------------------------------------------------------------
+    bool TransformHierarchy::_markDirty(SceneNode* node)
+    {
+        // slots of detached nodes are stale until the next rebuild
+        uint32 slot = node->mTransformSlot;
+        if (mStructureChanged || slot >= mNodes.size() || mNodes[slot] != node)
+            return false;
+
+        setBit(mDirty, slot);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void TransformHierarchy::rebuild(SceneNode* root)
+    {
+        mNodes.clear();
+        mParent.clear();
+        mFirstChild.clear();
+        mNumChildren.clear();
+
+        auto pad = [this]() {
+            while (mNodes.size() % 4)
+            {
+                mNodes.push_back(NULL);
+                mParent.push_back(0);
+            }
+        };
+
+        mNodes.push_back(root);
+        mParent.push_back(0);
+        pad();
+
+        // append the children of one level to form the next one
+        uint32 begin = 0;
+        while (begin < mNodes.size())
+        {
+            uint32 end = uint32(mNodes.size());
+            for (uint32 i = begin; i < end; i++)
+            {
+                mFirstChild.push_back(uint32(mNodes.size()));
+                uint32 numChildren = 0;
+                if (mNodes[i])
+                {
+                    for (auto c : mNodes[i]->getChildren())
+                    {
+                        mNodes.push_back(static_cast<SceneNode*>(c));
+                        mParent.push_back(i);
+                        numChildren++;
+                    }
+                }
+                mNumChildren.push_back(numChildren);
+            }
+            pad();
+            begin = end;
+        }
+
+        size_t size = mNodes.size();
+        for (int c = 0; c < 3; c++)
+        {
+            mPosition[c].resize(size, 0);
+            mScale[c].resize(size, 1);
+            mDerivedPosition[c].resize(size, 0);
+            mDerivedScale[c].resize(size, 1);
+        }
+        for (int c = 0; c < 4; c++)
+        {
+            mOrientation[c].resize(size, c == 0);
+            mDerivedOrientation[c].resize(size, c == 0);
+        }
+        mInheritOrientation.resize(size, 1);
+        mInheritScale.resize(size, 1);
+
+        size_t numWords = (size + 63) / 64;
+        mDirty.assign(numWords, 0);
+        mChanged.assign(numWords, 0);
+        mBoundsDirty.assign(numWords, 0);
+
+        // everything is recomputed after a structural change
+        mNumNodes = 0;
+        for (uint32 i = 0; i < size; i++)
+        {
+            if (!mNodes[i])
+                continue;
+            mNodes[i]->mTransformSlot = i;
+            setBit(mDirty, i);
+            mNumNodes++;
+        }
+
+        mStructureChanged = false;
+    }
+    //-----------------------------------------------------------------------
+    void TransformHierarchy::gather(uint32 i)
+    {
+        const SceneNode* n = mNodes[i];
+        for (int c = 0; c < 3; c++)
+        {
+            mPosition[c][i] = n->mPosition[c];
+            mScale[c][i] = n->mScale[c];
+        }
+        mOrientation[0][i] = n->mOrientation.w;
+        mOrientation[1][i] = n->mOrientation.x;
+        mOrientation[2][i] = n->mOrientation.y;
+        mOrientation[3][i] = n->mOrientation.z;
+        mInheritOrientation[i] = n->mInheritOrientation;
+        mInheritScale[i] = n->mInheritScale;
+    }
+    //-----------------------------------------------------------------------
+    void TransformHierarchy::updateGroup(uint32 i)
+    {
+        // same operations in the same order as Node::updateFromParentImpl, so the results match
+#if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
+        const uint32* p = &mParent[i];
+        const __m128 two = _mm_set1_ps(2);
+
+        __m128 pqw = gather4(mDerivedOrientation[0], p), pqx = gather4(mDerivedOrientation[1], p);
+        __m128 pqy = gather4(mDerivedOrientation[2], p), pqz = gather4(mDerivedOrientation[3], p);
+        __m128 psx = gather4(mDerivedScale[0], p), psy = gather4(mDerivedScale[1], p);
+        __m128 psz = gather4(mDerivedScale[2], p);
+
+        // position: parentOrientation * (parentScale * position) + parentPosition
+        __m128 vx = _mm_mul_ps(psx, _mm_loadu_ps(&mPosition[0][i]));
+        __m128 vy = _mm_mul_ps(psy, _mm_loadu_ps(&mPosition[1][i]));
+        __m128 vz = _mm_mul_ps(psz, _mm_loadu_ps(&mPosition[2][i]));
+
+        __m128 uvx = _mm_sub_ps(_mm_mul_ps(pqy, vz), _mm_mul_ps(pqz, vy));
+        __m128 uvy = _mm_sub_ps(_mm_mul_ps(pqz, vx), _mm_mul_ps(pqx, vz));
+        __m128 uvz = _mm_sub_ps(_mm_mul_ps(pqx, vy), _mm_mul_ps(pqy, vx));
+        __m128 uuvx = _mm_sub_ps(_mm_mul_ps(pqy, uvz), _mm_mul_ps(pqz, uvy));
+        __m128 uuvy = _mm_sub_ps(_mm_mul_ps(pqz, uvx), _mm_mul_ps(pqx, uvz));
+        __m128 uuvz = _mm_sub_ps(_mm_mul_ps(pqx, uvy), _mm_mul_ps(pqy, uvx));
+
+        __m128 w2 = _mm_mul_ps(two, pqw);
+        vx = _mm_add_ps(_mm_add_ps(vx, _mm_mul_ps(uvx, w2)), _mm_mul_ps(uuvx, two));
+        vy = _mm_add_ps(_mm_add_ps(vy, _mm_mul_ps(uvy, w2)), _mm_mul_ps(uuvy, two));
+        vz = _mm_add_ps(_mm_add_ps(vz, _mm_mul_ps(uvz, w2)), _mm_mul_ps(uuvz, two));
+
+        _mm_storeu_ps(&mDerivedPosition[0][i], _mm_add_ps(vx, gather4(mDerivedPosition[0], p)));
+        _mm_storeu_ps(&mDerivedPosition[1][i], _mm_add_ps(vy, gather4(mDerivedPosition[1], p)));
+        _mm_storeu_ps(&mDerivedPosition[2][i], _mm_add_ps(vz, gather4(mDerivedPosition[2], p)));
+
+        // scale
+        __m128 inherit = _mm_cmpneq_ps(_mm_loadu_ps(&mInheritScale[i]), _mm_setzero_ps());
+        __m128 sx = _mm_loadu_ps(&mScale[0][i]);
+        __m128 sy = _mm_loadu_ps(&mScale[1][i]);
+        __m128 sz = _mm_loadu_ps(&mScale[2][i]);
+        _mm_storeu_ps(&mDerivedScale[0][i], select(inherit, _mm_mul_ps(psx, sx), sx));
+        _mm_storeu_ps(&mDerivedScale[1][i], select(inherit, _mm_mul_ps(psy, sy), sy));
+        _mm_storeu_ps(&mDerivedScale[2][i], select(inherit, _mm_mul_ps(psz, sz), sz));
+
+        // orientation
+        inherit = _mm_cmpneq_ps(_mm_loadu_ps(&mInheritOrientation[i]), _mm_setzero_ps());
+        __m128 qw = _mm_loadu_ps(&mOrientation[0][i]);
+        __m128 qx = _mm_loadu_ps(&mOrientation[1][i]);
+        __m128 qy = _mm_loadu_ps(&mOrientation[2][i]);
+        __m128 qz = _mm_loadu_ps(&mOrientation[3][i]);
+
+        __m128 rw = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(pqw, qw), _mm_mul_ps(pqx, qx)),
+                                          _mm_mul_ps(pqy, qy)), _mm_mul_ps(pqz, qz));
+        __m128 rx = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pqw, qx), _mm_mul_ps(pqx, qw)),
+                                          _mm_mul_ps(pqy, qz)), _mm_mul_ps(pqz, qy));
+        __m128 ry = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pqw, qy), _mm_mul_ps(pqy, qw)),
+                                          _mm_mul_ps(pqz, qx)), _mm_mul_ps(pqx, qz));
+        __m128 rz = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pqw, qz), _mm_mul_ps(pqz, qw)),
+                                          _mm_mul_ps(pqx, qy)), _mm_mul_ps(pqy, qx));
+
+        _mm_storeu_ps(&mDerivedOrientation[0][i], select(inherit, rw, qw));
+        _mm_storeu_ps(&mDerivedOrientation[1][i], select(inherit, rx, qx));
+        _mm_storeu_ps(&mDerivedOrientation[2][i], select(inherit, ry, qy));
+        _mm_storeu_ps(&mDerivedOrientation[3][i], select(inherit, rz, qz));
+#else
+        for (uint32 j = i; j < i + 4; j++)
+        {
+            uint32 p = mParent[j];
+            Quaternion parentOrientation(mDerivedOrientation[0][p], mDerivedOrientation[1][p],
+                                         mDerivedOrientation[2][p], mDerivedOrientation[3][p]);
+            Vector3 parentScale(mDerivedScale[0][p], mDerivedScale[1][p], mDerivedScale[2][p]);
+            Vector3 parentPosition(mDerivedPosition[0][p], mDerivedPosition[1][p], mDerivedPosition[2][p]);
+
+            Quaternion orientation(mOrientation[0][j], mOrientation[1][j], mOrientation[2][j], mOrientation[3][j]);
+            Vector3 scale(mScale[0][j], mScale[1][j], mScale[2][j]);
+            Vector3 position(mPosition[0][j], mPosition[1][j], mPosition[2][j]);
+
+            if (mInheritOrientation[j] != 0)
+                orientation = parentOrientation * orientation;
+            if (mInheritScale[j] != 0)
+                scale = parentScale * scale;
+            position = parentOrientation * (parentScale * position) + parentPosition;
+
+            mDerivedOrientation[0][j] = orientation.w;
+            mDerivedOrientation[1][j] = orientation.x;
+            mDerivedOrientation[2][j] = orientation.y;
+            mDerivedOrientation[3][j] = orientation.z;
+            for (int c = 0; c < 3; c++)
+            {
+                mDerivedScale[c][j] = scale[c];
+                mDerivedPosition[c][j] = position[c];
+            }
+        }
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void TransformHierarchy::scatter(uint32 i)
+    {
+        SceneNode* n = mNodes[i];
+        n->mDerivedPosition = Vector3(mDerivedPosition[0][i], mDerivedPosition[1][i], mDerivedPosition[2][i]);
+        n->mDerivedOrientation = Quaternion(mDerivedOrientation[0][i], mDerivedOrientation[1][i],
+                                            mDerivedOrientation[2][i], mDerivedOrientation[3][i]);
+        n->mDerivedScale = Vector3(mDerivedScale[0][i], mDerivedScale[1][i], mDerivedScale[2][i]);
+
+        // the bookkeeping of Node::_update and Node::_updateFromParent
+        n->mCachedTransformOutOfDate = true;
+        n->mNeedParentUpdate = false;
+        n->mNeedChildUpdate = false;
+        n->mParentNotified = false;
+        n->mChildrenToUpdate.clear();
+
+        for (auto o : n->getAttachedObjects())
+            o->_notifyMoved();
+
+        if (auto listener = n->getListener())
+            listener->nodeUpdated(n);
+    }
+    //-----------------------------------------------------------------------
+    void TransformHierarchy::update(SceneNode* root)
+    {
+        if (mStructureChanged || mNodes.empty() || mNodes[0] != root)
+            rebuild(root);
+
+        // changes made by the listeners below are picked up by the next update
+        mChanged.swap(mDirty);
+        std::fill(mDirty.begin(), mDirty.end(), 0);
+
+        for (size_t w = 0; w < mChanged.size(); w++)
+        {
+            uint64 word = mChanged[w];
+            for (uint32 i = uint32(w * 64); word; word >>= 1, i++)
+            {
+                if (word & 1)
+                    gather(i);
+            }
+        }
+
+        // top down: the derived transforms
+        mNumUpdated = 0;
+        uint32 size = uint32(mNodes.size());
+        for (uint32 i = 0; i < size; i += 4)
+        {
+            uint64 word = mChanged[i >> 6];
+            if (!word)
+            {
+                // skip to the next word
+                i = (i | 63) - 3;
+                continue;
+            }
+
+            uint32 lanes = (word >> (i & 63)) & 0xF;
+            if (!lanes)
+                continue;
+
+            if (i == 0)
+            {
+                // the root has no parent
+                for (int c = 0; c < 3; c++)
+                {
+                    mDerivedPosition[c][0] = mPosition[c][0];
+                    mDerivedScale[c][0] = mScale[c][0];
+                }
+                for (int c = 0; c < 4; c++)
+                    mDerivedOrientation[c][0] = mOrientation[c][0];
+            }
+            else
+            {
+                updateGroup(i);
+            }
+
+            for (uint32 j = i; lanes; lanes >>= 1, j++)
+            {
+                if (!(lanes & 1))
+                    continue;
+
+                scatter(j);
+                setBit(mBoundsDirty, j);
+                mNumUpdated++;
+
+                // the children are in a later group, so they are visited in this pass
+                for (uint32 c = mFirstChild[j]; c < mFirstChild[j] + mNumChildren[j]; c++)
+                    setBit(mChanged, c);
+            }
+        }
+
+        // bottom up: the world bounds of the changed nodes and their ancestors
+        for (size_t w = mBoundsDirty.size(); w-- > 0;)
+        {
+            for (int b = 63; b >= 0; b--)
+            {
+                if (!((mBoundsDirty[w] >> b) & 1))
+                    continue;
+
+                uint32 i = uint32(w * 64 + b);
+                mNodes[i]->_updateBounds();
+                // parents precede their children, so they are visited later in this loop
+                if (i != 0)
+                    setBit(mBoundsDirty, mParent[i]);
+            }
+            mBoundsDirty[w] = 0;
+        }
+
+        std::fill(mChanged.begin(), mChanged.end(), 0);
+    }
+}
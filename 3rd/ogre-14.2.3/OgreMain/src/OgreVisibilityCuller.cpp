@@ -0,0 +1,328 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreVisibilityCuller.h"
+#include "OgreSIMDHelper.h"
+
+#include <functional>
+
+namespace Ogre {
+
+    /// nodes gathered and tested by one task, smaller graphs are culled on the calling thread
+    static const size_t NODES_PER_TASK = 4096;
+    /// visible nodes whose objects are updated by one task
+    static const size_t VISIBLE_NODES_PER_TASK = 256;
+
+    /// run task(0) to task(numTasks - 1) on the worker threads and the calling thread
+    static void runTasks(WorkQueue* wq, size_t numTasks, const std::function<void(size_t)>& task)
+    {
+        if (wq)
+            return wq->runTasks(numTasks, task);
+
+        for (size_t t = 0; t < numTasks; t++)
+            task(t);
+    }
+
+    /// what the objects of a range of visible nodes add to the queue
+    struct VisibilityCuller::QueueTask
+    {
+        RenderQueue queue;
+        RenderQueue::RecordedRenderableList renderables;
+        /// objects to update on the calling thread, after the given number of recorded renderables
+        std::vector<std::pair<size_t, MovableObject*>> deferred;
+        VisibleObjectsBoundsInfo bounds;
+        size_t numConcurrent;
+    };
+
+    //-----------------------------------------------------------------------
+    VisibilityCuller::VisibilityCuller()
+        : mNumVisible(0), mNumConcurrent(0), mStructureChanged(true), mBoundsChanged(true)
+    {
+    }
+    //-----------------------------------------------------------------------
+    VisibilityCuller::~VisibilityCuller() {}
+    //-----------------------------------------------------------------------
+    void VisibilityCuller::append(SceneNode* node)
+    {
+        uint32 i = uint32(mNodes.size());
+        mNodes.push_back(node);
+        mSubtreeEnd.push_back(0);
+
+        for (auto c : node->getChildren())
+            append(static_cast<SceneNode*>(c));
+
+        mSubtreeEnd[i] = uint32(mNodes.size());
+    }
+    //-----------------------------------------------------------------------
+    void VisibilityCuller::rebuild(SceneNode* root)
+    {
+        mNodes.clear();
+        mSubtreeEnd.clear();
+        append(root);
+
+        size_t size = (mNodes.size() + 3) & ~size_t(3);
+        for (int c = 0; c < 3; c++)
+        {
+            mCentre[c].assign(size, 0);
+            mHalfSize[c].assign(size, 0);
+        }
+        mNullBounds.assign(size, true);
+        mVisible.assign(size, false);
+
+        mStructureChanged = false;
+        mBoundsChanged = true;
+    }
+    //-----------------------------------------------------------------------
+    void VisibilityCuller::gather(size_t begin, size_t end)
+    {
+        end = std::min(end, mNodes.size());
+        for (size_t i = begin; i < end; i++)
+        {
+            const AxisAlignedBox& box = mNodes[i]->_getWorldAABB();
+            mNullBounds[i] = box.isNull();
+
+            // infinite boxes pass every plane
+            Vector3 centre = Vector3::ZERO, halfSize(std::numeric_limits<Real>::max());
+            if (box.isFinite())
+            {
+                centre = box.getCenter();
+                halfSize = box.getHalfSize();
+            }
+            for (int c = 0; c < 3; c++)
+            {
+                mCentre[c][i] = centre[c];
+                mHalfSize[c][i] = halfSize[c];
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void VisibilityCuller::cull(const Plane* planes, int numPlanes, size_t begin, size_t end)
+    {
+        // same operations in the same order as Plane::getSide, so the results match Frustum::isVisible
+#if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
+        for (size_t i = begin; i < end; i += 4)
+        {
+            __m128 cx = _mm_loadu_ps(&mCentre[0][i]);
+            __m128 cy = _mm_loadu_ps(&mCentre[1][i]);
+            __m128 cz = _mm_loadu_ps(&mCentre[2][i]);
+            __m128 hx = _mm_loadu_ps(&mHalfSize[0][i]);
+            __m128 hy = _mm_loadu_ps(&mHalfSize[1][i]);
+            __m128 hz = _mm_loadu_ps(&mHalfSize[2][i]);
+
+            __m128 culled = _mm_setzero_ps();
+            for (int p = 0; p < numPlanes; p++)
+            {
+                const Vector3& n = planes[p].normal;
+                __m128 dist = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n.x), cx), _mm_mul_ps(_mm_set1_ps(n.y), cy));
+                dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(n.z), cz));
+                dist = _mm_add_ps(dist, _mm_set1_ps(planes[p].d));
+
+                // |n.x * h.x| == |n.x| * h.x as the half size is positive
+                __m128 maxAbsDist = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Math::Abs(n.x)), hx),
+                                               _mm_mul_ps(_mm_set1_ps(Math::Abs(n.y)), hy));
+                maxAbsDist = _mm_add_ps(maxAbsDist, _mm_mul_ps(_mm_set1_ps(Math::Abs(n.z)), hz));
+
+                culled = _mm_or_ps(culled, _mm_cmplt_ps(dist, _mm_sub_ps(_mm_setzero_ps(), maxAbsDist)));
+            }
+
+            int mask = _mm_movemask_ps(culled);
+            for (int lane = 0; lane < 4; lane++)
+                mVisible[i + lane] = !((mask >> lane) & 1) && !mNullBounds[i + lane];
+        }
+#else
+        for (size_t i = begin; i < end; i++)
+        {
+            Vector3 centre(mCentre[0][i], mCentre[1][i], mCentre[2][i]);
+            Vector3 halfSize(mHalfSize[0][i], mHalfSize[1][i], mHalfSize[2][i]);
+
+            mVisible[i] = !mNullBounds[i];
+            for (int p = 0; p < numPlanes && mVisible[i]; p++)
+                mVisible[i] = planes[p].getSide(centre, halfSize) != Plane::NEGATIVE_SIDE;
+        }
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void VisibilityCuller::findVisibleObjects(SceneNode* root, Camera* cam, RenderQueue* queue,
+                                              VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+    {
+        if (mStructureChanged)
+            rebuild(root);
+
+        // the planes Frustum::isVisible tests against
+        const Frustum* frustum = cam->getCullingFrustum() ? cam->getCullingFrustum() : cam;
+        const Plane* frustumPlanes = frustum->getFrustumPlanes();
+        Plane planes[6];
+        int numPlanes = 0;
+        for (int p = 0; p < 6; p++)
+        {
+            // Skip far plane if infinite view frustum
+            if (p == FRUSTUM_PLANE_FAR && frustum->getFarClipDistance() == 0)
+                continue;
+            planes[numPlanes++] = frustumPlanes[p];
+        }
+
+        size_t size = mVisible.size();
+        size_t numTasks = (size + NODES_PER_TASK - 1) / NODES_PER_TASK;
+        WorkQueue* wq = Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+        bool gatherBounds = mBoundsChanged;
+        mBoundsChanged = false;
+        runTasks(wq, numTasks, [this, &planes, numPlanes, size, gatherBounds](size_t t) {
+            size_t begin = t * NODES_PER_TASK, end = std::min(size, begin + NODES_PER_TASK);
+            if (gatherBounds)
+                gather(begin, end);
+            cull(planes, numPlanes, begin, end);
+        });
+
+        SceneManager* sceneMgr = root->getCreator();
+        DebugDrawer* debugDrawer = sceneMgr ? sceneMgr->getDebugDrawer() : NULL;
+        bool parallelQueueing = sceneMgr && sceneMgr->isParallelQueueingEnabled() && !sceneMgr->hasLodListeners();
+
+        // with parallel queueing only collect the visible nodes here
+        mVisibleNodes.clear();
+        mOpenNodes.clear();
+        mNumVisible = 0;
+        mNumConcurrent = 0;
+
+        uint32 numNodes = uint32(mNodes.size());
+        for (uint32 i = 0; i < numNodes;)
+        {
+            // like the recursion, draw a node after its descendants
+            while (!mOpenNodes.empty() && mSubtreeEnd[mOpenNodes.back()] <= i)
+            {
+                debugDrawer->drawSceneNode(mNodes[mOpenNodes.back()]);
+                mOpenNodes.pop_back();
+            }
+
+            if (!mVisible[i])
+            {
+                i = mSubtreeEnd[i];
+                continue;
+            }
+
+            mNumVisible++;
+            if (parallelQueueing)
+            {
+                mVisibleNodes.push_back(i);
+            }
+            else
+            {
+                for (auto o : mNodes[i]->getAttachedObjects())
+                {
+                    queue->processVisibleObject(o, cam, onlyShadowCasters, visibleBounds);
+                }
+            }
+
+            if (debugDrawer)
+                mOpenNodes.push_back(i);
+            i++;
+        }
+
+        while (!mOpenNodes.empty())
+        {
+            debugDrawer->drawSceneNode(mNodes[mOpenNodes.back()]);
+            mOpenNodes.pop_back();
+        }
+
+        if (parallelQueueing)
+            queueVisibleParallel(wq, cam, queue, visibleBounds, onlyShadowCasters);
+    }
+    //-----------------------------------------------------------------------
+    void VisibilityCuller::queueVisibleParallel(WorkQueue* wq, Camera* cam, RenderQueue* queue,
+                                                VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+    {
+        size_t numVisible = mVisibleNodes.size();
+        size_t numTasks = (numVisible + VISIBLE_NODES_PER_TASK - 1) / VISIBLE_NODES_PER_TASK;
+        while (mQueueTasks.size() < numTasks)
+            mQueueTasks.emplace_back(new QueueTask());
+
+        for (size_t t = 0; t < numTasks; t++)
+        {
+            QueueTask& task = *mQueueTasks[t];
+            task.renderables.clear();
+            task.deferred.clear();
+            task.bounds.reset();
+            task.numConcurrent = 0;
+            task.queue._setRecording(queue, &task.renderables);
+        }
+
+        // bring the cached camera state up to date, so the tasks only read it
+        for (const Camera* c : {static_cast<const Camera*>(cam), cam->getLodCamera()})
+        {
+            c->getViewMatrix(true);
+            c->getProjectionMatrix();
+            c->getDerivedPosition();
+        }
+
+        runTasks(wq, numTasks, [this, cam, onlyShadowCasters, numVisible](size_t t) {
+            QueueTask& task = *mQueueTasks[t];
+            size_t end = std::min(numVisible, (t + 1) * VISIBLE_NODES_PER_TASK);
+            for (size_t v = t * VISIBLE_NODES_PER_TASK; v < end; v++)
+            {
+                for (auto o : mNodes[mVisibleNodes[v]]->getAttachedObjects())
+                {
+                    if (o->_canUpdateRenderQueueConcurrently())
+                    {
+                        task.queue.processVisibleObject(o, cam, onlyShadowCasters, &task.bounds);
+                        task.numConcurrent++;
+                    }
+                    else
+                    {
+                        if (!onlyShadowCasters || o->getCastShadows())
+                            o->_prepareRenderQueueUpdate();
+                        task.deferred.push_back({task.renderables.size(), o});
+                    }
+                }
+            }
+        });
+
+        // queue in the order of the scene graph, with the other objects in their place
+        for (size_t t = 0; t < numTasks; t++)
+        {
+            QueueTask& task = *mQueueTasks[t];
+            size_t r = 0;
+            auto addRecorded = [&task, &r, queue](size_t end) {
+                for (; r < end; r++)
+                {
+                    const auto& rr = task.renderables[r];
+                    queue->addRenderable(rr.renderable, rr.groupID, rr.priority);
+                }
+            };
+
+            for (const auto& d : task.deferred)
+            {
+                addRecorded(d.first);
+                queue->processVisibleObject(d.second, cam, onlyShadowCasters, visibleBounds);
+            }
+            addRecorded(task.renderables.size());
+
+            if (visibleBounds)
+                visibleBounds->merge(task.bounds);
+            mNumConcurrent += task.numConcurrent;
+        }
+    }
+}
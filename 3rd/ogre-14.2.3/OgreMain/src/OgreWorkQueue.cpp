@@ -29,6 +29,11 @@ THE SOFTWARE.
 #include "OgreWorkQueue.h"
 #include "OgreTimer.h"
 
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 namespace Ogre {
     void WorkQueue::processMainThreadTasks()
     {
@@ -37,6 +42,65 @@ namespace Ogre {
         OGRE_IGNORE_DEPRECATED_END
     }
     //---------------------------------------------------------------------
+    void WorkQueue::runTasks(size_t numTasks, const std::function<void(size_t)>& task)
+    {
+        struct Progress
+        {
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            std::mutex errorMutex;
+            std::exception_ptr error;
+
+            // a throwing task counts as done, the first exception is kept for the caller
+            void run(const std::function<void(size_t)>& task, size_t t)
+            {
+                try
+                {
+                    task(t);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+        };
+
+        if (numTasks < 2 || !getRequestsAccepted() || isPaused())
+        {
+            Progress progress;
+            for (size_t t = 0; t < numTasks; t++)
+                progress.run(task, t);
+            if (progress.error)
+                std::rethrow_exception(progress.error);
+            return;
+        }
+
+        auto progress = std::make_shared<Progress>();
+        auto work = [progress, numTasks, task]() {
+            size_t t;
+            while ((t = progress->next++) < numTasks)
+            {
+                progress->run(task, t);
+                progress->done++;
+            }
+        };
+
+        size_t numHelpers = std::min(numTasks - 1, getWorkerThreadCount());
+        for (size_t i = 0; i < numHelpers; i++)
+            addTask(work);
+        work();
+
+        // tasks that start late find nothing left to do
+        while (progress->done < numTasks)
+            std::this_thread::yield();
+
+        // only now, the tasks may refer to the caller's locals
+        if (progress->error)
+            std::rethrow_exception(progress->error);
+    }
+    //---------------------------------------------------------------------
     WorkQueue::Request::Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid)
         : mChannel(channel), mType(rtype), mData(rData), mRetryCount(retry), mID(rid), mAborted(false)
     {
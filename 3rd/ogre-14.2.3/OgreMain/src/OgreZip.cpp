@@ -28,19 +28,66 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 
 #if OGRE_NO_ZIP_ARCHIVE == 0
-#include <zip.h>
+#include "OgreFileSystem.h"
+
+// the miniz bundled with zip.c, its implementation is compiled there
+#define MINIZ_HEADER_FILE_ONLY
+#include "zip/miniz.h"
 
 namespace Ogre {
 namespace {
+    uint16 readU16(const uchar* p) { return uint16(p[0] | p[1] << 8); }
+    uint32 readU32(const uchar* p) { return p[0] | p[1] << 8 | p[2] << 16 | uint32(p[3]) << 24; }
+    uint64 readU64(const uchar* p) { return readU32(p) | uint64(readU32(p + 4)) << 32; }
+
+    /// a stored entry, read in place from the archive buffer, which it keeps alive
+    class ZipEntryDataStream : public MemoryDataStream
+    {
+        MemoryDataStreamPtr mArchiveBuffer;
+    public:
+        ZipEntryDataStream(const String& name, uchar* data, size_t size, const MemoryDataStreamPtr& archiveBuffer)
+            : MemoryDataStream(name, data, size, false, true), mArchiveBuffer(archiveBuffer)
+        {
+        }
+    };
+
+    /** Reads the entries of the zip file straight from its central directory
+
+        The archive is mapped into memory if possible. The entries are found through a hash index. Stored
+        entries are returned in place, deflated ones are inflated without locking, so several threads can
+        open entries at the same time.
+    */
     class ZipArchive : public Archive
     {
     protected:
-        /// Handle to root zip file
-        zip_t* mZipFile;
+        /// where the data of an entry is in mBuffer
+        struct Entry
+        {
+            size_t localHeader;
+            size_t compressedSize;
+            size_t size;
+            uint32 crc32;
+            uint16 method;
+            uint16 flags;
+        };
+        /// the whole zip file
         MemoryDataStreamPtr mBuffer;
-        /// File list (since zziplib seems to only allow scanning of dir tree once)
+        /// File list, directories included
         FileInfoList mFileList;
+        /// the entries in the order of mFileList
+        std::vector<Entry> mEntries;
+        /// index into mFileList by the path in the archive, lower case if not OGRE_RESOURCEMANAGER_STRICT
+        std::unordered_map<String, size_t> mIndex;
+#if !OGRE_RESOURCEMANAGER_STRICT
+        /// index into mFileList by the base name of files, SIZE_MAX if it is ambiguous
+        std::unordered_map<String, size_t> mBasenameIndex;
+#endif
+        bool mLoaded;
         OGRE_AUTO_MUTEX;
+
+        void readCentralDirectory();
+        /// index of filename into mFileList, SIZE_MAX if not found
+        size_t findEntry(const String& filename) const;
     public:
         ZipArchive(const String& name, const String& archType, const uint8* externBuf = 0, size_t externBufSz = 0);
         ~ZipArchive();
@@ -84,7 +131,7 @@ namespace {
 }
     //-----------------------------------------------------------------------
     ZipArchive::ZipArchive(const String& name, const String& archType, const uint8* externBuf, size_t externBufSz)
-        : Archive(name, archType), mZipFile(0)
+        : Archive(name, archType), mLoaded(false)
     {
         if(externBuf)
             mBuffer.reset(new MemoryDataStream(const_cast<uint8*>(externBuf), externBufSz));
@@ -98,95 +145,207 @@ namespace {
     void ZipArchive::load()
     {
         OGRE_LOCK_AUTO_MUTEX;
-        if (!mZipFile)
+        if (!mLoaded)
         {
             if(!mBuffer)
-                mBuffer.reset(new MemoryDataStream(_openFileStream(mName, std::ios::binary)));
-
-            mZipFile = zip_stream_open((const char*)mBuffer->getPtr(), mBuffer->size(), 0, 'r');
-
-            // Cache names
-            int n = zip_entries_total(mZipFile);
-            for (int i = 0; i < n; ++i) {
-                FileInfo info;
-                info.archive = this;
+            {
+                // stored entries are then read in place
+                mBuffer = std::dynamic_pointer_cast<MemoryDataStream>(_mapFileStream(mName));
+                if (!mBuffer)
+                    mBuffer.reset(new MemoryDataStream(_openFileStream(mName, std::ios::binary)));
+            }
 
-                zip_entry_openbyindex(mZipFile, i);
+            readCentralDirectory();
+            mLoaded = true;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ZipArchive::readCentralDirectory()
+    {
+        const uchar* data = mBuffer->getPtr();
+        size_t size = mBuffer->size();
 
-                info.filename = zip_entry_name(mZipFile);
-                // Get basename / path
-                StringUtil::splitFilename(info.filename, info.basename, info.path);
+        // the end of central directory record, followed by a comment of up to 64k
+        size_t eocd = size;
+        if (size >= 22)
+        {
+            size_t last = size - 22, first = last > 0xFFFF ? last - 0xFFFF : 0;
+            for (size_t i = last + 1; i-- > first;)
+            {
+                if (readU32(data + i) == 0x06054b50)
+                {
+                    eocd = i;
+                    break;
+                }
+            }
+        }
+        if (eocd == size)
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "'" + mName + "' is not a zip archive");
 
-                // Get sizes
-                info.uncompressedSize = zip_entry_size(mZipFile);
-                info.compressedSize = zip_entry_comp_size(mZipFile);
+        uint64 numEntries = readU16(data + eocd + 10);
+        uint64 offset = readU32(data + eocd + 16);
+        if ((numEntries == 0xFFFF || offset == 0xFFFFFFFF) && eocd >= 20 && readU32(data + eocd - 20) == 0x07064b50)
+        {
+            // the zip64 end of central directory record
+            uint64 eocd64 = readU64(data + eocd - 20 + 8);
+            if (eocd64 + 56 <= size && readU32(data + eocd64) == 0x06064b50)
+            {
+                numEntries = readU64(data + eocd64 + 32);
+                offset = readU64(data + eocd64 + 48);
+            }
+        }
 
-                if (zip_entry_isdir(mZipFile))
+        mFileList.reserve(numEntries);
+        mEntries.reserve(numEntries);
+        for (uint64 i = 0; i < numEntries; i++)
+        {
+            const uchar* header = data + offset;
+            if (offset + 46 > size || readU32(header) != 0x02014b50 ||
+                offset + 46 + readU16(header + 28) + readU16(header + 30) + readU16(header + 32) > size)
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "corrupt central directory in '" + mName + "'");
+
+            Entry entry;
+            entry.flags = readU16(header + 8);
+            entry.method = readU16(header + 10);
+            entry.crc32 = readU32(header + 16);
+            uint64 compressedSize = readU32(header + 20);
+            uint64 uncompressedSize = readU32(header + 24);
+            uint64 localHeader = readU32(header + 42);
+            uint16 nameLen = readU16(header + 28), extraLen = readU16(header + 30);
+
+            // the zip64 sizes and offset, in this order, if the 32 bit fields overflowed
+            for (const uchar* extra = header + 46 + nameLen; extra + 4 <= header + 46 + nameLen + extraLen;)
+            {
+                const uchar* field = extra + 4;
+                const uchar* fieldEnd = field + readU16(extra + 2);
+                if (readU16(extra) == 0x0001)
                 {
-                    info.filename = info.filename.substr(0, info.filename.length() - 1);
-                    StringUtil::splitFilename(info.filename, info.basename, info.path);
-                    // Set compressed size to -1 for folders; anyway nobody will check
-                    // the compressed size of a folder, and if he does, its useless anyway
-                    info.compressedSize = size_t(-1);
+                    for (uint64* v : {&uncompressedSize, &compressedSize, &localHeader})
+                    {
+                        if (*v == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                        {
+                            *v = readU64(field);
+                            field += 8;
+                        }
+                    }
                 }
+                extra = fieldEnd;
+            }
+            entry.compressedSize = compressedSize;
+            entry.size = uncompressedSize;
+            entry.localHeader = localHeader;
+
+            FileInfo info;
+            info.archive = this;
+            info.filename.assign((const char*)header + 46, nameLen);
+            std::replace(info.filename.begin(), info.filename.end(), '\\', '/');
+            String path = info.filename;
+            // Get basename / path
+            StringUtil::splitFilename(info.filename, info.basename, info.path);
+
+            // Get sizes
+            info.uncompressedSize = entry.size;
+            info.compressedSize = entry.compressedSize;
+
+            if (!info.filename.empty() && info.filename.back() == '/')
+            {
+                info.filename = info.filename.substr(0, info.filename.length() - 1);
+                StringUtil::splitFilename(info.filename, info.basename, info.path);
+                path = info.filename;
+                // Set compressed size to -1 for folders; anyway nobody will check
+                // the compressed size of a folder, and if he does, its useless anyway
+                info.compressedSize = size_t(-1);
+            }
 #if !OGRE_RESOURCEMANAGER_STRICT
-                else
-                {
-                    info.filename = info.basename;
-                }
-#endif
-                zip_entry_close(mZipFile);
-                mFileList.push_back(info);
+            else
+            {
+                info.filename = info.basename;
+                auto it = mBasenameIndex.emplace(info.basename, mFileList.size());
+                if (!it.second)
+                    it.first->second = SIZE_MAX;
             }
+            StringUtil::toLowerCase(path);
+#endif
+            mIndex.emplace(path, mFileList.size());
+            mFileList.push_back(info);
+            mEntries.push_back(entry);
+
+            offset += 46 + nameLen + extraLen + readU16(header + 32);
         }
     }
     //-----------------------------------------------------------------------
     void ZipArchive::unload()
     {
         OGRE_LOCK_AUTO_MUTEX;
-        if (mZipFile)
+        if (mLoaded)
         {
-            zip_close(mZipFile);
-            mZipFile = 0;
+            mLoaded = false;
             mFileList.clear();
+            mEntries.clear();
+            mIndex.clear();
+#if !OGRE_RESOURCEMANAGER_STRICT
+            mBasenameIndex.clear();
+#endif
             mBuffer.reset();
         }
     
+    }
+    //-----------------------------------------------------------------------
+    size_t ZipArchive::findEntry(const String& filename) const
+    {
+#if OGRE_RESOURCEMANAGER_STRICT
+        auto it = mIndex.find(filename);
+        return it != mIndex.end() ? it->second : SIZE_MAX;
+#else
+        String path = filename;
+        StringUtil::toLowerCase(path);
+        auto it = mIndex.find(path);
+        if (it != mIndex.end())
+            return it->second;
+
+        // Try if we find the file, if there are more files with the same name do not open anyone
+        String basename;
+        StringUtil::splitFilename(filename, basename, path);
+        it = mBasenameIndex.find(basename);
+        return it != mBasenameIndex.end() ? it->second : SIZE_MAX;
+#endif
     }
     //-----------------------------------------------------------------------
     DataStreamPtr ZipArchive::open(const String& filename, bool readOnly) const
     {
-        // zip is not threadsafe
-        OGRE_LOCK_AUTO_MUTEX;
-        String lookUpFileName = filename;
-
-        bool open = zip_entry_open(mZipFile, lookUpFileName.c_str(), OGRE_RESOURCEMANAGER_STRICT) == 0;
-#if !OGRE_RESOURCEMANAGER_STRICT
-        if (!open) // Try if we find the file
+        // the index and buffer do not change once loaded, so no locking is needed
+        size_t idx = findEntry(filename);
+        if (idx == SIZE_MAX || mFileList[idx].compressedSize == size_t(-1))
         {
-            String basename, path;
-            StringUtil::splitFilename(lookUpFileName, basename, path);
-            const FileInfoListPtr fileNfo = findFileInfo(basename, true);
-            if (fileNfo->size() == 1) // If there are more files with the same do not open anyone
-            {
-                Ogre::FileInfo info = fileNfo->at(0);
-                lookUpFileName = info.path + info.basename;
-                open = zip_entry_open(mZipFile, lookUpFileName.c_str(), OGRE_RESOURCEMANAGER_STRICT) == 0;
-            }
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not open "+filename);
         }
-#endif
 
-        if (!open)
+        const Entry& entry = mEntries[idx];
+        const FileInfo& info = mFileList[idx];
+        String name = info.path + info.basename;
+
+        // the data follows the local header, whose extra field may differ from the central one
+        const uchar* header = mBuffer->getPtr() + entry.localHeader;
+        size_t dataOffset = entry.localHeader + 30;
+        if (dataOffset <= mBuffer->size() && readU32(header) == 0x04034b50)
+            dataOffset += readU16(header + 26) + readU16(header + 28);
+        // bit 0: encrypted
+        if (dataOffset + entry.compressedSize > mBuffer->size() || (entry.flags & 1) ||
+            (entry.method != 0 && entry.method != 8))
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not read "+name);
+
+        uchar* data = mBuffer->getPtr() + dataOffset;
+        if (entry.method == 0)
         {
-            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not open "+lookUpFileName);
+            // stored, no copy
+            return std::make_shared<ZipEntryDataStream>(name, data, entry.size, mBuffer);
         }
 
-        // Construct & return stream
-        auto ret = std::make_shared<MemoryDataStream>(lookUpFileName, zip_entry_size(mZipFile));
-
-        if(zip_entry_noallocread(mZipFile, ret->getPtr(), ret->size()) < 0)
-            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not read "+lookUpFileName);
-        zip_entry_close(mZipFile);
+        // deflated, tinfl keeps no state, so entries can be inflated concurrently
+        auto ret = std::make_shared<MemoryDataStream>(name, entry.size);
+        if (tinfl_decompress_mem_to_mem(ret->getPtr(), entry.size, data, entry.compressedSize, 0) != entry.size ||
+            mz_crc32(MZ_CRC32_INIT, ret->getPtr(), entry.size) != entry.crc32)
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not read "+name);
 
         return ret;
     }
@@ -267,19 +426,13 @@ namespace {
     //-----------------------------------------------------------------------
     bool ZipArchive::exists(const String& filename) const
     {       
-        OGRE_LOCK_AUTO_MUTEX;
-        String cleanName = filename;
 #if !OGRE_RESOURCEMANAGER_STRICT
-        if(filename.rfind('/') != String::npos)
-        {
-            StringVector tokens = StringUtil::split(filename, "/");
-            cleanName = tokens[tokens.size() - 1];
-        }
+        String basename, path;
+        StringUtil::splitFilename(filename, basename, path);
+        if (mBasenameIndex.count(basename))
+            return true;
 #endif
-
-        return std::find_if(mFileList.begin(), mFileList.end(), [&cleanName](const Ogre::FileInfo& fi) {
-                   return fi.filename == cleanName;
-               }) != mFileList.end();
+        return findEntry(filename) != SIZE_MAX;
     }
     //---------------------------------------------------------------------
     time_t ZipArchive::getModifiedTime(const String& filename) const
@@ -32,6 +32,14 @@ THE SOFTWARE.
 #include "OgreHardwareBuffer.h"
 
 namespace Ogre {
+    /** OpenGL buffer object
+
+        When created with more than one copy, a buffer that is discarded as a whole in consecutive frames
+        switches to a storage holding that many copies of the buffer, which stays mapped. Discarding then
+        moves on to the next copy, after waiting on the fence placed when it was last left, instead of
+        orphaning the storage, so dynamic geometry rewritten every frame neither reallocates nor stalls.
+        Other writes go through glBufferSubData. Draws have to add getGLBufferOffset.
+    */
     class GL3PlusHardwareBuffer : public HardwareBuffer
     {
     private:
@@ -42,15 +50,39 @@ namespace Ogre {
         // for UBO/ SSBO
         GLint mBindingPoint;
 
+        // persistently mapped copies
+        uchar* mMappedData;
+        size_t mMaxCopies;
+        size_t mNumCopies;
+        size_t mCopy;
+        /// frame of the last whole buffer discard and the number of consecutive frames with one
+        unsigned long mLastDiscardFrame;
+        uint32 mDiscardFrames;
+        /// placed when the copy was left, GPU commands issued before might still read it
+        std::vector<GLsync> mFences;
+        /// locks of mapped buffers that do not discard go through here, as the mapping is write only
+        std::vector<uchar> mScratch;
+        bool mScratchWriteBack;
+
         /// Utility function to get the correct GL usage based on HBU's
         static GLenum getGLUsage(uint32 usage);
 
         void writeDataImpl(size_t offset, size_t length, const void* pSource, bool discardWholeBuffer);
+
+        /// consecutive frames with a discard, after which the copies are allocated
+        static const uint32 DISCARD_FRAMES_BEFORE_COPIES = 3;
+
+        /// count a whole buffer discard. Returns whether the buffer uses the mapped copies, allocating them if due.
+        bool notifyDiscard();
+        /// move on to the next copy, waiting until the GPU is done with it
+        void nextCopy();
+        void waitForFence(GLsync& fence);
     public:
         void* lockImpl(size_t offset, size_t length, LockOptions options) override;
         void unlockImpl() override;
 
-        GL3PlusHardwareBuffer(GLenum target, size_t sizeInBytes, uint32 usage, bool useShadowBuffer = false);
+        GL3PlusHardwareBuffer(GLenum target, size_t sizeInBytes, uint32 usage, bool useShadowBuffer = false,
+                              size_t numCopies = 1);
         ~GL3PlusHardwareBuffer();
 
         void readData(size_t offset, size_t length, void* pDest) override;
@@ -64,6 +96,12 @@ namespace Ogre {
 
         GLuint getGLBufferId(void) const { return mBufferId; }
 
+        /// offset of the current copy in the buffer object
+        size_t getGLBufferOffset() const { return mCopy * mSizeInBytes; }
+
+        /// whether the buffer cycles through persistently mapped copies, see getGLBufferOffset
+        bool isPersistentlyMapped() const { return mMappedData != NULL; }
+
         GLenum getTarget() const { return mTarget; }
 
         void setGLBufferBinding(GLint binding);
@@ -42,6 +42,10 @@ namespace Ogre {
 
         size_t mUniformBufferCount;
         size_t mShaderStorageBufferCount;
+        size_t mDynamicBufferCopies;
+
+        /// number of copies for vertex and index buffers with the given usage
+        size_t getNumCopies(HardwareBuffer::Usage usage) const;
 
         VertexDeclaration* createVertexDeclarationImpl(void) override;
     public:
@@ -66,6 +70,15 @@ namespace Ogre {
         /// Create a render to vertex buffer
         RenderToVertexBufferSharedPtr createRenderToVertexBuffer() override;
 
+        /** Set the number of persistently mapped copies HBU_CPU_TO_GPU vertex and index buffers cycle through
+
+            A buffer only gets its copies once it was discarded as a whole in a few consecutive frames. Each
+            discard then moves on to the next copy, so the GPU can still read the previous ones. Defaults to 3
+            where GL 4.4 or GL_ARB_buffer_storage is available, 1 disables it. Affects buffers created afterwards.
+        */
+        void setDynamicBufferCopies(size_t copies) { mDynamicBufferCopies = std::max<size_t>(copies, 1); }
+        size_t getDynamicBufferCopies() const { return mDynamicBufferCopies; }
+
         size_t getUniformBufferCount() { return mUniformBufferCount; }
         size_t getShaderStorageBufferCount() { return mShaderStorageBufferCount; }
 
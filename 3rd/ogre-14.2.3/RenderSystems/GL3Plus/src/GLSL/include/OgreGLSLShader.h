@@ -72,6 +72,8 @@ namespace Ogre {
 
         mutable HardwareBufferPtr mDefaultBuffer;
         bool mHasSamplerBinding;
+        /// program binary id in the microcode cache, hash of the source before compileSource adapts it
+        uint32 mMicrocodeId;
     };
 
     /** Factory class for GLSL shaders.
@@ -271,6 +271,7 @@ namespace Ogre {
         }
 
         mHasSamplerBinding = false;
+        mMicrocodeId = 0;
         // There is nothing to load
         mLoadFromFile = false;
     }
@@ -392,7 +393,7 @@ namespace Ogre {
         OGRE_CHECK_GL_ERROR(glProgramParameteri(mGLProgramHandle, GL_PROGRAM_SEPARABLE, GL_TRUE));
         OGRE_CHECK_GL_ERROR(glProgramParameteri(mGLProgramHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
 
-        uint32 hash = _getHash();
+        uint32 hash = mMicrocodeId;
 
         // Use precompiled program if possible.
         mLinked = GLSLProgram::getMicrocodeFromCache(hash, mGLProgramHandle);
@@ -423,12 +424,31 @@ namespace Ogre {
 
     void GLSLShader::loadFromSource()
     {
+        auto caps = Root::getSingleton().getRenderSystem()->getCapabilities();
+
+        // compileSource adapts the source to the driver, so the binary is identified by the source as given
+        mMicrocodeId = _getHash();
+
+        // With separate shader objects, a cached program binary is all we need: skip compiling the shader.
+        if (caps->hasCapability(RSC_SEPARATE_SHADER_OBJECTS) && mAttachedGLSLPrograms.empty() &&
+            mSyntaxCode != "gl_spirv" && mSource.find("void main") != String::npos &&
+            GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(mMicrocodeId))
+        {
+            OGRE_CHECK_GL_ERROR(mGLProgramHandle = glCreateProgram());
+            OGRE_CHECK_GL_ERROR(glProgramParameteri(mGLProgramHandle, GL_PROGRAM_SEPARABLE, GL_TRUE));
+            mLinked = GLSLProgram::getMicrocodeFromCache(mMicrocodeId, mGLProgramHandle);
+            if (mLinked)
+                return;
+
+            // stale binary, e.g. after a driver update
+            OGRE_CHECK_GL_ERROR(glDeleteProgram(mGLProgramHandle));
+            mGLProgramHandle = 0;
+        }
+
         // Create shader object.
         GLenum GLShaderType = getGLShaderType(mType);
         OGRE_CHECK_GL_ERROR(mGLShaderHandle = glCreateShader(GLShaderType));
 
-        auto caps = Root::getSingleton().getRenderSystem()->getCapabilities();
-
         if (caps->hasCapability(RSC_DEBUG))
             OGRE_CHECK_GL_ERROR(glObjectLabel(GL_SHADER, mGLShaderHandle, -1, mName.c_str()));
 
@@ -36,8 +36,10 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 
 namespace Ogre {
 
-    GL3PlusHardwareBuffer::GL3PlusHardwareBuffer(GLenum target, size_t sizeInBytes, uint32 usage, bool useShadowBuffer)
-    : HardwareBuffer(usage, useShadowBuffer), mTarget(target)
+    GL3PlusHardwareBuffer::GL3PlusHardwareBuffer(GLenum target, size_t sizeInBytes, uint32 usage, bool useShadowBuffer,
+                                                 size_t numCopies)
+        : HardwareBuffer(usage, useShadowBuffer), mTarget(target), mMappedData(NULL), mMaxCopies(numCopies),
+          mNumCopies(1), mCopy(0), mLastDiscardFrame(0), mDiscardFrames(0), mScratchWriteBack(false)
     {
         mSizeInBytes = sizeInBytes;
         mRenderSystem = static_cast<GL3PlusRenderSystem*>(Root::getSingleton().getRenderSystem());
@@ -49,6 +51,8 @@ namespace Ogre {
             OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "Cannot create GL buffer");
         }
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
+
+        // copies are only allocated once the buffer turns out to be discarded every frame
         OGRE_CHECK_GL_ERROR(glBufferData(mTarget, mSizeInBytes, NULL, getGLUsage(mUsage)));
 
         if (useShadowBuffer)
@@ -59,12 +63,98 @@ namespace Ogre {
 
     GL3PlusHardwareBuffer::~GL3PlusHardwareBuffer()
     {
+        for (auto fence : mFences)
+        {
+            if (fence)
+                glDeleteSync(fence);
+        }
+
+        // deleting the buffer unmaps it
         if(GL3PlusStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager())
             stateCacheManager->deleteGLBuffer(mTarget,mBufferId);
     }
 
+    void GL3PlusHardwareBuffer::waitForFence(GLsync& fence)
+    {
+        if (!fence)
+            return;
+
+        GLenum ret;
+        do
+        {
+            OGRE_CHECK_GL_ERROR(ret = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000));
+        } while (ret == GL_TIMEOUT_EXPIRED);
+
+        OGRE_CHECK_GL_ERROR(glDeleteSync(fence));
+        fence = 0;
+    }
+
+    bool GL3PlusHardwareBuffer::notifyDiscard()
+    {
+        if (mMappedData)
+            return true;
+        if (mMaxCopies < 2)
+            return false;
+
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        if (frame == mLastDiscardFrame)
+            return false;
+        mDiscardFrames = frame == mLastDiscardFrame + 1 ? mDiscardFrames + 1 : 1;
+        mLastDiscardFrame = frame;
+        if (mDiscardFrames < DISCARD_FRAMES_BEFORE_COPIES)
+            return false;
+
+        // the contents are discarded, so the storage can be replaced. The buffer name stays valid.
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
+        OGRE_CHECK_GL_ERROR(glBufferStorage(mTarget, mSizeInBytes * mMaxCopies, NULL, flags | GL_DYNAMIC_STORAGE_BIT));
+        OGRE_CHECK_GL_ERROR(mMappedData = (uchar*)glMapBufferRange(mTarget, 0, mSizeInBytes * mMaxCopies, flags));
+        if (!mMappedData)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "Cannot map GL buffer");
+        }
+        mNumCopies = mMaxCopies;
+        mCopy = 0;
+        mFences.resize(mNumCopies);
+        return true;
+    }
+
+    void GL3PlusHardwareBuffer::nextCopy()
+    {
+        OGRE_CHECK_GL_ERROR(mFences[mCopy] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        mCopy = (mCopy + 1) % mNumCopies;
+        waitForFence(mFences[mCopy]);
+    }
+
     void* GL3PlusHardwareBuffer::lockImpl(size_t offset, size_t length, LockOptions options)
     {
+        if (options == HBL_DISCARD && notifyDiscard())
+        {
+            nextCopy();
+            mScratchWriteBack = false;
+            return mMappedData + getGLBufferOffset() + offset;
+        }
+
+        if (mMappedData)
+        {
+            if (options == HBL_NO_OVERWRITE)
+            {
+                mScratchWriteBack = false;
+                return mMappedData + getGLBufferOffset() + offset;
+            }
+
+            // the GPU might still read the current copy. Writes go through glBufferSubData on unlock,
+            // which the driver orders after those draws without waiting here.
+            mScratch.resize(length);
+            mScratchWriteBack = options != HBL_READ_ONLY;
+            if (options == HBL_READ_ONLY || options == HBL_NORMAL)
+            {
+                mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
+                OGRE_CHECK_GL_ERROR(glGetBufferSubData(mTarget, getGLBufferOffset() + offset, length, mScratch.data()));
+            }
+            return mScratch.data();
+        }
+
         GLenum access = 0;
 
         // Use glMapBuffer
@@ -107,6 +197,14 @@ namespace Ogre {
 
     void GL3PlusHardwareBuffer::unlockImpl()
     {
+        if (mMappedData)
+        {
+            if (mScratchWriteBack)
+                writeDataImpl(mLockStart, mLockSize, mScratch.data(), false);
+            mScratchWriteBack = false;
+            return;
+        }
+
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
 
         GLboolean mapped;
@@ -130,7 +228,7 @@ namespace Ogre {
         // get data from the real buffer
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
 
-        OGRE_CHECK_GL_ERROR(glGetBufferSubData(mTarget, offset, length, pDest));
+        OGRE_CHECK_GL_ERROR(glGetBufferSubData(mTarget, getGLBufferOffset() + offset, length, pDest));
     }
 
     void GL3PlusHardwareBuffer::writeData(size_t offset, size_t length, const void* pSource,
@@ -147,8 +245,22 @@ namespace Ogre {
     void GL3PlusHardwareBuffer::writeDataImpl(size_t offset, size_t length, const void* pSource,
                                               bool discardWholeBuffer)
     {
+        if (discardWholeBuffer && notifyDiscard())
+        {
+            nextCopy();
+            memcpy(mMappedData + getGLBufferOffset() + offset, pSource, length);
+            return;
+        }
+
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
 
+        if (mMappedData)
+        {
+            // ordered after the draws still reading the current copy, without waiting for them
+            OGRE_CHECK_GL_ERROR(glBufferSubData(mTarget, getGLBufferOffset() + offset, length, pSource));
+            return;
+        }
+
         if (offset == 0 && length == mSizeInBytes)
         {
             OGRE_CHECK_GL_ERROR(glBufferData(mTarget, mSizeInBytes, pSource, getGLUsage(mUsage)));
@@ -183,12 +295,14 @@ namespace Ogre {
             mShadowBuffer->copyData(srcBuffer, srcOffset, dstOffset, length, discardWholeBuffer);
         }
 
-        // Do it the fast way.
-        mRenderSystem->_getStateCacheManager()->bindGLBuffer(
-            GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareBuffer&>(srcBuffer).getGLBufferId());
+        // Do it the fast way. The copy is ordered after the draws reading the current copy on the GPU
+        auto& src = static_cast<GL3PlusHardwareBuffer&>(srcBuffer);
+        mRenderSystem->_getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, src.getGLBufferId());
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, mBufferId);
 
-        OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, length));
+        OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                                src.getGLBufferOffset() + srcOffset,
+                                                getGLBufferOffset() + dstOffset, length));
 
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, 0);
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, 0);
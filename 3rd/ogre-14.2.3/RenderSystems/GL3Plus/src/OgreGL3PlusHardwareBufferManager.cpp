@@ -34,9 +34,13 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGLVertexArrayObject.h"
 
 namespace Ogre {
-    GL3PlusHardwareBufferManager::GL3PlusHardwareBufferManager() : mUniformBufferCount(0), mShaderStorageBufferCount(0)
+    GL3PlusHardwareBufferManager::GL3PlusHardwareBufferManager()
+        : mUniformBufferCount(0), mShaderStorageBufferCount(0), mDynamicBufferCopies(1)
     {
         mRenderSystem = static_cast<GL3PlusRenderSystem*>(Root::getSingleton().getRenderSystem());
+
+        if (mRenderSystem->hasMinGLVersion(4, 4) || mRenderSystem->checkExtension("GL_ARB_buffer_storage"))
+            mDynamicBufferCopies = 3;
     }
 
     GL3PlusHardwareBufferManager::~GL3PlusHardwareBufferManager()
@@ -52,13 +56,20 @@ namespace Ogre {
             static_cast<GLVertexArrayObject*>(d)->notifyContextDestroyed(context);
     }
 
+    size_t GL3PlusHardwareBufferManager::getNumCopies(HardwareBuffer::Usage usage) const
+    {
+        // only buffers that may be rewritten as a whole every frame. They switch to the copies once they do.
+        return usage == HBU_CPU_TO_GPU ? mDynamicBufferCopies : 1;
+    }
+
     HardwareVertexBufferSharedPtr
     GL3PlusHardwareBufferManager::createVertexBuffer(size_t vertexSize,
                                                          size_t numVerts,
                                                          HardwareBuffer::Usage usage,
                                                          bool useShadowBuffer)
     {
-        auto impl = new GL3PlusHardwareBuffer(GL_ARRAY_BUFFER, vertexSize * numVerts, usage, useShadowBuffer);
+        auto impl = new GL3PlusHardwareBuffer(GL_ARRAY_BUFFER, vertexSize * numVerts, usage, useShadowBuffer,
+                                              getNumCopies(usage));
         auto buf = std::make_shared<HardwareVertexBuffer>(this, vertexSize, numVerts, impl);
         {
             OGRE_LOCK_MUTEX(mVertexBuffersMutex);
@@ -74,7 +85,8 @@ namespace Ogre {
     {
         // Calculate the size of the indexes
         auto indexSize = HardwareIndexBuffer::indexSize(itype);
-        auto impl = new GL3PlusHardwareBuffer(GL_ELEMENT_ARRAY_BUFFER, indexSize * numIndexes, usage, useShadowBuffer);
+        auto impl = new GL3PlusHardwareBuffer(GL_ELEMENT_ARRAY_BUFFER, indexSize * numIndexes, usage, useShadowBuffer,
+                                              getNumCopies(usage));
 
         return std::make_shared<HardwareIndexBuffer>(this, itype, numIndexes, impl);
     }
@@ -1000,14 +1000,22 @@ namespace Ogre {
         vao->bind(this);
         bool updateVAO = vao->needsUpdate(op.vertexData->vertexBufferBinding, 0);
 
+        // the attribute offsets move with the current copy of buffers that are discarded every frame
+        for (const auto& binding : op.vertexData->vertexBufferBinding->getBindings())
+            updateVAO = updateVAO || binding.second->_getImpl<GL3PlusHardwareBuffer>()->isPersistentlyMapped();
+
         if (updateVAO)
             vao->bindToGpu(this, op.vertexData->vertexBufferBinding, 0);
 
         // We treat index buffer binding inside VAO as volatile, always updating and never relying onto it,
         // as one shared vertex buffer could be rendered with several index buffers, from submeshes and/or LODs
+        size_t indexOffset = 0;
         if (op.useIndexes)
-            mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER,
-                op.indexData->indexBuffer->_getImpl<GL3PlusHardwareBuffer>()->getGLBufferId());
+        {
+            auto indexBuffer = op.indexData->indexBuffer->_getImpl<GL3PlusHardwareBuffer>();
+            mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->getGLBufferId());
+            indexOffset = indexBuffer->getGLBufferOffset();
+        }
 
         auto numberOfInstances = op.numberOfInstances;
 
@@ -1087,7 +1095,7 @@ namespace Ogre {
 
             if (op.useIndexes)
             {
-                void *pBufferData = VBO_BUFFER_OFFSET(op.indexData->indexStart *
+                void *pBufferData = VBO_BUFFER_OFFSET(indexOffset + op.indexData->indexStart *
                                                      op.indexData->indexBuffer->getIndexSize());
                 GLenum indexType = (op.indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
                 OGRE_CHECK_GL_ERROR(glDrawElementsBaseVertex(GL_PATCHES, op.indexData->indexCount, indexType, pBufferData, op.vertexData->vertexStart));
@@ -1103,7 +1111,7 @@ namespace Ogre {
         }
         else if (op.useIndexes)
         {
-            void *pBufferData = VBO_BUFFER_OFFSET(op.indexData->indexStart *
+            void *pBufferData = VBO_BUFFER_OFFSET(indexOffset + op.indexData->indexStart *
                                                  op.indexData->indexBuffer->getIndexSize());
 
             GLenum indexType = (op.indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
@@ -1665,7 +1673,8 @@ namespace Ogre {
 
         const GL3PlusHardwareBuffer* hwGlBuffer = vertexBuffer->_getImpl<GL3PlusHardwareBuffer>();
         mStateCacheManager->bindGLBuffer(GL_ARRAY_BUFFER, hwGlBuffer->getGLBufferId());
-        void* pBufferData = VBO_BUFFER_OFFSET(elem.getOffset() + vertexStart * vertexBuffer->getVertexSize());
+        void* pBufferData = VBO_BUFFER_OFFSET(hwGlBuffer->getGLBufferOffset() + elem.getOffset() +
+                                              vertexStart * vertexBuffer->getVertexSize());
 
         if (vertexBuffer->isInstanceData())
         {
@@ -0,0 +1,69 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __TinyCommandQueue_H__
+#define __TinyCommandQueue_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreSingleton.h"
+#include "OgreTinyExports.h"
+
+#include <functional>
+#include <memory>
+
+namespace Ogre
+{
+    /** Deferred execution of the Tiny rendersystem
+
+        Draws, clears and buffer swaps are recorded on the render thread and handed over as one batch at the
+        end of each frame. The batches run in order on the Root WorkQueue, so the rasterization of a frame
+        overlaps with updating and culling the next one.
+
+        Anything touching memory a recorded command reads or writes has to wait for it: buffers track the
+        batch that last used them (see waitFor), textures and render targets finish() the queue.
+    */
+    class _OgreTinyExport TinyCommandQueue : public Singleton<TinyCommandQueue>
+    {
+    public:
+        typedef std::function<void()> Command;
+
+        TinyCommandQueue();
+        ~TinyCommandQueue();
+
+        /// append to the batch being recorded
+        void record(Command cmd);
+
+        /// hand the recorded batch over for execution. Blocks if too many batches are still pending.
+        void submit();
+
+        /// serial of the batch being recorded. Batches complete in order of their serials.
+        uint64 getRecordingSerial() const { return mRecordingSerial; }
+
+        /// block until the batch with the given serial was executed, submitting it if necessary
+        void waitFor(uint64 serial);
+
+        /// whether the batch with the given serial was executed, without blocking
+        bool isComplete(uint64 serial) const;
+
+        /// block until everything recorded so far was executed
+        void finish() { waitFor(mRecordingSerial); }
+
+        static TinyCommandQueue& getSingleton();
+        static TinyCommandQueue* getSingletonPtr();
+
+    private:
+        /// submitted batches that may wait for execution, limits memory use and latency
+        static const uint64 MAX_BATCHES_IN_FLIGHT = 4;
+
+        struct State;
+        // shared with the worker tasks, which may outlive the queue
+        std::shared_ptr<State> mState;
+        std::vector<Command> mRecording;
+        uint64 mRecordingSerial;
+
+        static void drain(const std::shared_ptr<State>& state);
+    };
+}
+
+#endif
@@ -0,0 +1,134 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __TinyFrameTarget_H__
+#define __TinyFrameTarget_H__
+
+#include "OgreRenderTarget.h"
+#include "OgreImage.h"
+#include "OgreTinyExports.h"
+
+#include <mutex>
+
+namespace Ogre
+{
+    /** \addtogroup RenderSystems RenderSystems
+    *  @{
+    */
+    /** \addtogroup Tiny Tiny
+    *  @{
+    */
+    /** Offscreen target streaming frames out of the Tiny rendersystem
+
+        Renders into a ring of PF_BYTE_RGBA buffers, that are either allocated by the target or
+        provided by the caller. Each swapBuffers(), as done by Root after every frame or by update(),
+        completes the buffer that was just rendered and continues with the next free one. As rasterization
+        is deferred, a frame becomes available once its recorded commands have executed.
+
+        A consumer, possibly running on another thread, takes completed frames in order with
+        acquireFrame() and hands them back with releaseFrame(). The pixels are never copied.
+        If the consumer falls behind, the oldest completed frame that is not acquired is reused
+        and counted as dropped.
+
+        @code
+        auto target = new TinyFrameTarget("stream", 1280, 720);
+        Root::getSingleton().getRenderSystem()->attachRenderTarget(*target);
+        target->addViewport(camera);
+        ...
+        TinyFrameTarget::Frame frame;
+        while (target->acquireFrame(frame))
+        {
+            TinyFrameTarget::convertToI420(frame.pixels, y, u, v, 1280, 640);
+            target->releaseFrame(frame);
+            encode(y, u, v);
+        }
+        @endcode
+    */
+    class _OgreTinyExport TinyFrameTarget : public RenderTarget
+    {
+    public:
+        struct Frame
+        {
+            PixelBox pixels;
+            /// 1 for the first completed frame and incremented with every swapBuffers()
+            uint64 number;
+            /// index into the ring
+            uint32 buffer;
+        };
+
+        /**
+        @param numBuffers size of the ring, at least 2
+        @param buffers optional caller owned memory for each of the numBuffers ring entries.
+            Each must hold width * height * 4 bytes and stay valid for the lifetime of the target.
+        */
+        TinyFrameTarget(const String& name, uint32 width, uint32 height, uint32 numBuffers = 3,
+                        uchar* const* buffers = NULL);
+        ~TinyFrameTarget();
+
+        /// take the oldest completed frame that was not acquired yet. Returns false if there is none.
+        bool acquireFrame(Frame& frame);
+
+        /// give an acquired frame back, so its buffer can be rendered to again
+        void releaseFrame(const Frame& frame);
+
+        /// number of completed frames that were overwritten before they could be acquired
+        uint64 getNumDroppedFrames() const;
+
+        /// the buffer currently rendered to. The object stays the same, while the memory rotates through the ring.
+        Image* getImage() { return &mBackBuffer; }
+
+        void swapBuffers() override;
+
+        bool requiresTextureFlipping() const override { return true; }
+
+        PixelFormat suggestPixelFormat() const override { return PF_BYTE_RGBA; }
+
+        /// FB_FRONT copies the last completed frame, FB_BACK the buffer being rendered to
+        void copyContentsToMemory(const Box& src, const PixelBox& dst, FrameBuffer buffer) override;
+
+        /** Convert PF_BYTE_RGBA pixels to planar YUV 4:2:0 (I420, BT.601 limited range)
+
+            Uses SSE2 where available. Odd widths/ heights replicate the last column/ row for chroma.
+            @param src pixels to convert
+            @param dstY, dstU, dstV planes of height and height/2 rounded up rows
+            @param strideY, strideUV row pitches of the planes in bytes
+        */
+        static void convertToI420(const PixelBox& src, uchar* dstY, uchar* dstU, uchar* dstV, uint32 strideY,
+                                  uint32 strideUV);
+
+    private:
+        enum BufferState
+        {
+            BS_FREE,
+            BS_RENDERING,
+            BS_COMPLETED,
+            BS_ACQUIRED
+        };
+
+        struct RingEntry
+        {
+            uchar* data;
+            BufferState state;
+            uint64 number;
+        };
+
+        std::vector<RingEntry> mRing;
+        std::vector<uchar> mStorage; // if the target owns the memory
+        uint32 mBackIndex;
+        uint64 mFrameCount;
+        uint64 mNumDropped;
+        Image mBackBuffer;
+        mutable std::mutex mMutex;
+
+        /// retire the back buffer and move on, executed after the frame commands
+        void completeFrame();
+
+        /// entry that is either free or holds the oldest completed frame, or -1 if all are acquired
+        int findReusableEntry() const;
+    };
+    /** @} */
+    /** @} */
+} // namespace Ogre
+
+#endif
@@ -0,0 +1,66 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __TinyHardwareBufferManager_H__
+#define __TinyHardwareBufferManager_H__
+
+#include "OgreHardwareBufferManager.h"
+#include "OgreTinyExports.h"
+
+namespace Ogre {
+    /** system memory buffer, that waits for recorded commands reading it before it is modified
+
+        Dynamic write only buffers rotate through up to MAX_COPIES copies instead, when discarded while still in
+        use, so rewriting them every frame does not stall on the rasterizer.
+    */
+    class _OgreTinyExport TinyHardwareBuffer : public HardwareBuffer
+    {
+        uchar* mData;
+        uint64 mLastUse; // TinyCommandQueue serial
+        /// copies retired by a discard, with the serial of their last use
+        std::vector<std::pair<uchar*, uint64>> mSpareCopies;
+        bool mRotateOnDiscard;
+
+        enum { MAX_COPIES = 3 };
+
+        /// replace mData by a copy that is not in use
+        void discard();
+
+        void* lockImpl(size_t offset, size_t length, LockOptions options) override;
+        void unlockImpl(void) override {}
+    public:
+        TinyHardwareBuffer(size_t sizeInBytes, Usage usage = HBU_CPU_ONLY);
+        ~TinyHardwareBuffer();
+        void readData(size_t offset, size_t length, void* pDest) override;
+        void writeData(size_t offset, size_t length, const void* pSource, bool discardWholeBuffer = false) override;
+        bool isSystemMemory(void) const override { return true; }
+
+        /// the batch being recorded reads this buffer
+        void _notifyUsed(uint64 serial) { mLastUse = serial; }
+
+        const uchar* getData() const { return mData; }
+    };
+
+    class TinyHardwareBufferManager : public HardwareBufferManager
+    {
+    public:
+        ~TinyHardwareBufferManager();
+
+        HardwareVertexBufferSharedPtr createVertexBuffer(size_t vertexSize, size_t numVerts,
+                                                         HardwareBuffer::Usage usage,
+                                                         bool useShadowBuffer = false) override;
+
+        HardwareIndexBufferSharedPtr createIndexBuffer(HardwareIndexBuffer::IndexType itype, size_t numIndexes,
+                                                       HardwareBuffer::Usage usage,
+                                                       bool useShadowBuffer = false) override;
+
+        HardwareBufferPtr createUniformBuffer(size_t sizeBytes, HardwareBufferUsage usage,
+                                              bool useShadowBuffer) override
+        {
+            return std::make_shared<TinyHardwareBuffer>(sizeBytes);
+        }
+    };
+}
+
+#endif
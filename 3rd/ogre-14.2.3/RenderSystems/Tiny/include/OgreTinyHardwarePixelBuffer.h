@@ -8,18 +8,21 @@
 #include "OgreHardwarePixelBuffer.h"
 
 namespace Ogre {
+    class TinyTexture;
+
     class TinyHardwarePixelBuffer: public HardwarePixelBuffer
     {
         PixelBox mBuffer;
+        TinyTexture* mParent;
     public:
         /// Should be called by HardwareBufferManager
-        TinyHardwarePixelBuffer(const PixelBox& data, Usage usage);
+        TinyHardwarePixelBuffer(const PixelBox& data, Usage usage, TinyTexture* parent = NULL);
 
         /// Lock a box
-        PixelBox lockImpl(const Box &lockBox,  LockOptions options) override {  return mBuffer.getSubVolume(lockBox); }
+        PixelBox lockImpl(const Box &lockBox,  LockOptions options) override;
 
         /// Unlock a box
-        void unlockImpl(void) override {}
+        void unlockImpl(void) override;
 
         /// @copydoc HardwarePixelBuffer::blitFromMemory
         void blitFromMemory(const PixelBox &src, const Box &dstBox) override;
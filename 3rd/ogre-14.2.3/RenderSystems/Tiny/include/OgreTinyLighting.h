@@ -0,0 +1,67 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __TinyLighting_H__
+#define __TinyLighting_H__
+
+#include "OgreColourValue.h"
+#include "OgreMatrix4.h"
+#include "OgreTinyExports.h"
+
+namespace Ogre {
+    /** Fixed function lighting of the Tiny rendersystem
+
+        Lambert diffuse and Blinn-Phong specular for up to OGRE_MAX_SIMULTANEOUS_LIGHTS directional and point
+        lights, using a non-local viewer like fixed function GL. Spotlights are lit like point lights.
+
+        prepare() hoists everything that does not depend on the shaded point out of the vertex and pixel loops:
+        the lights are moved to view space, the material colours are multiplied in and the result is packed as
+        structure of arrays, so shade() evaluates four lights at once.
+    */
+    struct _OgreTinyExport TinyLighting
+    {
+        /// @name uniforms, in world space like the auto constants
+        /// @{
+        Vector4 lightPosition[OGRE_MAX_SIMULTANEOUS_LIGHTS];
+        ColourValue lightDiffuse[OGRE_MAX_SIMULTANEOUS_LIGHTS];
+        ColourValue lightSpecular[OGRE_MAX_SIMULTANEOUS_LIGHTS];
+        Vector4 lightAttenuation[OGRE_MAX_SIMULTANEOUS_LIGHTS];
+        size_t numLights = 0;
+
+        Matrix4 view = Matrix4::IDENTITY;
+
+        ColourValue sceneColour = ColourValue::Black; // ambient and emissive
+        ColourValue diffuse = ColourValue::White;
+        ColourValue specular = ColourValue::Black;
+        float shininess = 0;
+        /// @}
+
+        /// update the packed lights, call after changing the uniforms
+        void prepare();
+
+        /** light a point
+            @param pos view space position
+            @param n view space unit normal
+            @param[out] diffuseOut ambient, emissive and diffuse terms. Alpha is the material diffuse alpha.
+            @param[out] specularOut specular term, to be added after texturing
+        */
+        void shade(const Vector3& pos, const Vector3& n, ColourValue& diffuseOut, ColourValue& specularOut) const;
+
+    private:
+        /// four lights, structure of arrays
+        struct LightBlock
+        {
+            float x[4], y[4], z[4], w[4]; // view space position or direction towards the light
+            float dr[4], dg[4], db[4];     // light diffuse * material diffuse
+            float sr[4], sg[4], sb[4];     // light specular * material specular
+            float range[4], att0[4], att1[4], att2[4];
+        };
+
+        LightBlock mBlocks[(OGRE_MAX_SIMULTANEOUS_LIGHTS + 3) / 4];
+        int mNumBlocks = 0;
+        bool mSpecular = false;
+    };
+}
+
+#endif
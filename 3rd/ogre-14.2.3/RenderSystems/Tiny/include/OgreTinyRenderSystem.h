@@ -8,6 +8,9 @@
 
 #include "OgreRenderWindow.h"
 #include "OgreRenderSystem.h"
+#include "OgreTinyTexture.h"
+#include "OgreTinyLighting.h"
+#include "OgreTinyCommandQueue.h"
 
 namespace Ogre {
     /** \addtogroup RenderSystems RenderSystems
@@ -40,7 +43,13 @@ namespace Ogre {
             return *img.getData<const vec4b>(mod(uvi[0], img.getWidth()), mod(uvi[1], img.getHeight()));
         }
 
-        virtual bool fragment(const vec3& bar, ColourValue& gl_FragColor) = 0;
+        /** shade a fragment
+            @param bar perspective correct barycentric coordinates of the fragment
+            @param dFdx, dFdy change of bar towards the right and bottom neighbour pixel
+            @param gl_FragColor output colour
+            @return true if the fragment is discarded
+        */
+        virtual bool fragment(const vec3& bar, const vec3& dFdx, const vec3& dFdy, ColourValue& gl_FragColor) = 0;
     };
 
     /**
@@ -49,6 +58,10 @@ namespace Ogre {
     class TinyRenderSystem : public RenderSystem
     {
         Matrix4 mVP; // viewport transform
+        Rect mViewportRect; // in pixels of the active target
+
+        bool mScissorEnabled;
+        Rect mScissorRect;
 
         Image* mActiveColourBuffer;
         Image* mActiveDepthBuffer;
@@ -58,29 +71,49 @@ namespace Ogre {
             mat4 uniform_MVP;
             mat4 uniform_Tex;
             mat4 uniform_MVIT;
-            vec3 uniform_lightDir;
-            ColourValue uniform_ambientCol;
+            mat4 uniform_MV;
+            TinyLighting uniform_lighting;
 
             bool uniform_doLighting;
+            bool uniform_perPixelLighting; // SO_PHONG, otherwise lit per vertex
+            bool uniform_doVertexColour;
 
-            const Image* image;
+            const TinyMipChain* texture;
+            TinyMipChain::SamplerState sampler;
 
             vec2 var_uv[3];
             vec3 var_normal[3];
-
-            void vertex(const vec4& vertex, const vec2* uv, const vec3* normal, int gl_VertexID,
-                        vec4& gl_Position);
-            bool fragment(const vec3& bar, ColourValue& gl_FragColor) override;
+            vec3 var_position[3];
+            ColourValue var_colour[3];
+            ColourValue var_lit[3];
+            ColourValue var_specular[3];
+
+            void vertex(const vec4& vertex, const vec2* uv, const vec3* normal, const ColourValue& colour,
+                        int gl_VertexID, vec4& gl_Position);
+            bool fragment(const vec3& bar, const vec3& dFdx, const vec3& dFdy, ColourValue& gl_FragColor) override;
         } mDefaultShader;
 
+        TexturePtr mActiveTexture; // the mip chain is only built when executing
+
+        /// a recorded _render call
+        struct DrawCommand;
+        std::unique_ptr<TinyCommandQueue> mCommandQueue;
+
+        bool mLightingDirty; // uniform_lighting needs prepare()
+
         bool mDepthTest;
         bool mDepthWrite;
-        bool mBlendAdd;
+        ColourBlendState mBlendState;
 
         HardwareBufferManager* mHardwareBufferManager;
 
         /// Check if the GL system has already been initialised
         bool mGLInitialised;
+
+        /// convert a rect with top-left origin to pixel rows of the active target
+        Rect toPixelRect(Rect r) const;
+        /// viewport intersected with the scissor rectangle, inclusive pixel bounds
+        Rect getClipRect() const;
     public:
         // Default constructor / destructor
         TinyRenderSystem();
@@ -124,6 +157,10 @@ namespace Ogre {
 
         void setLightingEnabled(bool enabled) override { mDefaultShader.uniform_doLighting = enabled; }
 
+        void setShadingType(ShadeOptions so) override { mDefaultShader.uniform_perPixelLighting = so == SO_PHONG; }
+
+        void _useLights(unsigned short limit) override;
+
         void _setViewport(Viewport *vp) override;
 
         void _endFrame(void) override;
@@ -0,0 +1,34 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __TinyRenderTexture_H__
+#define __TinyRenderTexture_H__
+
+#include "OgreRenderTexture.h"
+#include "OgreImage.h"
+
+namespace Ogre
+{
+    class TinyTexture;
+
+    /// renders directly into the memory of a texture slice
+    class TinyRenderTexture : public RenderTexture
+    {
+        Image mBuffer;
+        TinyTexture* mParent;
+    public:
+        TinyRenderTexture(const String& name, HardwarePixelBuffer* buffer, const PixelBox& data, uint32 zoffset,
+                          TinyTexture* parent);
+        ~TinyRenderTexture();
+
+        Image* getImage() { return &mBuffer; }
+
+        /// the texture needs a new mip chain
+        void swapBuffers() override;
+
+        bool requiresTextureFlipping() const override { return true; }
+    };
+}
+
+#endif
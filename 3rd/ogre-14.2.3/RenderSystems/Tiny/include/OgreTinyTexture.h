@@ -6,8 +6,81 @@
 #define __TinyTexture_H__
 
 #include "OgreTexture.h"
+#include "OgreTextureUnitState.h"
 
 namespace Ogre {
+    /** Sampling copy of a texture mip chain
+
+        Texels are stored as packed RGBA8 in 4x4 tiles, so a tile fills exactly one 64 byte cache line.
+        Tiles are laid out row-major and the texels inside a tile in Morton (Z-) order.
+        This way a bilinear footprint touches at most 4 cache lines regardless of the direction
+        the texture is traversed in.
+    */
+    struct TinyMipChain
+    {
+        struct Level
+        {
+            int width, height;
+            int tilesX;
+            std::vector<uint32> texels;
+
+            uint32 fetch(int x, int y) const
+            {
+                // interleave the two low bits of x and y
+                int morton = (x & 1) | ((y & 1) << 1) | ((x & 2) << 1) | ((y & 2) << 2);
+                return texels[(((y >> 2) * tilesX + (x >> 2)) << 4) | morton];
+            }
+        };
+
+        struct SamplerState
+        {
+            FilterOptions minFilter = FO_LINEAR;
+            FilterOptions magFilter = FO_LINEAR;
+            FilterOptions mipFilter = FO_POINT;
+            TextureAddressingMode addressU = TAM_WRAP;
+            TextureAddressingMode addressV = TAM_WRAP;
+            float mipBias = 0;
+        };
+
+        std::vector<Level> levels;
+
+        /// (re-)create the tiled copy from the given row-major RGBA8 levels
+        void build(const std::vector<PixelBox>& src);
+
+        /** sample the chain at uv
+            @param uv texture coordinate
+            @param dx, dy screen-space derivatives of uv, used to select the LOD
+            @return packed RGBA8 texel
+        */
+        uint32 sample(const SamplerState& s, const Vector2& uv, const Vector2& dx, const Vector2& dy) const;
+
+    private:
+        static int address(int c, int size, TextureAddressingMode mode)
+        {
+            switch(mode)
+            {
+            case TAM_CLAMP:
+            case TAM_BORDER:
+                return std::min(std::max(c, 0), size - 1);
+            case TAM_MIRROR:
+                c = (c % (2 * size) + 2 * size) % (2 * size);
+                return c < size ? c : 2 * size - 1 - c;
+            default:
+                return (c % size + size) % size;
+            }
+        }
+
+        /// lerp all four channels of two packed texels, w in [0, 256]
+        static uint32 lerp(uint32 a, uint32 b, uint32 w)
+        {
+            uint32 rb = ((a & 0x00FF00FF) * (256 - w) + (b & 0x00FF00FF) * w) >> 8;
+            uint32 ag = ((a >> 8) & 0x00FF00FF) * (256 - w) + ((b >> 8) & 0x00FF00FF) * w;
+            return (rb & 0x00FF00FF) | (ag & 0xFF00FF00);
+        }
+
+        uint32 sampleLevel(const SamplerState& s, int level, const Vector2& uv, bool bilinear) const;
+    };
+
     class TinyTexture : public Texture
     {
     public:
@@ -17,12 +90,21 @@ namespace Ogre {
 
         Image* getImage() { return &mBuffer; }
 
+        /// mip chain for sampling. Regenerated if the contents changed since the last call.
+        const TinyMipChain& _getMipChain();
+
+        /// mark the contents as modified
+        void _notifyContentsChanged() { mMipChainDirty = true; }
+
         virtual ~TinyTexture();
 
     protected:
         Image mBuffer;
+        TinyMipChain mMipChain;
+        bool mMipChainDirty;
+
         void createInternalResourcesImpl(void) override;
-        void freeInternalResourcesImpl(void) override {}
+        void freeInternalResourcesImpl(void) override;
     };
 }
 
@@ -17,6 +17,7 @@ namespace Ogre
     {
     public:
         TinyWindow();
+        ~TinyWindow();
 
         void create(const String& name, unsigned int width, unsigned int height,
                     bool fullScreen, const NameValuePairList *miscParams) override;
@@ -25,16 +26,28 @@ namespace Ogre
 
         void resize(unsigned int width, unsigned int height) override;
 
+        /// FB_BACK reads the buffer being rendered to, FB_FRONT and FB_AUTO the last completed frame
         void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer) override;
         bool requiresTextureFlipping() const override { return true; }
 
-        Image* getImage() { return &mBuffer; }
+        /// the buffer currently rendered to. The object stays the same, while the memory alternates.
+        Image* getImage() { return &mBackBuffer; }
 
         void swapBuffers() override;
 
     protected:
-        Image mBuffer;
+        /// frames are rasterized into one, while the other is presented
+        Image mBuffers[2];
+        /// view of the buffer the recorded commands render to, switched by a recorded command
+        Image mBackBuffer;
+        /// buffer of the frame being recorded
+        uint32 mRecordIndex;
+        /// serial of the completed frame that is still to be presented, 0 if none
+        uint64 mPresentSerial;
         SDL_Window* mParentWindow;
+
+        /// blit to the SDL window, once the frame commands were executed
+        void present(const Image& frame);
     };
 }
 
@@ -0,0 +1,129 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+
+#include "OgreTinyCommandQueue.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace Ogre
+{
+    template<> TinyCommandQueue* Singleton<TinyCommandQueue>::msSingleton = 0;
+    TinyCommandQueue* TinyCommandQueue::getSingletonPtr(void) { return msSingleton; }
+    TinyCommandQueue& TinyCommandQueue::getSingleton(void)
+    {
+        assert(msSingleton);
+        return (*msSingleton);
+    }
+
+    struct TinyCommandQueue::State
+    {
+        struct Batch
+        {
+            uint64 serial;
+            std::vector<Command> commands;
+        };
+
+        std::mutex mutex;
+        std::condition_variable done;
+        std::deque<Batch> pending;
+        // executed batches. Released on the render thread, as they hold the last reference to buffers.
+        std::vector<Batch> retired;
+        uint64 completed = 0;
+        bool running = false;
+    };
+
+    TinyCommandQueue::TinyCommandQueue() : mState(std::make_shared<State>()), mRecordingSerial(1) {}
+
+    TinyCommandQueue::~TinyCommandQueue() { finish(); }
+
+    void TinyCommandQueue::record(Command cmd) { mRecording.push_back(std::move(cmd)); }
+
+    void TinyCommandQueue::submit()
+    {
+        std::vector<State::Batch> retired;
+        {
+            std::lock_guard<std::mutex> lock(mState->mutex);
+            retired.swap(mState->retired);
+
+            if (mRecording.empty())
+                return; // nothing to do, the serial stays valid for the next batch
+
+            mState->pending.push_back({mRecordingSerial++, std::move(mRecording)});
+            mRecording.clear();
+        }
+
+        // the WorkQueue might not run our task, e.g. when paused or shutting down. waitFor drains then.
+        auto wq = Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+        if (wq && wq->getRequestsAccepted() && !wq->isPaused())
+        {
+            std::shared_ptr<State> state = mState;
+            wq->addTask([state]() { drain(state); });
+        }
+
+        // do not run ahead of the rasterizer by more than a few batches
+        if (mRecordingSerial > MAX_BATCHES_IN_FLIGHT + 1)
+            waitFor(mRecordingSerial - MAX_BATCHES_IN_FLIGHT - 1);
+    }
+
+    void TinyCommandQueue::drain(const std::shared_ptr<State>& state)
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        if (state->running)
+            return; // the running drain picks up our batch
+
+        state->running = true;
+        while (!state->pending.empty())
+        {
+            State::Batch batch = std::move(state->pending.front());
+            state->pending.pop_front();
+
+            lock.unlock();
+            for (auto& cmd : batch.commands)
+                cmd();
+            lock.lock();
+
+            state->completed = batch.serial;
+            state->retired.push_back(std::move(batch));
+            state->done.notify_all();
+        }
+        state->running = false;
+        state->done.notify_all();
+    }
+
+    bool TinyCommandQueue::isComplete(uint64 serial) const
+    {
+        std::lock_guard<std::mutex> lock(mState->mutex);
+        return mState->completed >= serial;
+    }
+
+    void TinyCommandQueue::waitFor(uint64 serial)
+    {
+        if (serial >= mRecordingSerial)
+            submit();
+
+        std::unique_lock<std::mutex> lock(mState->mutex);
+        while (mState->completed < serial && (!mState->pending.empty() || mState->running))
+        {
+            if (mState->running)
+            {
+                mState->done.wait(lock);
+                continue;
+            }
+
+            // nobody is working on it, do it ourselves
+            lock.unlock();
+            drain(mState);
+            lock.lock();
+        }
+
+        std::vector<State::Batch> retired;
+        retired.swap(mState->retired);
+        lock.unlock();
+    }
+}
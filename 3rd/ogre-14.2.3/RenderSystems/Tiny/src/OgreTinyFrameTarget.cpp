@@ -0,0 +1,262 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+
+#include "OgreTinyFrameTarget.h"
+#include "OgreTinyCommandQueue.h"
+#include "OgreException.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Ogre
+{
+TinyFrameTarget::TinyFrameTarget(const String& name, uint32 width, uint32 height, uint32 numBuffers,
+                                 uchar* const* buffers)
+    : mBackIndex(0), mFrameCount(0), mNumDropped(0)
+{
+    OgreAssert(numBuffers >= 2, "at least two buffers required");
+    mName = name;
+    mWidth = width;
+    mHeight = height;
+
+    size_t size = PixelUtil::getMemorySize(width, height, 1, PF_BYTE_RGBA);
+    if (!buffers)
+        mStorage.resize(size * numBuffers);
+
+    mRing.resize(numBuffers);
+    for (uint32 i = 0; i < numBuffers; i++)
+    {
+        mRing[i].data = buffers ? buffers[i] : mStorage.data() + size * i;
+        mRing[i].state = BS_FREE;
+        mRing[i].number = 0;
+    }
+
+    mRing[0].state = BS_RENDERING;
+    mBackBuffer.loadDynamicImage(mRing[0].data, width, height, 1, PF_BYTE_RGBA);
+}
+
+TinyFrameTarget::~TinyFrameTarget()
+{
+    if (auto queue = TinyCommandQueue::getSingletonPtr())
+        queue->finish();
+}
+
+int TinyFrameTarget::findReusableEntry() const
+{
+    int oldest = -1;
+    for (size_t i = 0; i < mRing.size(); i++)
+    {
+        if (mRing[i].state == BS_FREE)
+            return int(i);
+        if (mRing[i].state == BS_COMPLETED && (oldest < 0 || mRing[i].number < mRing[oldest].number))
+            oldest = int(i);
+    }
+    return oldest;
+}
+
+void TinyFrameTarget::swapBuffers()
+{
+    // complete the frame once it is rasterized
+    TinyCommandQueue& queue = TinyCommandQueue::getSingleton();
+    queue.record([this]() { completeFrame(); });
+    queue.submit();
+}
+
+void TinyFrameTarget::completeFrame()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    RingEntry& back = mRing[mBackIndex];
+    back.state = BS_COMPLETED;
+    back.number = ++mFrameCount;
+
+    // there is at least the frame we just completed
+    int next = findReusableEntry();
+    if (mRing[next].state == BS_COMPLETED)
+        mNumDropped++;
+
+    mBackIndex = next;
+    mRing[next].state = BS_RENDERING;
+    mBackBuffer.loadDynamicImage(mRing[next].data, mWidth, mHeight, 1, PF_BYTE_RGBA);
+}
+
+bool TinyFrameTarget::acquireFrame(Frame& frame)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    int oldest = -1;
+    for (size_t i = 0; i < mRing.size(); i++)
+    {
+        if (mRing[i].state == BS_COMPLETED && (oldest < 0 || mRing[i].number < mRing[oldest].number))
+            oldest = int(i);
+    }
+
+    if (oldest < 0)
+        return false;
+
+    mRing[oldest].state = BS_ACQUIRED;
+    frame.pixels = PixelBox(mWidth, mHeight, 1, PF_BYTE_RGBA, mRing[oldest].data);
+    frame.number = mRing[oldest].number;
+    frame.buffer = oldest;
+    return true;
+}
+
+void TinyFrameTarget::releaseFrame(const Frame& frame)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    OgreAssert(frame.buffer < mRing.size() && mRing[frame.buffer].state == BS_ACQUIRED &&
+                   mRing[frame.buffer].number == frame.number,
+               "frame was not acquired");
+    mRing[frame.buffer].state = BS_FREE;
+}
+
+uint64 TinyFrameTarget::getNumDroppedFrames() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumDropped;
+}
+
+void TinyFrameTarget::copyContentsToMemory(const Box& src, const PixelBox& dst, FrameBuffer buffer)
+{
+    if (src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1 ||
+        dst.getWidth() != src.getWidth() || dst.getHeight() != src.getHeight() || dst.getDepth() != 1)
+    {
+        OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box");
+    }
+
+    TinyCommandQueue::getSingleton().finish();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    uint32 index = mBackIndex;
+    if (buffer == FB_FRONT)
+    {
+        // newest frame that is not rendered to
+        for (size_t i = 0; i < mRing.size(); i++)
+        {
+            if ((mRing[i].state == BS_COMPLETED || mRing[i].state == BS_ACQUIRED) &&
+                (index == mBackIndex || mRing[i].number > mRing[index].number))
+                index = uint32(i);
+        }
+    }
+
+    PixelBox frame(mWidth, mHeight, 1, PF_BYTE_RGBA, mRing[index].data);
+    PixelUtil::bulkPixelConversion(frame.getSubVolume(src), dst);
+}
+
+namespace
+{
+// BT.601 limited range, 8 bit fixed point
+inline uchar rgbToY(int r, int g, int b) { return uchar(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16); }
+inline uchar rgbToU(int r, int g, int b) { return uchar(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128); }
+inline uchar rgbToV(int r, int g, int b) { return uchar(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128); }
+
+#if __OGRE_HAVE_SSE
+/// split 8 RGBA pixels into 16 bit R, G and B
+inline void unpackRGB(const uchar* src, __m128i& r, __m128i& g, __m128i& b)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    __m128i p0 = _mm_loadu_si128((const __m128i*)src);
+    __m128i p1 = _mm_loadu_si128((const __m128i*)(src + 16));
+    r = _mm_packs_epi32(_mm_and_si128(p0, mask), _mm_and_si128(p1, mask));
+    g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), mask), _mm_and_si128(_mm_srli_epi32(p1, 8), mask));
+    b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), mask), _mm_and_si128(_mm_srli_epi32(p1, 16), mask));
+}
+
+/// luma of 8 pixels. The weighted sum stays below 2^16, so unsigned 16 bit arithmetic is exact.
+inline void storeY(__m128i r, __m128i g, __m128i b, uchar* dst)
+{
+    __m128i y = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(66)), _mm_mullo_epi16(g, _mm_set1_epi16(129)));
+    y = _mm_add_epi16(y, _mm_mullo_epi16(b, _mm_set1_epi16(25)));
+    y = _mm_srli_epi16(_mm_add_epi16(y, _mm_set1_epi16(128)), 8);
+    y = _mm_add_epi16(y, _mm_set1_epi16(16));
+    _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(y, y));
+}
+
+/// average 2x2 blocks: vertical sums in, 4 averages out in the low 16 bit lanes
+inline __m128i average2x2(__m128i rowSum)
+{
+    __m128i sum = _mm_madd_epi16(rowSum, _mm_set1_epi16(1));
+    sum = _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(2)), 2);
+    return _mm_packs_epi32(sum, sum);
+}
+
+inline void storeChroma(__m128i r, __m128i g, __m128i b, int16 cr, int16 cg, int16 cb, uchar* dst)
+{
+    __m128i c = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(cr)), _mm_mullo_epi16(g, _mm_set1_epi16(cg)));
+    c = _mm_add_epi16(c, _mm_mullo_epi16(b, _mm_set1_epi16(cb)));
+    c = _mm_srai_epi16(_mm_add_epi16(c, _mm_set1_epi16(128)), 8);
+    c = _mm_add_epi16(c, _mm_set1_epi16(128));
+    int32 packed = _mm_cvtsi128_si32(_mm_packus_epi16(c, c));
+    memcpy(dst, &packed, 4);
+}
+#endif
+} // namespace
+
+void TinyFrameTarget::convertToI420(const PixelBox& src, uchar* dstY, uchar* dstU, uchar* dstV, uint32 strideY,
+                                    uint32 strideUV)
+{
+    OgreAssert(src.format == PF_BYTE_RGBA && src.getDepth() == 1, "PF_BYTE_RGBA 2D image expected");
+
+    uint32 width = src.getWidth();
+    uint32 height = src.getHeight();
+    size_t pitch = src.rowPitch * 4;
+    const uchar* base = src.getTopLeftFrontPixelPtr();
+
+    for (uint32 y = 0; y < height; y += 2)
+    {
+        const uchar* row0 = base + y * pitch;
+        const uchar* row1 = y + 1 < height ? row0 + pitch : row0;
+        uchar* outY0 = dstY + y * strideY;
+        uchar* outY1 = y + 1 < height ? outY0 + strideY : NULL;
+        uchar* outU = dstU + (y / 2) * strideUV;
+        uchar* outV = dstV + (y / 2) * strideUV;
+
+        uint32 x = 0;
+#if __OGRE_HAVE_SSE
+        for (; x + 8 <= width; x += 8)
+        {
+            __m128i r0, g0, b0, r1, g1, b1;
+            unpackRGB(row0 + x * 4, r0, g0, b0);
+            unpackRGB(row1 + x * 4, r1, g1, b1);
+
+            storeY(r0, g0, b0, outY0 + x);
+            if (outY1)
+                storeY(r1, g1, b1, outY1 + x);
+
+            __m128i r = average2x2(_mm_add_epi16(r0, r1));
+            __m128i g = average2x2(_mm_add_epi16(g0, g1));
+            __m128i b = average2x2(_mm_add_epi16(b0, b1));
+            storeChroma(r, g, b, -38, -74, 112, outU + x / 2);
+            storeChroma(r, g, b, 112, -94, -18, outV + x / 2);
+        }
+#endif
+        for (; x < width; x += 2)
+        {
+            uint32 x1 = std::min(x + 1, width - 1);
+            const uchar* p[4] = {row0 + x * 4, row0 + x1 * 4, row1 + x * 4, row1 + x1 * 4};
+
+            outY0[x] = rgbToY(p[0][0], p[0][1], p[0][2]);
+            if (x1 != x)
+                outY0[x1] = rgbToY(p[1][0], p[1][1], p[1][2]);
+            if (outY1)
+            {
+                outY1[x] = rgbToY(p[2][0], p[2][1], p[2][2]);
+                if (x1 != x)
+                    outY1[x1] = rgbToY(p[3][0], p[3][1], p[3][2]);
+            }
+
+            int r = (p[0][0] + p[1][0] + p[2][0] + p[3][0] + 2) >> 2;
+            int g = (p[0][1] + p[1][1] + p[2][1] + p[3][1] + 2) >> 2;
+            int b = (p[0][2] + p[1][2] + p[2][2] + p[3][2] + 2) >> 2;
+            outU[x / 2] = rgbToU(r, g, b);
+            outV[x / 2] = rgbToV(r, g, b);
+        }
+    }
+}
+} // namespace Ogre
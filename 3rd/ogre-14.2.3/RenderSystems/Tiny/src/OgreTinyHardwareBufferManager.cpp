@@ -0,0 +1,104 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+
+#include "OgreTinyHardwareBufferManager.h"
+#include "OgreTinyCommandQueue.h"
+
+namespace Ogre {
+    TinyHardwareBuffer::TinyHardwareBuffer(size_t sizeInBytes, Usage usage)
+        : HardwareBuffer(HBU_CPU_ONLY, false), mLastUse(0), mRotateOnDiscard(usage == HBU_CPU_TO_GPU)
+    {
+        mSizeInBytes = sizeInBytes;
+        mData = (uchar*)AlignedMemory::allocate(mSizeInBytes);
+    }
+
+    TinyHardwareBuffer::~TinyHardwareBuffer()
+    {
+        AlignedMemory::deallocate(mData);
+        // recorded commands hold a reference to the buffer, so none of the copies is in use any more
+        for (auto& copy : mSpareCopies)
+            AlignedMemory::deallocate(copy.first);
+    }
+
+    void TinyHardwareBuffer::discard()
+    {
+        auto& queue = TinyCommandQueue::getSingleton();
+        if (!mRotateOnDiscard || queue.isComplete(mLastUse))
+        {
+            queue.waitFor(mLastUse);
+            return;
+        }
+
+        // the spare copies are ordered by their last use, the first one is the oldest
+        if (mSpareCopies.empty() || (!queue.isComplete(mSpareCopies.front().second) &&
+                                     mSpareCopies.size() + 1 < MAX_COPIES))
+        {
+            mSpareCopies.push_back({mData, mLastUse});
+            mData = (uchar*)AlignedMemory::allocate(mSizeInBytes);
+            mLastUse = 0;
+            return;
+        }
+
+        auto oldest = mSpareCopies.front();
+        mSpareCopies.erase(mSpareCopies.begin());
+        mSpareCopies.push_back({mData, mLastUse});
+        queue.waitFor(oldest.second);
+        mData = oldest.first;
+        mLastUse = 0;
+    }
+
+    void* TinyHardwareBuffer::lockImpl(size_t offset, size_t length, LockOptions options)
+    {
+        if (options == HBL_DISCARD && mLastUse)
+            discard();
+        else if (options != HBL_READ_ONLY && options != HBL_NO_OVERWRITE && mLastUse)
+            TinyCommandQueue::getSingleton().waitFor(mLastUse);
+        return mData + offset;
+    }
+
+    void TinyHardwareBuffer::readData(size_t offset, size_t length, void* pDest)
+    {
+        assert((offset + length) <= mSizeInBytes);
+        memcpy(pDest, mData + offset, length);
+    }
+
+    void TinyHardwareBuffer::writeData(size_t offset, size_t length, const void* pSource, bool discardWholeBuffer)
+    {
+        assert((offset + length) <= mSizeInBytes);
+        if (mLastUse && (discardWholeBuffer || (offset == 0 && length == mSizeInBytes)))
+            discard();
+        else if (mLastUse)
+            TinyCommandQueue::getSingleton().waitFor(mLastUse);
+        memcpy(mData + offset, pSource, length);
+    }
+
+    TinyHardwareBufferManager::~TinyHardwareBufferManager()
+    {
+        destroyAllDeclarations();
+        destroyAllBindings();
+    }
+
+    HardwareVertexBufferSharedPtr TinyHardwareBufferManager::createVertexBuffer(size_t vertexSize, size_t numVerts,
+                                                                                HardwareBuffer::Usage usage,
+                                                                                bool useShadowBuffer)
+    {
+        auto buf = std::make_shared<HardwareVertexBuffer>(this, vertexSize, numVerts,
+                                                          new TinyHardwareBuffer(vertexSize * numVerts, usage));
+        {
+            OGRE_LOCK_MUTEX(mVertexBuffersMutex);
+            mVertexBuffers.insert(buf.get());
+        }
+        return buf;
+    }
+
+    HardwareIndexBufferSharedPtr TinyHardwareBufferManager::createIndexBuffer(HardwareIndexBuffer::IndexType itype,
+                                                                              size_t numIndexes,
+                                                                              HardwareBuffer::Usage usage,
+                                                                              bool useShadowBuffer)
+    {
+        return std::make_shared<HardwareIndexBuffer>(
+            this, itype, numIndexes, new TinyHardwareBuffer(HardwareIndexBuffer::indexSize(itype) * numIndexes, usage));
+    }
+}
@@ -3,12 +3,44 @@
 // of this distribution and at https://www.ogre3d.org/licensing.
 // SPDX-License-Identifier: MIT
 #include "OgreTinyHardwarePixelBuffer.h"
+#include "OgreTinyTexture.h"
+#include "OgreTinyRenderTexture.h"
+#include "OgreTinyCommandQueue.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "OgreStringConverter.h"
 
 namespace Ogre {
 
-    TinyHardwarePixelBuffer::TinyHardwarePixelBuffer(const PixelBox& data, Usage usage)
-        : HardwarePixelBuffer(data.getWidth(), data.getHeight(), data.getDepth(), data.format, usage, false), mBuffer(data)
+    TinyHardwarePixelBuffer::TinyHardwarePixelBuffer(const PixelBox& data, Usage usage, TinyTexture* parent)
+        : HardwarePixelBuffer(data.getWidth(), data.getHeight(), data.getDepth(), data.format, usage, false),
+          mBuffer(data), mParent(parent)
     {
+        if (!(mUsage & TU_RENDERTARGET) || !parent)
+            return;
+
+        // Create render target for each slice
+        mSliceTRT.reserve(mDepth);
+        for (uint32 zoffset = 0; zoffset < mDepth; ++zoffset)
+        {
+            String name = "rtt/" + StringConverter::toString((size_t)this) + "/" + parent->getName();
+            RenderTexture* trt = new TinyRenderTexture(name, this, data, zoffset, parent);
+            mSliceTRT.push_back(trt);
+            Root::getSingleton().getRenderSystem()->attachRenderTarget(*trt);
+        }
+    }
+
+    PixelBox TinyHardwarePixelBuffer::lockImpl(const Box &lockBox,  LockOptions options)
+    {
+        // recorded draws might sample or render to the texture
+        TinyCommandQueue::getSingleton().finish();
+        return mBuffer.getSubVolume(lockBox);
+    }
+
+    void TinyHardwarePixelBuffer::unlockImpl(void)
+    {
+        if (mParent)
+            mParent->_notifyContentsChanged();
     }
 
     void TinyHardwarePixelBuffer::blitFromMemory(const PixelBox &src, const Box &dstBox)
@@ -18,6 +50,8 @@ namespace Ogre {
             OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Destination box out of range");
         }
 
+        TinyCommandQueue::getSingleton().finish();
+
         PixelBox scaled;
         if (src.getSize() != dstBox.getSize())
         {
@@ -31,6 +65,9 @@ namespace Ogre {
             scaled = mBuffer.getSubVolume(dstBox);
             PixelUtil::bulkPixelConversion(src, scaled);
         }
+
+        if (mParent)
+            mParent->_notifyContentsChanged();
     }
 
     void TinyHardwarePixelBuffer::blitToMemory(const Box &srcBox, const PixelBox &dst)
@@ -40,6 +77,8 @@ namespace Ogre {
             OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "source box out of range");
         }
 
+        TinyCommandQueue::getSingleton().finish();
+
         if(srcBox.getSize() != dst.getSize())
         {
             // We need scaling
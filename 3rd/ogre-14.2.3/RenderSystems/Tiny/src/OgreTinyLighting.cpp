@@ -0,0 +1,181 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+
+#include "OgreTinyLighting.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Ogre {
+    void TinyLighting::prepare()
+    {
+        mNumBlocks = int((numLights + 3) / 4);
+        mSpecular = false;
+
+        for (int b = 0; b < mNumBlocks; b++)
+        {
+            LightBlock& block = mBlocks[b];
+            for (int lane = 0; lane < 4; lane++)
+            {
+                size_t i = b * 4 + lane;
+                if (i >= numLights)
+                {
+                    // contributes nothing
+                    block.x[lane] = block.y[lane] = block.w[lane] = 0;
+                    block.z[lane] = 1;
+                    block.dr[lane] = block.dg[lane] = block.db[lane] = 0;
+                    block.sr[lane] = block.sg[lane] = block.sb[lane] = 0;
+                    block.range[lane] = std::numeric_limits<float>::max();
+                    block.att0[lane] = 1;
+                    block.att1[lane] = block.att2[lane] = 0;
+                    continue;
+                }
+
+                Vector4 pos = view * lightPosition[i];
+                if (pos.w == 0)
+                {
+                    // directional: the direction towards the light, no attenuation
+                    Vector3 dir = pos.xyz().normalisedCopy();
+                    pos = Vector4(dir.x, dir.y, dir.z, 0);
+                    block.range[lane] = std::numeric_limits<float>::max();
+                    block.att0[lane] = 1;
+                    block.att1[lane] = block.att2[lane] = 0;
+                }
+                else
+                {
+                    pos /= pos.w;
+                    block.range[lane] = lightAttenuation[i][0];
+                    block.att0[lane] = lightAttenuation[i][1];
+                    block.att1[lane] = lightAttenuation[i][2];
+                    block.att2[lane] = lightAttenuation[i][3];
+                }
+                block.x[lane] = pos.x;
+                block.y[lane] = pos.y;
+                block.z[lane] = pos.z;
+                block.w[lane] = pos.w;
+
+                ColourValue d = lightDiffuse[i] * diffuse;
+                ColourValue s = lightSpecular[i] * specular;
+                block.dr[lane] = d.r;
+                block.dg[lane] = d.g;
+                block.db[lane] = d.b;
+                block.sr[lane] = s.r;
+                block.sg[lane] = s.g;
+                block.sb[lane] = s.b;
+
+                mSpecular |= s.r > 0 || s.g > 0 || s.b > 0;
+            }
+        }
+    }
+
+    void TinyLighting::shade(const Vector3& pos, const Vector3& n, ColourValue& diffuseOut,
+                             ColourValue& specularOut) const
+    {
+        float diff[3] = {0, 0, 0};
+        float spec[3] = {0, 0, 0};
+
+        for (int b = 0; b < mNumBlocks; b++)
+        {
+            const LightBlock& block = mBlocks[b];
+            float ndotl[4], ndoth[4], att[4];
+#if __OGRE_HAVE_SSE
+            // vector from the point to the light, pos * w is zero for directional lights
+            __m128 w = _mm_loadu_ps(block.w);
+            __m128 lx = _mm_sub_ps(_mm_loadu_ps(block.x), _mm_mul_ps(_mm_set1_ps(pos.x), w));
+            __m128 ly = _mm_sub_ps(_mm_loadu_ps(block.y), _mm_mul_ps(_mm_set1_ps(pos.y), w));
+            __m128 lz = _mm_sub_ps(_mm_loadu_ps(block.z), _mm_mul_ps(_mm_set1_ps(pos.z), w));
+
+            __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, lx), _mm_mul_ps(ly, ly)), _mm_mul_ps(lz, lz));
+            // a point at the light position would divide by zero
+            d2 = _mm_max_ps(d2, _mm_set1_ps(1e-12f));
+            __m128 dist = _mm_sqrt_ps(d2);
+            __m128 invDist = _mm_div_ps(_mm_set1_ps(1), dist);
+            lx = _mm_mul_ps(lx, invDist);
+            ly = _mm_mul_ps(ly, invDist);
+            lz = _mm_mul_ps(lz, invDist);
+
+            __m128 nx = _mm_set1_ps(n.x), ny = _mm_set1_ps(n.y), nz = _mm_set1_ps(n.z);
+            __m128 nl = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, lx), _mm_mul_ps(ny, ly)), _mm_mul_ps(nz, lz));
+            nl = _mm_max_ps(nl, _mm_setzero_ps());
+
+            // 1 / (c + l * d + q * d^2), zero beyond the range
+            __m128 a = _mm_add_ps(_mm_loadu_ps(block.att0), _mm_mul_ps(_mm_loadu_ps(block.att1), dist));
+            a = _mm_add_ps(a, _mm_mul_ps(_mm_loadu_ps(block.att2), d2));
+            a = _mm_div_ps(_mm_set1_ps(1), a);
+            a = _mm_and_ps(a, _mm_cmple_ps(dist, _mm_loadu_ps(block.range)));
+
+            __m128 da = _mm_mul_ps(nl, a);
+            __m128 dr = _mm_mul_ps(da, _mm_loadu_ps(block.dr));
+            __m128 dg = _mm_mul_ps(da, _mm_loadu_ps(block.dg));
+            __m128 db = _mm_mul_ps(da, _mm_loadu_ps(block.db));
+
+            // sum the lanes of r, g and b at once
+            __m128 t0 = _mm_unpacklo_ps(dr, dg); // r0 g0 r1 g1
+            __m128 t1 = _mm_unpackhi_ps(dr, dg); // r2 g2 r3 g3
+            __m128 rg = _mm_add_ps(t0, t1);      // r02 g02 r13 g13
+            rg = _mm_add_ps(rg, _mm_movehl_ps(rg, rg));
+            __m128 bb = _mm_add_ps(db, _mm_movehl_ps(db, db));
+            bb = _mm_add_ss(bb, _mm_shuffle_ps(bb, bb, _MM_SHUFFLE(1, 1, 1, 1)));
+            float rgs[4];
+            _mm_storeu_ps(rgs, rg);
+            diff[0] += rgs[0];
+            diff[1] += rgs[1];
+            diff[2] += _mm_cvtss_f32(bb);
+
+            if (!mSpecular)
+                continue;
+
+            // half vector with the viewer at +z
+            __m128 hz = _mm_add_ps(lz, _mm_set1_ps(1));
+            __m128 hlen = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, lx), _mm_mul_ps(ly, ly)), _mm_mul_ps(hz, hz)));
+            __m128 nh = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, lx), _mm_mul_ps(ny, ly)), _mm_mul_ps(nz, hz));
+            nh = _mm_div_ps(nh, _mm_max_ps(hlen, _mm_set1_ps(1e-6f)));
+
+            _mm_storeu_ps(ndotl, nl);
+            _mm_storeu_ps(ndoth, nh);
+            _mm_storeu_ps(att, a);
+#else
+            for (int lane = 0; lane < 4; lane++)
+            {
+                Vector3 l(block.x[lane] - pos.x * block.w[lane], block.y[lane] - pos.y * block.w[lane],
+                          block.z[lane] - pos.z * block.w[lane]);
+                float dist = std::max(l.length(), 1e-6f);
+                l /= dist;
+
+                ndotl[lane] = std::max(n.dotProduct(l), 0.0f);
+                att[lane] = 1 / (block.att0[lane] + block.att1[lane] * dist + block.att2[lane] * dist * dist);
+                if (dist > block.range[lane])
+                    att[lane] = 0;
+
+                float da = ndotl[lane] * att[lane];
+                diff[0] += da * block.dr[lane];
+                diff[1] += da * block.dg[lane];
+                diff[2] += da * block.db[lane];
+
+                Vector3 h = l + Vector3::UNIT_Z;
+                ndoth[lane] = n.dotProduct(h) / std::max(h.length(), 1e-6f);
+            }
+
+            if (!mSpecular)
+                continue;
+#endif
+            for (int lane = 0; lane < 4; lane++)
+            {
+                if (ndotl[lane] <= 0 || ndoth[lane] <= 0)
+                    continue;
+                float s = std::pow(ndoth[lane], shininess) * att[lane];
+                spec[0] += s * block.sr[lane];
+                spec[1] += s * block.sg[lane];
+                spec[2] += s * block.sb[lane];
+            }
+        }
+
+        diffuseOut = ColourValue(sceneColour.r + diff[0], sceneColour.g + diff[1], sceneColour.b + diff[2],
+                                 diffuse.a);
+        specularOut = ColourValue(spec[0], spec[1], spec[2], 0);
+    }
+}
@@ -14,19 +14,29 @@
 #include "OgreException.h"
 #include "OgreTinyDepthBuffer.h"
 #include "OgreTinyHardwarePixelBuffer.h"
-#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreTinyHardwareBufferManager.h"
 #include "OgreRoot.h"
 #include "OgreConfig.h"
 #include "OgreViewport.h"
 #include "OgreTinyWindow.h"
+#include "OgreTinyFrameTarget.h"
+#include "OgreTinyRenderTexture.h"
 #include "OgreTinyTexture.h"
 
 #include "tinyrenderer.h"
 
 namespace Ogre {
     TinyRenderSystem::TinyRenderSystem()
-        : mHardwareBufferManager(0)
+        : mScissorEnabled(false), mLightingDirty(true), mDepthTest(true), mDepthWrite(true),
+          mHardwareBufferManager(0)
     {
+        mCommandQueue.reset(new TinyCommandQueue());
+
+        mDefaultShader.texture = NULL;
+        mDefaultShader.uniform_doLighting = false;
+        mDefaultShader.uniform_perPixelLighting = false;
+        mDefaultShader.uniform_doVertexColour = false;
+
         LogManager::getSingleton().logMessage(getName() + " created.");
 
         initConfigOptions();
@@ -37,9 +47,23 @@ namespace Ogre {
         mFixedFunctionParams->_setLogicalIndexes(logicalBufferStruct);
         mFixedFunctionParams->setAutoConstant(0, GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
         mFixedFunctionParams->setAutoConstant(4, GpuProgramParameters::ACT_TEXTURE_MATRIX);
-        mFixedFunctionParams->setAutoConstant(8, GpuProgramParameters::ACT_DERIVED_AMBIENT_LIGHT_COLOUR);
-        mFixedFunctionParams->setAutoConstant(9, GpuProgramParameters::ACT_LIGHT_POSITION);
-        mFixedFunctionParams->setAutoConstant(10, GpuProgramParameters::ACT_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX);
+        mFixedFunctionParams->setAutoConstant(8, GpuProgramParameters::ACT_DERIVED_SCENE_COLOUR);
+        mFixedFunctionParams->setAutoConstant(9, GpuProgramParameters::ACT_SURFACE_DIFFUSE_COLOUR);
+        mFixedFunctionParams->setAutoConstant(10, GpuProgramParameters::ACT_SURFACE_SPECULAR_COLOUR);
+        mFixedFunctionParams->setAutoConstant(11, GpuProgramParameters::ACT_SURFACE_SHININESS);
+        mFixedFunctionParams->setAutoConstant(12, GpuProgramParameters::ACT_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX);
+        mFixedFunctionParams->setAutoConstant(16, GpuProgramParameters::ACT_WORLDVIEW_MATRIX);
+        mFixedFunctionParams->setAutoConstant(20, GpuProgramParameters::ACT_VIEW_MATRIX);
+
+        // all lights are bound, the ones past the current light list are black
+        for (uint32 i = 0; i < OGRE_MAX_SIMULTANEOUS_LIGHTS; i++)
+        {
+            size_t light_offset = 24 + i * 4;
+            mFixedFunctionParams->setAutoConstant(light_offset + 0, GpuProgramParameters::ACT_LIGHT_POSITION, i);
+            mFixedFunctionParams->setAutoConstant(light_offset + 1, GpuProgramParameters::ACT_LIGHT_DIFFUSE_COLOUR, i);
+            mFixedFunctionParams->setAutoConstant(light_offset + 2, GpuProgramParameters::ACT_LIGHT_SPECULAR_COLOUR, i);
+            mFixedFunctionParams->setAutoConstant(light_offset + 3, GpuProgramParameters::ACT_LIGHT_ATTENUATION, i);
+        }
 
         mActiveRenderTarget = 0;
         mGLInitialised = false;
@@ -48,6 +72,8 @@ namespace Ogre {
 
     void TinyRenderSystem::applyFixedFunctionParams(const GpuProgramParametersPtr& params, uint16 mask)
     {
+        TinyLighting& lighting = mDefaultShader.uniform_lighting;
+
         // Autoconstant index is not a physical index
         for (const auto& ac : params->getAutoConstants())
         {
@@ -63,15 +89,45 @@ namespace Ogre {
                 case GpuProgramParameters::ACT_TEXTURE_MATRIX:
                     mDefaultShader.uniform_Tex = Matrix4(ptr);
                     break;
-                case GpuProgramParameters::ACT_DERIVED_AMBIENT_LIGHT_COLOUR:
-                    memcpy(mDefaultShader.uniform_ambientCol.ptr(), ptr, sizeof(float)*4);
+                case GpuProgramParameters::ACT_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX:
+                    mDefaultShader.uniform_MVIT = Matrix4(ptr);
+                    break;
+                case GpuProgramParameters::ACT_WORLDVIEW_MATRIX:
+                    mDefaultShader.uniform_MV = Matrix4(ptr);
+                    break;
+                case GpuProgramParameters::ACT_VIEW_MATRIX:
+                    lighting.view = Matrix4(ptr);
+                    mLightingDirty = true;
+                    break;
+                case GpuProgramParameters::ACT_DERIVED_SCENE_COLOUR:
+                    memcpy(lighting.sceneColour.ptr(), ptr, sizeof(float)*4);
+                    break;
+                case GpuProgramParameters::ACT_SURFACE_DIFFUSE_COLOUR:
+                    memcpy(lighting.diffuse.ptr(), ptr, sizeof(float)*4);
+                    mLightingDirty = true;
+                    break;
+                case GpuProgramParameters::ACT_SURFACE_SPECULAR_COLOUR:
+                    memcpy(lighting.specular.ptr(), ptr, sizeof(float)*4);
+                    mLightingDirty = true;
+                    break;
+                case GpuProgramParameters::ACT_SURFACE_SHININESS:
+                    lighting.shininess = ptr[0];
                     break;
                 case GpuProgramParameters::ACT_LIGHT_POSITION:
-                    // ptr[3] ? LIGHT_POINT : LIGHT_DIRECTIONAL;
-                    mDefaultShader.uniform_lightDir = ptr[3] ? Vector3(ptr).normalisedCopy() : -Vector3(ptr);
+                    memcpy(lighting.lightPosition[ac.data].ptr(), ptr, sizeof(float)*4);
+                    mLightingDirty = true;
                     break;
-                case GpuProgramParameters::ACT_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX:
-                    mDefaultShader.uniform_MVIT = Matrix4(ptr);
+                case GpuProgramParameters::ACT_LIGHT_DIFFUSE_COLOUR:
+                    memcpy(lighting.lightDiffuse[ac.data].ptr(), ptr, sizeof(float)*4);
+                    mLightingDirty = true;
+                    break;
+                case GpuProgramParameters::ACT_LIGHT_SPECULAR_COLOUR:
+                    memcpy(lighting.lightSpecular[ac.data].ptr(), ptr, sizeof(float)*4);
+                    mLightingDirty = true;
+                    break;
+                case GpuProgramParameters::ACT_LIGHT_ATTENUATION:
+                    memcpy(lighting.lightAttenuation[ac.data].ptr(), ptr, sizeof(float)*4);
+                    mLightingDirty = true;
                     break;
                 default:
                     // ignore
@@ -127,13 +183,16 @@ namespace Ogre {
 
         rsc->setCapability(RSC_VERTEX_TEXTURE_FETCH);
 
+        // textures are rendered to in place
+        rsc->setCapability(RSC_HWRENDER_TO_TEXTURE);
+
         return rsc;
     }
 
     void TinyRenderSystem::initialiseFromRenderSystemCapabilities(RenderSystemCapabilities* caps, RenderTarget* primary)
     {
         // Use VBO's by default
-        mHardwareBufferManager = new DefaultHardwareBufferManager();
+        mHardwareBufferManager = new TinyHardwareBufferManager();
 
         // Create the texture manager
         mTextureManager = new TinyTextureManager();
@@ -143,6 +202,9 @@ namespace Ogre {
 
     void TinyRenderSystem::shutdown(void)
     {
+        mCommandQueue->finish();
+        mActiveTexture.reset();
+
         RenderSystem::shutdown();
 
         OGRE_DELETE mHardwareBufferManager;
@@ -216,17 +278,21 @@ namespace Ogre {
         if(stage > 0)
             return;
 
-        if(!enabled || !texPtr)
-        {
-            mDefaultShader.image = NULL;
-            return;
-        }
-
-        mDefaultShader.image = static_cast<TinyTexture*>(texPtr.get())->getImage();
+        mActiveTexture = enabled ? texPtr : TexturePtr();
     }
 
     void TinyRenderSystem::_setSampler(size_t unit, Sampler& sampler)
     {
+        if(unit > 0)
+            return;
+
+        auto& s = mDefaultShader.sampler;
+        s.minFilter = sampler.getFiltering(FT_MIN);
+        s.magFilter = sampler.getFiltering(FT_MAG);
+        s.mipFilter = sampler.getFiltering(FT_MIP);
+        s.addressU = sampler.getAddressingMode().u;
+        s.addressV = sampler.getAddressingMode().v;
+        s.mipBias = sampler.getMipmapBias();
     }
 
     void TinyRenderSystem::_setAlphaRejectSettings(CompareFunction func, unsigned char value, bool alphaToCoverage)
@@ -250,15 +316,8 @@ namespace Ogre {
             _setRenderTarget(target);
             mActiveViewport = vp;
 
-            // Calculate the "lower-left" corner of the viewport
-            Rect vpRect = vp->getActualDimensions();
-            if (!target->requiresTextureFlipping())
-            {
-                // Convert "upper-left" corner to "lower-left"
-                std::swap(vpRect.top, vpRect.bottom);
-                vpRect.top = target->getHeight() - vpRect.top;
-                vpRect.bottom = target->getHeight() - vpRect.bottom;
-            }
+            Rect vpRect = toPixelRect(vp->getActualDimensions());
+            mViewportRect = vpRect;
 
             mVP.makeTransform({vpRect.left + vpRect.width() / 2.f, vpRect.top + vpRect.height() / 2.f, 0.5},
                               {vpRect.width() / 2.f, vpRect.height() / 2.f, 0.5}, Ogre::Quaternion::IDENTITY);
@@ -267,8 +326,37 @@ namespace Ogre {
         }
     }
 
+    Rect TinyRenderSystem::toPixelRect(Rect r) const
+    {
+        if (!mActiveRenderTarget->requiresTextureFlipping())
+        {
+            // Convert "upper-left" corner to "lower-left"
+            std::swap(r.top, r.bottom);
+            r.top = mActiveRenderTarget->getHeight() - r.top;
+            r.bottom = mActiveRenderTarget->getHeight() - r.bottom;
+        }
+        return r;
+    }
+
+    Rect TinyRenderSystem::getClipRect() const
+    {
+        Rect clip = mViewportRect;
+        if (mScissorEnabled)
+            clip = clip.intersect(mScissorRect);
+
+        // to inclusive bounds inside the colour buffer. Its Image may be repointed by a recorded swap
+        // while we record, so the size is taken from the target.
+        clip.left = std::max<int32>(clip.left, 0);
+        clip.top = std::max<int32>(clip.top, 0);
+        clip.right = std::min<int32>(clip.right, mActiveRenderTarget->getWidth()) - 1;
+        clip.bottom = std::min<int32>(clip.bottom, mActiveRenderTarget->getHeight()) - 1;
+        return clip;
+    }
+
     void TinyRenderSystem::_endFrame(void)
     {
+        // rasterize while the next frame is prepared
+        mCommandQueue->submit();
     }
 
     void TinyRenderSystem::_setCullingMode(CullingMode mode)
@@ -289,7 +377,7 @@ namespace Ogre {
 
     void TinyRenderSystem::setColourBlendState(const ColourBlendState& state)
     {
-        mBlendAdd = state.destFactor == SBF_ONE;
+        mBlendState = state;
     }
 
     HardwareOcclusionQuery* TinyRenderSystem::createHardwareOcclusionQuery(void)
@@ -303,53 +391,177 @@ namespace Ogre {
     }
 
     void TinyRenderSystem::DefaultShader::vertex(const vec4& vertex, const vec2* uv, const vec3* normal,
-                                                 int gl_VertexID, vec4& gl_Position)
+                                                 const ColourValue& colour, int gl_VertexID, vec4& gl_Position)
     {
         gl_Position = uniform_MVP * vertex;
 
+        var_colour[gl_VertexID] = colour;
+
         if(uv)
             var_uv[gl_VertexID] = (uniform_Tex*vec4(uv->x, uv->y, 0, 1)).xy();
 
-        if(normal)
-            var_normal[gl_VertexID] = uniform_MVIT.linear() * *normal;
+        if(!uniform_doLighting)
+            return;
+
+        vec3 n = (uniform_MVIT.linear() * *normal).normalisedCopy();
+        vec3 pos = (uniform_MV * vertex).xyz();
+        if(uniform_perPixelLighting)
+        {
+            var_normal[gl_VertexID] = n;
+            var_position[gl_VertexID] = pos;
+        }
+        else
+        {
+            uniform_lighting.shade(pos, n, var_lit[gl_VertexID], var_specular[gl_VertexID]);
+        }
     }
-    bool TinyRenderSystem::DefaultShader::fragment(const vec3& bar, ColourValue& gl_FragColor)
+    bool TinyRenderSystem::DefaultShader::fragment(const vec3& bar, const vec3& dFdx, const vec3& dFdy,
+                                                   ColourValue& gl_FragColor)
     {
-        if(image)
+        if(uniform_doVertexColour)
+            gl_FragColor = var_colour[0]*bar.x + var_colour[1]*bar.y + var_colour[2]*bar.z;
+
+        ColourValue lit, specular;
+        if(uniform_doLighting)
+        {
+            if(uniform_perPixelLighting)
+            {
+                vec3 n = var_normal[0]*bar.x + var_normal[1]*bar.y + var_normal[2]*bar.z;
+                vec3 pos = var_position[0]*bar.x + var_position[1]*bar.y + var_position[2]*bar.z;
+                uniform_lighting.shade(pos, n.normalisedCopy(), lit, specular);
+            }
+            else
+            {
+                lit = var_lit[0]*bar.x + var_lit[1]*bar.y + var_lit[2]*bar.z;
+                specular = var_specular[0]*bar.x + var_specular[1]*bar.y + var_specular[2]*bar.z;
+            }
+            gl_FragColor = lit;
+        }
+
+        if(texture)
         {
             vec2 uv = var_uv[0]*bar.x + var_uv[1]*bar.y + var_uv[2]*bar.z;
+            vec2 duvdx = var_uv[0]*dFdx.x + var_uv[1]*dFdx.y + var_uv[2]*dFdx.z;
+            vec2 duvdy = var_uv[0]*dFdy.x + var_uv[1]*dFdy.y + var_uv[2]*dFdy.z;
 
-            const vec4b& tex = sample2D(*image, uv);
+            uint32 tex = texture->sample(sampler, uv, duvdx, duvdy);
+            auto texb = (const uchar*)&tex;
 
-            if(tex[3] < 1)
+            if(texb[3] < 1)
                 return true;
 
-            gl_FragColor = ColourValue(tex.ptr());
+            gl_FragColor = gl_FragColor * ColourValue(texb);
         }
 
+        // separate specular, like fixed function GL
         if(uniform_doLighting)
         {
-            vec3 n = var_normal[0]*bar.x + var_normal[1]*bar.y + var_normal[2]*bar.z;
-            float diffuse = std::max(0.f, n.dotProduct(uniform_lightDir));
-            gl_FragColor *= diffuse;
-            gl_FragColor += uniform_ambientCol;
+            gl_FragColor.r += specular.r;
+            gl_FragColor.g += specular.g;
+            gl_FragColor.b += specular.b;
         }
 
         return false;
     }
 
-    static uchar* getData(const RenderOperation& op, VertexElementSemantic sem, size_t& step)
+    /// vertex or index data of a recorded draw
+    struct Stream
+    {
+        HardwareBufferPtr buffer; // kept alive until executed
+        const uchar* data;
+        size_t step;
+        VertexElementType type;
+
+        Stream() : data(NULL), step(0), type(VET_FLOAT1) {}
+
+        template<typename T> const T* at(size_t i) const { return (const T*)(data + step * i); }
+    };
+
+    static void markUsed(HardwareBuffer* buf)
     {
+        if(auto impl = dynamic_cast<TinyHardwareBuffer*>(buf->_getImpl<HardwareBuffer>()))
+            impl->_notifyUsed(TinyCommandQueue::getSingleton().getRecordingSerial());
+    }
+
+    static Stream getData(const RenderOperation& op, VertexElementSemantic sem)
+    {
+        Stream ret;
         auto element = op.vertexData->vertexDeclaration->findElementBySemantic(sem);
         if(!element)
-            return NULL;
+            return ret;
 
-        step = op.vertexData->vertexDeclaration->getVertexSize(element->getSource());
+        ret.step = op.vertexData->vertexDeclaration->getVertexSize(element->getSource());
+        ret.type = element->getType();
 
         auto buf = op.vertexData->vertexBufferBinding->getBuffer(element->getSource());
-        uchar* ret = (uchar*)buf->lock(HardwareBuffer::HBL_NORMAL);
+        markUsed(buf.get());
+        ret.buffer = buf;
+        ret.data = (const uchar*)buf->lock(HardwareBuffer::HBL_READ_ONLY);
         buf->unlock(); // no real locking performed
-        return ret + element->getOffset() + op.vertexData->vertexStart * step;
+        ret.data += element->getOffset() + op.vertexData->vertexStart * ret.step;
+        return ret;
+    }
+
+    static ColourValue getColour(const uchar* data, VertexElementType type)
+    {
+        switch(type)
+        {
+        case VET_UBYTE4_NORM:
+            return ColourValue(data);
+        case VET_FLOAT4:
+            return ColourValue(((const float*)data)[0], ((const float*)data)[1], ((const float*)data)[2],
+                               ((const float*)data)[3]);
+        case VET_FLOAT3:
+            return ColourValue(((const float*)data)[0], ((const float*)data)[1], ((const float*)data)[2]);
+        default:
+            return ColourValue::White;
+        }
+    }
+
+    struct TinyRenderSystem::DrawCommand
+    {
+        DefaultShader shader;
+        TexturePtr texture;
+        RasterState state;
+        Matrix4 viewport;
+        Image* colourBuffer;
+        Image* depthBuffer;
+
+        Stream positions, uvs, normals, colours, indices;
+        size_t drawCount;
+        int verts; // per primitive
+        int advance; // between primitives
+
+        void execute();
+    };
+
+    void TinyRenderSystem::DrawCommand::execute()
+    {
+        shader.texture = texture ? &static_cast<TinyTexture*>(texture.get())->_getMipChain() : NULL;
+
+        const uint16* idx16Data = indices.step == 2 ? indices.at<uint16>(0) : NULL;
+        const uint32* idx32Data = indices.step == 4 ? indices.at<uint32>(0) : NULL;
+
+        vec4 clip_vert[3]; // triangle coordinates (clip coordinates), written by VS, read by FS
+        for(size_t i = 0; i + verts <= drawCount; i += advance)
+        {
+            for(int j= 0; j < verts; j++)
+            {
+                size_t idx = i + j;
+                idx = idx16Data ? idx16Data[idx] : (idx32Data ? idx32Data[idx] : idx);
+                const vec2* uv = uvs.data ? uvs.at<vec2>(idx) : NULL;
+                const vec3* n = normals.data ? normals.at<vec3>(idx) : NULL;
+                ColourValue col = colours.data ? getColour(colours.at<uchar>(idx), colours.type) : ColourValue::White;
+                shader.vertex(vec4(*positions.at<Vector3f>(idx)), uv, n, col, j, clip_vert[j]);
+            }
+
+            if (verts == 3)
+                triangle(viewport, clip_vert, shader, *colourBuffer, *depthBuffer, state);
+            else if (verts == 2)
+                line(viewport, clip_vert, shader, *colourBuffer, *depthBuffer, state);
+            else
+                point(viewport, clip_vert[0], shader, *colourBuffer, *depthBuffer, state);
+        }
     }
 
     void TinyRenderSystem::_render(const RenderOperation& op)
@@ -357,85 +569,152 @@ namespace Ogre {
         // Call super class.
         RenderSystem::_render(op);
 
-        bool isStrip = op.operationType == RenderOperation::OT_TRIANGLE_STRIP;
+        // the buffers are referenced now and read when the frame is executed
+        auto cmd = std::make_shared<DrawCommand>();
 
-        if(!isStrip && op.operationType != RenderOperation::OT_TRIANGLE_LIST) // only triangle list/ strip supported
-            return;
+        cmd->positions = getData(op, VES_POSITION);
+        OgreAssert(cmd->positions.data, "VES_POSITION required");
+        cmd->uvs = getData(op, VES_TEXTURE_COORDINATES);
+        cmd->normals = getData(op, VES_NORMAL);
+        cmd->colours = getData(op, VES_DIFFUSE);
 
-        size_t posStep;
-        auto posData = getData(op, VES_POSITION, posStep);
-        OgreAssert(posData, "VES_POSITION required");
+        bool doLighting = mDefaultShader.uniform_doLighting;
+        mDefaultShader.uniform_doLighting &= bool(cmd->normals.data);
+        if (mDefaultShader.uniform_doLighting && mLightingDirty)
+        {
+            // once per light or material change instead of per vertex or pixel
+            mDefaultShader.uniform_lighting.prepare();
+            mLightingDirty = false;
+        }
+        // like fixed function GL, vertex colours replace the material colour when lighting is off
+        mDefaultShader.uniform_doVertexColour = cmd->colours.data && !doLighting;
 
-        size_t uvStep = 0;
-        auto uvData = getData(op, VES_TEXTURE_COORDINATES, uvStep);
+        cmd->drawCount = op.vertexData->vertexCount;
+        if (op.useIndexes)
+        {
+            auto& buf = op.indexData->indexBuffer;
+            markUsed(buf.get());
+            cmd->indices.buffer = buf;
+            cmd->indices.step = buf->getIndexSize();
+            cmd->indices.data = (const uchar*)buf->lock(HardwareBuffer::HBL_READ_ONLY);
+            cmd->indices.data += op.indexData->indexStart * cmd->indices.step;
+            buf->unlock();
+            cmd->drawCount = op.indexData->indexCount;
+        }
 
-        size_t normStep = 0;
-        uchar* normData = getData(op, VES_NORMAL, normStep);;
+        RasterState& state = cmd->state;
+        state.depthCheck = mDepthTest;
+        state.depthWrite = mDepthWrite;
+        state.blend = mBlendState;
+        state.clip = getClipRect();
 
-        mDefaultShader.uniform_doLighting &= bool(normData);
+        // the viewport transform does not flip y for targets that need it, so neither does the winding
+        state.cullMode = mCullingMode;
+        if (!mActiveRenderTarget->requiresTextureFlipping() && mCullingMode != CULL_NONE)
+            state.cullMode = mCullingMode == CULL_CLOCKWISE ? CULL_ANTICLOCKWISE : CULL_CLOCKWISE;
 
-        int16* idx16Data = NULL;
-        int32* idx32Data = NULL;
-        size_t drawCount = op.vertexData->vertexCount;
-        if (op.useIndexes)
+        bool supported = true;
+        switch(op.operationType)
         {
-            if(op.indexData->indexBuffer->getIndexSize() == 2)
-            {
-                idx16Data = (int16*)op.indexData->indexBuffer->lock(HardwareBuffer::HBL_NORMAL);
-                idx16Data += op.indexData->indexStart;
-            }
-            else
-            {
-                idx32Data = (int32*)op.indexData->indexBuffer->lock(HardwareBuffer::HBL_NORMAL);
-                idx32Data += op.indexData->indexStart;
-            }
-            op.indexData->indexBuffer->unlock();
-            drawCount = op.indexData->indexCount;
+        case RenderOperation::OT_TRIANGLE_LIST:
+            cmd->verts = cmd->advance = 3;
+            break;
+        case RenderOperation::OT_TRIANGLE_STRIP:
+            cmd->verts = 3;
+            cmd->advance = 1;
+            state.cullMode = CULL_NONE; // winding alternates
+            break;
+        case RenderOperation::OT_LINE_LIST:
+            cmd->verts = cmd->advance = 2;
+            break;
+        case RenderOperation::OT_LINE_STRIP:
+            cmd->verts = 2;
+            cmd->advance = 1;
+            break;
+        case RenderOperation::OT_POINT_LIST:
+            cmd->verts = cmd->advance = 1;
+            break;
+        default: // triangle fans and adjacency types are not supported
+            supported = false;
+            break;
         }
 
-        Vector3f* v = NULL;
-        Vector2* uv = NULL;
-        Vector3f* n = NULL;
-        vec4 clip_vert[3]; // triangle coordinates (clip coordinates), written by VS, read by FS
+        // fully scissored
+        supported &= state.clip.width() >= 0 && state.clip.height() >= 0;
+
+        cmd->texture = mActiveTexture;
+        cmd->viewport = mVP;
+        cmd->colourBuffer = mActiveColourBuffer;
+        cmd->depthBuffer = mActiveDepthBuffer;
+
+        bool first = true;
         do
         {
-            for(size_t i = 0; i < drawCount; i += 3)
-            {
-                if (i && isStrip)
-                    i -= 2;
-                for(int j= 0; j < 3; j++)
-                {
-                    int idx = i + j;
-                    idx = idx16Data ? idx16Data[idx] : (idx32Data ? idx32Data[idx] : idx);
-                    v = (Vector3f*)(posData + posStep*idx);
-                    uv = (Vector2*)(uvData + uvStep*idx);
-                    n = (Vector3f*)(normData + normStep*idx);
-                    mDefaultShader.vertex(vec4(*v), uv, n, j, clip_vert[j]);
-                }
-                triangle(mVP, clip_vert, mDefaultShader, *mActiveColourBuffer, *mActiveDepthBuffer,
-                            mDepthTest, mDepthWrite, mBlendAdd, !isStrip);
-            }
+            if (!supported)
+                continue;
 
+            // each pass iteration sees its own uniforms
+            if (!first)
+                cmd = std::make_shared<DrawCommand>(*cmd);
+            first = false;
+
+            cmd->shader = mDefaultShader;
+            mCommandQueue->record([cmd]() { cmd->execute(); });
         } while (updatePassIterationRenderState());
+
+        mDefaultShader.uniform_doLighting = doLighting;
     }
 
-    void TinyRenderSystem::setScissorTest(bool enabled, const Rect& rect)
+    void TinyRenderSystem::_useLights(unsigned short limit)
     {
+        if (limit == mDefaultShader.uniform_lighting.numLights)
+            return;
+
+        mDefaultShader.uniform_lighting.numLights = limit;
+        mLightingDirty = true;
+    }
 
+    void TinyRenderSystem::setScissorTest(bool enabled, const Rect& rect)
+    {
+        mScissorEnabled = enabled;
+        if (enabled)
+            mScissorRect = toPixelRect(rect);
     }
 
     void TinyRenderSystem::clearFrameBuffer(unsigned int buffers,
                                                const ColourValue& colour,
                                                float depth, unsigned short stencil)
     {
-        if (buffers & FBT_COLOUR)
-        {
-            mActiveColourBuffer->setTo(colour);
-        }
-        if (buffers & FBT_DEPTH)
-        {
-            mActiveDepthBuffer->setTo(ColourValue(depth));
-        }
+        // like the GL rendersystems, only clear the active viewport
+        Rect clip = getClipRect();
+        if (clip.width() < 0 || clip.height() < 0)
+            return;
+
+        Box box(clip.left, clip.top, clip.right + 1, clip.bottom + 1);
+        Image* colourBuffer = (buffers & FBT_COLOUR) ? mActiveColourBuffer : NULL;
+        Image* depthBuffer = (buffers & FBT_DEPTH) ? mActiveDepthBuffer : NULL;
+        mCommandQueue->record([=]() {
+            if (colourBuffer)
+            {
+                // RGB for windows, RGBA for textures and frame targets
+                uchar px[4];
+                PixelUtil::packColour(colour.saturateCopy(), PF_BYTE_RGBA, px);
+                PixelBox dst = colourBuffer->getPixelBox().getSubVolume(box);
+                size_t bpp = PixelUtil::getNumElemBytes(dst.format);
+                for (uint32 y = 0; y < dst.getHeight(); y++)
+                {
+                    uchar* row = dst.data + y * dst.rowPitch * bpp;
+                    for (uint32 x = 0; x < dst.getWidth(); x++)
+                        memcpy(row + x * bpp, px, bpp);
+                }
+            }
+            if (depthBuffer)
+            {
+                PixelBox dst = depthBuffer->getPixelBox().getSubVolume(box);
+                for (uint32 y = 0; y < dst.getHeight(); y++)
+                    std::fill_n((float*)dst.data + y * dst.rowPitch, dst.getWidth(), depth);
+            }
+        });
     }
 
     void TinyRenderSystem::_setRenderTarget(RenderTarget *target)
@@ -445,12 +724,6 @@ namespace Ogre {
         if (!target)
             return;
 
-        if(auto win = dynamic_cast<TinyWindow*>(target))
-        {
-            mActiveColourBuffer = win->getImage();
-            mActiveDepthBuffer = dynamic_cast<TinyDepthBuffer*>(win->getDepthBuffer())->getImage();
-        }
-
         // Check the depth buffer status
         auto *depthBuffer = target->getDepthBuffer();
 
@@ -461,5 +734,15 @@ namespace Ogre {
             // or the Current context doesn't match the one this Depth buffer was created with
             setDepthBufferFor( target );
         }
+
+        if(auto win = dynamic_cast<TinyWindow*>(target))
+            mActiveColourBuffer = win->getImage();
+        else if(auto frames = dynamic_cast<TinyFrameTarget*>(target))
+            mActiveColourBuffer = frames->getImage();
+        else if(auto rtt = dynamic_cast<TinyRenderTexture*>(target))
+            mActiveColourBuffer = rtt->getImage();
+
+        OgreAssert(target->getDepthBuffer(), "Tiny requires a depth buffer");
+        mActiveDepthBuffer = static_cast<TinyDepthBuffer*>(target->getDepthBuffer())->getImage();
     }
 }
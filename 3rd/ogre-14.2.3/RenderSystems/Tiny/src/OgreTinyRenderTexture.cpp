@@ -0,0 +1,34 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#include "OgreTinyRenderTexture.h"
+#include "OgreTinyTexture.h"
+#include "OgreTinyCommandQueue.h"
+
+namespace Ogre
+{
+    TinyRenderTexture::TinyRenderTexture(const String& name, HardwarePixelBuffer* buffer, const PixelBox& data,
+                                         uint32 zoffset, TinyTexture* parent)
+        : RenderTexture(buffer, zoffset), mParent(parent)
+    {
+        mName = name;
+
+        // no copy, the rasterizer writes to the texture storage
+        PixelBox slice = data.getSubVolume(Box(0, 0, zoffset, data.getWidth(), data.getHeight(), zoffset + 1));
+        mBuffer.loadDynamicImage(slice.data, slice.getWidth(), slice.getHeight(), 1, slice.format);
+    }
+
+    TinyRenderTexture::~TinyRenderTexture()
+    {
+        if (auto queue = TinyCommandQueue::getSingletonPtr())
+            queue->finish();
+    }
+
+    void TinyRenderTexture::swapBuffers()
+    {
+        // after the draws into the texture executed
+        if (mParent)
+            TinyCommandQueue::getSingleton().record([this]() { mParent->_notifyContentsChanged(); });
+    }
+}
@@ -9,14 +9,16 @@
 #include "OgreTinyHardwarePixelBuffer.h"
 #include "OgreBitwise.h"
 #include "OgreTextureManager.h"
+#include "OgreTinyCommandQueue.h"
 
 namespace Ogre {
     TinyTexture::TinyTexture(ResourceManager* creator, const String& name,
                                    ResourceHandle handle, const String& group, bool isManual,
                                    ManualResourceLoader* loader)
-        : Texture(creator, name, handle, group, isManual, loader)
+        : Texture(creator, name, handle, group, isManual, loader), mMipChainDirty(true)
     {
-        mMipmapsHardwareGenerated = false;
+        // we generate them ourselves on first use
+        mMipmapsHardwareGenerated = true;
     }
 
     TinyTexture::~TinyTexture()
@@ -33,10 +35,15 @@ namespace Ogre {
         if((mUsage & TU_RENDERTARGET) && (mUsage & ~TU_RENDERTARGET) == 0)
             mUsage |= HardwareBuffer::HBU_DYNAMIC;
 
+        // recorded draws might still use the old storage
+        TinyCommandQueue::getSingleton().finish();
+
         // Adjust format if required.
         mFormat = TextureManager::getSingleton().getNativeFormat(mTextureType, mFormat, mUsage);
 
-        mNumMipmaps = mNumRequestedMipmaps = 0;
+        // only 2D textures are sampled
+        if (mTextureType != TEX_TYPE_2D)
+            mNumMipmaps = mNumRequestedMipmaps = 0;
 
         mBuffer.create(mFormat, mWidth, mHeight, mDepth, getNumFaces(), mNumMipmaps);
 
@@ -47,16 +54,112 @@ namespace Ogre {
             for (uint32 mip = 0; mip <= getNumMipmaps(); mip++)
             {
                 TinyHardwarePixelBuffer* buf =
-                    new TinyHardwarePixelBuffer(mBuffer.getPixelBox(face, mip), mUsage);
+                    new TinyHardwarePixelBuffer(mBuffer.getPixelBox(face, mip), mUsage, this);
                 mSurfaceList.push_back(HardwarePixelBufferSharedPtr(buf));
             }
         }
 
-        // Generate mipmaps after all texture levels have been loaded
-        // This is required for compressed formats such as DXT
+        mMipChainDirty = true;
+    }
+
+    void TinyTexture::freeInternalResourcesImpl(void)
+    {
+        TinyCommandQueue::getSingleton().finish();
+        mMipChain.levels.clear();
+        mMipChainDirty = true;
+    }
+
+    const TinyMipChain& TinyTexture::_getMipChain()
+    {
+        if (!mMipChainDirty)
+            return mMipChain;
+
+        // filter the levels below the top one, if we are responsible for them
+        // halvings use the SIMD box filter of Image::scale, large levels are split over the worker threads
         if (mUsage & TU_AUTOMIPMAP)
         {
+            for (uint32 mip = 1; mip <= mNumMipmaps; mip++)
+                Image::scale(mBuffer.getPixelBox(0, mip - 1), mBuffer.getPixelBox(0, mip), Image::FILTER_BILINEAR);
+        }
+
+        std::vector<PixelBox> levels;
+        for (uint32 mip = 0; mip <= mNumMipmaps; mip++)
+            levels.push_back(mBuffer.getPixelBox(0, mip));
+        mMipChain.build(levels);
+
+        mMipChainDirty = false;
+        return mMipChain;
+    }
 
+    void TinyMipChain::build(const std::vector<PixelBox>& src)
+    {
+        levels.resize(src.size());
+        for (size_t i = 0; i < src.size(); i++)
+        {
+            const PixelBox& box = src[i];
+            Level& l = levels[i];
+            l.width = box.getWidth();
+            l.height = box.getHeight();
+            l.tilesX = (l.width + 3) / 4;
+            l.texels.resize(size_t(l.tilesX) * ((l.height + 3) / 4) * 16);
+
+            for (int y = 0; y < l.height; y++)
+            {
+                int morton = ((y & 1) << 1) | ((y & 2) << 2);
+                uint32* tileRow = &l.texels[size_t(y >> 2) * l.tilesX * 16];
+                const uchar* row = box.data + 4 * y * box.rowPitch;
+                for (int x = 0; x < l.width; x++)
+                    memcpy(tileRow + ((x >> 2) << 4) + (morton | (x & 1) | ((x & 2) << 1)), row + 4 * x, 4);
+            }
         }
     }
+
+    uint32 TinyMipChain::sampleLevel(const SamplerState& s, int level, const Vector2& uv, bool bilinear) const
+    {
+        const Level& l = levels[level];
+        float u = uv.x * l.width;
+        float v = uv.y * l.height;
+
+        if (!bilinear)
+            return l.fetch(address(std::floor(u), l.width, s.addressU),
+                           address(std::floor(v), l.height, s.addressV));
+
+        // texel centers are at .5
+        u -= 0.5f;
+        v -= 0.5f;
+        float fu = std::floor(u);
+        float fv = std::floor(v);
+        uint32 wu = (u - fu) * 256;
+        uint32 wv = (v - fv) * 256;
+
+        int x0 = address(fu, l.width, s.addressU);
+        int x1 = address(fu + 1, l.width, s.addressU);
+        int y0 = address(fv, l.height, s.addressV);
+        int y1 = address(fv + 1, l.height, s.addressV);
+
+        return lerp(lerp(l.fetch(x0, y0), l.fetch(x1, y0), wu), lerp(l.fetch(x0, y1), l.fetch(x1, y1), wu), wv);
+    }
+
+    uint32 TinyMipChain::sample(const SamplerState& s, const Vector2& uv, const Vector2& dx, const Vector2& dy) const
+    {
+        // derivatives in texels of the top level
+        Vector2 size(levels[0].width, levels[0].height);
+        float rho2 = std::max((dx * size).squaredLength(), (dy * size).squaredLength());
+        float lod = 0.5f * std::log2(std::max(rho2, 1e-8f)) + s.mipBias;
+
+        if (lod <= 0 || levels.size() == 1 || s.mipFilter == FO_NONE)
+            return sampleLevel(s, 0, uv, (lod <= 0 ? s.magFilter : s.minFilter) > FO_POINT);
+
+        bool bilinear = s.minFilter > FO_POINT;
+        float maxLod = levels.size() - 1;
+        lod = std::min(lod, maxLod);
+
+        if (s.mipFilter == FO_POINT)
+            return sampleLevel(s, int(lod + 0.5f), uv, bilinear);
+
+        int l0 = lod;
+        int l1 = std::min(l0 + 1, int(maxLod));
+        uint32 w = (lod - l0) * 256;
+        return lerp(sampleLevel(s, l0, uv, bilinear), sampleLevel(s, l1, uv, bilinear), w);
+    }
 }
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "OgreTinyWindow.h"
+#include "OgreTinyCommandQueue.h"
 #include "OgreException.h"
 #include "OgreStringConverter.h"
 
@@ -14,12 +15,19 @@
 
 namespace Ogre
 {
-TinyWindow::TinyWindow() : mParentWindow(NULL)
+TinyWindow::TinyWindow() : mRecordIndex(0), mPresentSerial(0), mParentWindow(NULL)
 {
     mIsFullScreen = false;
     mActive = true;
 }
 
+TinyWindow::~TinyWindow()
+{
+    // recorded commands might still write to mBuffers
+    if (auto queue = TinyCommandQueue::getSingletonPtr())
+        queue->finish();
+}
+
 void TinyWindow::create(const String& name, uint width, uint height,
                             bool fullScreen, const NameValuePairList *miscParams)
 {
@@ -37,17 +45,48 @@ void TinyWindow::create(const String& name, uint width, uint height,
 
 void TinyWindow::resize(uint width, uint height)
 {
+    // also drops a frame waiting to be presented, it no longer fits the window
+    if (auto queue = TinyCommandQueue::getSingletonPtr())
+        queue->finish();
+
     mWidth = width;
     mHeight = height;
-    mBuffer.create(PF_BYTE_RGB, width, height);
+    for (auto& buffer : mBuffers)
+        buffer.create(PF_BYTE_RGB, width, height);
+    mRecordIndex = 0;
+    mPresentSerial = 0;
+    mBackBuffer.loadDynamicImage(mBuffers[0].getData(), width, height, 1, PF_BYTE_RGB);
 }
 
 void TinyWindow::swapBuffers()
 {
-#if OGRE_BITES_HAVE_SDL
-    if(!mParentWindow)
-        return;
+    TinyCommandQueue& queue = TinyCommandQueue::getSingleton();
+
+    // continue in the other buffer once this frame is rasterized
+    uint32 next = mRecordIndex ^ 1;
+    uchar* data = mBuffers[next].getData();
+    uint32 width = mWidth, height = mHeight;
+    queue.record([this, data, width, height]()
+                 { mBackBuffer.loadDynamicImage(data, width, height, 1, PF_BYTE_RGB); });
+    uint64 serial = queue.getRecordingSerial();
+    queue.submit();
+
+    // SDL wants its window on the render thread. Present the previous frame, which was rasterized while
+    // this one was recorded, and leave this one to the workers. The next frame will not be submitted
+    // before we return, so its buffer is not written to meanwhile.
+    if (mParentWindow && mPresentSerial)
+    {
+        queue.waitFor(mPresentSerial);
+        present(mBuffers[next]);
+    }
+
+    mPresentSerial = serial;
+    mRecordIndex = next;
+}
 
+void TinyWindow::present(const Image& frame)
+{
+#if OGRE_BITES_HAVE_SDL
     SDL_Surface* surface = SDL_GetWindowSurface(mParentWindow);
 
     SDL_LockSurface(surface);
@@ -58,7 +97,8 @@ void TinyWindow::swapBuffers()
     dst.rowPitch = surface->pitch/surface->format->BytesPerPixel;
     dst.data = (uchar*)surface->pixels;
 
-    copyContentsToMemory(dst, dst, FB_BACK);
+    PixelUtil::bulkPixelConversion(frame.getPixelBox().getSubVolume(Box(0, 0, dst.getWidth(), dst.getHeight())),
+                                   dst);
 
     SDL_UnlockSurface(surface);
 
@@ -77,6 +117,9 @@ void TinyWindow::copyContentsToMemory(const Box& src, const PixelBox& dst, Frame
         OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box");
     }
 
-    PixelUtil::bulkPixelConversion(mBuffer.getPixelBox().getSubVolume(src), dst);
+    TinyCommandQueue::getSingleton().finish();
+
+    const Image& frame = mBuffers[buffer == FB_BACK ? mRecordIndex : mRecordIndex ^ 1];
+    PixelUtil::bulkPixelConversion(frame.getPixelBox().getSubVolume(src), dst);
 }
 } // namespace Ogre
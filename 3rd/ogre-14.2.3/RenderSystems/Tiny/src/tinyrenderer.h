@@ -15,6 +15,8 @@ subject to the following restrictions:
 #include <OgreVector.h>
 #include <OgreMatrix4.h>
 
+#include <climits>
+
 namespace Ogre {
 typedef Vector<2, float> vec2;
 typedef Vector<3, float> vec3;
@@ -26,72 +28,224 @@ typedef Matrix3 mat3;
 typedef Matrix4 mat4;
 
 
-static vec3 barycentric(const vec2 tri[3], const vec2& P) {
+/// matrix mapping screen coordinates (x, y, 1) to barycentric coordinates
+static mat3 barycentricTransform(const vec2 tri[3]) {
     mat3 ABC(tri[0].x, tri[1].x, tri[2].x,
              tri[0].y, tri[1].y, tri[2].y,
              1,     1,          1);
-    //if (ABC.determinant()<1e-6) return vec3(-1,1,1); // for a degenerate triangle generate negative coordinates, it will be thrown away by the rasterizator
-    return ABC.inverse() * vec3(P.x, P.y, 1);
+    return ABC.inverse();
+}
+
+/// perspective correct barycentric coordinates, w_inv holds 1/w of the vertices
+static vec3 perspectiveCorrect(const vec3& bc_screen, const vec3& w_inv) {
+    vec3 bc_clip = bc_screen*w_inv;
+    return bc_clip/(bc_clip.x+bc_clip.y+bc_clip.z); // check https://github.com/ssloy/tinyrenderer/wiki/Technical-difficulties-linear-interpolation-with-perspective-deformations
 }
 
 static float cross(const vec2 &v1, const vec2 &v2) {
     return v1.x * v2.y - v1.y * v2.x;
 }
 
+/// fixed function state used by the rasterizer
+struct RasterState {
+    bool depthCheck;
+    bool depthWrite;
+    CullingMode cullMode;
+    ColourBlendState blend;
+    Rect clip; ///< inclusive pixel bounds, already intersected with the target
+};
+
+static float blendFactor(SceneBlendFactor f, float src, float srcA, float dst, float dstA) {
+    switch (f) {
+    case SBF_ONE:                     return 1;
+    case SBF_ZERO:                    return 0;
+    case SBF_DEST_COLOUR:             return dst;
+    case SBF_SOURCE_COLOUR:           return src;
+    case SBF_ONE_MINUS_DEST_COLOUR:   return 1 - dst;
+    case SBF_ONE_MINUS_SOURCE_COLOUR: return 1 - src;
+    case SBF_DEST_ALPHA:              return dstA;
+    case SBF_SOURCE_ALPHA:            return srcA;
+    case SBF_ONE_MINUS_DEST_ALPHA:    return 1 - dstA;
+    case SBF_ONE_MINUS_SOURCE_ALPHA:  return 1 - srcA;
+    }
+    return 1;
+}
+
+static float blendOp(SceneBlendOperation op, float src, float dst) {
+    switch (op) {
+    case SBO_ADD:              return src + dst;
+    case SBO_SUBTRACT:         return src - dst;
+    case SBO_REVERSE_SUBTRACT: return dst - src;
+    case SBO_MIN:              return std::min(src, dst);
+    case SBO_MAX:              return std::max(src, dst);
+    }
+    return src;
+}
+
+/// blend, mask and write a shaded fragment to a PF_BYTE_RGB or PF_BYTE_RGBA pixel.
+/// Without an alpha channel, dst alpha is 1.
+static void writeFragment(const ColourBlendState& blend, ColourValue src, uchar* dst, int channels) {
+    src.saturate();
+
+    ColourValue dstCol(dst[0] / 255.f, dst[1] / 255.f, dst[2] / 255.f, channels == 4 ? dst[3] / 255.f : 1);
+    if (blend.blendingEnabled()) {
+        ColourValue srcCol = src;
+        for (int c = 0; c < 4; c++) {
+            bool alpha = c == 3;
+            float s = srcCol[c] * blendFactor(alpha ? blend.sourceFactorAlpha : blend.sourceFactor, srcCol[c],
+                                              srcCol.a, dstCol[c], dstCol.a);
+            float d = dstCol[c] * blendFactor(alpha ? blend.destFactorAlpha : blend.destFactor, srcCol[c],
+                                              srcCol.a, dstCol[c], dstCol.a);
+            src[c] = blendOp(alpha ? blend.alphaOperation : blend.operation, s, d);
+        }
+        src.saturate();
+    }
+
+    bool mask[4] = {blend.writeR, blend.writeG, blend.writeB, blend.writeA};
+    for (int c = 0; c < channels; c++)
+        if (mask[c])
+            dst[c] = uchar(src[c] * 255);
+}
+
+/// shade a fragment at x, y, returns whether it was written
+static bool fragment(const RasterState& state, IShader& shader, Image& image, Image& zbuffer, int x, int y,
+                     float frag_depth, const vec3& bar, const vec3& dFdx, const vec3& dFdy) {
+    if (frag_depth < 0.0)
+        return false;
+
+    if(state.depthCheck && frag_depth > *zbuffer.getData<float>(x, y))
+        return false;
+
+    ColourValue fragColour;
+    bool discard = shader.fragment(bar, dFdx, dFdy, fragColour);
+    if (discard) return false;
+
+    writeFragment(state.blend, fragColour, image.getData(x, y), image.getBPP() / 8);
+
+    if (state.depthWrite)
+        *zbuffer.getData<float>(x, y) = frag_depth;
+    return true;
+}
+
+static bool inside(const Rect& r, int x, int y) {
+    return x >= r.left && x <= r.right && y >= r.top && y <= r.bottom;
+}
+
+/// screen coordinates after persp. division, w holds 1/w
+static vec4 toScreen(const mat4& Viewport, const vec4& clip) {
+    vec4 pt = Viewport*clip;
+    float w = pt[3];
+    pt /= w;
+    pt[3] = 1 / w;
+    return pt;
+}
+
 /// triangle screen coordinates before persp. division
 static void triangle(const mat4& Viewport, const vec4 clip_verts[3], IShader& shader, Image& image,
-                     Image& zbuffer, bool depthCheck, bool depthWrite, bool blendAdd, bool doCull)
+                     Image& zbuffer, const RasterState& state)
 {
-    vec4 pts[3]  = { Viewport*clip_verts[0],    Viewport*clip_verts[1],    Viewport*clip_verts[2]    };  // triangle screen coordinates before persp. division
-    for (int i = 0; i < 3; i++)
-    {
-        float w = pts[i][3];
-        pts[i] /= w;
-        pts[i][3] = 1 / w;
-    }
+    vec4 pts[3]  = { toScreen(Viewport, clip_verts[0]), toScreen(Viewport, clip_verts[1]), toScreen(Viewport, clip_verts[2]) };
 
     vec2 pts2[3] = { pts[0].xy(), pts[1].xy(), pts[2].xy() };  // triangle screen coordinates after  perps. division
 
-    if(doCull && cross(pts2[2] - pts2[0], pts2[2] - pts2[1]) > 0)
+    float area = cross(pts2[2] - pts2[0], pts2[2] - pts2[1]);
+    if (!(area != 0))
+        return; // degenerate, has no barycentric coordinates
+    if((state.cullMode == CULL_CLOCKWISE && area > 0) || (state.cullMode == CULL_ANTICLOCKWISE && area < 0))
         return; // culled
 
+    // the bounding box is clipped against the viewport & scissor rectangle, so pixels outside are never visited
     vec2 bboxmin( std::numeric_limits<float>::max(),  std::numeric_limits<float>::max());
     vec2 bboxmax(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
-    vec2 clamp(image.getWidth()-1, image.getHeight()-1);
+    vec2 clampmin(state.clip.left, state.clip.top);
+    vec2 clampmax(state.clip.right, state.clip.bottom);
     for (int i=0; i<3; i++)
         for (int j=0; j<2; j++) {
-            bboxmin[j] = std::max(0.f,       std::min(bboxmin[j], pts2[i][j]));
-            bboxmax[j] = std::min(clamp[j], std::max(bboxmax[j], pts2[i][j]));
+            bboxmin[j] = std::max(clampmin[j], std::min(bboxmin[j], pts2[i][j]));
+            bboxmax[j] = std::min(clampmax[j], std::max(bboxmax[j], pts2[i][j]));
         }
 
+    // barycentric coordinates are affine in screen space, so the per pixel steps are constant
+    mat3 toBarycentric = barycentricTransform(pts2);
+    vec3 bc_dx = toBarycentric.GetColumn(0);
+    vec3 bc_dy = toBarycentric.GetColumn(1);
+    vec3 w_inv(pts[0][3], pts[1][3], pts[2][3]);
+    vec3 depths(pts[0][2], pts[1][2], pts[2][2]);
+
 #pragma omp parallel for
     for (int x=(int)bboxmin.x; x<=(int)bboxmax.x; x++) {
         for (int y=(int)bboxmin.y; y<=(int)bboxmax.y; y++) {
-            vec3 bc_screen  = barycentric(pts2, vec2(x, y));
-            vec3 bc_clip    = vec3(bc_screen.x*pts[0][3], bc_screen.y*pts[1][3], bc_screen.z*pts[2][3]);
-            bc_clip = bc_clip/(bc_clip.x+bc_clip.y+bc_clip.z); // check https://github.com/ssloy/tinyrenderer/wiki/Technical-difficulties-linear-interpolation-with-perspective-deformations
-            float frag_depth = vec3(pts[0][2], pts[1][2], pts[2][2]).dotProduct(bc_clip);
+            vec3 bc_screen  = toBarycentric * vec3(x, y, 1);
             if (bc_screen.x<0 || bc_screen.y<0 || bc_screen.z<0) continue;
 
-            if (frag_depth < 0.0)
-                continue;
+            vec3 bc_clip    = perspectiveCorrect(bc_screen, w_inv);
+            float frag_depth = depths.dotProduct(bc_screen); // z/w is affine in screen space
 
-            if(depthCheck && frag_depth > *zbuffer.getData<float>(x, y))
-                continue;
+            // derivatives for texture LOD selection, like a GPU does on a 2x2 quad
+            vec3 dFdx = perspectiveCorrect(bc_screen + bc_dx, w_inv) - bc_clip;
+            vec3 dFdy = perspectiveCorrect(bc_screen + bc_dy, w_inv) - bc_clip;
 
-            ColourValue fragColour;
-            bool discard = shader.fragment(bc_clip, fragColour);
-            if (discard) continue;
-            auto& dst = *image.getData<vec3b>(x, y);
-            if(blendAdd)
-                fragColour += ColourValue(vec4b(dst[0], dst[1], dst[2], 0).ptr());
-            fragColour.saturate();
-            fragColour *= 255;
-
-            dst = vec3b(fragColour.ptr());
-            if (depthWrite)
-                *zbuffer.getData<float>(x, y) = frag_depth;
+            fragment(state, shader, image, zbuffer, x, y, frag_depth, bc_clip, dFdx, dFdy);
         }
     }
 }
-}
\ No newline at end of file
+
+/// line between the first two clip_verts, the shader sees them as barycentric (1, 0, 0) and (0, 1, 0)
+static void line(const mat4& Viewport, const vec4 clip_verts[2], IShader& shader, Image& image,
+                 Image& zbuffer, const RasterState& state)
+{
+    // clip against the near plane (z > -w), so the perspective division stays valid
+    float d0 = clip_verts[0][2] + clip_verts[0][3];
+    float d1 = clip_verts[1][2] + clip_verts[1][3];
+    if (d0 < 0 && d1 < 0)
+        return;
+
+    float t0 = 0, t1 = 1;
+    if (d0 < 0)
+        t0 = d0 / (d0 - d1);
+    else if (d1 < 0)
+        t1 = d0 / (d0 - d1);
+
+    vec4 a = toScreen(Viewport, clip_verts[0] + (clip_verts[1] - clip_verts[0]) * t0);
+    vec4 b = toScreen(Viewport, clip_verts[0] + (clip_verts[1] - clip_verts[0]) * t1);
+
+    // at most one pixel apart, so the line has no gaps
+    int steps = std::ceil(std::max(std::abs(b.x - a.x), std::abs(b.y - a.y)));
+    int prev_x = INT_MIN, prev_y = INT_MIN;
+    vec3 zero(0, 0, 0);
+    for (int i = 0; i <= steps; i++) {
+        float s = steps ? float(i) / steps : 0;
+        int x = std::floor(a.x + (b.x - a.x) * s);
+        int y = std::floor(a.y + (b.y - a.y) * s);
+        // each pixel once, blending would apply twice otherwise
+        if (x == prev_x && y == prev_y)
+            continue;
+        prev_x = x;
+        prev_y = y;
+        if (!inside(state.clip, x, y))
+            continue;
+
+        // depth is affine in screen space, the attributes need perspective correction
+        float frag_depth = a.z + (b.z - a.z) * s;
+        float t = s * b.w / ((1 - s) * a.w + s * b.w);
+        t = t0 + (t1 - t0) * t;
+        fragment(state, shader, image, zbuffer, x, y, frag_depth, vec3(1 - t, t, 0), zero, zero);
+    }
+}
+
+static void point(const mat4& Viewport, const vec4& clip_vert, IShader& shader, Image& image,
+                  Image& zbuffer, const RasterState& state)
+{
+    if (clip_vert[2] + clip_vert[3] < 0)
+        return;
+
+    vec4 pt = toScreen(Viewport, clip_vert);
+    int x = std::floor(pt.x);
+    int y = std::floor(pt.y);
+    if (!inside(state.clip, x, y))
+        return;
+
+    vec3 zero(0, 0, 0);
+    fragment(state, shader, image, zbuffer, x, y, pt.z, vec3(1, 0, 0), zero, zero);
+}
+}
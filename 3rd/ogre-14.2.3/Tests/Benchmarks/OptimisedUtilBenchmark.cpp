@@ -0,0 +1,72 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+// Measures the throughput of every OptimisedUtil implementation available on this CPU.
+// Usage: Benchmark_OptimisedUtil [seconds per kernel]
+
+#include "OgreOptimisedUtil.h"
+#include "OgreStringConverter.h"
+
+#include <cstdio>
+
+using namespace Ogre;
+
+int main(int argc, char** argv)
+{
+    double minSeconds = argc > 1 ? StringConverter::parseReal(argv[1], 0.05f) : 0.05;
+
+    const char* kernels[OptimisedUtil::BK_COUNT] = {"skinning", "morph", "concatenate",
+                                                    "face normals", "light facing", "extrude"};
+    const size_t sizes[] = {1000, 10000, 100000, 1000000};
+
+    printf("millions of elements per second\n");
+    printf("%-10s %-10s", "impl", "vertices");
+    for (const char* k : kernels)
+        printf(" %12s", k);
+    printf("\n");
+
+    for (const auto& impl : OptimisedUtil::getAvailableImplementations())
+    {
+        for (size_t n : sizes)
+        {
+            std::vector<double> throughput = OptimisedUtil::benchmark(impl.second, n, minSeconds);
+            printf("%-10s %-10zu", impl.first.c_str(), n);
+            for (double t : throughput)
+                printf(" %12.1f", t / 1e6);
+            printf("\n");
+        }
+    }
+
+    OptimisedUtil* fastest = OptimisedUtil::_selectFastestImplementation();
+    for (const auto& impl : OptimisedUtil::getAvailableImplementations())
+    {
+        if (impl.second == fastest)
+            printf("selected: %s\n", impl.first.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+// Measures the scene graph update, recursive and through SceneManager::setTransformHierarchyEnabled.
+// Usage: Benchmark_TransformHierarchy [nodes] [frames]
+
+#include "Ogre.h"
+#include "OgreDefaultHardwareBufferManager.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+using namespace Ogre;
+
+int main(int argc, char** argv)
+{
+    size_t numNodes = argc > 1 ? StringConverter::parseSizeT(argv[1], 50000) : 50000;
+    int numFrames = argc > 2 ? StringConverter::parseInt(argv[2], 20) : 20;
+
+    // keep the log off the console
+    LogManager logMgr;
+    logMgr.createLog("", true, false, true);
+    Root root("", "", "");
+    DefaultHardwareBufferManager hbm;
+
+    printf("%zu nodes, median ms per update\n", numNodes);
+    printf("%-18s %10s %10s %10s\n", "update", "static", "move 10%", "move all");
+
+    // the same random graph for both updates: "wide" keeps parents among the first quarter of the
+    // nodes, "deep" picks any earlier node
+    const char* shapes[2] = {"wide", "deep"};
+    const char* names[2] = {"recursive", "hierarchy"};
+    Timer timer;
+    for (int shape = 0; shape < 2; shape++)
+    {
+        SceneManager* mgrs[2] = {root.createSceneManager(), root.createSceneManager()};
+        mgrs[1]->setTransformHierarchyEnabled(true);
+
+        std::minstd_rand rng;
+        auto random = [&rng](Real lo, Real hi) { return lo + (hi - lo) * Real(rng()) / rng.max(); };
+
+        std::vector<SceneNode*> nodes[2];
+        for (int m = 0; m < 2; m++)
+            nodes[m].push_back(mgrs[m]->getRootSceneNode());
+        for (size_t i = 0; i < numNodes; i++)
+        {
+            size_t size = nodes[0].size();
+            size_t parent = rng() % (shape == 0 ? std::min<size_t>(size, 1 + size / 4) : size);
+            Vector3 pos(random(-10, 10), random(-10, 10), random(-10, 10));
+            Quaternion rot(Radian(random(-3, 3)), Vector3(random(-1, 1), 1, random(-1, 1)).normalisedCopy());
+            for (int m = 0; m < 2; m++)
+                nodes[m].push_back(nodes[m][parent]->createChildSceneNode(pos, rot));
+        }
+
+        for (int m = 0; m < 2; m++)
+        {
+            mgrs[m]->_updateSceneGraph(NULL);
+
+            double ms[3];
+            for (int step = 0; step < 3; step++)
+            {
+                size_t stride = step == 0 ? 0 : step == 1 ? 10 : 1;
+                std::vector<uint64> times;
+                for (int f = 0; f < numFrames; f++)
+                {
+                    for (size_t i = 1; stride && i < nodes[m].size(); i += stride)
+                        nodes[m][i]->yaw(Degree(1));
+
+                    timer.reset();
+                    mgrs[m]->_updateSceneGraph(NULL);
+                    times.push_back(timer.getMicroseconds());
+                }
+                // the median, as other processes disturb single frames
+                std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+                ms[step] = times[times.size() / 2] / 1000.0;
+            }
+            printf("%-18s %10.2f %10.2f %10.2f\n", (String(shapes[shape]) + " " + names[m]).c_str(), ms[0],
+                   ms[1], ms[2]);
+        }
+
+        root.destroySceneManager(mgrs[0]);
+        root.destroySceneManager(mgrs[1]);
+    }
+    return 0;
+}
@@ -70,6 +70,27 @@ TEST_F(RTShaderSystem, createShaderBasedTechnique)
     EXPECT_TRUE(shaderGen.removeShaderBasedTechnique(mat->getTechniques()[0], "MyScheme"));
 }
 
+TEST_F(RTShaderSystem, precompileMaterials)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    shaderGen.createScheme("MyScheme");
+    shaderGen.getRenderState("MyScheme")->setLightCountAutoUpdate(false);
+
+    ResourceGroupManager::getSingleton().createResourceGroup("Other");
+    auto mat = MaterialManager::getSingleton().create("TestMat", RGN_DEFAULT);
+    auto other = MaterialManager::getSingleton().create("OtherMat", "Other");
+
+    EXPECT_EQ(shaderGen.precompileMaterials("MyScheme", RGN_DEFAULT), size_t(1));
+    ASSERT_EQ(mat->getTechniques().size(), size_t(2));
+    EXPECT_TRUE(mat->getTechniques()[1]->getPasses()[0]->hasGpuProgram(GPT_FRAGMENT_PROGRAM));
+    EXPECT_EQ(other->getTechniques().size(), size_t(1));
+
+    // already generated materials are validated again, the programs are reused
+    EXPECT_GE(shaderGen.precompileMaterials("MyScheme"), size_t(2));
+    EXPECT_EQ(mat->getTechniques().size(), size_t(2));
+    EXPECT_EQ(other->getTechniques().size(), size_t(2));
+}
+
 TEST_F(RTShaderSystem, MaterialSerializer)
 {
     auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
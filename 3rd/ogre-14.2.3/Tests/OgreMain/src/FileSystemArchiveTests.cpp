@@ -294,6 +294,28 @@ TEST_F(FileSystemArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,MappedRead)
+{
+    FileSystemArchiveFactory::setMapFiles(true);
+    DataStreamPtr stream = mArch->open("rootfile.txt");
+    DataStreamPtr stream2 = mArch->open("rootfile2.txt");
+    // writeable streams are never mapped
+    DataStreamPtr rwStream = mArch->open("rootfile.txt", false);
+    FileSystemArchiveFactory::setMapFiles(false);
+
+    EXPECT_TRUE(dynamic_cast<MemoryDataStream*>(stream.get()));
+    EXPECT_FALSE(dynamic_cast<MemoryDataStream*>(rwStream.get()));
+    EXPECT_EQ(stream->size(), mArch->open("rootfile.txt")->size());
+
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 1 in file 2"), stream2->getLine());
+    stream->skipLine();
+    stream->seek(0);
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    stream->close();
+    EXPECT_EQ(String("this is line 2 in file 2"), stream2->getLine());
+}
+//--------------------------------------------------------------------------
 TEST_F(FileSystemArchiveTests,CreateAndRemoveFile)
 {
     EXPECT_TRUE(!mArch->isReadOnly());
@@ -29,6 +29,9 @@ THE SOFTWARE.
 
 #include "OgreRoot.h"
 #include "OgreSceneNode.h"
+#include "OgreTransformHierarchy.h"
+#include "OgreVisibilityCuller.h"
+#include "OgreWorkQueue.h"
 #include "OgreEntity.h"
 #include "OgreCamera.h"
 #include "RootWithoutRenderSystemFixture.h"
@@ -38,19 +41,28 @@ THE SOFTWARE.
 #include "OgreTechnique.h"
 #include "OgrePass.h"
 #include "OgreMaterialManager.h"
+#include "OgreScriptCompiler.h"
 #include "OgreConfigFile.h"
 #include "OgreSTBICodec.h"
 #include "OgreHighLevelGpuProgramManager.h"
 #include "OgreMeshManager.h"
 #include "OgreMesh.h"
+#include "OgreSubMesh.h"
 #include "OgreSkeletonManager.h"
 #include "OgreSkeletonInstance.h"
+#include "OgreBone.h"
 #include "OgreCompositorManager.h"
 #include "OgreTextureManager.h"
 #include "OgreFileSystem.h"
 #include "OgreArchiveManager.h"
+#include "OgreMeshSerializer.h"
 
 #include "OgreHighLevelGpuProgram.h"
+#include "OgreAutoParamDataSource.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreFrameAllocator.h"
+#include "OgreMemoryReport.h"
+#include "OgreDefaultHardwareBufferManager.h"
 
 #include "OgreKeyFrame.h"
 
@@ -58,6 +70,10 @@ THE SOFTWARE.
 #include "OgreBillboard.h"
 
 #include <random>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 using std::minstd_rand;
 
 using namespace Ogre;
@@ -212,6 +228,564 @@ static void createRandomEntityClones(Entity* ent, size_t cloneCount, const Vecto
     }
 }
 
+TEST_F(SceneNodeTest, TransformHierarchy)
+{
+    // the same random graph in both, one updated recursively, one through the hierarchy
+    SceneManager* mgrs[2] = {mRoot->createSceneManager(), mSceneMgr};
+    mSceneMgr->setTransformHierarchyEnabled(true);
+
+    std::minstd_rand rng;
+    auto random = [&rng](Real lo, Real hi) { return lo + (hi - lo) * Real(rng()) / rng.max(); };
+
+    std::vector<SceneNode*> nodes[2];
+    for (int m = 0; m < 2; m++)
+        nodes[m].push_back(mgrs[m]->getRootSceneNode());
+
+    for (int i = 0; i < 300; i++)
+    {
+        size_t parent = rng() % nodes[0].size();
+        Vector3 pos(random(-10, 10), random(-10, 10), random(-10, 10));
+        Quaternion rot(Radian(random(-3, 3)), Vector3(random(-1, 1), 1, random(-1, 1)).normalisedCopy());
+        Vector3 scale(random(0.5, 2), random(0.5, 2), random(0.5, 2));
+        bool inheritOrientation = rng() % 4, inheritScale = rng() % 4;
+        bool hasEntity = i % 10 == 0;
+        for (int m = 0; m < 2; m++)
+        {
+            SceneNode* node = nodes[m][parent]->createChildSceneNode(pos, rot);
+            node->setScale(scale);
+            node->setInheritOrientation(inheritOrientation);
+            node->setInheritScale(inheritScale);
+            if (hasEntity)
+                node->attachObject(mgrs[m]->createEntity("sphere.mesh"));
+            nodes[m].push_back(node);
+        }
+    }
+
+    auto expectSame = [&]() {
+        for (auto m : mgrs)
+            m->_updateSceneGraph(NULL);
+
+        for (size_t i = 0; i < nodes[0].size(); i++)
+        {
+            EXPECT_TRUE(nodes[0][i]->_getDerivedPosition().positionEquals(nodes[1][i]->_getDerivedPosition(), 1e-3));
+            EXPECT_TRUE(nodes[0][i]->_getDerivedOrientation().equals(nodes[1][i]->_getDerivedOrientation(), Degree(0.5)));
+            EXPECT_TRUE(nodes[0][i]->_getDerivedScale().positionEquals(nodes[1][i]->_getDerivedScale(), 1e-4));
+            const AxisAlignedBox& a = nodes[0][i]->_getWorldAABB();
+            const AxisAlignedBox& b = nodes[1][i]->_getWorldAABB();
+            ASSERT_EQ(a.isNull(), b.isNull());
+            if (!a.isNull())
+            {
+                EXPECT_TRUE(a.getMinimum().positionEquals(b.getMinimum(), 1e-2));
+                EXPECT_TRUE(a.getMaximum().positionEquals(b.getMaximum(), 1e-2));
+            }
+        }
+    };
+
+    expectSame();
+    EXPECT_EQ(mSceneMgr->_getTransformHierarchy()->getNumNodes(), nodes[1].size());
+
+    // static frames recompute nothing
+    mSceneMgr->_updateSceneGraph(NULL);
+    EXPECT_EQ(mSceneMgr->_getTransformHierarchy()->getNumUpdatedNodes(), 0u);
+
+    // move some nodes
+    for (int i = 0; i < 20; i++)
+    {
+        size_t n = 1 + rng() % (nodes[0].size() - 1);
+        Vector3 d(random(-5, 5), random(-5, 5), random(-5, 5));
+        for (int m = 0; m < 2; m++)
+        {
+            nodes[m][n]->translate(d);
+            nodes[m][n]->yaw(Degree(10));
+        }
+    }
+    expectSame();
+
+    // reparent, parents have lower indices than their descendants, so this keeps the graph a tree
+    for (int i = 0; i < 10; i++)
+    {
+        size_t n = 2 + rng() % (nodes[0].size() - 2);
+        size_t parent = rng() % n;
+        for (int m = 0; m < 2; m++)
+        {
+            // the recursive update does not shrink the bounds of the old parent by itself
+            Node* oldParent = nodes[m][n]->getParent();
+            oldParent->removeChild(nodes[m][n]);
+            oldParent->needUpdate();
+            nodes[m][parent]->addChild(nodes[m][n]);
+        }
+    }
+    expectSame();
+
+    // destroy the last node, which has no children
+    for (int m = 0; m < 2; m++)
+    {
+        mgrs[m]->destroySceneNode(nodes[m].back());
+        nodes[m].pop_back();
+    }
+    expectSame();
+
+    // switching back to the recursive update keeps the pending changes
+    for (int m = 0; m < 2; m++)
+        nodes[m][1]->setPosition(1, 2, 3);
+    mSceneMgr->setTransformHierarchyEnabled(false);
+    expectSame();
+}
+
+TEST_F(SceneNodeTest, ParallelCulling)
+{
+    struct Recorder : public RenderQueue::RenderableListener
+    {
+        std::vector<Renderable*> queued;
+        bool renderableQueued(Renderable* rend, uint8, ushort, Technique**, RenderQueue*) override
+        {
+            queued.push_back(rend);
+            return true;
+        }
+    } recorder;
+    mSceneMgr->getRenderQueue()->setRenderableListener(&recorder);
+    mRoot->getWorkQueue()->startup();
+
+    Camera* cam = mSceneMgr->createCamera("Camera");
+    SceneNode* camNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    camNode->attachObject(cam);
+    camNode->setPosition(0, 0, 300);
+    cam->setFarClipDistance(600);
+
+    // enough nodes to be split across several tasks
+    std::minstd_rand rng;
+    auto random = [&rng](Real lo, Real hi) { return lo + (hi - lo) * Real(rng()) / rng.max(); };
+    std::vector<SceneNode*> nodes(1, mSceneMgr->getRootSceneNode());
+    for (int i = 0; i < 12000; i++)
+    {
+        SceneNode* parent = nodes[rng() % nodes.size()];
+        SceneNode* node = parent->createChildSceneNode(Vector3(random(-80, 80), random(-80, 80), random(-80, 80)));
+        if (i % 6 == 0)
+        {
+            Entity* ent = mSceneMgr->createEntity("sphere.mesh");
+            ent->setCastShadows(i % 12 == 0);
+            node->attachObject(ent);
+        }
+        nodes.push_back(node);
+    }
+
+    auto findVisible = [&](bool onlyShadowCasters, AxisAlignedBox& box) {
+        mSceneMgr->_updateSceneGraph(cam);
+        mSceneMgr->getRenderQueue()->clear();
+        recorder.queued.clear();
+        VisibleObjectsBoundsInfo bounds;
+        mSceneMgr->_findVisibleObjects(cam, &bounds, onlyShadowCasters);
+        box = bounds.aabb;
+        return recorder.queued;
+    };
+
+    auto expectSame = [&]() {
+        for (bool onlyShadowCasters : {false, true})
+        {
+            AxisAlignedBox a, b;
+            mSceneMgr->setParallelCullingEnabled(false);
+            auto expected = findVisible(onlyShadowCasters, a);
+            EXPECT_FALSE(expected.empty());
+            mSceneMgr->setParallelCullingEnabled(true);
+            EXPECT_EQ(findVisible(onlyShadowCasters, b), expected);
+            EXPECT_EQ(a, b);
+
+            // reuses the gathered bounds with the hierarchy
+            mSceneMgr->setTransformHierarchyEnabled(true);
+            findVisible(onlyShadowCasters, b);
+            EXPECT_EQ(findVisible(onlyShadowCasters, b), expected);
+            EXPECT_EQ(a, b);
+            mSceneMgr->setTransformHierarchyEnabled(false);
+        }
+    };
+
+    expectSame();
+    const VisibilityCuller* culler = mSceneMgr->_getVisibilityCuller();
+    EXPECT_GT(culler->getNumVisibleNodes(), 0u);
+    EXPECT_LT(culler->getNumVisibleNodes(), culler->getNumNodes());
+
+    // a different view, with an infinite far plane
+    camNode->setPosition(100, 20, -50);
+    camNode->lookAt(Vector3(-50, 0, 0), Node::TS_WORLD);
+    cam->setFarClipDistance(0);
+    expectSame();
+
+    // destroyed nodes are dropped, the last ones have no children
+    for (int i = 0; i < 100; i++)
+    {
+        mSceneMgr->destroySceneNode(nodes.back());
+        nodes.pop_back();
+    }
+    expectSame();
+}
+
+TEST_F(SceneNodeTest, ParallelQueueing)
+{
+    struct Recorder : public RenderQueue::RenderableListener
+    {
+        std::vector<std::pair<Renderable*, uint8>> queued;
+        bool renderableQueued(Renderable* rend, uint8 groupID, ushort, Technique**, RenderQueue*) override
+        {
+            queued.push_back({rend, groupID});
+            return true;
+        }
+    } recorder;
+    mSceneMgr->getRenderQueue()->setRenderableListener(&recorder);
+    mSceneMgr->getRenderQueue()->getQueueGroup(RENDER_QUEUE_2)->setShadowsEnabled(false);
+    mRoot->getWorkQueue()->startup();
+
+    Camera* cam = mSceneMgr->createCamera("Camera");
+    SceneNode* camNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    camNode->attachObject(cam);
+    camNode->setPosition(0, 0, 300);
+    cam->setFarClipDistance(600);
+
+    // entities are updated on worker threads, billboard sets on the calling thread in their place
+    std::minstd_rand rng;
+    auto random = [&rng](Real lo, Real hi) { return lo + (hi - lo) * Real(rng()) / rng.max(); };
+    for (int i = 0; i < 6000; i++)
+    {
+        SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+            Vector3(random(-80, 80), random(-80, 80), random(-80, 80)));
+        if (i % 10 == 0)
+        {
+            BillboardSet* bbs = mSceneMgr->createBillboardSet();
+            bbs->createBillboard(Vector3::ZERO);
+            node->attachObject(bbs);
+            continue;
+        }
+
+        Entity* ent = mSceneMgr->createEntity("sphere.mesh");
+        ent->setCastShadows(i % 3 == 0);
+        if (i % 7 == 0)
+            ent->setRenderQueueGroup(RENDER_QUEUE_2);
+        node->attachObject(ent);
+        if (i % 5 == 0)
+            node->attachObject(mSceneMgr->createEntity("sphere.mesh"));
+    }
+
+    auto findVisible = [&](bool onlyShadowCasters, VisibleObjectsBoundsInfo& bounds) {
+        mSceneMgr->_updateSceneGraph(cam);
+        mSceneMgr->getRenderQueue()->clear();
+        recorder.queued.clear();
+        bounds.reset();
+        mSceneMgr->_findVisibleObjects(cam, &bounds, onlyShadowCasters);
+        return recorder.queued;
+    };
+
+    mSceneMgr->setParallelCullingEnabled(true);
+    for (bool onlyShadowCasters : {false, true})
+    {
+        VisibleObjectsBoundsInfo a, b;
+        mSceneMgr->setParallelQueueingEnabled(false);
+        auto expected = findVisible(onlyShadowCasters, a);
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(mSceneMgr->_getVisibilityCuller()->getNumConcurrentObjects(), 0u);
+
+        mSceneMgr->setParallelQueueingEnabled(true);
+        EXPECT_EQ(findVisible(onlyShadowCasters, b), expected);
+        EXPECT_GT(mSceneMgr->_getVisibilityCuller()->getNumConcurrentObjects(), 1000u);
+        EXPECT_EQ(a.aabb, b.aabb);
+        EXPECT_EQ(a.receiverAabb, b.receiverAabb);
+        EXPECT_EQ(a.minDistance, b.minDistance);
+        EXPECT_EQ(a.maxDistance, b.maxDistance);
+        EXPECT_EQ(a.minDistanceInFrustum, b.minDistanceInFrustum);
+        EXPECT_EQ(a.maxDistanceInFrustum, b.maxDistanceInFrustum);
+    }
+}
+
+TEST_F(SceneNodeTest, PopulateLightList)
+{
+    struct LightTestSceneManager : public SceneManager
+    {
+        LightTestSceneManager() : SceneManager("LightTest") {}
+        const String& getTypeName() const override { static String name = "LightTest"; return name; }
+        using SceneManager::findLightsAffectingFrustum;
+    } sm;
+
+    Camera* cam = sm.createCamera("Camera");
+    sm.getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 400))->attachObject(cam);
+    cam->setFOVy(Degree(90));
+
+    // many small lights, a few that cover everything
+    std::minstd_rand rng;
+    auto random = [&rng](Real lo, Real hi) { return lo + (hi - lo) * Real(rng()) / rng.max(); };
+    for (int i = 0; i < 300; i++)
+    {
+        Light* l = sm.createLight(i % 100 == 0 ? Light::LT_DIRECTIONAL : Light::LT_POINT);
+        if (i % 77 == 0)
+            l->setType(Light::LT_SPOTLIGHT);
+        l->setCastShadows(i % 50 == 1);
+        l->setLightMask(i % 3 ? 1 : 2);
+        if (i % 60 != 2)
+            l->setAttenuation(random(1, 15), 1, 0, 0);
+        SceneNode* node = sm.getRootSceneNode()->createChildSceneNode(
+            Vector3(random(-100, 100), random(-100, 100), random(-100, 100)));
+        node->setDirection(Vector3(random(-1, 1), random(-1, 1), -1));
+        node->attachObject(l);
+    }
+
+    sm.findLightsAffectingFrustum(cam);
+    const LightList& inFrustum = sm._getLightsAffectingFrustum();
+    ASSERT_GT(inFrustum.size(), 100u);
+
+    auto check = [&]() {
+        for (int i = 0; i < 1000; i++)
+        {
+            Vector3 pos(random(-120, 120), random(-120, 120), random(-120, 120));
+            Real radius = i % 50 == 0 ? 1000 : random(0, 20);
+            uint32 mask = i % 2 ? 0xFFFFFFFF : 1;
+
+            LightList lights;
+            sm._populateLightList(pos, radius, lights, mask);
+
+            // what the linear scan finds, the first as many as there are shadow casters stay unsorted
+            LightList expected;
+            size_t numShadowCasters = 0;
+            for (Light* l : inFrustum)
+            {
+                if (!(l->getLightMask() & mask))
+                    continue;
+                if (l->isInLightRange(Sphere(pos, radius)))
+                    expected.push_back(l);
+                numShadowCasters += l->getCastShadows();
+            }
+            auto dist = [&pos](const Light* l) {
+                return l->getType() == Light::LT_DIRECTIONAL ? -1 : pos.squaredDistance(l->getDerivedPosition());
+            };
+            std::stable_sort(expected.begin() + std::min(numShadowCasters, expected.size()), expected.end(),
+                             [&dist](const Light* a, const Light* b) { return dist(a) < dist(b); });
+
+            ASSERT_EQ(lights, expected);
+        }
+    };
+    check();
+
+    // casting shadows changes the unsorted part of the list
+    for (size_t i = 0; i < inFrustum.size(); i += 7)
+        inFrustum[i]->setCastShadows(!inFrustum[i]->getCastShadows());
+    sm.findLightsAffectingFrustum(cam);
+    check();
+}
+
+TEST_F(SceneNodeTest, RetainedRenderQueue)
+{
+    struct Collector : public QueuedRenderableVisitor
+    {
+        std::vector<RenderablePass> items;
+        void visit(RenderablePass* rp) override { items.push_back(*rp); }
+        void visit(const Pass* p, RenderableList& rs) override {}
+    } collector;
+
+    Camera* cam = mSceneMgr->createCamera("Camera");
+    SceneNode* camNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    camNode->attachObject(cam);
+    camNode->setPosition(0, 0, 600); // sees all nodes, even moved ones
+
+    MaterialPtr mat = MaterialManager::getSingleton().create("Retained", RGN_DEFAULT);
+    mat->setSceneBlending(SBT_TRANSPARENT_ALPHA);
+    mat->setDepthWriteEnabled(false);
+
+    // enough transparents for the radix sort
+    std::minstd_rand rng;
+    auto random = [&rng](Real lo, Real hi) { return lo + (hi - lo) * Real(rng()) / rng.max(); };
+    std::vector<SceneNode*> nodes;
+    auto addNodes = [&](int count) {
+        for (int i = 0; i < count; i++)
+        {
+            Entity* ent = mSceneMgr->createEntity("sphere.mesh");
+            ent->setMaterial(mat);
+            nodes.push_back(mSceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3(random(-80, 80), random(-80, 80), random(-80, 80))));
+            nodes.back()->attachObject(ent);
+        }
+    };
+    addNodes(3000);
+
+    auto render = [&]() {
+        mSceneMgr->_updateSceneGraph(cam);
+        RenderQueue* queue = mSceneMgr->getRenderQueue();
+        queue->clear();
+        mSceneMgr->_findVisibleObjects(cam, NULL, false);
+        collector.items.clear();
+        for (const auto& g : queue->_getQueueGroups())
+        {
+            if (!g)
+                continue;
+            for (const auto& pg : g->getPriorityGroups())
+            {
+                pg.second->sort(cam);
+                pg.second->getTransparents().acceptVisitor(&collector, QueuedRenderableCollection::OM_SORT_DESCENDING);
+            }
+        }
+        return collector.items;
+    };
+
+    auto byPointer = [](std::vector<RenderablePass> items) {
+        std::sort(items.begin(), items.end(), [](const RenderablePass& a, const RenderablePass& b) {
+            return std::make_pair(a.renderable, a.pass) < std::make_pair(b.renderable, b.pass);
+        });
+        return items;
+    };
+    auto expectSame = [&](const std::vector<RenderablePass>& items, const std::vector<RenderablePass>& expected) {
+        ASSERT_EQ(items.size(), expected.size());
+        auto a = byPointer(items), b = byPointer(expected);
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            ASSERT_EQ(a[i].renderable, b[i].renderable);
+            ASSERT_EQ(a[i].pass, b[i].pass);
+        }
+        // far to near, like the radix sort
+        for (size_t i = 1; i < items.size(); i++)
+        {
+            ASSERT_LE(float(-items[i - 1].renderable->getSquaredViewDepth(cam)),
+                      float(-items[i].renderable->getSquaredViewDepth(cam)));
+        }
+    };
+    auto renderBoth = [&]() {
+        mSceneMgr->setRetainedRenderQueueEnabled(false);
+        auto expected = render();
+        EXPECT_FALSE(expected.empty());
+        mSceneMgr->setRetainedRenderQueueEnabled(true);
+        auto items = render();
+        expectSame(items, expected);
+    };
+
+    renderBoth();
+    RenderQueue::RetainedSortStats stats = mSceneMgr->getRenderQueue()->getRetainedSortStats();
+    EXPECT_EQ(stats.fullSorts, 1u);
+    EXPECT_EQ(stats.fullSortItems, 3000u);
+
+    // nothing changed, the whole order is reused
+    expectSame(render(), render());
+    RenderQueue::RetainedSortStats prev = stats;
+    stats = mSceneMgr->getRenderQueue()->getRetainedSortStats();
+    EXPECT_EQ(stats.fullSorts, prev.fullSorts);
+    EXPECT_EQ(stats.deltaSorts, prev.deltaSorts + 2);
+    EXPECT_EQ(stats.reused, prev.reused + 6000);
+
+    // a few move, some disappear and some are added
+    for (int i = 0; i < 20; i++)
+        nodes[rng() % nodes.size()]->translate(random(-50, 50), random(-50, 50), random(-50, 50));
+    for (int i = 0; i < 30; i++)
+    {
+        size_t n = rng() % nodes.size();
+        mSceneMgr->destroySceneNode(nodes[n]);
+        nodes.erase(nodes.begin() + n);
+    }
+    addNodes(40);
+
+    prev = stats;
+    auto items = render();
+    stats = mSceneMgr->getRenderQueue()->getRetainedSortStats();
+    mSceneMgr->setRetainedRenderQueueEnabled(false);
+    expectSame(items, render());
+    EXPECT_EQ(stats.fullSorts, prev.fullSorts);
+    EXPECT_EQ(stats.deltaSorts, prev.deltaSorts + 1);
+    // a removed child is replaced by the last one, which counts as one more removal and insertion
+    EXPECT_GE(stats.removed - prev.removed, 30u);
+    EXPECT_EQ((stats.inserted - prev.inserted) - (stats.removed - prev.removed), 10u);
+    EXPECT_LE(stats.moved - prev.moved, 20u);
+    EXPECT_GT(stats.reused - prev.reused, 2800u);
+    EXPECT_EQ(stats.reused - prev.reused + stats.moved - prev.moved + stats.inserted - prev.inserted, items.size());
+
+    // a different view sorts everything again
+    mSceneMgr->setRetainedRenderQueueEnabled(true);
+    render();
+    camNode->setPosition(100, 20, -50);
+    camNode->lookAt(Vector3(-50, 0, 0), Node::TS_WORLD);
+    prev = mSceneMgr->getRenderQueue()->getRetainedSortStats();
+    items = render();
+    stats = mSceneMgr->getRenderQueue()->getRetainedSortStats();
+    EXPECT_EQ(stats.fullSorts, prev.fullSorts + 1);
+    mSceneMgr->setRetainedRenderQueueEnabled(false);
+    expectSame(items, render());
+}
+
+TEST_F(SceneNodeTest, ShadowVolumeCache)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("sphere.mesh", RGN_DEFAULT);
+    mesh->buildEdgeList();
+
+    auto indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 65536, HBU_CPU_ONLY);
+
+    // the indexes of the volume and their split between renderables and light caps
+    auto volume = [&](Entity* ent, Light* light, int flags) {
+        size_t used = 0;
+        std::vector<size_t> out;
+        for (auto sr : ent->getShadowVolumeRenderableList(light, indexBuffer, used, 1000, flags))
+        {
+            for (auto r : {sr, sr->getLightCapRenderable()})
+            {
+                // the light cap keeps its previous range without SRF_INCLUDE_LIGHT_CAP
+                if (!r || (r != sr && !(flags & SRF_INCLUDE_LIGHT_CAP)))
+                    continue;
+                IndexData* id = r->getRenderOperationForUpdate()->indexData;
+                std::vector<uint16> idx(id->indexCount);
+                indexBuffer->readData(id->indexStart * 2, idx.size() * 2, idx.data());
+                out.push_back(id->indexCount);
+                out.insert(out.end(), idx.begin(), idx.end());
+            }
+        }
+        return out;
+    };
+
+    Entity* cached = mSceneMgr->createEntity(mesh);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(cached);
+    Light* point = mSceneMgr->createLight(Light::LT_POINT);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 300, 200))->attachObject(point);
+    Light* dir = mSceneMgr->createLight(Light::LT_DIRECTIONAL);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(dir);
+    dir->getParentSceneNode()->setDirection(Vector3(1, -1, 0), Node::TS_WORLD);
+    mSceneMgr->getRootSceneNode()->_update(true, false);
+
+    int flags = SRF_INCLUDE_LIGHT_CAP | SRF_INCLUDE_DARK_CAP;
+    for (int i = 0; i < 3; i++)
+    {
+        // a new entity builds its volume from scratch
+        Entity* fresh = mSceneMgr->createEntity(mesh);
+        cached->getParentSceneNode()->attachObject(fresh);
+
+        for (Light* l : {point, dir})
+        {
+            auto expected = volume(fresh, l, flags);
+            ASSERT_FALSE(expected.empty());
+            EXPECT_EQ(volume(cached, l, flags), expected);
+            EXPECT_EQ(volume(cached, l, flags), expected);
+        }
+        EXPECT_NE(volume(cached, point, flags), volume(cached, dir, flags));
+        // the flags are part of the cached state
+        EXPECT_EQ(volume(cached, point, SRF_INCLUDE_DARK_CAP), volume(fresh, point, SRF_INCLUDE_DARK_CAP));
+
+        mSceneMgr->destroyEntity(fresh);
+        point->getParentSceneNode()->translate(Vector3(150, -100, 0));
+        mSceneMgr->getRootSceneNode()->_update(true, false);
+    }
+
+    // entities sharing the edge list build their volumes concurrently, leaving only the copy
+    Entity* fresh = mSceneMgr->createEntity(mesh);
+    cached->getParentSceneNode()->attachObject(fresh);
+    auto expected = volume(fresh, point, flags);
+
+    std::vector<Entity*> ents;
+    std::vector<ShadowCaster::ShadowVolume*> builds;
+    for (int i = 0; i < 2; i++)
+    {
+        ents.push_back(mSceneMgr->createEntity(mesh));
+        cached->getParentSceneNode()->attachObject(ents.back());
+        builds.push_back(ents.back()->_getShadowVolumeToBuild(point, flags));
+        ASSERT_TRUE(builds.back());
+    }
+    mRoot->getWorkQueue()->runTasks(builds.size(), [&builds](size_t i) { ShadowCaster::_buildShadowVolume(*builds[i]); });
+
+    for (auto e : ents)
+    {
+        EXPECT_FALSE(e->_getShadowVolumeToBuild(point, flags));
+        EXPECT_EQ(volume(e, point, flags), expected);
+    }
+}
+
 struct SceneQueryTest : public RootWithoutRenderSystemFixture {
     SceneManager* mSceneMgr;
     Camera* mCamera;
@@ -358,6 +932,149 @@ TEST(Image, Resize)
     ASSERT_TRUE(!memcmp(img.getData(), ref.getData(), ref.getSize()));
 }
 
+TEST(Image, BoxDownsample)
+{
+    // odd widths exercise the scalar tail after the SIMD kernel
+    for (uint32 width : {2, 34, 70})
+    {
+        Image src(PF_BYTE_RGBA, width, 6);
+        for (size_t i = 0; i < src.getSize(); i++)
+            src.getData()[i] = uchar(i * 37 + i / 5);
+
+        Image box(PF_BYTE_RGBA, width / 2, 3);
+        Image::scale(src.getPixelBox(), box.getPixelBox(), Image::FILTER_BILINEAR);
+
+        const uchar* s = src.getData();
+        size_t pitch = width * 4;
+        for (size_t y = 0; y < 3; y++)
+        {
+            for (size_t x = 0; x < width * 2; x++)
+            {
+                size_t i = 2 * y * pitch + (x / 4) * 8 + x % 4;
+                int avg = (s[i] + s[i + 4] + s[i + pitch] + s[i + pitch + 4] + 2) / 4;
+                ASSERT_EQ(box.getData()[y * width * 2 + x], avg) << width << " " << x << " " << y;
+            }
+        }
+    }
+}
+
+TEST(Image, Bicubic)
+{
+    Image src(PF_BYTE_RGBA, 37, 21);
+    for (size_t i = 0; i < src.getSize(); i += 4)
+        *(uint32*)(src.getData() + i) = 0x80402010;
+
+    // a constant image stays constant, whether the filter magnifies or minifies
+    for (auto size : {std::make_pair(80, 50), std::make_pair(9, 5)})
+    {
+        Image dst(PF_BYTE_RGBA, size.first, size.second);
+        Image::scale(src.getPixelBox(), dst.getPixelBox(), Image::FILTER_BICUBIC);
+        for (size_t i = 0; i < dst.getSize(); i += 4)
+            ASSERT_EQ(*(uint32*)(dst.getData() + i), 0x80402010);
+    }
+
+    // formats without a direct kernel go through float
+    Image src565(PF_R5G6B5, 8, 8);
+    PixelUtil::bulkPixelConversion(src.getPixelBox().getSubVolume(Box(0, 0, 8, 8)), src565.getPixelBox());
+    Image dst565(PF_R5G6B5, 4, 4);
+    Image::scale(src565.getPixelBox(), dst565.getPixelBox(), Image::FILTER_BICUBIC);
+    EXPECT_EQ(src565.getColourAt(0, 0, 0), dst565.getColourAt(3, 3, 0));
+}
+
+TEST(Image, GenerateMipmaps)
+{
+    Image img(PF_FLOAT32_RGBA, 16, 4);
+    for (uint32 y = 0; y < 4; y++)
+        for (uint32 x = 0; x < 16; x++)
+            img.setColourAt(ColourValue(x, y, 1, 0.5), x, y, 0);
+
+    img.generateMipmaps();
+    ASSERT_EQ(img.getNumMipmaps(), 4u);
+    // the top level is kept
+    EXPECT_EQ(img.getColourAt(15, 3, 0), ColourValue(15, 3, 1, 0.5));
+
+    // box filtered halvings
+    PixelBox mip1 = img.getPixelBox(0, 1);
+    EXPECT_EQ(mip1.getWidth(), 8u);
+    EXPECT_EQ(mip1.getColourAt(0, 0, 0), ColourValue(0.5, 0.5, 1, 0.5));
+    EXPECT_EQ(mip1.getColourAt(7, 1, 0), ColourValue(14.5, 2.5, 1, 0.5));
+
+    PixelBox mip4 = img.getPixelBox(0, 4);
+    EXPECT_EQ(mip4.getWidth(), 1u);
+    EXPECT_EQ(mip4.getHeight(), 1u);
+    // the last levels are no exact halvings, so they are linearly filtered
+    ColourValue c = mip4.getColourAt(0, 0, 0);
+    EXPECT_NEAR(c.r, 7.5, 1e-3);
+    EXPECT_NEAR(c.g, 1.5, 1e-3);
+    EXPECT_EQ(c.b, 1);
+    EXPECT_EQ(c.a, 0.5);
+}
+
+// expand a 4 colour BC1 block to RGB8
+static void decodeBC1(const uchar* block, uchar* rgb)
+{
+    uint16 c[2] = {uint16(block[0] | block[1] << 8), uint16(block[2] | block[3] << 8)};
+    int pal[4][3];
+    for (int i = 0; i < 2; i++)
+    {
+        pal[i][0] = ((c[i] >> 11) & 31) * 255 / 31;
+        pal[i][1] = ((c[i] >> 5) & 63) * 255 / 63;
+        pal[i][2] = (c[i] & 31) * 255 / 31;
+    }
+    for (int k = 0; k < 3; k++)
+    {
+        pal[2][k] = (2 * pal[0][k] + pal[1][k]) / 3;
+        pal[3][k] = (pal[0][k] + 2 * pal[1][k]) / 3;
+    }
+    uint32 indices = block[4] | block[5] << 8 | block[6] << 16 | uint32(block[7]) << 24;
+    for (int i = 0; i < 16; i++)
+        for (int k = 0; k < 3; k++)
+            rgb[3 * i + k] = uchar(pal[(indices >> (2 * i)) & 3][k]);
+}
+
+TEST(Image, Compress)
+{
+    // partial blocks at the edges
+    Image solid(PF_BYTE_RGB, 6, 5);
+    solid.setTo(ColourValue::Red);
+    solid.compress(PF_DXT1);
+    ASSERT_EQ(solid.getFormat(), PF_DXT1);
+    ASSERT_EQ(solid.getSize(), 4 * 8u);
+    for (size_t b = 0; b < 4; b++)
+    {
+        const uchar expected[] = {0x00, 0xF8, 0x00, 0xF8, 0, 0, 0, 0};
+        EXPECT_TRUE(!memcmp(solid.getData() + 8 * b, expected, 8)) << b;
+    }
+
+    // a gradient along one axis is reproduced closely
+    Image gradient(PF_BYTE_RGBA, 4, 4);
+    for (uint32 y = 0; y < 4; y++)
+        for (uint32 x = 0; x < 4; x++)
+            gradient.setColourAt(ColourValue(x / 3.0f, 0.5f, 1 - x / 3.0f, y / 3.0f), x, y, 0);
+    Image ref = gradient;
+
+    gradient.compress(PF_DXT5);
+    ASSERT_EQ(gradient.getSize(), 16u);
+    const uchar* block = gradient.getData();
+    // alpha endpoints
+    EXPECT_EQ(block[0], 255);
+    EXPECT_EQ(block[1], 0);
+
+    uchar rgb[48];
+    decodeBC1(block + 8, rgb);
+    for (int i = 0; i < 16; i++)
+        for (int k = 0; k < 3; k++)
+            EXPECT_NEAR(rgb[3 * i + k], ref.getData()[4 * i + k], 10) << i << " " << k;
+
+    // all mipmaps are encoded
+    Image mipmapped(PF_BYTE_RGBA, 16, 16);
+    mipmapped.setTo(ColourValue::White);
+    mipmapped.generateMipmaps();
+    mipmapped.compress(PF_DXT1);
+    EXPECT_EQ(mipmapped.getNumMipmaps(), 4u);
+    EXPECT_EQ(mipmapped.getSize(), (16 + 4 + 1 + 1 + 1) * 8u);
+}
+
 
 TEST(Image, Combine)
 {
@@ -458,6 +1175,150 @@ TEST_F(ResourceLoading, CollsionUseExisting)
         "Collision", "Tests", "null", GPT_VERTEX_PROGRAM));
 }
 
+struct PreparingThreadListener : public Resource::Listener
+{
+    std::mutex mutex;
+    std::condition_variable otherThread;
+    std::thread::id caller = std::this_thread::get_id();
+    std::set<std::thread::id> threads;
+
+    void preparingComplete(Resource*) override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+        otherThread.notify_all();
+
+        // let the workers pick up the remaining resources
+        if (std::this_thread::get_id() == caller)
+            otherThread.wait_for(lock, std::chrono::seconds(2), [this]() { return threads.size() > 1; });
+    }
+};
+
+TEST_F(ResourceLoading, ParallelLoading)
+{
+#if OGRE_THREAD_SUPPORT != 1 && OGRE_THREAD_SUPPORT != 2
+    GTEST_SKIP() << "OGRE_THREAD_SUPPORT 1 or 2 required";
+#endif
+    mRoot->getWorkQueue()->startup();
+    auto& rgm = ResourceGroupManager::getSingleton();
+
+    PreparingThreadListener listener;
+    std::vector<ResourcePtr> meshes;
+    for (auto name : {"ogrehead.mesh", "knot.mesh", "robot.mesh", "ninja.mesh", "athene.mesh", "penguin.mesh"})
+    {
+        meshes.push_back(MeshManager::getSingleton().createOrRetrieve(name, rgm.findGroupContainingResource(name)).first);
+        meshes.back()->addListener(&listener);
+    }
+
+    rgm.setParallelLoadingEnabled(true);
+    rgm.loadResources(meshes);
+    rgm.setParallelLoadingEnabled(false);
+
+    for (auto& r : meshes)
+        r->removeListener(&listener);
+
+    // some were prepared on a worker thread
+    EXPECT_GT(listener.threads.size(), 1u);
+
+    std::vector<std::pair<size_t, AxisAlignedBox>> loaded;
+    for (auto& r : meshes)
+    {
+        MeshPtr mesh = static_pointer_cast<Mesh>(r);
+        ASSERT_TRUE(mesh->isLoaded());
+        // the dependencies revealed by loading the mesh are loaded too
+        if (mesh->hasSkeleton())
+            EXPECT_TRUE(mesh->getSkeleton()->isLoaded());
+        for (auto sm : mesh->getSubMeshes())
+        {
+            if (sm->getMaterial())
+                EXPECT_TRUE(sm->getMaterial()->isLoaded());
+        }
+        loaded.emplace_back(mesh->getNumSubMeshes(), mesh->getBounds());
+    }
+
+    // same result as loading them one by one
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        MeshPtr mesh = static_pointer_cast<Mesh>(meshes[i]);
+        mesh->reload();
+        EXPECT_EQ(mesh->getNumSubMeshes(), loaded[i].first);
+        EXPECT_EQ(mesh->getBounds(), loaded[i].second);
+    }
+}
+
+/// builds edge lists on loading like meshes of old versions do
+struct AutoBuildEdgeListsListener : public MeshSerializerListener
+{
+    bool build = false;
+    void processMaterialName(Mesh* mesh, String* name) override {}
+    void processSkeletonName(Mesh* mesh, String* name) override {}
+    void processMeshCompleted(Mesh* mesh) override { mesh->setAutoBuildEdgeLists(build); }
+};
+
+TEST_F(ResourceLoading, SaveBuiltEdgeLists)
+{
+    auto& rgm = ResourceGroupManager::getSingleton();
+    auto& mm = MeshManager::getSingleton();
+    String readOnly = mFSLayer->getWritablePath("EdgeListReadOnly");
+    String writable = mFSLayer->getWritablePath("EdgeListWritable");
+    String cacheDir = mFSLayer->getWritablePath("EdgeListCache");
+    for (const auto& dir : {readOnly, writable, cacheDir})
+        FileSystemLayer::createDirectory(dir);
+
+    // a mesh file without edge lists
+    MeshPtr plane = mm.createPlane("EdgeListPlane", RGN_DEFAULT, Plane(Vector3::UNIT_Z, 0), 10, 10, 4, 4);
+    MeshSerializer().exportMesh(plane, readOnly + "/edges.mesh");
+    MeshSerializer().exportMesh(plane, writable + "/edges.mesh");
+    mm.remove(plane);
+    plane.reset();
+
+    // whether the mesh has edge lists, from the file unless building them is enabled
+    AutoBuildEdgeListsListener listener;
+    mm.setListener(&listener);
+    auto loadHasEdgeLists = [&](bool build) {
+        mm.setPrepareAllMeshesForShadowVolumes(build);
+        listener.build = build;
+        MeshPtr mesh = mm.load("edges.mesh", "EdgeLists");
+        bool built = mesh->isEdgeListBuilt();
+        mm.remove(mesh);
+        mm.setPrepareAllMeshesForShadowVolumes(false);
+        return built;
+    };
+    mm.setSaveBuiltEdgeLists(true);
+
+    // read-only files are left alone, unless there is a cache
+    rgm.addResourceLocation(readOnly, "FileSystem", "EdgeLists", false, true);
+    rgm.initialiseResourceGroup("EdgeLists");
+    EXPECT_TRUE(loadHasEdgeLists(true));
+    EXPECT_FALSE(loadHasEdgeLists(false));
+
+    Archive* cache = ArchiveManager::getSingleton().load(cacheDir, "FileSystem", false);
+    mm.setEdgeListCache(cache);
+    EXPECT_TRUE(loadHasEdgeLists(true));
+    EXPECT_TRUE(loadHasEdgeLists(false));
+    mm.setEdgeListCache(NULL);
+    EXPECT_FALSE(loadHasEdgeLists(false));
+    StringVectorPtr entries = cache->list(false);
+    ASSERT_EQ(entries->size(), 1u);
+    FileSystemLayer::removeFile(cacheDir + "/" + entries->front());
+    ArchiveManager::getSingleton().unload(cache);
+
+    // writable files are replaced in place
+    rgm.destroyResourceGroup("EdgeLists");
+    rgm.addResourceLocation(writable, "FileSystem", "EdgeLists", false, false);
+    rgm.initialiseResourceGroup("EdgeLists");
+    EXPECT_TRUE(loadHasEdgeLists(true));
+    EXPECT_TRUE(loadHasEdgeLists(false));
+
+    mm.setSaveBuiltEdgeLists(false);
+    mm.setListener(NULL);
+    rgm.destroyResourceGroup("EdgeLists");
+    FileSystemLayer::removeFile(readOnly + "/edges.mesh");
+    FileSystemLayer::removeFile(writable + "/edges.mesh");
+    for (const auto& dir : {readOnly, writable, cacheDir})
+        FileSystemLayer::removeDirectory(dir);
+}
+
 struct DeletePreviousResourceLoadingListener : public ResourceLoadingListener
 {
     bool resourceCollision(Resource* resource, ResourceManager* resourceManager) override
@@ -573,6 +1434,66 @@ TEST_F(SkeletonTests, linkedSkeletonAnimationSource)
     EXPECT_TRUE(entity->getAnimationState("Stealth")); // animation from ninja.sekeleton
 }
 
+TEST_F(SkeletonTests, FlatPose)
+{
+    auto sceneMgr = mRoot->createSceneManager();
+    auto entity = sceneMgr->createEntity("jaiqua.mesh");
+    SkeletonInstance* skel = entity->getSkeleton();
+    auto states = entity->getAllAnimationStates()->getAnimationStates();
+    ASSERT_GE(states.size(), 2u);
+
+    // two blended animations, one of them masked
+    AnimationState* first = states.begin()->second;
+    AnimationState* second = std::next(states.begin())->second;
+    first->setEnabled(true);
+    first->setWeight(0.6);
+    second->setEnabled(true);
+    second->setWeight(0.3);
+    second->createBlendMask(skel->getNumBones(), 0.5);
+    second->setBlendMaskEntry(0, 1);
+
+    auto expectPose = [&](Real firstTime, Real secondTime) {
+        first->setTimePosition(firstTime);
+        second->setTimePosition(secondTime);
+        EXPECT_TRUE(skel->_canSetAnimationStateConcurrently(*entity->getAllAnimationStates()));
+        skel->setAnimationState(*entity->getAllAnimationStates());
+        std::vector<Vector3> positions, scales;
+        std::vector<Quaternion> orientations;
+        for (auto b : skel->getBones())
+        {
+            positions.push_back(b->getPosition());
+            orientations.push_back(b->getOrientation());
+            scales.push_back(b->getScale());
+        }
+
+        // the per node path
+        skel->reset();
+        skel->getAnimation(first->getAnimationName())->apply(skel, first->getTimePosition(), 0.6);
+        skel->getAnimation(second->getAnimationName())
+            ->apply(skel, second->getTimePosition(), 0.3f, second->getBlendMask(), 1.0f);
+        for (auto b : skel->getBones())
+        {
+            EXPECT_TRUE(b->getPosition().positionEquals(positions[b->getHandle()], 1e-4));
+            EXPECT_TRUE(b->getOrientation().equals(orientations[b->getHandle()], Radian(1e-3)));
+            EXPECT_TRUE(b->getScale().positionEquals(scales[b->getHandle()], 1e-4));
+        }
+    };
+
+    // the first evaluation prepares the animations
+    EXPECT_FALSE(skel->_canSetAnimationStateConcurrently(*entity->getAllAnimationStates()));
+    skel->setAnimationState(*entity->getAllAnimationStates());
+
+    // sequential playback past the end, then jumps
+    for (Real t = 0; t < first->getLength() * 1.5; t += 0.05)
+        expectPose(t, t * 0.7);
+    for (Real t : {0.9, 0.1, 2.5, 0.0, 1.7})
+        expectPose(t, first->getLength() - t * 0.5);
+
+    // spline interpolation takes the per node path
+    skel->getAnimation(first->getAnimationName())->setInterpolationMode(Animation::IM_SPLINE);
+    EXPECT_FALSE(skel->_canSetAnimationStateConcurrently(*entity->getAllAnimationStates()));
+}
+
 TEST(MaterialLoading, LateShadowCaster)
 {
     Root root("");
@@ -588,6 +1509,85 @@ TEST(MaterialLoading, LateShadowCaster)
     EXPECT_TRUE(tech->getShadowCasterMaterial());
 }
 
+static String dumpNodes(const ConcreteNodeList& nodes)
+{
+    String ret;
+    for (const auto& node : nodes)
+    {
+        ret += StringUtil::format("%d %u %s %s {", int(node->type), node->line, node->token.c_str(),
+                                  node->file.c_str());
+        ret += dumpNodes(node->children) + "}";
+    }
+    return ret;
+}
+
+TEST(ScriptCompilerManager, ParsedScriptCache)
+{
+    Root root("");
+    auto& mgr = ScriptCompilerManager::getSingleton();
+    mgr.setSaveParsedScriptsToCache(true);
+
+    String script = "material Cached\n{\n technique\n {\n  pass\n  {\n   diffuse 1 0 0 // red\n  }\n }\n}\n";
+    String expected = dumpNodes(*mgr._parse(script, "cached.material"));
+    EXPECT_TRUE(mgr.isParsedScriptCacheDirty());
+
+    auto cache = std::make_shared<MemoryDataStream>(size_t(4096));
+    mgr.saveParsedScriptCache(cache);
+    cache->seek(0);
+    mgr.loadParsedScriptCache(cache);
+    EXPECT_FALSE(mgr.isParsedScriptCacheDirty());
+
+    // served from the cache
+    EXPECT_EQ(dumpNodes(*mgr._parse(script, "cached.material")), expected);
+    EXPECT_FALSE(mgr.isParsedScriptCacheDirty());
+
+    // the cached tree compiles like a parsed one
+    DataStreamPtr stream = std::make_shared<MemoryDataStream>("cached.material", &script[0], script.size());
+    mgr.parseScript(stream, RGN_DEFAULT);
+    auto mat = MaterialManager::getSingleton().getByName("Cached", RGN_DEFAULT);
+    ASSERT_TRUE(mat);
+    EXPECT_EQ(mat->getTechnique(0)->getPass(0)->getDiffuse(), ColourValue::Red);
+    EXPECT_FALSE(mgr.isParsedScriptCacheDirty());
+
+    // changed content is parsed again
+    script.replace(script.find("1 0 0"), 5, "0 1 0");
+    EXPECT_NE(dumpNodes(*mgr._parse(script, "cached.material")), expected);
+    EXPECT_TRUE(mgr.isParsedScriptCacheDirty());
+}
+
+TEST(ScriptCompilerManager, BrokenParsedScriptCache)
+{
+    Root root("");
+    auto& mgr = ScriptCompilerManager::getSingleton();
+    mgr.setSaveParsedScriptsToCache(true);
+
+    String script = "material Cached\n{\n technique\n {\n  pass\n  {\n  }\n }\n}\n";
+    mgr._parse(script, "cached.material");
+
+    auto cache = std::make_shared<MemoryDataStream>(size_t(4096));
+    mgr.saveParsedScriptCache(cache);
+    size_t size = cache->tell();
+
+    // truncated anywhere, the cache is dropped instead of throwing and written again on save
+    for (size_t len : {size_t(0), size_t(4), size / 2, size - 1})
+    {
+        auto truncated = std::make_shared<MemoryDataStream>(cache->getPtr(), len);
+        EXPECT_NO_THROW(mgr.loadParsedScriptCache(truncated));
+        EXPECT_TRUE(mgr.isParsedScriptCacheDirty());
+    }
+
+    // a huge entry length, which follows the name and the hash, is not allocated
+    String name = "cached.material";
+    uchar* pos = std::search(cache->getPtr(), cache->getPtr() + size, name.begin(), name.end());
+    ASSERT_NE(pos, cache->getPtr() + size);
+    uint32 huge = 0x7FFFFFFF;
+    memcpy(pos + name.size() + 4, &huge, sizeof(huge));
+    auto corrupt = std::make_shared<MemoryDataStream>(cache->getPtr(), size);
+    EXPECT_NO_THROW(mgr.loadParsedScriptCache(corrupt));
+    EXPECT_TRUE(mgr.isParsedScriptCacheDirty());
+    EXPECT_TRUE(mgr._parse(script, "cached.material"));
+}
+
 TEST(Light, AnimableValue)
 {
     Light l;
@@ -663,6 +1663,82 @@ TEST(GpuProgramParams, Variability)
     EXPECT_EQ(params.getConstantDefinition("parameter").variability, GPV_PER_OBJECT);
 }
 
+TEST(GpuProgramParams, ChangedVariability)
+{
+    auto constants = std::make_shared<GpuNamedConstants>();
+    auto addConstant = [&](const String& name, GpuConstantType type, uint32 elementSize) {
+        GpuConstantDefinition& def = constants->map[name];
+        def.constType = type;
+        def.elementSize = elementSize;
+        def.physicalIndex = constants->bufferSize * 4;
+        constants->bufferSize += elementSize;
+    };
+    constants->bufferSize = 0;
+    addConstant("world", GCT_MATRIX_4X4, 16);
+    addConstant("ambient", GCT_FLOAT4, 4);
+    addConstant("manual", GCT_FLOAT4, 4);
+
+    GpuProgramParameters params;
+    params._setNamedConstants(constants);
+    params.setNamedAutoConstant("world", GpuProgramParameters::ACT_WORLD_MATRIX);
+    params.setNamedAutoConstant("ambient", GpuProgramParameters::ACT_AMBIENT_LIGHT_COLOUR);
+
+    EXPECT_EQ(params._getConstantsSize(GPV_PER_OBJECT), 64u);
+    EXPECT_EQ(params._getConstantsSize(GPV_GLOBAL), 32u);
+    EXPECT_EQ(params._getConstantsSize(GPV_ALL), 96u);
+
+    AutoParamDataSource source;
+    Affine3 world(Vector3(1, 2, 3), Quaternion::IDENTITY);
+    source.setAmbientLightColour(ColourValue(0.1, 0.2, 0.3));
+    source.setWorldMatrices(&world, 1);
+
+    params._updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(params._getChangedVariability(), GPV_GLOBAL | GPV_PER_OBJECT);
+    EXPECT_EQ(params.getFloatPointer(0)[3], 1);
+
+    // nothing changed in the source
+    params._updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(params._getChangedVariability(), 0);
+
+    // next object, at the same place
+    Affine3 sameWorld = world;
+    source.setWorldMatrices(&sameWorld, 1);
+    params._updateAutoParams(&source, GPV_PER_OBJECT);
+    EXPECT_EQ(params._getChangedVariability(), 0);
+
+    Affine3 moved(Vector3(4, 5, 6), Quaternion::IDENTITY);
+    source.setWorldMatrices(&moved, 1);
+    params._updateAutoParams(&source, GPV_PER_OBJECT);
+    EXPECT_EQ(params._getChangedVariability(), GPV_PER_OBJECT);
+    EXPECT_EQ(params.getFloatPointer(0)[3], 4);
+
+    // not written until the mask asks for it
+    source.setAmbientLightColour(ColourValue::Red);
+    params._updateAutoParams(&source, GPV_PER_OBJECT);
+    EXPECT_EQ(params._getChangedVariability(), 0);
+    EXPECT_EQ(params.getFloatPointer(64)[0], 0.1f);
+
+    params._updateAutoParams(&source, GPV_GLOBAL);
+    EXPECT_EQ(params._getChangedVariability(), GPV_GLOBAL);
+    EXPECT_EQ(params.getFloatPointer(64)[0], 1);
+
+    // the values of another pass number cannot be reused
+    source.setPassNumber(1);
+    params._updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(params._getChangedVariability(), 0);
+    params.getFloatPointer(64)[0] = 0;
+    source.setPassNumber(0);
+    params._updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(params._getChangedVariability(), GPV_GLOBAL);
+
+    // adding an auto constant writes everything again, only the new one has a different value
+    params.setNamedAutoConstant("manual", GpuProgramParameters::ACT_FOG_COLOUR);
+    source.setFog(FOG_NONE, ColourValue::Blue, 0, 0, 0);
+    params._updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(params._getChangedVariability(), GPV_GLOBAL);
+    EXPECT_EQ(params.getFloatPointer(80)[2], 1);
+}
+
 TEST(Billboard, TextureCoords)
 {
     Root root("");
@@ -695,4 +1771,290 @@ TEST(Billboard, TextureCoords)
             bb->setTexcoordIndex((ysegs - y - 1)*xsegs + x);
         }
     }
-}
\ No newline at end of file
+}
+TEST(OptimisedUtil, Implementations)
+{
+    const auto& impls = OptimisedUtil::getAvailableImplementations();
+    ASSERT_FALSE(impls.empty());
+    EXPECT_EQ(impls[0].first, "General");
+
+    float pos[12] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1};
+    EdgeData::Triangle tri;
+    tri.vertIndex[0] = 0;
+    tri.vertIndex[1] = 1;
+    tri.vertIndex[2] = 2;
+    for (const auto& impl : impls)
+    {
+        aligned_vector<Vector4> normal(1);
+        impl.second->calculateFaceNormals(pos, &tri, &normal[0], 1);
+        EXPECT_EQ(normal[0], Vector4(0, 0, 1, 0)) << impl.first;
+
+        float extruded[12];
+        impl.second->extrudeVertices(Vector4(0, 0, 1, 0), 10, pos, extruded, 4);
+        EXPECT_NEAR(extruded[11], -9, 0.01) << impl.first;
+
+        std::vector<double> throughput = OptimisedUtil::benchmark(impl.second, 100, 0);
+        ASSERT_EQ(throughput.size(), size_t(OptimisedUtil::BK_COUNT));
+        for (double t : throughput)
+            EXPECT_GT(t, 0) << impl.first;
+    }
+
+    OptimisedUtil* prev = OptimisedUtil::getImplementation();
+    OptimisedUtil* fastest = OptimisedUtil::_selectFastestImplementation();
+    EXPECT_EQ(OptimisedUtil::getImplementation(), fastest);
+    OptimisedUtil::setImplementation(prev);
+}
+
+TEST(OptimisedUtil, MatchGeneral)
+{
+    // sizes that leave a remainder after the SIMD loops
+    const size_t numVertices = 37, numTriangles = 29;
+    std::minstd_rand rng(5);
+    std::uniform_real_distribution<float> dist(-10, 10);
+
+    std::vector<float> posNorm(numVertices * 6), weights(numVertices * 2);
+    std::vector<uchar> indices(numVertices * 2);
+    for (size_t i = 0; i < numVertices; i++)
+    {
+        for (int k = 0; k < 6; k++)
+            posNorm[i * 6 + k] = dist(rng);
+        weights[i * 2] = 0.25f;
+        weights[i * 2 + 1] = 0.75f;
+        indices[i * 2] = uchar(i % 3);
+        indices[i * 2 + 1] = uchar((i + 1) % 3);
+    }
+    aligned_vector<Affine3> bones(3);
+    std::vector<const Affine3*> blendMatrices;
+    for (int b = 0; b < 3; b++)
+    {
+        bones[b].makeTransform(Vector3(b, 2, -b), Vector3::UNIT_SCALE, Quaternion(Degree(b * 40), Vector3::UNIT_Z));
+        blendMatrices.push_back(&bones[b]);
+    }
+
+    std::vector<float> positions(numVertices * 3);
+    for (size_t i = 0; i < numVertices; i++)
+        std::copy_n(&posNorm[i * 6], 3, &positions[i * 3]);
+    std::vector<EdgeData::Triangle> triangles(numTriangles);
+    for (auto& t : triangles)
+    {
+        for (int k = 0; k < 3; k++)
+            t.vertIndex[k] = rng() % numVertices;
+    }
+
+    struct Results
+    {
+        std::vector<float> skinned, extrudedPoint, extrudedDir;
+        aligned_vector<Vector4> normals;
+        std::vector<char> facings;
+    };
+    auto run = [&](OptimisedUtil* impl) {
+        Results r;
+        r.skinned.resize(posNorm.size());
+        impl->softwareVertexSkinning(&posNorm[0], &r.skinned[0], &posNorm[3], &r.skinned[3], &weights[0],
+                                     &indices[0], &blendMatrices[0], 24, 24, 24, 24, 8, 2, 2, numVertices);
+        r.normals.resize(numTriangles);
+        impl->calculateFaceNormals(&positions[0], &triangles[0], &r.normals[0], numTriangles);
+        r.facings.resize(numTriangles);
+        impl->calculateLightFacing(Vector4(1, 2, 3, 1), &r.normals[0], &r.facings[0], numTriangles);
+        r.extrudedPoint.resize(positions.size());
+        impl->extrudeVertices(Vector4(1, 2, 3, 1), 100, &positions[0], &r.extrudedPoint[0], numVertices);
+        r.extrudedDir.resize(positions.size());
+        impl->extrudeVertices(Vector4(0, -1, 1, 0), 100, &positions[0], &r.extrudedDir[0], numVertices);
+        return r;
+    };
+
+    const auto& impls = OptimisedUtil::getAvailableImplementations();
+    Results ref = run(impls[0].second);
+    for (const auto& impl : impls)
+    {
+        Results r = run(impl.second);
+        for (size_t i = 0; i < ref.skinned.size(); i++)
+            EXPECT_NEAR(r.skinned[i], ref.skinned[i], 1e-3) << impl.first;
+        for (size_t i = 0; i < numTriangles; i++)
+        {
+            for (int k = 0; k < 4; k++)
+                EXPECT_NEAR(r.normals[i][k], ref.normals[i][k], std::abs(ref.normals[i][k]) * 1e-4 + 1e-3)
+                    << impl.first;
+            // facings of the reference normals, the dot products can round either way around 0
+            Real d = Vector4(1, 2, 3, 1).dotProduct(ref.normals[i]);
+            if (std::abs(d) > 1e-2)
+                EXPECT_EQ(r.facings[i], ref.facings[i]) << impl.first;
+        }
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            EXPECT_NEAR(r.extrudedPoint[i], ref.extrudedPoint[i], 0.1) << impl.first;
+            EXPECT_NEAR(r.extrudedDir[i], ref.extrudedDir[i], 0.1) << impl.first;
+        }
+    }
+}
+
+TEST(OptimisedUtil, RunChunked)
+{
+    Root root("");
+    root.getWorkQueue()->startup();
+    size_t prevThreshold = OptimisedUtil::getParallelThreshold();
+    OptimisedUtil::setParallelThreshold(100);
+
+    std::vector<int> counts(1000);
+    std::mutex mutex;
+    size_t numCalls = 0;
+    OptimisedUtil::_runChunked(counts.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            counts[i]++;
+        std::lock_guard<std::mutex> lock(mutex);
+        numCalls++;
+    });
+    EXPECT_EQ(std::count(counts.begin(), counts.end(), 1), int(counts.size()));
+    EXPECT_EQ(numCalls, std::min<size_t>(10, root.getWorkQueue()->getWorkerThreadCount() + 1));
+
+    OptimisedUtil::setParallelThreshold(prevThreshold);
+}
+
+TEST(WorkQueue, RunTasksThrowing)
+{
+    Root root("");
+    WorkQueue* queue = root.getWorkQueue();
+    queue->startup();
+
+    for (bool paused : {false, true})
+    {
+        queue->setPaused(paused);
+        std::atomic<int> finished(0);
+        bool caught = false;
+        try
+        {
+            queue->runTasks(64, [&finished](size_t t) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                finished++;
+                if (t == 0 || t == 33)
+                    OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "task failed");
+            });
+        }
+        catch (const InvalidParametersException&)
+        {
+            caught = true;
+            // the remaining tasks ran before the exception got to the caller
+            EXPECT_EQ(finished, 64);
+        }
+        EXPECT_TRUE(caught);
+    }
+    queue->setPaused(false);
+}
+
+TEST(FrameAllocator, Basic)
+{
+    FrameAllocator arena(256);
+
+    auto marker = arena.getMarker();
+    char* a = static_cast<char*>(arena.allocate(10, 1));
+    void* b = arena.allocate(16, 16);
+    EXPECT_EQ(size_t(b) % 16, 0u);
+    EXPECT_GE(static_cast<char*>(b), a + 10);
+
+    // does not fit, so goes to a new block
+    void* c = arena.allocate(1000);
+    EXPECT_EQ(size_t(c) % OGRE_SIMD_ALIGNMENT, 0u);
+    EXPECT_EQ(arena.getNumAllocations(), 3u);
+    EXPECT_GE(arena.getCapacity(), 1256u);
+
+    arena.rewind(marker);
+    EXPECT_EQ(arena.getUsedBytes(), 0u);
+    EXPECT_EQ(arena.allocate(10, 1), a);
+
+    // the blocks are merged into one fitting the peak
+    size_t peak = arena.getPeakBytes();
+    arena.reset();
+    EXPECT_GE(arena.getCapacity(), peak);
+    size_t capacity = arena.getCapacity();
+    arena.allocate(1000);
+    arena.allocate(10);
+    EXPECT_EQ(arena.getCapacity(), capacity);
+
+    std::vector<int, ArenaAllocator<int>> v{ArenaAllocator<int>(&arena)};
+    for (int i = 0; i < 100; i++)
+        v.push_back(i);
+    EXPECT_EQ(v[99], 99);
+}
+
+namespace
+{
+struct PooledObject : public AllocatedObject<MEMCATEGORY_SCRIPTING>
+{
+    char data[40];
+};
+}
+
+TEST(CategoryAllocator, Pooling)
+{
+    ASSERT_TRUE(CategoryAllocator::setPoolingEnabled(MEMCATEGORY_SCRIPTING, true));
+    auto before = CategoryAllocator::getStats(MEMCATEGORY_SCRIPTING);
+
+    std::vector<PooledObject*> objects;
+    for (int i = 0; i < 100; i++)
+        objects.push_back(new PooledObject());
+
+    // the blocks of one size class are packed in slabs
+    EXPECT_EQ(size_t(objects[1]) - size_t(objects[0]), 48u);
+    EXPECT_FALSE(CategoryAllocator::setPoolingEnabled(MEMCATEGORY_SCRIPTING, false));
+
+    auto stats = CategoryAllocator::getStats(MEMCATEGORY_SCRIPTING);
+    EXPECT_EQ(stats.liveAllocations, 100u);
+    EXPECT_EQ(stats.liveBytes, 100 * sizeof(PooledObject));
+    EXPECT_EQ(stats.totalAllocations - before.totalAllocations, 100u);
+    EXPECT_GE(stats.pooledBytes, stats.liveBytes);
+
+    // freed blocks are reused first
+    PooledObject* last = objects.back();
+    delete last;
+    objects.back() = new PooledObject();
+    EXPECT_EQ(objects.back(), last);
+
+    for (auto o : objects)
+        delete o;
+    EXPECT_EQ(CategoryAllocator::getStats(MEMCATEGORY_SCRIPTING).liveAllocations, 0u);
+
+    CategoryAllocator::_frameEnded();
+    EXPECT_GE(CategoryAllocator::getStats(MEMCATEGORY_SCRIPTING).frameAllocations, 101u);
+    CategoryAllocator::_frameEnded();
+    EXPECT_EQ(CategoryAllocator::getStats(MEMCATEGORY_SCRIPTING).frameAllocations, 0u);
+
+    EXPECT_TRUE(CategoryAllocator::setPoolingEnabled(MEMCATEGORY_SCRIPTING, false));
+}
+
+typedef SceneNodeTest MemoryReportTest;
+TEST_F(MemoryReportTest, Capture)
+{
+    auto before = MemoryReport::capture();
+
+    auto sinbad = mSceneMgr->createEntity("sinbad", "Sinbad.mesh");
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(sinbad);
+
+    auto report = MemoryReport::capture();
+    EXPECT_GT(report.categories[MEMCATEGORY_SCENE_OBJECTS].liveAllocations,
+              before.categories[MEMCATEGORY_SCENE_OBJECTS].liveAllocations);
+    EXPECT_GT(report.getObjectBytes(), before.getObjectBytes());
+
+    EXPECT_GT(report.buffers.numVertexBuffers, before.buffers.numVertexBuffers);
+    EXPECT_GT(report.buffers.numIndexBuffers, before.buffers.numIndexBuffers);
+    EXPECT_GT(report.buffers.vertexBytes, before.buffers.vertexBytes);
+
+    auto mesh = std::find_if(report.managers.begin(), report.managers.end(),
+                             [](const MemoryReport::ManagerUsage& m) { return m.resourceType == "Mesh"; });
+    ASSERT_NE(mesh, report.managers.end());
+    EXPECT_GE(mesh->numLoaded, 1u);
+    ASSERT_FALSE(mesh->largest.empty());
+    EXPECT_EQ(mesh->largest[0].name, "Sinbad.mesh");
+    EXPECT_EQ(mesh->memoryUsage, MeshManager::getSingleton().getMemoryUsage());
+    EXPECT_NE(report.toString().find("Sinbad.mesh"), String::npos);
+
+    DefaultHardwareBufferManagerBase mgr;
+    auto shadowed = std::make_shared<HardwareIndexBuffer>(&mgr, HardwareIndexBuffer::IT_16BIT, 100, HBU_GPU_ONLY, true);
+    auto plain = mgr.createIndexBuffer(HardwareIndexBuffer::IT_32BIT, 100, HBU_GPU_ONLY);
+    auto usage = mgr.getMemoryUsage();
+    EXPECT_EQ(usage.numIndexBuffers, 2u);
+    EXPECT_EQ(usage.indexBytes, 600u);
+    EXPECT_EQ(usage.shadowBytes, 200u);
+
+    shadowed.reset();
+    EXPECT_EQ(mgr.getMemoryUsage().numIndexBuffers, 1u);
+}
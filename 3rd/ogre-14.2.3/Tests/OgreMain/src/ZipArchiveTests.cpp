@@ -30,6 +30,10 @@ THE SOFTWARE.
 #include "OgreCommon.h"
 #include "OgreConfigFile.h"
 #include "OgreFileSystemLayer.h"
+#include "OgreException.h"
+
+#include <thread>
+#include <atomic>
 
 using namespace Ogre;
 
@@ -250,3 +254,97 @@ TEST_F(ZipArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+TEST_F(ZipArchiveTests,Exists)
+{
+    EXPECT_TRUE(arch->exists("rootfile.txt"));
+    EXPECT_TRUE(arch->exists(fileId("level2/materials/scripts/file3.material")));
+    EXPECT_FALSE(arch->exists("missing.txt"));
+    EXPECT_THROW(arch->open("missing.txt"), FileNotFoundException);
+}
+//--------------------------------------------------------------------------
+TEST_F(ZipArchiveTests,ConcurrentRead)
+{
+    String ref[2] = {arch->open("rootfile.txt")->getAsString(), arch->open("rootfile2.txt")->getAsString()};
+
+    // entries are inflated without locking the archive
+    std::vector<std::thread> threads;
+    std::atomic<int> matches(0);
+    for (int i = 0; i < 8; i++)
+    {
+        threads.emplace_back([&, i]() {
+            for (int j = 0; j < 50; j++)
+            {
+                if (arch->open(i % 2 ? "rootfile2.txt" : "rootfile.txt")->getAsString() == ref[i % 2])
+                    matches++;
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    EXPECT_EQ(matches, 8 * 50);
+}
+//--------------------------------------------------------------------------
+TEST(ZipArchive,StoredInPlace)
+{
+    // "dir/stored.txt" holding "stored data" without compression
+    static const uint8 data[] = {
+    0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0x11, 0x55,
+    0xd7, 0x99, 0x0b, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x64, 0x69,
+    0x72, 0x2f, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x64, 0x2e, 0x74, 0x78, 0x74, 0x73, 0x74, 0x6f, 0x72,
+    0x65, 0x64, 0x20, 0x64, 0x61, 0x74, 0x61, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0x11, 0x55, 0xd7, 0x99, 0x0b, 0x00, 0x00, 0x00, 0x0b,
+    0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x64, 0x69, 0x72, 0x2f, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x64, 0x2e,
+    0x74, 0x78, 0x74, 0x50, 0x4b, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x3c,
+    0x00, 0x00, 0x00, 0x37, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+    EmbeddedZipArchiveFactory::addEmbbeddedFile("stored.zip", data, sizeof(data), NULL);
+    EmbeddedZipArchiveFactory factory;
+    Archive* arch = factory.createInstance("stored.zip", true);
+    arch->load();
+
+    DataStreamPtr stream = arch->open(fileId("dir/stored.txt"));
+    auto mem = dynamic_cast<MemoryDataStream*>(stream.get());
+    ASSERT_TRUE(mem);
+    // no copy of the entry is made
+    EXPECT_GE(mem->getPtr(), data);
+    EXPECT_LT(mem->getPtr(), data + sizeof(data));
+    EXPECT_EQ(stream->getAsString(), "stored data");
+
+    factory.destroyInstance(arch);
+}
+//--------------------------------------------------------------------------
+TEST(ZipArchive,InflatedCrc)
+{
+    // "deflated.txt" holding "deflated data deflated data", deflated
+    static const uint8 data[] = {
+    0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x21, 0x00, 0xa1, 0x87,
+    0xda, 0x2e, 0x13, 0x00, 0x00, 0x00, 0x1b, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x64, 0x65,
+    0x66, 0x6c, 0x61, 0x74, 0x65, 0x64, 0x2e, 0x74, 0x78, 0x74, 0x4b, 0x49, 0x4d, 0xcb, 0x49, 0x2c,
+    0x49, 0x4d, 0x51, 0x48, 0x49, 0x2c, 0x49, 0x54, 0x48, 0x41, 0xe6, 0x01, 0x00, 0x50, 0x4b, 0x01,
+    0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x21, 0x00, 0xa1, 0x87, 0xda,
+    0x2e, 0x13, 0x00, 0x00, 0x00, 0x1b, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x64, 0x65, 0x66, 0x6c, 0x61,
+    0x74, 0x65, 0x64, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x00, 0x01, 0x00, 0x3a, 0x00, 0x00, 0x00, 0x3d, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+    // the same with a wrong CRC in the central directory
+    static uint8 corrupt[sizeof(data)];
+    memcpy(corrupt, data, sizeof(data));
+    corrupt[61 + 16] ^= 0xFF;
+
+    EmbeddedZipArchiveFactory::addEmbbeddedFile("deflated.zip", data, sizeof(data), NULL);
+    EmbeddedZipArchiveFactory::addEmbbeddedFile("corrupt.zip", corrupt, sizeof(corrupt), NULL);
+    EmbeddedZipArchiveFactory factory;
+    Archive* arch = factory.createInstance("deflated.zip", true);
+    Archive* corruptArch = factory.createInstance("corrupt.zip", true);
+    arch->load();
+    corruptArch->load();
+
+    EXPECT_EQ(arch->open("deflated.txt")->getAsString(), "deflated data deflated data");
+    EXPECT_THROW(corruptArch->open("deflated.txt"), FileNotFoundException);
+
+    factory.destroyInstance(arch);
+    factory.destroyInstance(corruptArch);
+}
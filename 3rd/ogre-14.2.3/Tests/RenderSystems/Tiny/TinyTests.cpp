@@ -0,0 +1,386 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include "Ogre.h"
+#include "OgreTinyPlugin.h"
+#include "OgreTinyCommandQueue.h"
+#include "OgreTinyHardwareBufferManager.h"
+#include "OgreTinyLighting.h"
+#include "OgreSTBICodec.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreImageCodec.h"
+
+#include <fstream>
+#include <future>
+
+using namespace Ogre;
+
+struct TinyRenderSystemTest : public ::testing::Test
+{
+    Root* mRoot;
+    TinyPlugin* mPlugin;
+    RenderWindow* mWindow;
+    SceneManager* mSceneMgr;
+    Camera* mCamera;
+
+    void SetUp() override
+    {
+        mRoot = new Root("", "", "");
+        mPlugin = new TinyPlugin();
+        mRoot->installPlugin(mPlugin);
+        mRoot->setRenderSystem(mRoot->getRenderSystemByName("Tiny Rendering Subsystem"));
+        mRoot->initialise(false);
+        mWindow = mRoot->createRenderWindow("TinyTest", 64, 64, false);
+
+        mSceneMgr = mRoot->createSceneManager();
+        mCamera = mSceneMgr->createCamera("cam");
+        mCamera->setNearClipDistance(1);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 10))->attachObject(mCamera);
+        mWindow->addViewport(mCamera);
+    }
+
+    void TearDown() override
+    {
+        delete mRoot;
+        delete mPlugin;
+    }
+
+    ColourValue readPixel(size_t x, size_t y)
+    {
+        Image img(PF_BYTE_RGBA, mWindow->getWidth(), mWindow->getHeight());
+        mWindow->copyContentsToMemory(img.getPixelBox(), img.getPixelBox(), RenderTarget::FB_FRONT);
+        return img.getColourAt(x, y, 0);
+    }
+};
+
+TEST_F(TinyRenderSystemTest, CommandQueueOrder)
+{
+    auto& queue = TinyCommandQueue::getSingleton();
+    std::vector<int> executed;
+
+    uint64 first = queue.getRecordingSerial();
+    queue.record([&executed]() { executed.push_back(1); });
+    queue.record([&executed]() { executed.push_back(2); });
+    queue.submit();
+    EXPECT_EQ(queue.getRecordingSerial(), first + 1);
+
+    queue.record([&executed]() { executed.push_back(3); });
+    queue.finish();
+
+    EXPECT_TRUE(queue.isComplete(first));
+    EXPECT_TRUE(queue.isComplete(first + 1));
+    EXPECT_EQ(executed, std::vector<int>({1, 2, 3}));
+}
+
+TEST_F(TinyRenderSystemTest, RecordedDraws)
+{
+    // a triangle around the centre of the view, in vertex colours
+    ManualObject* tri = mSceneMgr->createManualObject();
+    tri->begin("BaseWhiteNoLighting");
+    tri->position(-2, -2, 0);
+    tri->colour(ColourValue::Red);
+    tri->position(2, -2, 0);
+    tri->colour(ColourValue::Red);
+    tri->position(0, 2, 0);
+    tri->colour(ColourValue::Red);
+    tri->end();
+    mSceneMgr->getRootSceneNode()->attachObject(tri);
+
+    // keep several frames in flight, only the last one must be visible
+    ColourValue backgrounds[] = {ColourValue::White, ColourValue::Green, ColourValue::Blue};
+    for (const auto& bg : backgrounds)
+    {
+        mWindow->getViewport(0)->setBackgroundColour(bg);
+        mRoot->renderOneFrame();
+    }
+
+    EXPECT_EQ(readPixel(32, 32), ColourValue::Red);
+    EXPECT_EQ(readPixel(0, 0), ColourValue::Blue);
+    EXPECT_EQ(readPixel(63, 63), ColourValue::Blue);
+}
+
+TEST_F(TinyRenderSystemTest, BlendedLines)
+{
+    // added on black, so a pixel written twice comes out brighter
+    MaterialPtr mat = MaterialManager::getSingleton().getByName("BaseWhiteNoLighting")->clone("AddedLines");
+    mat->getTechnique(0)->getPass(0)->setSceneBlending(SBT_ADD);
+
+    // separate lines of various lengths, a pixel is about 0.13 units
+    ManualObject* lines = mSceneMgr->createManualObject();
+    lines->begin(mat, RenderOperation::OT_LINE_LIST);
+    for (int k = 0; k < 10; k++)
+    {
+        lines->position(-3.5 + 0.13 * k, -3 + 0.6 * k, 0);
+        lines->colour(0.25, 0, 0);
+        lines->position(0.5 + 0.29 * k, -2.9 + 0.6 * k + 0.02 * k, 0);
+        lines->colour(0.25, 0, 0);
+    }
+    lines->end();
+    mSceneMgr->getRootSceneNode()->attachObject(lines);
+
+    mWindow->getViewport(0)->setBackgroundColour(ColourValue::Black);
+    mRoot->renderOneFrame();
+
+    Image img(PF_BYTE_RGBA, mWindow->getWidth(), mWindow->getHeight());
+    mWindow->copyContentsToMemory(img.getPixelBox(), img.getPixelBox(), RenderTarget::FB_FRONT);
+    int lit = 0;
+    for (uint32 y = 0; y < img.getHeight(); y++)
+    {
+        for (uint32 x = 0; x < img.getWidth(); x++)
+        {
+            float r = img.getColourAt(x, y, 0).r;
+            if (r == 0)
+                continue;
+            lit++;
+            EXPECT_NEAR(r, 0.25, 0.01) << x << "," << y;
+        }
+    }
+    EXPECT_GT(lit, 250);
+}
+
+TEST_F(TinyRenderSystemTest, DoubleBufferedWindow)
+{
+    // a frame is rendered to the buffer the frame before the last one was presented from
+    mWindow->getViewport(0)->setBackgroundColour(ColourValue::Green);
+    mRoot->renderOneFrame();
+    mWindow->getViewport(0)->setBackgroundColour(ColourValue::Blue);
+    mRoot->renderOneFrame();
+
+    Image front(PF_BYTE_RGBA, mWindow->getWidth(), mWindow->getHeight());
+    Image back(PF_BYTE_RGBA, mWindow->getWidth(), mWindow->getHeight());
+    mWindow->copyContentsToMemory(front.getPixelBox(), front.getPixelBox(), RenderTarget::FB_FRONT);
+    mWindow->copyContentsToMemory(back.getPixelBox(), back.getPixelBox(), RenderTarget::FB_BACK);
+    EXPECT_EQ(front.getColourAt(10, 10, 0), ColourValue::Blue);
+    EXPECT_EQ(back.getColourAt(10, 10, 0), ColourValue::Green);
+
+    // the next frame goes to the back buffer
+    mWindow->getViewport(0)->setBackgroundColour(ColourValue::Red);
+    mRoot->renderOneFrame();
+    EXPECT_EQ(readPixel(10, 10), ColourValue::Red);
+    mWindow->copyContentsToMemory(back.getPixelBox(), back.getPixelBox(), RenderTarget::FB_BACK);
+    EXPECT_EQ(back.getColourAt(10, 10, 0), ColourValue::Blue);
+}
+
+TEST(TinyLighting, PointAtLight)
+{
+    TinyLighting lighting;
+    lighting.numLights = 2;
+    lighting.lightPosition[0] = Vector4(1, 2, 3, 1);
+    lighting.lightPosition[1] = Vector4(0, 0, 1, 0);
+    for (int i = 0; i < 2; i++)
+    {
+        lighting.lightDiffuse[i] = ColourValue(0.5, 0.5, 0.5);
+        lighting.lightSpecular[i] = ColourValue::White;
+        lighting.lightAttenuation[i] = Vector4(100, 1, 0, 0);
+    }
+    lighting.specular = ColourValue::White;
+    lighting.shininess = 8;
+    lighting.prepare();
+
+    // the shaded point has no direction to the point light, which must not turn the sum into NaN
+    ColourValue diffuse, specular;
+    lighting.shade(Vector3(1, 2, 3), Vector3::UNIT_Z, diffuse, specular);
+    for (int c = 0; c < 3; c++)
+    {
+        EXPECT_TRUE(std::isfinite(diffuse[c])) << c;
+        EXPECT_TRUE(std::isfinite(specular[c])) << c;
+        EXPECT_GE(diffuse[c], 0.5f) << c;
+    }
+}
+
+TEST_F(TinyRenderSystemTest, DiscardRotatesCopies)
+{
+    auto& queue = TinyCommandQueue::getSingleton();
+    TinyHardwareBuffer buf(64, HBU_CPU_TO_GPU);
+
+    // the first and the last batch block until released, which keeps them all in flight
+    std::promise<void> started, release[2];
+    std::shared_future<void> released[2] = {release[0].get_future().share(), release[1].get_future().share()};
+    std::vector<const uchar*> copies;
+    std::vector<uchar> read(3);
+    for (int i = 0; i < 3; i++)
+    {
+        memset(buf.lock(HardwareBuffer::HBL_DISCARD), i + 1, buf.getSizeInBytes());
+        buf.unlock();
+        copies.push_back(buf.getData());
+
+        buf._notifyUsed(queue.getRecordingSerial());
+        const uchar* data = buf.getData();
+        uchar* dst = &read[i];
+        std::promise<void>* start = i == 0 ? &started : NULL;
+        std::shared_future<void> wait = i == 0 ? released[0] : i == 2 ? released[1] : std::shared_future<void>();
+        queue.record([start, wait, data, dst]() {
+            if (start)
+                start->set_value();
+            if (wait.valid())
+                wait.wait();
+            *dst = data[63];
+        });
+        queue.submit();
+    }
+
+    // a new copy for every discard while the previous ones are in use
+    EXPECT_NE(copies[0], copies[1]);
+    EXPECT_NE(copies[1], copies[2]);
+    EXPECT_NE(copies[0], copies[2]);
+
+    // at most 3 copies, the oldest comes back once its batch completed and the others keep their data
+    started.get_future().wait(); // on a worker, not drained by the waiting below
+    release[0].set_value();
+    memset(buf.lock(HardwareBuffer::HBL_DISCARD), 4, buf.getSizeInBytes());
+    buf.unlock();
+    EXPECT_EQ(buf.getData(), copies[0]);
+    EXPECT_EQ(copies[1][0], 2);
+    EXPECT_EQ(copies[2][0], 3);
+
+    // each batch read the data it was recorded with
+    release[1].set_value();
+    queue.finish();
+    EXPECT_EQ(read, std::vector<uchar>({1, 2, 3}));
+
+    // used by a completed batch only, written in place
+    buf._notifyUsed(queue.getRecordingSerial() - 1);
+    buf.lock(HardwareBuffer::HBL_DISCARD);
+    buf.unlock();
+    EXPECT_EQ(buf.getData(), copies[0]);
+}
+
+TEST_F(TinyRenderSystemTest, MaterialDependencies)
+{
+    // make the texture loadable, so loading it early would show
+    ConfigFile cf;
+    cf.load(FileSystemLayer(OGRE_VERSION_NAME).getConfigFilePath("resources.cfg"));
+    for (const auto& it : cf.getSettings("General"))
+        ResourceGroupManager::getSingleton().addResourceLocation(it.second, it.first, RGN_DEFAULT);
+    STBIImageCodec::startup();
+
+    MaterialPtr mat = MaterialManager::getSingleton().create("DependencyTest", RGN_DEFAULT);
+    mat->getTechnique(0)->getPass(0)->createTextureUnitState("BeachStones.jpg");
+    // changed behind the back of the unit, which prepares and loads it without gamma correction
+    TextureManager::getSingleton().getByName("BeachStones.jpg", RGN_DEFAULT)->setGamma(2.2f);
+
+    std::vector<ResourcePtr> dependencies;
+    mat->_getDependencies(dependencies);
+
+    // reported, but left to ResourceGroupManager::loadResources to prepare concurrently
+    ASSERT_EQ(dependencies.size(), 1u);
+    EXPECT_EQ(dependencies[0]->getName(), "BeachStones.jpg");
+    EXPECT_EQ(dependencies[0]->getLoadingState(), Resource::LOADSTATE_UNLOADED);
+    // with the settings of the unit, as TextureUnitState::_prepare would prepare it
+    EXPECT_EQ(static_pointer_cast<Texture>(dependencies[0])->getGamma(), 1.0f);
+
+    dependencies[0]->load();
+    EXPECT_EQ(dependencies[0]->getLoadingState(), Resource::LOADSTATE_LOADED);
+
+    mat.reset();
+    dependencies.clear();
+    MaterialManager::getSingleton().remove("DependencyTest", RGN_DEFAULT);
+    TextureManager::getSingleton().removeAll();
+    STBIImageCodec::shutdown();
+}
+
+/// decodes 4x4 images stored as their PixelFormat followed by the pixels
+struct RawImageCodec : public ImageCodec
+{
+    String getType() const override { return "rawimage"; }
+    String magicNumberToFileExt(const char* magicNumberPtr, size_t maxbytes) const override { return BLANKSTRING; }
+    void decode(const DataStreamPtr& input, const Any& output) const override
+    {
+        uint32 format;
+        input->read(&format, sizeof(format));
+        Image* img = any_cast<Image*>(output);
+        img->create(PixelFormat(format), 4, 4);
+        input->read(img->getData(), img->getSize());
+    }
+};
+
+struct CacheReadListener : public LogListener
+{
+    int reads = 0;
+    void messageLogged(const String& message, LogMessageLevel lml, bool maskDebug, const String& logName,
+                       bool& skipThisMessage) override
+    {
+        reads += message.find("read from cache entry") != String::npos;
+    }
+};
+
+TEST_F(TinyRenderSystemTest, TextureCachePrecision)
+{
+    // with block compression available, the cache would use it
+    const_cast<RenderSystemCapabilities*>(mRoot->getRenderSystem()->getCapabilities())
+        ->setCapability(RSC_TEXTURE_COMPRESSION_DXT);
+
+    FileSystemLayer fsLayer(OGRE_VERSION_NAME);
+    String sourceDir = fsLayer.getWritablePath("TextureCacheSource");
+    String cacheDir = fsLayer.getWritablePath("TextureCacheEntries");
+    FileSystemLayer::createDirectory(sourceDir);
+    FileSystemLayer::createDirectory(cacheDir);
+
+    RawImageCodec codec;
+    Codec::registerCodec(&codec);
+    CacheReadListener listener;
+    LogManager::getSingleton().getDefaultLog()->addListener(&listener);
+
+    auto& texMgr = TextureManager::getSingleton();
+    Archive* cache = ArchiveManager::getSingleton().load(cacheDir, "FileSystem", false);
+    texMgr.setTextureCache(cache);
+    texMgr.setTextureCacheCompression(true);
+    texMgr.setVerbose(true);
+
+    // out of the 0..1 range and finer than 8 bits
+    std::vector<Image> sources;
+    for (PixelFormat format : {PF_FLOAT32_RGB, PF_SHORT_RGBA})
+    {
+        sources.emplace_back(format, 4, 4);
+        for (uint32 i = 0; i < 16; i++)
+            sources.back().setColourAt(
+                ColourValue(i * 0.0011f, 1 - i * 0.0013f, format == PF_FLOAT32_RGB ? 2.5f : 0.5f), i % 4, i / 4, 0);
+        std::ofstream(sourceDir + "/" + PixelUtil::getFormatName(format) + ".rawimage", std::ios::binary)
+            .write((const char*)&format, sizeof(uint32))
+            .write((const char*)sources.back().getData(), sources.back().getSize());
+    }
+    ResourceGroupManager::getSingleton().addResourceLocation(sourceDir, "FileSystem", RGN_DEFAULT);
+
+    for (const Image& src : sources)
+    {
+        PixelFormat format = src.getFormat();
+        String name = PixelUtil::getFormatName(format) + ".rawimage";
+
+        // stored as decoded and read back on the next load
+        for (int i = 0; i < 2; i++)
+        {
+            texMgr.load(name, RGN_DEFAULT, TEX_TYPE_2D, 0);
+            texMgr.remove(name, RGN_DEFAULT);
+        }
+        EXPECT_EQ(listener.reads, 1);
+        listener.reads = 0;
+
+        StringVectorPtr entries = cache->list(false);
+        ASSERT_EQ(entries->size(), 1u);
+        DataStreamPtr entry = cache->open(entries->front());
+        uint32 header[12];
+        entry->read(header, sizeof(header));
+        EXPECT_EQ(header[5], uint32(format));
+        EXPECT_EQ(header[4] & 4, 0u); // not compressed
+        std::vector<uchar> data(src.getSize());
+        EXPECT_EQ(entry->read(data.data(), data.size()), data.size());
+        EXPECT_EQ(memcmp(data.data(), src.getData(), data.size()), 0);
+        entry.reset();
+
+        FileSystemLayer::removeFile(cacheDir + "/" + entries->front());
+        FileSystemLayer::removeFile(sourceDir + "/" + name);
+    }
+
+    ResourceGroupManager::getSingleton().removeResourceLocation(sourceDir, RGN_DEFAULT);
+    texMgr.setTextureCache(NULL);
+    texMgr.setTextureCacheCompression(false);
+    texMgr.setVerbose(false);
+    LogManager::getSingleton().getDefaultLog()->removeListener(&listener);
+    Codec::unregisterCodec(&codec);
+    FileSystemLayer::removeDirectory(sourceDir);
+    FileSystemLayer::removeDirectory(cacheDir);
+}
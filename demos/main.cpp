@@ -43,6 +43,17 @@ int main(int argc, char** argv) {
   DemoApp app("AwtkOgreApp", 800, 600);
 
   app.init(NULL);
+
+  /* shaders are compiled by init, the caches are written on exit */
+  if (argc > 1 && tk_str_eq(argv[1], "--warm-shader-cache")) {
+    return 0;
+  }
+
+  /* watch what ogre holds while the demo runs */
+  if (argc > 1 && tk_str_eq(argv[1], "--memory-panel")) {
+    app.showMemoryPanel(widget_child(window_manager(), "main"));
+  }
+
   app.run();
 
   return 0;
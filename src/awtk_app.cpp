@@ -88,6 +88,15 @@ static ret_t awtk_hook_camera_buttons(AwtkApp* app, widget_t* win) {
   return RET_OK;
 }
 
+static ret_t on_memory_panel_timer(const timer_info_t* info) {
+  widget_t* label = WIDGET(info->ctx);
+  String text = MemoryReport::capture(3).toString();
+
+  widget_set_text_utf8(label, text.c_str());
+
+  return RET_REPEAT;
+}
+
 AwtkApp::AwtkApp(OgreApp* app) : m_app(app) {
 }
 
@@ -98,6 +107,36 @@ ret_t AwtkApp::hookCameraButtons(widget_t* win) {
   return awtk_hook_camera_buttons(this, win);
 }
 
+ret_t AwtkApp::showMemoryPanel(widget_t* win) {
+  widget_t* label = NULL;
+  timer_info_t info;
+  return_value_if_fail(win != NULL, RET_BAD_PARAMS);
+
+  if (widget_lookup(win, "memory_panel", FALSE) != NULL) {
+    return RET_OK;
+  }
+
+  label = label_create(win, 0, 0, 0, 0);
+  return_value_if_fail(label != NULL, RET_OOM);
+
+  widget_set_name(label, "memory_panel");
+  widget_set_self_layout(label, "default(x=0,y=0,w=50%,h=100%)");
+  label_set_line_wrap(label, TRUE);
+  widget_set_style_str(label, "normal:text_align_h", "left");
+  widget_set_style_str(label, "normal:text_align_v", "top");
+  widget_set_style_int(label, "normal:font_size", 12);
+  widget_set_style_color(label, "normal:text_color", 0xffffffff);
+  widget_set_style_color(label, "normal:bg_color", 0x80000000);
+  widget_add_timer(label, on_memory_panel_timer, 1000);
+
+  /* fill it now, not a second later */
+  memset(&info, 0x00, sizeof(info));
+  info.ctx = label;
+  on_memory_panel_timer(&info);
+
+  return RET_OK;
+}
+
 ret_t AwtkApp::init(const char* app_root) {
   const char* app_name = "";
   return_value_if_fail(tk_pre_init() == RET_OK, RET_FAIL);
@@ -33,6 +33,9 @@ class AwtkApp {
   ret_t init(const char* app_root); 
   ret_t run(void);
 
+  /* show the memory held by ogre in a corner of win, refreshed every second */
+  ret_t showMemoryPanel(widget_t* win);
+
   OgreApp* getApp(void) {
     return m_app;
   }
@@ -36,6 +36,14 @@ OgreApp::OgreApp(const char* app_name, int w, int h)
       mLightHelper(),
       mWidth(w),
       mHeight(h) {
+  /* nodes, entities and particles come and go for the whole run, keep them off the heap */
+  if (!CategoryAllocator::setPoolingEnabled(MEMCATEGORY_SCENE_CONTROL, true)) {
+    /* objects of the category are alive already, they stay on the heap */
+    log_warn("pooling of MEMCATEGORY_SCENE_CONTROL not enabled\n");
+  }
+  if (!CategoryAllocator::setPoolingEnabled(MEMCATEGORY_SCENE_OBJECTS, true)) {
+    log_warn("pooling of MEMCATEGORY_SCENE_OBJECTS not enabled\n");
+  }
 }
 
 OgreApp::~OgreApp() {
@@ -52,6 +60,8 @@ void OgreApp::setup() {
   // register our scene with the RTSS
   RTShader::ShaderGenerator* shadergen = RTShader::ShaderGenerator::getSingletonPtr();
   shadergen->addSceneManager(mSceneMgr);
+  // generate and compile the shaders now, not when an object first shows up
+  shadergen->precompileMaterials(MSN_SHADERGEN);
 
   mSceneManagerHelper.init(mSceneMgr);
   mCameraHelper.init(mSceneMgr, getRenderWindow(), Vector3(0, -1, 0), Vector3(0, 0, 0));
@@ -60,6 +70,16 @@ void OgreApp::setup() {
   root->addFrameListener(this);
 }
 
+void OgreApp::loadResources() {
+  /* skip lexing and parsing of the scripts that did not change since the last run */
+  enableScriptCache();
+  /* reuse the driver program binaries of the last run */
+  enableShaderCache();
+  /* upload the decoded and mipmapped textures of the last run, block compression is lossy so it is left off */
+  enableTextureCache();
+  ApplicationContext::loadResources();
+}
+
 bool OgreApp::mouseMoved(const MouseMotionEvent& evt) {
   pointer_event_t event;
   widget_t* widget = window_manager();
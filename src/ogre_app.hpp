@@ -41,6 +41,7 @@ class OgreApp : public ApplicationContext, public InputListener, public RenderTa
 
  protected:
   void setup() override;
+  void loadResources() override;
 
   bool mouseMoved(const MouseMotionEvent& evt) override;
   bool mouseWheelRolled(const MouseWheelEvent& evt) override;